@@ -0,0 +1,150 @@
+--[[
+Generates 'ljitstencils.h', the stencils of the baseline JIT compiler, from
+their source in 'etc/jitstencils.s': it assembles the source and turns each
+stencil into an array of bytes and the list of its holes, which are the
+relocations against the undefined 'jit_*' symbols.
+
+Needs GNU binutils (as, objcopy, nm, and readelf) for x86-64.
+
+Usage (from the root of the distribution):
+    lua etc/jitstencils.lua [source] [header]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local Source = arg[1] or "etc/jitstencils.s"
+local Header = arg[2] or "ljitstencils.h"
+
+--[[ Kinds of relocations, as in 'ljit.c' --]]
+local Kinds = {
+    R_X86_64_64 = "JR_64",
+    R_X86_64_32 = "JR_32",
+    R_X86_64_32S = "JR_32S",
+    R_X86_64_8 = "JR_8",
+    R_X86_64_PC32 = "JR_PC32",
+    R_X86_64_PLT32 = "JR_PC32",
+}
+
+local function run(command)
+    local f = assert(io.popen(command .. " 2>&1"))
+    local output = f:read("a")
+    local ok = f:close()
+    if not ok then
+        error(("'%s' failed:\n%s"):format(command, output))
+    end
+    return output
+end
+
+local object = os.tmpname()
+local binary = os.tmpname()
+run(("as --64 -o %s %s"):format(object, Source))
+run(("objcopy -O binary --only-section=.text %s %s"):format(object, binary))
+
+local text do
+    local f = assert(io.open(binary, "rb"))
+    text = f:read("a")
+    f:close()
+end
+
+-- addresses of the labels of the stencils
+local Labels, Stencils = {}, {}
+for address, name in run("nm -n " .. object):gmatch("(%x+) %a ([%w_]+)") do
+    Labels[name] = tonumber(address, 16)
+    if name:match("^st_") and not name:match("_end$") then
+        Stencils[#Stencils + 1] = name
+    end
+end
+
+-- holes: relocations against the 'jit_*' symbols
+local Relocations, Holes = {}, {}
+for line in run("readelf -rW " .. object):gmatch("[^\n]+") do
+    local offset, kind, symbol, sign, addend =
+        line:match("^(%x+)%s+%x+%s+(R_X86_64_%w+)%s+%x+%s+(jit_[%w_]+)%s*([%+%-])%s*(%x+)")
+    if offset then
+        symbol = symbol:match("^jit_(.*)$"):upper()
+        Relocations[#Relocations + 1] = {
+            offset = tonumber(offset, 16),
+            kind = assert(Kinds[kind], "unknown relocation " .. kind),
+            hole = symbol,
+            addend = (sign == "-" and -1 or 1) * tonumber(addend, 16),
+        }
+        Holes[symbol] = true
+    end
+end
+os.remove(object)
+os.remove(binary)
+
+local HoleNames = {}
+for hole in pairs(Holes) do
+    HoleNames[#HoleNames + 1] = hole
+end
+table.sort(HoleNames)
+
+local out = {}
+local function emit(s, ...)
+    out[#out + 1] = s:format(...)
+end
+
+emit("/*\n")
+emit("** $Id: ljitstencils.h $\n")
+emit("** Stencils of the baseline JIT compiler (x86-64)\n")
+emit("** Generated by 'etc/jitstencils.lua' from 'etc/jitstencils.s'; do not\n")
+emit("** edit it by hand\n")
+emit("** See Copyright Notice in lua.h\n")
+emit("*/\n\n")
+
+emit("/* holes ('jit_*' symbols) */\n")
+emit("enum JitHoleName {\n")
+for _, hole in ipairs(HoleNames) do
+    emit("  JH_%s,\n", hole)
+end
+emit("  NUM_HOLES\n};\n\n")
+
+for _, name in ipairs(Stencils) do
+    local first = Labels[name]
+    local last = assert(Labels[name .. "_end"], "no end for " .. name)
+    local bytes = {}
+    for i = first + 1, last do
+        bytes[#bytes + 1] = ("0x%02x"):format(text:byte(i))
+    end
+    emit("static const lu_byte %s_code[] = {", name)
+    for i, b in ipairs(bytes) do
+        emit("%s%s%s", (i - 1) % 12 == 0 and "\n  " or " ", b, i < #bytes and "," or "")
+    end
+    emit("\n};\n")
+    local holes = {}
+    for _, r in ipairs(Relocations) do
+        if r.offset >= first and r.offset < last then
+            holes[#holes + 1] = ("  {%d, %s, JH_%s, %d}"):format(r.offset - first,
+                r.kind, r.hole, r.addend)
+        end
+    end
+    if #holes > 0 then
+        emit("static const JitHole %s_holes[] = {\n%s\n};\n", name,
+            table.concat(holes, ",\n"))
+    end
+    emit("\n")
+end
+
+emit("enum JitStencilName {\n")
+for _, name in ipairs(Stencils) do
+    emit("  %s,\n", name:upper())
+end
+emit("  NUM_STENCILS\n};\n\n")
+
+emit("static const JitStencil jitstencils[NUM_STENCILS] = {\n")
+for i, name in ipairs(Stencils) do
+    local hasholes = false
+    for _, r in ipairs(Relocations) do
+        if r.offset >= Labels[name] and r.offset < Labels[name .. "_end"] then
+            hasholes = true
+        end
+    end
+    emit("  %s(%s)%s\n", hasholes and "jitstencil" or "jitstencil0", name,
+        i < #Stencils and "," or "")
+end
+emit("};\n")
+
+local f = assert(io.open(Header, "w"))
+f:write(table.concat(out))
+f:close()
@@ -0,0 +1,719 @@
+# Stencils of the baseline JIT compiler (see 'ljit.c')
+# See Copyright Notice in lua.h
+#
+# Each stencil runs between its label 'st_<name>' and 'st_<name>_end'.
+# Undefined symbols 'jit_*' are the holes that 'ljit.c' patches when it
+# copies the stencil; 'etc/jitstencils.lua' turns this file into
+# 'ljitstencils.h'. Stencils never jump to each other, only to holes.
+#
+# Registers on entry to any stencil (see 'JitFunction' in 'ljit.c'):
+#   %rdi  base of the frame (register 0)
+#   %rsi  CallInfo of the frame
+#   %rdx  the running LClosure
+# Operands of an instruction are addressed by:
+#   %r10  register A
+#   %r8   operand B (register or constant)
+#   %r9   operand C (register or constant)
+# Stencils use only caller-saved registers, keep %rdi, %rsi, and %rdx,
+# and call nothing. Values are 'TValue's: 16 bytes of value and the tag
+# at offset 16. Registers are 24 bytes apart ('StackValue').
+#
+# Holes:
+#   jit_ra, jit_rb, jit_rc    offsets of registers A, B, C from base
+#   jit_kb, jit_kc            addresses of constant operands
+#   jit_val, jit_tag          a 64-bit value and a tag to store
+#   jit_imm                   a signed 32-bit immediate operand
+#   jit_lane                  offset of a vector component
+#   jit_upval, jit_upvalv     offsets of 'cl->upvals[B]' and 'UpVal.v'
+#   jit_trap                  offset of 'ci->u.l.trap'
+#   jit_alimit, jit_array     offsets of 'Table.alimit' and 'Table.array'
+#   jit_ronly                 offset of 'Table.readonly'
+#   jit_pc                    value returned to the interpreter
+#   jit_exit                  exit of the instruction (a guard failed)
+#   jit_leave                 exit of the instruction (hooks)
+#   jit_true, jit_false       code after a test that succeeds or fails
+#   jit_target                code at the target of a jump
+
+	.set TINT, 0x03		# LUA_VNUMINT
+	.set TFLT, 0x13		# LUA_VNUMFLT
+	.set TNIL, 0x00		# LUA_VNIL
+	.set TFALSE, 0x01	# LUA_VFALSE
+	.set TTRUE, 0x11	# LUA_VTRUE
+	.set TVECTOR, 0x04	# LUA_TVECTOR
+	.set TVEC2, 0x04	# LUA_VVECTOR2
+	.set TVEC3, 0x14	# LUA_VVECTOR3
+	.set TVEC4, 0x24	# LUA_VVECTOR4
+	.set TTABLE, 0x46	# ctb(LUA_VTABLE)
+	.set COLLECTABLE, 0x40	# BIT_ISCOLLECTABLE
+
+	.text
+
+# {======================================================
+# Operands and exits
+# =======================================================
+
+st_ra:
+	lea jit_ra(%rdi), %r10
+st_ra_end:
+
+st_rb:
+	lea jit_rb(%rdi), %r8
+st_rb_end:
+
+st_rc:
+	lea jit_rc(%rdi), %r9
+st_rc_end:
+
+st_kb:
+	movabs $jit_kb, %r8
+st_kb_end:
+
+st_kc:
+	movabs $jit_kc, %r9
+st_kc_end:
+
+# return to the interpreter, which goes on at 'jit_pc'
+st_exit:
+	movabs $jit_pc, %rax
+	ret
+st_exit_end:
+
+# head of a loop: leave if hooks or a signal set 'trap'
+st_loop:
+	cmpl $0, jit_trap(%rsi)
+	jne jit_leave
+st_loop_end:
+
+# }======================================================
+
+
+# {======================================================
+# Loads and moves
+# =======================================================
+
+st_move:
+	movdqu jit_rb(%rdi), %xmm0
+	movzbl jit_rb+16(%rdi), %eax
+	movdqu %xmm0, jit_ra(%rdi)
+	movb %al, jit_ra+16(%rdi)
+st_move_end:
+
+st_loadv:
+	movabs $jit_val, %rax
+	mov %rax, jit_ra(%rdi)
+	movb $jit_tag, jit_ra+16(%rdi)
+st_loadv_end:
+
+st_settag:
+	movb $jit_tag, jit_ra+16(%rdi)
+st_settag_end:
+
+st_getupval:
+	mov jit_upval(%rdx), %rax
+	mov jit_upvalv(%rax), %rax
+	movdqu (%rax), %xmm0
+	movzbl 16(%rax), %ecx
+	movdqu %xmm0, jit_ra(%rdi)
+	movb %cl, jit_ra+16(%rdi)
+st_getupval_end:
+
+# }======================================================
+
+
+# {======================================================
+# Arithmetic
+# =======================================================
+
+# R[A] := B iop C, both integers
+.macro arith_ii name, iop
+st_\name\()_ii:
+	cmpb $TINT, 16(%r8)
+	jne jit_exit
+	cmpb $TINT, 16(%r9)
+	jne jit_exit
+	mov (%r8), %rax
+	\iop (%r9), %rax
+	mov %rax, (%r10)
+	movb $TINT, 16(%r10)
+st_\name\()_ii_end:
+.endm
+
+# R[A] := B fop C, both floats
+.macro arith_ff name, fop
+st_\name\()_ff:
+	cmpb $TFLT, 16(%r8)
+	jne jit_exit
+	cmpb $TFLT, 16(%r9)
+	jne jit_exit
+	movsd (%r8), %xmm0
+	\fop (%r9), %xmm0
+	movsd %xmm0, (%r10)
+	movb $TFLT, 16(%r10)
+st_\name\()_ff_end:
+.endm
+
+# R[A] := B op C, any numbers (integers use 'iop', if given)
+.macro arith_nn name, iop, fop
+st_\name\()_nn:
+	movzbl 16(%r8), %eax
+	movzbl 16(%r9), %ecx
+	cmp $TINT, %eax
+	jne 1f
+	cmp $TINT, %ecx
+	jne 2f
+.ifnb \iop
+	mov (%r8), %rax
+	\iop (%r9), %rax
+	mov %rax, (%r10)
+	movb $TINT, 16(%r10)
+	jmp 9f
+.else
+	cvtsi2sdq (%r8), %xmm0
+	cvtsi2sdq (%r9), %xmm1
+	jmp 5f
+.endif
+1:	cmp $TFLT, %eax
+	jne jit_exit
+	movsd (%r8), %xmm0
+	jmp 3f
+2:	cvtsi2sdq (%r8), %xmm0
+3:	cmp $TFLT, %ecx
+	jne 4f
+	movsd (%r9), %xmm1
+	jmp 5f
+4:	cmp $TINT, %ecx
+	jne jit_exit
+	cvtsi2sdq (%r9), %xmm1
+5:	\fop %xmm1, %xmm0
+	movsd %xmm0, (%r10)
+	movb $TFLT, 16(%r10)
+9:
+st_\name\()_nn_end:
+.endm
+
+# fail unless the tag in %eax is a vector (not a quaternion)
+.macro isvector
+	cmp $TVEC3, %eax
+	je 7f
+	cmp $TVEC4, %eax
+	je 7f
+	cmp $TVEC2, %eax
+	jne jit_exit
+7:
+.endm
+
+# number at (\reg) into all lanes of \xmm (as 'glm_toflt')
+.macro tolanes reg, xmm
+	movzbl 16(\reg), %ecx
+	cmp $TFLT, %ecx
+	jne 6f
+	movsd (\reg), \xmm
+	jmp 8f
+6:	cmp $TINT, %ecx
+	jne jit_exit
+	cvtsi2sdq (\reg), \xmm
+8:	cvtsd2ss \xmm, \xmm
+	shufps $0, \xmm, \xmm
+.endm
+
+# R[A] := B pop C, vectors of the same kind
+.macro arith_vv name, pop
+st_\name\()_vv:
+	movzbl 16(%r8), %eax
+	cmpb %al, 16(%r9)
+	jne jit_exit
+	isvector
+	movups (%r8), %xmm0
+	movups (%r9), %xmm1
+	\pop %xmm1, %xmm0
+	movups %xmm0, (%r10)
+	movb %al, 16(%r10)
+st_\name\()_vv_end:
+.endm
+
+# R[A] := B pop C, B a vector and C a number
+.macro arith_vn name, pop
+st_\name\()_vn:
+	movzbl 16(%r8), %eax
+	isvector
+	tolanes %r9, %xmm1
+	movups (%r8), %xmm0
+	\pop %xmm1, %xmm0
+	movups %xmm0, (%r10)
+	movb %al, 16(%r10)
+st_\name\()_vn_end:
+.endm
+
+# R[A] := B pop C, B a number and C a vector
+.macro arith_nv name, pop
+st_\name\()_nv:
+	movzbl 16(%r9), %eax
+	isvector
+	tolanes %r8, %xmm0
+	movups (%r9), %xmm1
+	\pop %xmm1, %xmm0
+	movups %xmm0, (%r10)
+	movb %al, 16(%r10)
+st_\name\()_nv_end:
+.endm
+
+	arith_ii add, add
+	arith_ff add, addsd
+	arith_nn add, add, addsd
+	arith_vv add, addps
+	arith_vn add, addps
+	arith_nv add, addps
+
+	arith_ii sub, sub
+	arith_ff sub, subsd
+	arith_nn sub, sub, subsd
+	arith_vv sub, subps
+	arith_vn sub, subps
+	arith_nv sub, subps
+
+	arith_ii mul, imul
+	arith_ff mul, mulsd
+	arith_nn mul, imul, mulsd
+	arith_vv mul, mulps
+	arith_vn mul, mulps
+	arith_nv mul, mulps
+
+	arith_ff div, divsd
+	arith_nn div, , divsd
+	arith_vv div, divps
+	arith_vn div, divps
+	arith_nv div, divps
+
+	arith_ii band, and
+	arith_ii bor, or
+	arith_ii bxor, xor
+
+# R[A] := B % C, integers ('luaV_mod'); C in {0, -1} goes to the
+# interpreter
+st_mod_ii:
+	cmpb $TINT, 16(%r8)
+	jne jit_exit
+	cmpb $TINT, 16(%r9)
+	jne jit_exit
+	mov (%r9), %rcx
+	lea 1(%rcx), %rax
+	cmp $1, %rax
+	jbe jit_exit
+	mov (%r8), %rax
+	mov %rdx, %r11
+	cqo
+	idiv %rcx
+	test %rdx, %rdx
+	je 1f
+	mov %rdx, %rax
+	xor %rcx, %rax
+	jns 1f
+	add %rcx, %rdx
+1:	mov %rdx, (%r10)
+	movb $TINT, 16(%r10)
+	mov %r11, %rdx
+st_mod_ii_end:
+
+# R[A] := B // C, integers ('luaV_idiv'); C in {0, -1} goes to the
+# interpreter
+st_idiv_ii:
+	cmpb $TINT, 16(%r8)
+	jne jit_exit
+	cmpb $TINT, 16(%r9)
+	jne jit_exit
+	mov (%r9), %rcx
+	lea 1(%rcx), %rax
+	cmp $1, %rax
+	jbe jit_exit
+	mov (%r8), %rax
+	mov %rdx, %r11
+	cqo
+	idiv %rcx
+	test %rdx, %rdx
+	je 1f
+	xor (%r8), %rcx
+	jns 1f
+	sub $1, %rax
+1:	mov %rax, (%r10)
+	movb $TINT, 16(%r10)
+	mov %r11, %rdx
+st_idiv_ii_end:
+
+# R[A] := -B, any number
+st_unm:
+	movzbl 16(%r8), %eax
+	mov (%r8), %rcx
+	cmp $TINT, %eax
+	jne 1f
+	neg %rcx
+	jmp 2f
+1:	cmp $TFLT, %eax
+	jne jit_exit
+	btc $63, %rcx
+2:	mov %rcx, (%r10)
+	movb %al, 16(%r10)
+st_unm_end:
+
+# R[A] := not B
+st_not:
+	movzbl 16(%r8), %eax
+	cmp $TFALSE, %eax
+	je 1f
+	test $0x0f, %al
+	je 1f
+	movb $TFALSE, 16(%r10)
+	jmp 2f
+1:	movb $TTRUE, 16(%r10)
+2:
+st_not_end:
+
+# }======================================================
+
+
+# {======================================================
+# Tables and vectors
+# =======================================================
+
+# R[A] := B[C], B a table and C an integer key in its array part
+st_gettable:
+	cmpb $TTABLE, 16(%r8)
+	jne jit_exit
+	cmpb $TINT, 16(%r9)
+	jne jit_exit
+	mov (%r8), %r11
+	mov (%r9), %rcx
+	sub $1, %rcx
+	mov jit_alimit(%r11), %eax
+	cmp %rax, %rcx
+	jae jit_exit
+	mov jit_array(%r11), %r11
+	movzbl (%r11,%rcx), %eax
+	test $0x0f, %al
+	je jit_exit
+	add $1, %rcx
+	shl $4, %rcx
+	sub %rcx, %r11
+	movdqu (%r11), %xmm0
+	movdqu %xmm0, (%r10)
+	movb %al, 16(%r10)
+st_gettable_end:
+
+# A[B] := C, A a table, B an integer key of a present entry in its
+# array part, and C not collectable (so that there is no barrier)
+.macro settable name, ronly
+st_\name:
+	cmpb $TTABLE, 16(%r10)
+	jne jit_exit
+	cmpb $TINT, 16(%r8)
+	jne jit_exit
+	movzbl 16(%r9), %eax
+	test $COLLECTABLE, %al
+	jne jit_exit
+	mov (%r10), %r11
+.if \ronly
+	cmpb $0, jit_ronly(%r11)
+	jne jit_exit
+.endif
+	mov (%r8), %rcx
+	sub $1, %rcx
+	mov jit_alimit(%r11), %eax
+	cmp %rax, %rcx
+	jae jit_exit
+	mov jit_array(%r11), %r11
+	testb $0x0f, (%r11,%rcx)
+	je jit_exit
+	movzbl 16(%r9), %eax
+	movb %al, (%r11,%rcx)
+	add $1, %rcx
+	shl $4, %rcx
+	sub %rcx, %r11
+	movdqu (%r9), %xmm0
+	movdqu %xmm0, (%r11)
+st_\name\()_end:
+.endm
+
+	settable settable, 0
+	settable settable_ro, 1
+
+# R[A] := B.x (a component of a vector); 'jit_tag' is the smallest
+# vector with that component
+st_vgetfield:
+	movzbl 16(%r8), %eax
+	isvector
+	cmp $jit_tag, %eax
+	jb jit_exit
+	cvtss2sd jit_lane(%r8), %xmm0
+	movsd %xmm0, (%r10)
+	movb $TFLT, 16(%r10)
+st_vgetfield_end:
+
+# }======================================================
+
+
+# {======================================================
+# Jumps and tests
+# =======================================================
+
+st_jmp:
+	jmp jit_target
+st_jmp_end:
+
+# R[A] < R[B] and R[A] <= R[B], two integers or two floats
+.macro order name, icc, fcc
+st_\name:
+	movzbl 16(%r10), %eax
+	movzbl 16(%r8), %ecx
+	cmp $TINT, %eax
+	jne 1f
+	cmp $TINT, %ecx
+	jne jit_exit
+	mov (%r10), %rax
+	cmp (%r8), %rax
+	j\icc jit_true
+	jmp jit_false
+1:	cmp $TFLT, %eax
+	jne jit_exit
+	cmp $TFLT, %ecx
+	jne jit_exit
+	movsd (%r8), %xmm0
+	ucomisd (%r10), %xmm0
+	j\fcc jit_true
+	jmp jit_false
+st_\name\()_end:
+.endm
+
+	order lt, l, a
+	order le, le, ae
+
+# R[A] == R[B], two integers or two floats
+st_eq:
+	movzbl 16(%r10), %eax
+	movzbl 16(%r8), %ecx
+	cmp $TINT, %eax
+	jne 1f
+	cmp $TINT, %ecx
+	jne jit_exit
+	mov (%r10), %rax
+	cmp (%r8), %rax
+	je jit_true
+	jmp jit_false
+1:	cmp $TFLT, %eax
+	jne jit_exit
+	cmp $TFLT, %ecx
+	jne jit_exit
+	movsd (%r10), %xmm0
+	ucomisd (%r8), %xmm0
+	jp jit_false
+	je jit_true
+	jmp jit_false
+st_eq_end:
+
+# R[A] op sB, a number and an immediate ('swap' compares sB op R[A])
+.macro orderi name, icc, fcc, swap
+st_\name:
+	movzbl 16(%r10), %eax
+	cmp $TINT, %eax
+	jne 1f
+	cmpq $jit_imm, (%r10)
+	j\icc jit_true
+	jmp jit_false
+1:	cmp $TFLT, %eax
+	jne jit_exit
+	mov $jit_imm, %rcx
+	cvtsi2sdq %rcx, %xmm1
+	movsd (%r10), %xmm0
+.if \swap
+	ucomisd %xmm0, %xmm1
+.else
+	ucomisd %xmm1, %xmm0
+.endif
+	j\fcc jit_true
+	jmp jit_false
+st_\name\()_end:
+.endm
+
+	orderi lti, l, a, 1
+	orderi lei, le, ae, 1
+	orderi gti, g, a, 0
+	orderi gei, ge, ae, 0
+
+# R[A] == sB
+st_eqi:
+	movzbl 16(%r10), %eax
+	cmp $TINT, %eax
+	jne 1f
+	cmpq $jit_imm, (%r10)
+	je jit_true
+	jmp jit_false
+1:	cmp $TFLT, %eax
+	jne jit_false
+	mov $jit_imm, %rcx
+	cvtsi2sdq %rcx, %xmm1
+	ucomisd (%r10), %xmm1
+	jp jit_false
+	je jit_true
+	jmp jit_false
+st_eqi_end:
+
+# R[A] == K, K nil or a boolean (only the tag matters)
+st_eqktag:
+	cmpb $jit_tag, 16(%r10)
+	je jit_true
+	jmp jit_false
+st_eqktag_end:
+
+# R[A] == K, K a short string (same tag and same pointer)
+st_eqkstr:
+	cmpb $jit_tag, 16(%r10)
+	jne jit_false
+	movabs $jit_val, %rax
+	cmp %rax, (%r10)
+	je jit_true
+	jmp jit_false
+st_eqkstr_end:
+
+# R[A] == K, K an integer (a float R[A] goes to the interpreter)
+st_eqkint:
+	movzbl 16(%r10), %eax
+	cmp $TINT, %eax
+	jne 1f
+	movabs $jit_val, %rax
+	cmp %rax, (%r10)
+	je jit_true
+	jmp jit_false
+1:	cmp $TFLT, %eax
+	je jit_exit
+	jmp jit_false
+st_eqkint_end:
+
+# R[A] == K, K a float (an integer R[A] goes to the interpreter)
+st_eqkflt:
+	movzbl 16(%r10), %eax
+	cmp $TFLT, %eax
+	jne 1f
+	movabs $jit_val, %rax
+	movq %rax, %xmm1
+	ucomisd (%r10), %xmm1
+	jp jit_false
+	je jit_true
+	jmp jit_false
+1:	cmp $TINT, %eax
+	je jit_exit
+	jmp jit_false
+st_eqkflt_end:
+
+# R[A] is not false or nil
+st_test:
+	movzbl 16(%r10), %eax
+	cmp $TFALSE, %eax
+	je jit_false
+	test $0x0f, %al
+	je jit_false
+	jmp jit_true
+st_test_end:
+
+# }======================================================
+
+
+# {======================================================
+# Numerical 'for' loops
+# =======================================================
+
+# integer loop; 'forprep' in 'lvm.c' with an integer limit
+st_forprep:
+	cmpb $TINT, 16(%r10)
+	jne jit_exit
+	cmpb $TINT, 40(%r10)
+	jne jit_exit
+	cmpb $TINT, 64(%r10)
+	jne jit_exit
+	mov 48(%r10), %rcx
+	test %rcx, %rcx
+	je jit_exit
+	mov (%r10), %rax
+	mov %rax, 72(%r10)
+	movb $TINT, 88(%r10)
+	mov 24(%r10), %r11
+	test %rcx, %rcx
+	js 2f
+	cmp %r11, %rax
+	jg jit_target
+	sub %rax, %r11
+	cmp $1, %rcx
+	je 3f
+	mov %r11, %rax
+	jmp 4f
+2:	cmp %r11, %rax
+	jl jit_target
+	sub %r11, %rax
+	add $1, %rcx
+	neg %rcx
+	add $1, %rcx
+4:	mov %rdx, %r9
+	xor %edx, %edx
+	div %rcx
+	mov %r9, %rdx
+	mov %rax, %r11
+3:	mov %r11, 24(%r10)
+st_forprep_end:
+
+.macro forloop_i
+	mov 24(%r10), %rax
+	test %rax, %rax
+	je 8f
+	sub $1, %rax
+	mov %rax, 24(%r10)
+	mov (%r10), %rcx
+	add 48(%r10), %rcx
+	mov %rcx, (%r10)
+	mov %rcx, 72(%r10)
+	movb $TINT, 88(%r10)
+	jmp jit_target
+.endm
+
+.macro forloop_f
+	movsd (%r10), %xmm0
+	addsd 48(%r10), %xmm0
+	movsd 48(%r10), %xmm1
+	xorpd %xmm2, %xmm2
+	ucomisd %xmm2, %xmm1
+	ja 1f
+	ucomisd 24(%r10), %xmm0
+	jae 2f
+	jmp 8f
+1:	movsd 24(%r10), %xmm1
+	ucomisd %xmm0, %xmm1
+	jb 8f
+2:	movsd %xmm0, (%r10)
+	movsd %xmm0, 72(%r10)
+	movb $TFLT, 88(%r10)
+	jmp jit_target
+.endm
+
+st_forloop_i:
+	cmpb $TINT, 64(%r10)
+	jne jit_exit
+	forloop_i
+8:
+st_forloop_i_end:
+
+st_forloop_f:
+	cmpb $TFLT, 64(%r10)
+	jne jit_exit
+	forloop_f
+8:
+st_forloop_f_end:
+
+st_forloop:
+	cmpb $TINT, 64(%r10)
+	jne 9f
+	forloop_i
+8:	jmp 10f
+9:	cmpb $TFLT, 64(%r10)
+	jne jit_exit
+	forloop_f
+8:
+10:
+st_forloop_end:
+
+# }======================================================
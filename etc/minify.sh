@@ -166,6 +166,7 @@ echo "#if defined(LUA_IMPLEMENTATION)" >> ${OUTFILE}
   cat ${LUA_DIR}/lcode.h >> ${OUTFILE}
   cat ${LUA_DIR}/lvm.h >> ${OUTFILE}
   cat ${LUA_DIR}/lctype.h >> ${OUTFILE}
+  cat ${LUA_DIR}/lsimd.h >> ${OUTFILE}
 
   echo "/* luaglm */" >> ${OUTFILE}
   cat ${LUA_DIR}/lglm_core.h >> ${OUTFILE}
@@ -381,6 +381,17 @@ LUA_API size_t lua_stringtonumber (lua_State *L, const char *s) {
 }
 
 
+LUA_API int lua_fmtinteger (char *buff, size_t sz, lua_Integer n) {
+  return luaO_fmtint(buff, sz, n);
+}
+
+
+LUA_API int lua_fmtnumber (char *buff, size_t sz, int conv, int prec,
+                                                         lua_Number n) {
+  return luaO_fmtnum(buff, sz, conv, prec, n);
+}
+
+
 LUA_API lua_Number lua_tonumberx (lua_State *L, int idx, int *pisnum) {
   lua_Number n = 0;
   const TValue *o = index2value(L, idx);
@@ -421,6 +432,13 @@ LUA_API const char *lua_tolstring (lua_State *L, int idx, size_t *len) {
     luaC_checkGC(L);
     o = index2value(L, idx);  /* previous call may reallocate the stack */
   }
+#if defined(LUAGLM_EXT_SLICE)
+  else if (ttisslicestring(o)) {  /* slices are not zero-terminated */
+    setsvalue(L, o, luaS_fromslice(L, tsvalue(o)));
+    luaC_checkGC(L);
+    o = index2value(L, idx);  /* previous call may reallocate the stack */
+  }
+#endif
   if (len != NULL)
     *len = vslen(o);
   lua_unlock(L);
@@ -440,6 +458,9 @@ LUA_API lua_Unsigned lua_rawlen (lua_State *L, int idx) {
     case LUA_VLNGSTR: return tsvalue(o)->u.lnglen;
 #if defined(LUAGLM_EXT_BLOB)
     case LUA_VBLOBSTR: return tsvalue(o)->u.lnglen;
+#endif
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR: return tsvalue(o)->u.lnglen;
 #endif
     case LUA_VUSERDATA: return uvalue(o)->len;
     case LUA_VTABLE: return luaH_getn(hvalue(o));
@@ -568,6 +589,49 @@ LUA_API const char *lua_pushstring (lua_State *L, const char *s) {
 }
 
 
+#if defined(LUAGLM_EXT_SLICE)
+LUA_API void lua_pushslice (lua_State *L, int idx, size_t i, size_t len) {
+  TString *ts;
+  const TValue *o;
+  lua_lock(L);
+  o = index2value(L, idx);
+  api_check(L, ttisstring(o), "string expected");
+  api_check(L, i <= vslen(o) && len <= vslen(o) - i, "invalid slice");
+  ts = luaS_newslice(L, tsvalue(o), i, len);
+  setsvalue2s(L, L->top, ts);
+  api_incr_top(L);
+  luaC_checkGC(L);
+  lua_unlock(L);
+}
+#endif
+
+
+#if defined(LUAGLM_EXT_BUILDER)
+LUA_API char *lua_resizebuffer (lua_State *L, char *buff, size_t osz,
+                                                          size_t nsz) {
+  lua_lock(L);
+  api_check(L, buff != NULL || osz == 0, "invalid buffer size");
+  buff = luaS_resizebuff(L, buff, osz, nsz);
+  lua_unlock(L);
+  return buff;
+}
+
+
+LUA_API const char *lua_pushbuffer (lua_State *L, char *buff, size_t sz,
+                                                              size_t len) {
+  TString *ts;
+  lua_lock(L);
+  api_check(L, buff != NULL && len <= sz, "invalid buffer");
+  ts = luaS_frombuff(L, buff, sz, len);
+  setsvalue2s(L, L->top, ts);
+  api_incr_top(L);
+  luaC_checkGC(L);
+  lua_unlock(L);
+  return getstr(ts);
+}
+#endif
+
+
 #if defined(LUAGLM_EXT_BLOB)
 LUA_API int lua_isstringblob (lua_State *L, int idx) {
   const TValue *o = index2value(L, idx);
@@ -697,10 +761,10 @@ LUA_API int lua_pushthread (lua_State *L) {
 
 
 l_sinline int auxgetstr (lua_State *L, const TValue *t, const char *k) {
-  const TValue *slot;
+  lu_byte tag;
   TString *str = luaS_new(L, k);
-  if (luaV_fastget(L, t, str, slot, luaH_getstr)) {
-    setobj2s(L, L->top, slot);
+  luaV_fastget(t, str, s2v(L->top), luaH_getstr, tag);
+  if (!tagisempty(tag)) {
     api_incr_top(L);
   }
   else {
@@ -711,7 +775,7 @@ l_sinline int auxgetstr (lua_State *L, const TValue *t, const char *k) {
     else if (ttismatrix(t))
       glmMat_get(L, t, s2v(L->top -1), L->top - 1);
     else
-      luaV_finishget(L, t, s2v(L->top - 1), L->top - 1, slot);
+      luaV_finishget(L, t, s2v(L->top - 1), L->top - 1, tag);
   }
   return ttype(s2v(L->top - 1));
 }
@@ -723,36 +787,36 @@ l_sinline int auxgetstr (lua_State *L, const TValue *t, const char *k) {
 ** was created and never removed, they must always be in the array
 ** part of the registry.
 */
-#define getGtable(L)  \
-	(&hvalue(&G(L)->l_registry)->array[LUA_RIDX_GLOBALS - 1])
+#define getGtable(L,gt)  \
+	arr2obj(hvalue(&G(L)->l_registry), LUA_RIDX_GLOBALS - 1, gt)
 
 
 LUA_API int lua_getglobal (lua_State *L, const char *name) {
   int result = LUA_TNONE;
 
-  const TValue *G;
+  TValue G;
   lua_lock(L);
-  G = getGtable(L);
-  result = auxgetstr(L, G, name);
+  getGtable(L, &G);
+  result = auxgetstr(L, &G, name);
   lua_unlock(L);
   return result;
 }
 
 
 LUA_API int lua_gettable (lua_State *L, int idx) {
-  const TValue *slot;
+  lu_byte tag;
   TValue *t;
   lua_lock(L);
   t = index2value(L, idx);
-  if (luaV_fastget(L, t, s2v(L->top - 1), slot, luaH_get)) {
-    setobj2s(L, L->top - 1, slot);
+  luaV_fastget(t, s2v(L->top - 1), s2v(L->top - 1), luaH_get, tag);
+  if (tagisempty(tag)) {  /* not a raw hit? */
+    if (ttisvector(t))
+      glmVec_get(L, t, s2v(L->top - 1), L->top - 1);
+    else if (ttismatrix(t))
+      glmMat_get(L, t, s2v(L->top - 1), L->top - 1);
+    else
+      luaV_finishget(L, t, s2v(L->top - 1), L->top - 1, tag);
   }
-  else if (ttisvector(t))
-    glmVec_get(L, t, s2v(L->top - 1), L->top - 1);
-  else if (ttismatrix(t))
-    glmMat_get(L, t, s2v(L->top - 1), L->top - 1);
-  else
-    luaV_finishget(L, t, s2v(L->top - 1), L->top - 1, slot);
   lua_unlock(L);
   return ttype(s2v(L->top - 1));
 }
@@ -784,14 +848,12 @@ LUA_API int lua_geti (lua_State *L, int idx, lua_Integer n) {
   else if (ttismatrix(t))
     glmMat_rawgeti(t, n, L->top);
   else {
-    const TValue *slot;
-    if (luaV_fastgeti(L, t, n, slot)) {
-      setobj2s(L, L->top, slot);
-    }
-    else {
+    lu_byte tag;
+    luaV_fastgeti(t, n, s2v(L->top), tag);
+    if (tagisempty(tag)) {
       TValue aux;
       setivalue(&aux, n);
-      luaV_finishget(L, t, &aux, L->top, slot);
+      luaV_finishget(L, t, &aux, L->top, tag);
     }
   }
   api_incr_top(L);
@@ -800,11 +862,12 @@ LUA_API int lua_geti (lua_State *L, int idx, lua_Integer n) {
 }
 
 
-l_sinline int finishrawget (lua_State *L, const TValue *val) {
-  if (isempty(val))  /* avoid copying empty items to the stack */
+/*
+** Finish a raw get whose result (with tag 'tag') was put at the top.
+*/
+l_sinline int finishrawget (lua_State *L, lu_byte tag) {
+  if (tagisempty(tag))  /* avoid copying empty items to the stack */
     setnilvalue(s2v(L->top));
-  else
-    setobj2s(L, L->top, val);
   api_incr_top(L);
   return ttype(s2v(L->top - 1));
 }
@@ -829,9 +892,9 @@ LUA_API int lua_rawget (lua_State *L, int idx) {
     result = glmMat_rawget(o, s2v(L->top - 1), L->top - 1);
   else {
     Table *t = ensuretable(L, o);
-    const TValue *val = luaH_get(t, s2v(L->top - 1));
+    lu_byte tag = luaH_get(t, s2v(L->top - 1), s2v(L->top - 1));
     L->top--;  /* remove key */
-    result = finishrawget(L, val);
+    result = finishrawget(L, tag);
   }
   lua_unlock(L);
   return result;
@@ -854,7 +917,7 @@ LUA_API int lua_rawgeti (lua_State *L, int idx, lua_Integer n) {
   }
   else {
     Table *t = ensuretable(L, o);
-    result = finishrawget(L, luaH_getint(t, n));
+    result = finishrawget(L, luaH_getint(t, n, s2v(L->top)));
   }
   lua_unlock(L);
   return result;
@@ -870,7 +933,7 @@ LUA_API int lua_rawgetp (lua_State *L, int idx, const void *p) {
   t = index2value(L, idx);
   api_check(L, ttistable(t), "table expected");
   setpvalue(&k, cast_voidp(p));
-  result = finishrawget(L, luaH_get(hvalue(t), &k));
+  result = finishrawget(L, luaH_get(hvalue(t), &k, s2v(L->top)));
   lua_unlock(L);
   return result;
 }
@@ -1012,14 +1075,12 @@ LUA_API int lua_getiuservalue (lua_State *L, int idx, int n) {
 ** t[k] = value at the top of the stack (where 'k' is a string)
 */
 static void auxsetstr (lua_State *L, const TValue *t, const char *k) {
-  const TValue *slot;
+  int hres;
   TString *str = luaS_new(L, k);
   api_checknelems(L, 1);
-  if (luaV_fastget(L, t, str, slot, luaH_getstr)) {
-#if defined(LUAGLM_EXT_READONLY)
-    readonly_api_check(L, hvalue(t));
-#endif
-    luaV_finishfastset(L, t, slot, s2v(L->top - 1));
+  luaV_fastset(t, str, s2v(L->top - 1), hres, luaH_psetstr);
+  if (hres == HOK) {
+    luaV_finishfastset(L, t, s2v(L->top - 1));
     L->top--;  /* pop value */
   }
   else {
@@ -1028,7 +1089,7 @@ static void auxsetstr (lua_State *L, const TValue *t, const char *k) {
     if (ttismatrix(t))
       glmMat_set(L, t, s2v(L->top - 1), s2v(L->top - 2));
     else
-      luaV_finishset(L, t, s2v(L->top - 1), s2v(L->top - 2), slot);
+      luaV_finishset(L, t, s2v(L->top - 1), s2v(L->top - 2), hres);
     L->top -= 2;  /* pop value and key */
   }
   lua_unlock(L);  /* lock done by caller */
@@ -1036,10 +1097,10 @@ static void auxsetstr (lua_State *L, const TValue *t, const char *k) {
 
 
 LUA_API void lua_setglobal (lua_State *L, const char *name) {
-  const TValue *G;
+  TValue G;
   lua_lock(L);  /* unlock done in 'auxsetstr' */
-  G = getGtable(L);
-  auxsetstr(L, G, name);
+  getGtable(L, &G);
+  auxsetstr(L, &G, name);
 }
 
 
@@ -1051,15 +1112,12 @@ LUA_API void lua_settable (lua_State *L, int idx) {
   if (ttismatrix(t))
     glmMat_set(L, t, s2v(L->top - 2), s2v(L->top - 1));
   else {
-    const TValue *slot;
-    if (luaV_fastget(L, t, s2v(L->top - 2), slot, luaH_get)) {
-#if defined(LUAGLM_EXT_READONLY)
-      readonly_api_check(L, hvalue(t));
-#endif
-      luaV_finishfastset(L, t, slot, s2v(L->top - 1));
-    }
+    int hres;
+    luaV_fastset(t, s2v(L->top - 2), s2v(L->top - 1), hres, luaH_pset);
+    if (hres == HOK)
+      luaV_finishfastset(L, t, s2v(L->top - 1));
     else
-      luaV_finishset(L, t, s2v(L->top - 2), s2v(L->top - 1), slot);
+      luaV_finishset(L, t, s2v(L->top - 2), s2v(L->top - 1), hres);
   }
   L->top -= 2;  /* pop index and value */
   lua_unlock(L);
@@ -1083,17 +1141,14 @@ LUA_API void lua_seti (lua_State *L, int idx, lua_Integer n) {
     glmMat_set(L, t, &aux, s2v(L->top - 1));
   }
   else {
-    const TValue *slot;
-    if (luaV_fastgeti(L, t, n, slot)) {
-#if defined(LUAGLM_EXT_READONLY)
-      readonly_api_check(L, hvalue(t));
-#endif
-      luaV_finishfastset(L, t, slot, s2v(L->top - 1));
-    }
+    int hres;
+    luaV_fastseti(t, n, s2v(L->top - 1), hres);
+    if (hres == HOK)
+      luaV_finishfastset(L, t, s2v(L->top - 1));
     else {
       TValue aux;
       setivalue(&aux, n);
-      luaV_finishset(L, t, &aux, s2v(L->top - 1), slot);
+      luaV_finishset(L, t, &aux, s2v(L->top - 1), hres);
     }
   }
   L->top--;  /* pop value */
@@ -1115,7 +1170,7 @@ static void aux_rawset (lua_State *L, int idx, TValue *key, int n) {
     readonly_api_check(L, t);
 #endif
     luaH_set(L, t, key, s2v(L->top - 1));
-    invalidateTMcache(t);
+    invalidatecaches(L, t);
     luaC_barrierback(L, obj2gco(t), s2v(L->top - 1));
   }
   L->top -= n;
@@ -1325,10 +1380,11 @@ LUA_API int lua_load (lua_State *L, lua_Reader reader, void *data,
     LClosure *f = clLvalue(s2v(L->top - 1));  /* get newly created function */
     if (f->nupvalues >= 1) {  /* does it have an upvalue? */
       /* get global table from registry */
-      const TValue *gt = getGtable(L);
+      TValue gt;
+      getGtable(L, &gt);
       /* set global table as 1st upvalue of 'f' (may be LUA_ENV) */
-      setobj(L, f->upvals[0]->v, gt);
-      luaC_barrier(L, f->upvals[0], gt);
+      setobj(L, f->upvals[0]->v, &gt);
+      luaC_barrier(L, f->upvals[0], &gt);
     }
   }
   lua_unlock(L);
@@ -1508,6 +1564,15 @@ LUA_API int lua_next (lua_State *L, int idx) {
 }
 
 
+LUA_API void lua_setiterators (lua_State *L, lua_CFunction next,
+                                             lua_CFunction inext) {
+  lua_lock(L);
+  G(L)->iternext = next;
+  G(L)->iterinext = inext;
+  lua_unlock(L);
+}
+
+
 LUA_API void lua_toclose (lua_State *L, int idx) {
   int nresults;
   StkId o;
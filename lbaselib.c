@@ -734,6 +734,12 @@ LUAMOD_API int luaopen_base (lua_State *L) {
   /* set global _VERSION */
   lua_pushliteral(L, LUA_VERSION);
   lua_setfield(L, -2, "_VERSION");
+  /* let the VM run generic 'for' loops over 'next' and 'ipairs' */
+#if defined(LUAGLM_COMPAT_IPAIRS)
+  lua_setiterators(L, luaB_next, ipairsaux_raw);
+#else
+  lua_setiterators(L, luaB_next, ipairsaux);
+#endif
   return 1;
 }
 
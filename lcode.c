@@ -107,6 +107,25 @@ int luaK_exp2const (FuncState *fs, const expdesc *e, TValue *v) {
 }
 
 
+/*
+** If expression is a table copied from a template by the last
+** instruction coded (a constructor with only constant fields), fills
+** 'v' with that template and returns 1. Otherwise, returns 0.
+*/
+int luaK_exp2template (FuncState *fs, const expdesc *e, TValue *v) {
+  Instruction i;
+  if (e->k != VNONRELOC || hasjumps(e) || fs->pc < 2 ||
+      fs->lasttarget > fs->pc - 2)  /* may jump over the table? */
+    return 0;
+  i = fs->f->code[fs->pc - 2];
+  if (GET_OPCODE(i) != OP_NEWTABLE || GETARG_B(i) != TEMPLATEB ||
+      GETARG_A(i) != e->u.info)
+    return 0;
+  setobj(fs->ls->L, v, &fs->f->k[GETARG_Ax(fs->f->code[fs->pc - 1])]);
+  return 1;
+}
+
+
 /*
 ** Return the previous instruction of the current code. If there
 ** may be a jump target between the current instruction and the
@@ -544,10 +563,10 @@ static int addk (FuncState *fs, TValue *key, TValue *v) {
   TValue val;
   lua_State *L = fs->ls->L;
   Proto *f = fs->f;
-  const TValue *idx = luaH_get(fs->ls->h, key);  /* query scanner table */
+  int tag = luaH_get(fs->ls->h, key, &val);  /* query scanner table */
   int k, oldsize;
-  if (ttisinteger(idx)) {  /* is there an index there? */
-    k = cast_int(ivalue(idx));
+  if (tag == LUA_VNUMINT) {  /* is there an index there? */
+    k = cast_int(ivalue(&val));
     /* correct value? (warning: must distinguish floats from integers!) */
     if (k < fs->nk && ttypetag(&f->k[k]) == ttypetag(v) &&
                       luaV_rawequalobj(&f->k[k], v))
@@ -559,7 +578,7 @@ static int addk (FuncState *fs, TValue *key, TValue *v) {
   /* numerical value does not need GC barrier;
      table has no metatable, so it does not need to invalidate cache */
   setivalue(&val, k);
-  luaH_finishset(L, fs->ls->h, key, idx, &val);
+  luaH_set(L, fs->ls->h, key, &val);
   luaM_growvector(L, f->k, k, f->sizek, TValue, MAXARG_Ax, "constants");
   while (oldsize < f->sizek) setnilvalue(&f->k[oldsize++]);
   setobj(L, &f->k[k], v);
@@ -1360,6 +1379,23 @@ static int constfolding (FuncState *fs, int op, expdesc *e1,
 }
 
 
+/*
+** In optimized chunks, when 'e' is the still relocatable result of an
+** arithmetic operator, mark that operator as producing an intermediate
+** result: the arithmetic operator being coded will be its only
+** consumer, so a matrix created for it can hold the next result too
+** (see 'luaT_trybinTM').
+*/
+static void marktemp (FuncState *fs, expdesc *e) {
+  if (fs->ls->dyd->optimize && e->k == VRELOC) {
+    Instruction *pi = &getinstruction(fs, e);
+    OpCode op = GET_OPCODE(*pi);
+    if ((OP_ADDI <= op && op <= OP_SHR) || op == OP_UNM)
+      SETARG_k(*pi, 1);
+  }
+}
+
+
 /*
 ** Emit code for unary expressions that "produce values"
 ** (everything but 'not').
@@ -1584,6 +1620,7 @@ void luaK_prefix (FuncState *fs, UnOpr op, expdesc *e, int line) {
     case OPR_MINUS: case OPR_BNOT:  /* use 'ef' as fake 2nd operand */
       if (constfolding(fs, op + LUA_OPUNM, e, &ef))
         break;
+      marktemp(fs, e);
       /* else */ /* FALLTHROUGH */
     case OPR_LEN:
       codeunexpval(fs, cast(OpCode, op + OP_UNM), e, line);
@@ -1618,8 +1655,10 @@ void luaK_infix (FuncState *fs, BinOpr op, expdesc *v) {
     case OPR_MOD: case OPR_POW:
     case OPR_BAND: case OPR_BOR: case OPR_BXOR:
     case OPR_SHL: case OPR_SHR: {
-      if (!tonumeral(v, NULL))
+      if (!tonumeral(v, NULL)) {
+        marktemp(fs, v);
         luaK_exp2anyreg(fs, v);
+      }
       /* else keep numeral, which may be folded with 2nd operand */
       break;
     }
@@ -1669,8 +1708,11 @@ static void codeconcat (FuncState *fs, expdesc *e1, expdesc *e2, int line) {
 void luaK_posfix (FuncState *fs, BinOpr opr,
                   expdesc *e1, expdesc *e2, int line) {
   luaK_dischargevars(fs, e2);
-  if (foldbinop(opr) && constfolding(fs, opr + LUA_OPADD, e1, e2))
-    return;  /* done by folding */
+  if (foldbinop(opr)) {
+    if (constfolding(fs, opr + LUA_OPADD, e1, e2))
+      return;  /* done by folding */
+    marktemp(fs, e2);
+  }
   switch (opr) {
     case OPR_AND: {
       lua_assert(e1->t == NO_JUMP);  /* list closed by 'luaK_infix' */
@@ -1767,6 +1809,30 @@ void luaK_settablesize (FuncState *fs, int pc, int ra, int asize, int hsize) {
 }
 
 
+/*
+** Replace the code of a constructor, from its OP_NEWTABLE at 'pc' on,
+** by a copy of template 't'. (The code being removed only stores
+** constants, so it has no jumps or jump targets.) The constants added
+** after the first 'nk' ones were used only by that code, so they are
+** removed too; in particular, nested templates live only inside 't'.
+** (Entries of the scanner table that still point to them are harmless,
+** as 'addk' checks the value at the index it finds.)
+*/
+void luaK_settemplate (FuncState *fs, int pc, int ra, int nk,
+                       const TValue *t) {
+  TValue key;
+  int k;
+  while (fs->pc > pc + 2)
+    removelastinstruction(fs);
+  for (; fs->nk > nk; fs->nk--)
+    setnilvalue(&fs->f->k[fs->nk - 1]);
+  setobj(fs->ls->L, &key, t);
+  k = addk(fs, &key, &key);  /* template itself is the key */
+  fs->f->code[pc] = CREATE_ABCk(OP_NEWTABLE, ra, TEMPLATEB, 0, 0);
+  fs->f->code[pc + 1] = CREATE_Ax(OP_EXTRAARG, k);
+}
+
+
 /*
 ** Emit a SETLIST instruction.
 ** 'base' is register that keeps table;
@@ -1806,6 +1872,412 @@ static int finaltarget (Instruction *code, int i) {
 }
 
 
+/*
+** {======================================================================
+** Optimizer ('O' in the load mode)
+** Works on the final code of a function: it threads jumps, marks the
+** instructions to be removed (unreachable code, jumps to the next
+** instruction, redundant moves and loads), and then compacts the code,
+** correcting jump offsets, line information, and the ranges of local
+** variables. It never changes what the code computes, only what
+** debug hooks can observe between instructions. At last, it replaces
+** pairs of opcodes by superinstructions.
+** =======================================================================
+*/
+
+/* flags in the scratch vector of 'optimize' */
+#define PCTARGET	1  /* instruction is the target of a jump */
+#define PCREACH		2  /* instruction can be executed */
+#define PCDEAD		4  /* instruction will be removed */
+
+
+/*
+** Destination of the jump done by instruction 'pc', or -1 if it does
+** not jump. (For OP_FORPREP it is the instruction after the loop.)
+*/
+static int jumpdest (const Instruction *code, int pc) {
+  Instruction i = code[pc];
+  switch (GET_OPCODE(i)) {
+    case OP_JMP: return pc + 1 + GETARG_sJ(i);
+    case OP_FORPREP: return pc + 2 + GETARG_Bx(i);
+    case OP_TFORPREP: return pc + 1 + GETARG_Bx(i);
+    case OP_FORLOOP: case OP_TFORLOOP: return pc + 1 - GETARG_Bx(i);
+    default: return -1;
+  }
+}
+
+
+/* inverse of 'jumpdest' (offsets only shrink, so they always fit) */
+static void setjumpdest (Instruction *code, int pc, int dest) {
+  Instruction *i = &code[pc];
+  switch (GET_OPCODE(*i)) {
+    case OP_JMP: SETARG_sJ(*i, dest - (pc + 1)); break;
+    case OP_FORPREP: SETARG_Bx(*i, dest - (pc + 2)); break;
+    case OP_TFORPREP: SETARG_Bx(*i, dest - (pc + 1)); break;
+    default: SETARG_Bx(*i, (pc + 1) - dest); break;  /* loops */
+  }
+}
+
+
+/*
+** True if instruction 'pc' cannot be separated from the next one: tests
+** and OP_LFALSESKIP may skip it, and it may be an extra argument, the
+** metamethod call of an arithmetic instruction, or the OP_TFORLOOP of
+** an OP_TFORCALL.
+*/
+static int bindsnext (const Instruction *code, int pc) {
+  OpCode op = GET_OPCODE(code[pc]);
+  if (testTMode(op) || op == OP_LFALSESKIP)
+    return 1;
+  switch (GET_OPCODE(code[pc + 1])) {
+    case OP_EXTRAARG: case OP_MMBIN: case OP_MMBINI: case OP_MMBINK:
+    case OP_TFORLOOP:
+      return 1;
+    default: return 0;
+  }
+}
+
+
+/*
+** If instruction 'i' only sets register R[A] to a value that does not
+** depend on R[A] (with no other effects), return A; otherwise, -1.
+*/
+static int loadsreg (Instruction i) {
+  switch (GET_OPCODE(i)) {
+    case OP_LOADNIL:
+      if (GETARG_B(i) != 0)
+        return -1;  /* sets several registers */
+      /* FALLTHROUGH */
+    case OP_LOADI: case OP_LOADF: case OP_LOADK: case OP_LOADFALSE:
+    case OP_LOADTRUE: case OP_GETUPVAL:
+      return GETARG_A(i);
+    case OP_MOVE:
+      return (GETARG_A(i) != GETARG_B(i)) ? GETARG_A(i) : -1;
+    default: return -1;
+  }
+}
+
+
+/*
+** Jump threading. A jump to a return becomes a copy of that return
+** (with its line, so that line hooks see the same lines). A jump taken
+** after an OP_TEST that lands on another OP_TEST of the same register
+** goes directly to where that second test leads. (The final targets of
+** all jumps are already known; see 'luaK_finish'.)
+*/
+static void threadjumps (Instruction *code, int *lines, int n) {
+  int pc;
+  for (pc = 1; pc < n; pc++) {
+    int dest;
+    Instruction t = code[pc - 1];
+    if (GET_OPCODE(code[pc]) != OP_JMP)
+      continue;
+    dest = jumpdest(code, pc);
+    if (GET_OPCODE(t) == OP_TEST) {  /* jump taken iff R[A] is 'k'? */
+      int count;
+      for (count = 0; count < 100; count++) {  /* avoid infinite loops */
+        Instruction d = code[dest];
+        if (GET_OPCODE(d) != OP_TEST || GETARG_A(d) != GETARG_A(t))
+          break;
+        if (GETARG_k(d) == GETARG_k(t))  /* 'd' jumps too? */
+          dest = finaltarget(code, dest + 1);
+        else  /* 'd' skips its jump */
+          dest = finaltarget(code, dest + 2);
+      }
+      setjumpdest(code, pc, dest);
+    }
+    else if (!bindsnext(code, pc - 1)) {  /* unconditional jump? */
+      Instruction d = code[dest];
+      switch (GET_OPCODE(d)) {
+        case OP_RETURN:
+          if (GETARG_B(d) == 0)
+            break;  /* returns up to top, set by previous instruction */
+          /* FALLTHROUGH */
+        case OP_RETURN0: case OP_RETURN1:
+          code[pc] = d;
+          lines[pc] = lines[dest];
+          break;
+        default: break;
+      }
+    }
+  }
+}
+
+
+static void marktargets (const Instruction *code, int n, int *flags) {
+  int pc;
+  for (pc = 0; pc < n; pc++) {
+    OpCode op = GET_OPCODE(code[pc]);
+    int dest = jumpdest(code, pc);
+    if (dest >= 0)
+      flags[dest] |= PCTARGET;
+    if ((testTMode(op) || op == OP_LFALSESKIP) && pc + 2 < n)
+      flags[pc + 2] |= PCTARGET;  /* target of a skip */
+  }
+}
+
+
+/*
+** Mark the instructions that can be executed, doing a depth-first
+** traversal of the control flow from the first one. ('stack' has space
+** for 'n' entries, as each instruction is pushed at most once.)
+*/
+static void markreachable (const Instruction *code, int n, int *flags,
+                           int *stack) {
+  int top = 0;
+  flags[0] |= PCREACH;
+  stack[top++] = 0;
+  while (top > 0) {
+    int pc = stack[--top];
+    int succ[3];
+    int ns = 0;
+    int dest = jumpdest(code, pc);
+    OpCode op = GET_OPCODE(code[pc]);
+    if (dest >= 0)
+      succ[ns++] = dest;
+    switch (op) {
+      case OP_JMP: case OP_TFORPREP:
+      case OP_RETURN: case OP_RETURN0: case OP_RETURN1:
+        break;  /* no fall through */
+      case OP_LFALSESKIP:
+        succ[ns++] = pc + 2;
+        break;
+      default:
+        succ[ns++] = pc + 1;
+        if (testTMode(op))
+          succ[ns++] = pc + 2;
+        break;
+    }
+    while (ns-- > 0) {
+      int s = succ[ns];
+      if (s < n && !(flags[s] & PCREACH)) {
+        flags[s] |= PCREACH;
+        stack[top++] = s;
+      }
+    }
+  }
+}
+
+
+/*
+** Returns of values just moved into place: 'R[a] := R[b]; ...;
+** R[a+n-1] := R[b+n-1]; return R[a], ..., R[a+n-1]' becomes 'return
+** R[b], ..., R[b+n-1]', and the moves are marked to be removed. (An
+** OP_RETURN with 'k' runs '__close' metamethods before reading its
+** values, so it is not changed.)
+*/
+static void fusereturns (Instruction *code, int n, int *flags) {
+  int pc;
+  for (pc = 0; pc < n; pc++) {
+    Instruction *i = &code[pc];
+    int a = GETARG_A(*i);
+    int nret, first, b, t;
+    if (GET_OPCODE(*i) == OP_RETURN1)
+      nret = 1;
+    else if (GET_OPCODE(*i) == OP_RETURN && !GETARG_k(*i) &&
+             GETARG_B(*i) > 1)
+      nret = GETARG_B(*i) - 1;
+    else
+      continue;
+    first = pc - nret;  /* first move */
+    if (first < 0 || GET_OPCODE(code[first]) != OP_MOVE ||
+        GETARG_A(code[first]) != a ||
+        (first > 0 && bindsnext(code, first - 1)))
+      continue;
+    b = GETARG_B(code[first]);
+    if (!(b + nret <= a || a + nret <= b))
+      continue;  /* moves would overwrite their own sources */
+    for (t = 1; t <= nret; t++) {  /* check other moves */
+      Instruction mv = code[first + t];
+      if ((flags[first + t] & PCTARGET) || (t < nret &&
+          (GET_OPCODE(mv) != OP_MOVE || GETARG_A(mv) != a + t ||
+           GETARG_B(mv) != b + t)))
+        break;
+    }
+    if (t > nret) {  /* all checks passed? */
+      SETARG_A(*i, b);
+      for (t = 0; t < nret; t++)
+        flags[first + t] |= PCDEAD;
+    }
+  }
+}
+
+
+/*
+** Mark the instructions to be removed: unreachable ones, jumps to the
+** next instruction, the second move of 'R[A] := R[B]; R[B] := R[A]',
+** LOADNILs that can join the previous one, and loads into a register
+** that the next instruction, in the same line, overwrites. (Line hooks
+** could see the register between lines.) An instruction is never
+** removed after one that is bound to it ('bindsnext').
+*/
+static void markdead (Instruction *code, const int *lines, int n,
+                      int *flags) {
+  int last = -1;  /* last instruction kept */
+  int prev = -1;  /* instruction kept before 'last' */
+  int pc;
+  for (pc = 0; pc < n; pc++) {
+    Instruction *i = &code[pc];
+    int r;
+    if (flags[pc] & PCDEAD)
+      continue;  /* already removed (see 'fusereturns') */
+    else if (last >= 0 && bindsnext(code, last))
+      ;  /* must keep it */
+    else if (!(flags[pc] & PCREACH)) {
+      flags[pc] |= PCDEAD;
+      continue;
+    }
+    else if (GET_OPCODE(*i) == OP_JMP) {
+      int next = pc + 1;
+      while (next < n && !(flags[next] & PCREACH))
+        next++;  /* skip unreachable code */
+      if (jumpdest(code, pc) == next) {
+        flags[pc] |= PCDEAD;
+        continue;
+      }
+    }
+    else if (last >= 0 && !(flags[pc] & PCTARGET)) {
+      Instruction *l = &code[last];
+      if (GET_OPCODE(*l) == OP_MOVE && GET_OPCODE(*i) == OP_MOVE &&
+          GETARG_A(*l) == GETARG_B(*i) && GETARG_B(*l) == GETARG_A(*i)) {
+        flags[pc] |= PCDEAD;  /* R[B] already has R[A] */
+        continue;
+      }
+      if (GET_OPCODE(*l) == OP_LOADNIL && GET_OPCODE(*i) == OP_LOADNIL) {
+        int from = GETARG_A(*l), l1 = from + GETARG_B(*l);
+        int pfrom = GETARG_A(*i), l2 = pfrom + GETARG_B(*i);
+        if (from <= l2 + 1 && pfrom <= l1 + 1) {  /* can connect both? */
+          if (pfrom < from) from = pfrom;  /* from = min(from, pfrom) */
+          if (l2 > l1) l1 = l2;  /* l1 = max(l1, l2) */
+          SETARG_A(*l, from);
+          SETARG_B(*l, l1 - from);
+          flags[pc] |= PCDEAD;
+          continue;
+        }
+      }
+    }
+    if (last >= 0 && (r = loadsreg(code[last])) >= 0 &&
+        loadsreg(*i) == r && lines[last] == lines[pc] &&
+        !(prev >= 0 && bindsnext(code, prev))) {
+      flags[last] |= PCDEAD;  /* its value is never used */
+      last = pc;
+      continue;
+    }
+    prev = last;
+    last = pc;
+  }
+}
+
+
+/* decode the line information of the function into 'lines' */
+static void getlines (FuncState *fs, int *lines) {
+  Proto *f = fs->f;
+  int line = f->linedefined;
+  int nabs = 0;
+  int pc;
+  for (pc = 0; pc < fs->pc; pc++) {
+    if (f->lineinfo[pc] != ABSLINEINFO)
+      line += f->lineinfo[pc];
+    else
+      line = f->abslineinfo[nabs++].line;
+    lines[pc] = line;
+  }
+}
+
+
+/*
+** Remove the instructions marked dead, rebuilding the line information
+** from 'lines'. 'map' becomes the new position of each old instruction
+** (or of the next kept one, for removed ones).
+*/
+static void compact (FuncState *fs, int *map, const int *lines) {
+  Proto *f = fs->f;
+  int n = fs->pc;
+  int npc = 0;
+  int pc;
+  for (pc = 0; pc < n; pc++) {
+    int dead = (map[pc] & PCDEAD);
+    map[pc] = npc;
+    if (!dead) npc++;
+  }
+  map[n] = npc;
+  fs->pc = 0;
+  fs->previousline = f->linedefined;
+  fs->iwthabs = 0;
+  fs->nabslineinfo = 0;
+  for (pc = 0; pc < n; pc++) {
+    if (map[pc + 1] != map[pc]) {  /* instruction kept? */
+      int dest = jumpdest(f->code, pc);
+      f->code[fs->pc] = f->code[pc];
+      if (dest >= 0)
+        setjumpdest(f->code, fs->pc, map[dest]);
+      fs->pc++;
+      savelineinfo(fs, f, lines[pc]);
+    }
+  }
+  for (pc = 0; pc < fs->ndebugvars; pc++) {
+    LocVar *var = &f->locvars[pc];
+    var->startpc = map[var->startpc];
+    var->endpc = map[var->endpc];
+  }
+}
+
+
+/*
+** Replace the first instruction of each pair of opcodes in
+** 'luaP_superops' by its superinstruction. The second one is the next
+** instruction, or the one after the OP_MMBIN* of an arithmetic opcode,
+** and it may be the first one of another pair. (The interpreter then
+** runs only its first part after the previous superinstruction.)
+*/
+static void fusepairs (Instruction *code, int n) {
+  int pc;
+  for (pc = 0; pc < n - 1; pc++) {
+    OpCode op = GET_OPCODE(code[pc]);
+    int next = pc + 1;
+    int s;
+    if (testMMMode(GET_OPCODE(code[next])) && ++next == n)
+      break;
+    for (s = 0; s < NUM_OPCODES - NUM_BASEOPS; s++) {
+      if (luaP_superops[s][0] == op &&
+          luaP_superops[s][1] == getBaseOp(GET_OPCODE(code[next]))) {
+        SET_OPCODE(code[pc], NUM_BASEOPS + s);
+        break;
+      }
+    }
+  }
+}
+
+
+static void optimize (FuncState *fs) {
+  Dyndata *dyd = fs->ls->dyd;
+  Instruction *code = fs->f->code;
+  int n = fs->pc;
+  int *flags, *lines;
+  int pc;
+  if (dyd->pcs.size < 3 * n + 1) {  /* flags, lines, and a stack */
+    luaM_freearray(fs->ls->L, dyd->pcs.arr, dyd->pcs.size);
+    dyd->pcs.arr = NULL; dyd->pcs.size = 0;  /* in case of errors */
+    dyd->pcs.arr = luaM_newvector(fs->ls->L, 3 * n + 1, int);
+    dyd->pcs.size = 3 * n + 1;
+  }
+  flags = dyd->pcs.arr;  /* n + 1 entries (see 'compact') */
+  lines = flags + n + 1;
+  for (pc = 0; pc <= n; pc++)
+    flags[pc] = 0;
+  getlines(fs, lines);
+  threadjumps(code, lines, n);
+  marktargets(code, n, flags);
+  markreachable(code, n, flags, lines + n);
+  fusereturns(code, n, flags);
+  markdead(code, lines, n, flags);
+  compact(fs, flags, lines);
+  fusepairs(fs->f->code, fs->pc);
+}
+
+/* }====================================================================== */
+
+
 /*
 ** Do a final pass over the code of a function, doing small peephole
 ** optimizations and adjustments.
@@ -1838,4 +2310,6 @@ void luaK_finish (FuncState *fs) {
       default: break;
     }
   }
+  if (fs->ls->dyd->optimize)
+    optimize(fs);
 }
@@ -230,6 +230,7 @@ LUA_API const char *lua_getlocal (lua_State *L, const lua_Debug *ar, int n) {
     StkId pos = NULL;  /* to avoid warnings */
     name = luaG_findlocal(L, ar->i_ci, n, &pos);
     if (name) {
+      glm_escapemat(s2v(pos));  /* it may be a temporary */
       setobjs2s(L, L->top, pos);
       api_incr_top(L);
     }
@@ -470,7 +471,7 @@ static int findsetreg (const Proto *p, int lastpc, int reg) {
     lastpc--;  /* previous instruction was not actually executed */
   for (pc = 0; pc < lastpc; pc++) {
     Instruction i = p->code[pc];
-    OpCode op = GET_OPCODE(i);
+    OpCode op = getBaseOp(GET_OPCODE(i));
     int a = GETARG_A(i);
     int change;  /* true if current instruction changed 'reg' */
     switch (op) {
@@ -533,7 +534,7 @@ static const char *getobjname (const Proto *p, int lastpc, int reg,
   pc = findsetreg(p, lastpc, reg);
   if (pc != -1) {  /* could find instruction? */
     Instruction i = p->code[pc];
-    OpCode op = GET_OPCODE(i);
+    OpCode op = getBaseOp(GET_OPCODE(i));
     switch (op) {
       case OP_MOVE: {
         int b = GETARG_B(i);  /* move from 'b' to 'a' */
@@ -595,7 +596,7 @@ static const char *funcnamefromcode (lua_State *L, const Proto *p,
                                      int pc, const char **name) {
   TMS tm = (TMS)0;  /* (initial value avoids warnings) */
   Instruction i = p->code[pc];  /* calling instruction */
-  switch (GET_OPCODE(i)) {
+  switch (getBaseOp(GET_OPCODE(i))) {
     case OP_CALL:
     case OP_TAILCALL:
       return getobjname(p, pc, GETARG_A(i), name);  /* get function name */
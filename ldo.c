@@ -1155,12 +1155,23 @@ int luaD_protectedparser (lua_State *L, ZIO *z, const char *name,
   p.dyd.actvar.arr = NULL; p.dyd.actvar.size = 0;
   p.dyd.gt.arr = NULL; p.dyd.gt.size = 0;
   p.dyd.label.arr = NULL; p.dyd.label.size = 0;
+  p.dyd.cfield.arr = NULL; p.dyd.cfield.size = 0;
+  p.dyd.tok.arr = NULL; p.dyd.tok.size = 0;
+  p.dyd.inl.arr = NULL; p.dyd.inl.size = 0;
+  p.dyd.inlname.arr = NULL; p.dyd.inlname.size = 0;
+  p.dyd.pcs.arr = NULL; p.dyd.pcs.size = 0;
+  p.dyd.optimize = (mode != NULL && strchr(mode, LUA_LOADOPTIMIZE) != NULL);
   luaZ_initbuffer(L, &p.buff);
   status = luaD_pcall(L, f_parser, &p, savestack(L, L->top), L->errfunc);
   luaZ_freebuffer(L, &p.buff);
   luaM_freearray(L, p.dyd.actvar.arr, p.dyd.actvar.size);
   luaM_freearray(L, p.dyd.gt.arr, p.dyd.gt.size);
   luaM_freearray(L, p.dyd.label.arr, p.dyd.label.size);
+  luaM_freearray(L, p.dyd.cfield.arr, p.dyd.cfield.size);
+  luaM_freearray(L, p.dyd.tok.arr, p.dyd.tok.size);
+  luaM_freearray(L, p.dyd.inl.arr, p.dyd.inl.size);
+  luaM_freearray(L, p.dyd.inlname.arr, p.dyd.inlname.size);
+  luaM_freearray(L, p.dyd.pcs.arr, p.dyd.pcs.size);
   decnny(L);
   return status;
 }
@@ -14,8 +14,10 @@
 
 #include "lua.h"
 
+#include "lgc.h"
 #include "lobject.h"
 #include "lstate.h"
+#include "ltable.h"
 #include "lundump.h"
 
 
@@ -140,45 +142,82 @@ static void dumpCode (DumpState *D, const Proto *f) {
 
 static void dumpFunction(DumpState *D, const Proto *f, TString *psource);
 
-static void dumpConstants (DumpState *D, const Proto *f) {
-  int i;
-  int n = f->sizek;
-  dumpInt(D, n);
-  for (i = 0; i < n; i++) {
-    const TValue *o = &f->k[i];
-    int tt = ttypetag(o);
+static void dumpTemplate (DumpState *D, Table *t);
+
+static void dumpValue (DumpState *D, const TValue *o) {
+  int tt = ttisnil(o) ? LUA_VNIL : ttypetag(o);  /* (empty slots are nil) */
 #if defined(LUAGLM_EXT_BLOB)  /* Blobs are dumped as long strings */
-    dumpByte(D, tt == LUA_VBLOBSTR ? LUA_VLNGSTR : tt);
+  dumpByte(D, tt == LUA_VBLOBSTR ? LUA_VLNGSTR : tt);
 #else
-    dumpByte(D, tt);
+  dumpByte(D, tt);
 #endif
-    switch (tt) {
-      case LUA_VNUMFLT:
-        dumpNumber(D, fltvalue(o));
-        break;
-      case LUA_VNUMINT:
-        dumpInteger(D, ivalue(o));
-        break;
-      case LUA_VVECTOR2:
-      case LUA_VVECTOR3:
-      case LUA_VVECTOR4:
-      case LUA_VQUAT:
-        dumpVectorType(D, vvalue(o), tt);
-        break;
-      case LUA_VSHRSTR:
+  switch (tt) {
+    case LUA_VNUMFLT:
+      dumpNumber(D, fltvalue(o));
+      break;
+    case LUA_VNUMINT:
+      dumpInteger(D, ivalue(o));
+      break;
+    case LUA_VVECTOR2:
+    case LUA_VVECTOR3:
+    case LUA_VVECTOR4:
+    case LUA_VQUAT:
+      dumpVectorType(D, vvalue(o), tt);
+      break;
+    case LUA_VSHRSTR:
 #if defined(LUAGLM_EXT_BLOB)
-      case LUA_VBLOBSTR:
+    case LUA_VBLOBSTR:
 #endif
-      case LUA_VLNGSTR:
-        dumpString(D, tsvalue(o));
-        break;
-      default:
-        lua_assert(tt == LUA_VNIL || tt == LUA_VFALSE || tt == LUA_VTRUE);
+    case LUA_VLNGSTR:
+      dumpString(D, tsvalue(o));
+      break;
+    case LUA_VTABLE:  /* template of a constructor */
+      dumpTemplate(D, hvalue(o));
+      break;
+    default:
+      lua_assert(tt == LUA_VNIL || tt == LUA_VFALSE || tt == LUA_VTRUE);
+  }
+}
+
+
+/*
+** Dump a table template: sizes of its array and hash parts, the
+** values in its array part, and the pairs in its hash part.
+*/
+static void dumpTemplate (DumpState *D, Table *t) {
+  unsigned int asize = luaH_realasize(t);
+  unsigned int i;
+  int nh = 0;
+  Node *n, *limit = gnode(t, cast_sizet(sizenode(t)));
+  for (n = gnode(t, 0); n < limit; n++)
+    nh += !isempty(gval(n));
+  dumpInt(D, cast_int(asize));
+  dumpInt(D, nh);
+  for (i = 0; i < asize; i++) {
+    TValue o;
+    arr2obj(t, i, &o);
+    dumpValue(D, &o);
+  }
+  for (n = gnode(t, 0); n < limit; n++) {
+    if (!isempty(gval(n))) {
+      TValue k;
+      getnodekey(D->L, &k, n);
+      dumpValue(D, &k);
+      dumpValue(D, gval(n));
     }
   }
 }
 
 
+static void dumpConstants (DumpState *D, const Proto *f) {
+  int i;
+  int n = f->sizek;
+  dumpInt(D, n);
+  for (i = 0; i < n; i++)
+    dumpValue(D, &f->k[i]);
+}
+
+
 static void dumpProtos (DumpState *D, const Proto *f) {
   int i;
   int n = f->sizep;
@@ -18,8 +18,10 @@
 #include "ldo.h"
 #include "lfunc.h"
 #include "lgc.h"
+#include "ljit.h"
 #include "lmem.h"
 #include "lobject.h"
+#include "lopcodes.h"
 #include "lstate.h"
 
 
@@ -281,8 +283,14 @@ Proto *luaF_newproto (lua_State *L) {
   f->sizek = 0;
   f->p = NULL;
   f->sizep = 0;
+  f->cache = NULL;
   f->code = NULL;
   f->sizecode = 0;
+  f->icache = NULL;
+#if defined(LUA_USE_JIT)
+  f->jitmode = JIT_DEFAULT;
+  f->jit = NULL;
+#endif
   f->lineinfo = NULL;
   f->sizelineinfo = 0;
   f->abslineinfo = NULL;
@@ -301,8 +309,41 @@ Proto *luaF_newproto (lua_State *L) {
 }
 
 
+/*
+** Inline caches: instructions that index a table with a constant short
+** string (OP_GETTABUP, OP_GETFIELD, OP_SETTABUP, OP_SETFIELD, and
+** OP_SELF) keep in 'icache[pc]' the index of the node where they last
+** found their key. The VM checks that hint against the key stored in
+** that node, so it needs no invalidation when a table is rehashed and
+** it also serves all tables built with the same sequence of keys (e.g.,
+** objects of a class). Functions without those instructions have no
+** caches.
+*/
+void luaF_initcache (lua_State *L, Proto *f) {
+  int pc;
+  for (pc = 0; pc < f->sizecode; pc++) {
+    switch (getBaseOp(GET_OPCODE(f->code[pc]))) {
+      case OP_GETTABUP: case OP_GETFIELD: case OP_SETTABUP:
+      case OP_SETFIELD: case OP_SELF: {
+        int i;
+        f->icache = luaM_newvector(L, f->sizecode, unsigned int);
+        for (i = 0; i < f->sizecode; i++)
+          f->icache[i] = 0;
+        return;
+      }
+      default: break;
+    }
+  }
+}
+
+
 void luaF_freeproto (lua_State *L, Proto *f) {
+#if defined(LUA_USE_JIT)
+  luaJ_freeproto(L, f);
+#endif
   luaM_freearray(L, f->code, f->sizecode);
+  if (f->icache != NULL)
+    luaM_freearray(L, f->icache, f->sizecode);
   luaM_freearray(L, f->p, f->sizep);
   luaM_freearray(L, f->k, f->sizek);
   luaM_freearray(L, f->lineinfo, f->sizelineinfo);
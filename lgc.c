@@ -90,6 +90,10 @@
 */
 #define gcvalueN(o)     (iscollectable(o) ? gcvalue(o) : NULL)
 
+/* collectable object in entry 'i' of the array part of 't' (or NULL) */
+#define gcvalarr(t,i)  \
+	((*getArrTag(t,i) & BIT_ISCOLLECTABLE) ? getArrVal(t,i)->gc : NULL)
+
 
 #define markvalue(g,o) { checkliveness(g->mainthread,o); \
   if (valiswhite(o)) reallymarkobject(g,gcvalue(o)); }
@@ -269,6 +273,24 @@ GCObject *luaC_newobj (lua_State *L, int tt, size_t sz) {
   return o;
 }
 
+
+#if defined(LUAGLM_EXT_BUILDER)
+/*
+** Link a block of memory, allocated with 'luaM_newobject' or one of its
+** variants but not yet known by the collector, as a new object with
+** type tag 'tt'.
+*/
+GCObject *luaC_linkobj (lua_State *L, void *block, int tt) {
+  global_State *g = G(L);
+  GCObject *o = cast(GCObject *, block);
+  o->marked = luaC_white(g);
+  o->tt = tt;
+  o->next = g->allgc;
+  g->allgc = o;
+  return o;
+}
+#endif
+
 /* }====================================================== */
 
 
@@ -303,6 +325,13 @@ static void reallymarkobject (global_State *g, GCObject *o) {
       set2black(o);  /* nothing to visit */
       break;
     }
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR: {  /* slices keep their parents alive */
+      set2black(o);
+      markobject(g, getslice(gco2ts(o))->parent);
+      break;
+    }
+#endif
     case LUA_VUPVAL: {
       UpVal *uv = gco2upv(o);
       if (upisopen(uv))
@@ -467,6 +496,25 @@ static void traverseweakvalue (global_State *g, Table *h) {
 }
 
 
+/*
+** Traverse the array part of a table. Returns true iff any object was
+** marked.
+*/
+static int traversearray (global_State *g, Table *h) {
+  unsigned int asize = luaH_realasize(h);
+  int marked = 0;
+  unsigned int i;
+  for (i = 0; i < asize; i++) {
+    GCObject *o = gcvalarr(h, i);
+    if (o != NULL && iswhite(o)) {
+      marked = 1;
+      reallymarkobject(g, o);
+    }
+  }
+  return marked;
+}
+
+
 /*
 ** Traverse an ephemeron table and link it to proper list. Returns true
 ** iff any object was marked during this traversal (which implies that
@@ -480,19 +528,11 @@ static void traverseweakvalue (global_State *g, Table *h) {
 ** by 'genlink'.
 */
 static int traverseephemeron (global_State *g, Table *h, int inv) {
-  int marked = 0;  /* true if an object is marked in this traversal */
   int hasclears = 0;  /* true if table has white keys */
   int hasww = 0;  /* true if table has entry "white-key -> white-value" */
   unsigned int i;
-  unsigned int asize = luaH_realasize(h);
   unsigned int nsize = sizenode(h);
-  /* traverse array part */
-  for (i = 0; i < asize; i++) {
-    if (valiswhite(&h->array[i])) {
-      marked = 1;
-      reallymarkobject(g, gcvalue(&h->array[i]));
-    }
-  }
+  int marked = traversearray(g, h);  /* traverse array part */
   /* traverse hash part; if 'inv', traverse descending
      (see 'convergeephemerons') */
   for (i = 0; i < nsize; i++) {
@@ -524,10 +564,7 @@ static int traverseephemeron (global_State *g, Table *h, int inv) {
 
 static void traversestrongtable (global_State *g, Table *h) {
   Node *n, *limit = gnodelast(h);
-  unsigned int i;
-  unsigned int asize = luaH_realasize(h);
-  for (i = 0; i < asize; i++)  /* traverse array part */
-    markvalue(g, &h->array[i]);
+  traversearray(g, h);
   for (n = gnode(h, 0); n < limit; n++) {  /* traverse hash part */
     if (isempty(gval(n)))  /* entry is empty? */
       clearkey(n);  /* clear its key */
@@ -579,6 +616,8 @@ static int traverseudata (global_State *g, Udata *u) {
 */
 static int traverseproto (global_State *g, Proto *f) {
   int i;
+  if (f->cache && iswhite(f->cache))
+    f->cache = NULL;  /* allow cache to be collected */
   markobjectN(g, f->source);
   for (i = 0; i < f->sizek; i++)  /* mark literals */
     markvalue(g, &f->k[i]);
@@ -748,9 +787,9 @@ static void clearbyvalues (global_State *g, GCObject *l, GCObject *f) {
     unsigned int i;
     unsigned int asize = luaH_realasize(h);
     for (i = 0; i < asize; i++) {
-      TValue *o = &h->array[i];
-      if (iscleared(g, gcvalueN(o)))  /* value was collected? */
-        setempty(o);  /* remove entry */
+      GCObject *o = gcvalarr(h, i);
+      if (iscleared(g, o))  /* value was collected? */
+        *getArrTag(h, i) = LUA_VEMPTY;  /* remove entry */
     }
     for (n = gnode(h, 0); n < limit; n++) {
       if (iscleared(g, gcvalueN(gval(n))))  /* unmarked value? */
@@ -815,6 +854,11 @@ static void freeobj (lua_State *L, GCObject *o) {
       luaM_freemem(L, ts, sizelstring(ts->u.lnglen));
       break;
     }
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR:
+      luaM_freemem(L, o, sizeslice);
+      break;
+#endif
     default: lua_assert(0);
   }
 }
@@ -1566,6 +1610,7 @@ static lu_mem atomic (lua_State *L) {
   clearbyvalues(g, g->weak, origweak);
   clearbyvalues(g, g->allweak, origall);
   luaS_clearcache(g);
+  luaT_invalidatechains(L);  /* cached keys may be collected */
   g->currentwhite = cast_byte(otherwhite(g));  /* flip current white */
   lua_assert(g->gray == NULL);
   return work;  /* estimate of slots marked by 'atomic' */
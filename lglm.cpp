@@ -120,7 +120,7 @@ extern LUA_API_LINKAGE {
 /* return helpers */
 #define glm_runerror(L, M) (luaG_runerror((L), (M)), 0)
 #define glm_typeError(L, O, M) (luaG_typeerror((L), (O), (M)), 0)
-#define glm_finishset(L, T, K, V) (luaV_finishset((L), (T), (K), (V), GLM_NULLPTR), 1)
+#define glm_finishset(L, T, K, V) (luaV_finishset((L), (T), (K), (V), HNOTATABLE), 1)
 
 /* lua_gettop() macro */
 #if !defined(_gettop)
@@ -193,10 +193,10 @@ static inline lua_Integer glm_flttointeger(const TValue *obj) {
 }
 
 /* trybinTM where the first element is predefined */
-static int num_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event);
+static int num_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event, int temp);
 static int vec_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event);
 static int quat_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event);
-static int mat_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event);
+static int mat_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event, int temp);
 
 /*
 ** {==================================================================
@@ -289,13 +289,11 @@ static void vec_finishget(lua_State *L, const TValue *obj, TValue *key, StkId re
     luaT_callTMres(L, tm, obj, key, res); /* call it */
   else {
     // This logic would be considered the first 'loop' of luaV_finishget
-    const TValue *slot = GLM_NULLPTR;
+    lu_byte tag;
     const TValue *t = tm;  /* else try to access 'tm[key]' */
-    if (luaV_fastget(L, t, key, slot, luaH_get)) {  /* fast track? */
-      setobj2s(L, res, slot);  /* done */
-      return;
-    }
-    luaV_finishget(L, t, key, res, slot);
+    luaV_fastget(t, key, s2v(res), luaH_get, tag);
+    if (tagisempty(tag))  /* not done by the fast track? */
+      luaV_finishget(L, t, key, res, tag);
   }
 }
 
@@ -611,10 +609,10 @@ int glmVec_next(const TValue *obj, StkId key) {
   return 0;
 }
 
-int glm_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event) {
+int glm_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event, int temp) {
   switch (ttype(p1)) {
-    case LUA_TNUMBER: return num_trybinTM(L, p1, p2, res, event);
-    case LUA_TMATRIX: return mat_trybinTM(L, p1, p2, res, event);
+    case LUA_TNUMBER: return num_trybinTM(L, p1, p2, res, event, temp);
+    case LUA_TMATRIX: return mat_trybinTM(L, p1, p2, res, event, temp);
     case LUA_TVECTOR: {
       if (ttisquat(p1))  // quaternion-specific implementation
         return quat_trybinTM(L, p1, p2, res, event);
@@ -714,6 +712,7 @@ static int matgeti (const TValue *obj, lua_Integer n, StkId res) {
 GCMatrix *glmMat_new(lua_State *L) {
   GCObject *o = luaC_newobj(L, LUA_VMATRIX, sizeof(GCMatrix));
   GCMatrix *mat = gco2mat(o);
+  mat->istemp = 0;
   glm_mat_boundary(&mat->mat4) = glm::identity<glm::mat<4, 4, glm_Float>>();
   return mat;
 }
@@ -1287,8 +1286,10 @@ static glm::length_t PopulateVector(lua_State *L, int idx, glm::vec<4, T> &vec,
     const glm::length_t dims = static_cast<glm::length_t>(luaH_getn(hvalue(value)));
     const glm::length_t length = glm::min(dims, v_desired - v_idx);
     for (glm::length_t j = 1; j <= length; ++j) {
-      const TValue *t_val = luaH_getint(hvalue(value), static_cast<lua_Integer>(j));
-      if (!glm_castvalue(t_val, vec[v_idx++])) {  // Primitive type: cast & store it.
+      TValue t_val;
+      setnilvalue(&t_val);
+      luaH_getint(hvalue(value), static_cast<lua_Integer>(j), &t_val);
+      if (!glm_castvalue(&t_val, vec[v_idx++])) {  // Primitive type: cast & store it.
         return luaL_argerror(L, idx, INVALID_VECTOR_TYPE);
       }
     }
@@ -1365,8 +1366,10 @@ static bool PopulateMatrix(lua_State *L, int idx, int top, bool fixed_size, glmM
     for (; size < column_limit; ++size) {
       glm::length_t v_size = 0;
       if (as_table) {  // An array contains all of the elements of a matrix.
-        const TValue *value = luaH_getint(hvalue(o), static_cast<lua_Integer>(size) + 1);
-        v_size = ttisnil(value) ? 0 : PopulateVector(L, idx, m.m44[size], 0, m_secondary, value);
+        TValue value;
+        setnilvalue(&value);
+        luaH_getint(hvalue(o), static_cast<lua_Integer>(size) + 1, &value);
+        v_size = ttisnil(&value) ? 0 : PopulateVector(L, idx, m.m44[size], 0, m_secondary, &value);
       }
       else {
         const TValue *value = glm_index2value(L, idx);
@@ -1631,6 +1634,15 @@ LUA_API const char *glm_pushstring(lua_State *L, int idx) {
   return lua_pushliteral(L, "nil");
 }
 
+LUA_API int glm_tostringbuff(lua_State *L, int idx, char *buff, size_t len) {
+  const TValue *o = glm_index2value(L, idx);
+  if (ttisvector(o))
+    return glmVec_tostr(o, buff, len);
+  else if (ttismatrix(o))
+    return glmMat_tostr(o, buff, len);
+  return -1;
+}
+
 LUA_API int glm_unpack_vector(lua_State *L, int idx) {
   luaL_checkstack(L, 4, "vector fields"); // Ensure stack-space
   const TValue *o = glm_index2value(L, idx);
@@ -1746,10 +1758,12 @@ static int glmH_tovector(lua_State *L, const TValue *o, glmVector *v) {
   Table* t = hvalue(o);
   for (int i = 0; i < 4; ++i) {
     TString *key = luaS_newlstr(L, dims[i], 1);  // luaS_newliteral
-    const TValue *slot = luaH_getstr(t, key);  // @TODO: Allow TM_INDEX instead of raw-accessing
-    if (ttisnumber(slot)) {
+    TValue slot;
+    setnilvalue(&slot);
+    luaH_getstr(t, key, &slot);  // @TODO: Allow TM_INDEX instead of raw-accessing
+    if (ttisnumber(&slot)) {
       if (v != GLM_NULLPTR) {
-        v->v4[i] = glm_castfloat(nvalue(slot));
+        v->v4[i] = glm_castfloat(nvalue(&slot));
       }
       count++;
     }
@@ -1976,7 +1990,27 @@ LUA_API void lua_pushmatrix(lua_State *L, const lua_Mat4 *matrix) {
 */
 
 /*
-** Create a new matrix collectible and set it to the stack.
+** Matrix collectible for the result of an operator over 'p1' and 'p2': an
+** operand that is a temporary matrix, i.e., an intermediate result that only
+** this operator consumes (see luaT_trybinTM), or else a new matrix. 'temp' is
+** whether the result is itself a temporary.
+*/
+static GCMatrix *glmMat_result(lua_State *L, const TValue *p1, const TValue *p2, int temp) {
+  GCMatrix *mat = GLM_NULLPTR;
+  if (ttismatrix(p1) && gco2mat(gcvalue(p1))->istemp)
+    mat = gco2mat(gcvalue(p1));
+  else if (ttismatrix(p2) && gco2mat(gcvalue(p2))->istemp)
+    mat = gco2mat(gcvalue(p2));
+  else {
+    mat = glmMat_new(L);
+  }
+  mat->istemp = cast_byte(temp);
+  return mat;
+}
+
+/*
+** Create a new matrix collectible, or reuse a temporary operand, and set it
+** to the stack. The value 'x' is computed before it overwrites the matrix.
 **
 ** A dimension override is included to simplify the below logic for operations
 ** that operate on a per-value basis. Allowing the use of more generalized
@@ -1984,9 +2018,10 @@ LUA_API void lua_pushmatrix(lua_State *L, const lua_Mat4 *matrix) {
 */
 #define glm_newmvalue(L, obj, x, dims)  \
   LUA_MLM_BEGIN                         \
-  GCMatrix *mat = glmMat_new(L);        \
+  const grit_length_t dims_ = (dims);   \
+  GCMatrix *mat = glmMat_result(L, p1, p2, temp); \
   glm_mat_boundary(&(mat->mat4)) = (x); \
-  mat->mat4.dimensions = dims;          \
+  mat->mat4.dimensions = dims_;         \
   glm_setmvalue2s(L, obj, mat);         \
   luaC_checkGC(L);                      \
   LUA_MLM_END
@@ -2031,7 +2066,7 @@ LUA_API void lua_pushmatrix(lua_State *L, const lua_Mat4 *matrix) {
   }                                                                                                                 \
   LUA_MLM_END
 
-static int num_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event) {
+static int num_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event, int temp) {
   const glm_Float s = glm_toflt(p1);
   switch (event) {
     case TM_ADD: {
@@ -2404,7 +2439,7 @@ static int quat_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId
   return 0;
 }
 
-static int mat_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event) {
+static int mat_trybinTM(lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event, int temp) {
   const glmMatrix &m = glm_mvalue(p1);
   const grit_length_t cols = LUAGLM_MATRIX_COLS(m.dimensions);
   switch (event) {
@@ -166,8 +166,11 @@ LUAI_FUNC int glmVec_isfinite (const TValue *obj);
 */
 LUAI_FUNC int glmVec_next (const TValue *obj, StkId key);
 
-/* trybinTM handler for GLM objects */
-LUAI_FUNC int glm_trybinTM (lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event);
+/*
+** trybinTM handler for GLM objects. A temporary matrix operand may hold the
+** result, which is itself a temporary when 'temp' is true (see luaT_trybinTM).
+*/
+LUAI_FUNC int glm_trybinTM (lua_State *L, const TValue *p1, const TValue *p2, StkId res, TMS event, int temp);
 
 /* }================================================================== */
 
@@ -9,6 +9,8 @@
 
 #include <cstdio>
 #include <cctype>
+#include <cstring>
+#include <cstdarg>
 #include <glm/glm.hpp>
 
 /*
@@ -42,20 +44,80 @@
 /* Forward declare functor for pushing Lua strings without intermediate std::string */
 namespace glm {
 namespace detail {
+  /// <summary>
+  /// Append 'n' characters to the result of _vsnprintf, truncating it to
+  /// 'buff_len' - 1 characters as vsnprintf would.
+  /// </summary>
+  static GLM_FUNC_QUALIFIER void _vsnappend(char *buff, size_t buff_len, size_t &length, const char *s, size_t n) {
+    if (length + 1 < buff_len)
+      memcpy(buff + length, s, (n < buff_len - length - 1) ? n : buff_len - length - 1);
+    length += n;
+  }
+
+  /// <summary>
+  /// vsnprintf for the flag-free "%s", "%d", "%lld", and "%f" conversions of
+  /// lglm_compute_to_string. Numbers are formatted by lua_fmtinteger and
+  /// lua_fmtnumber, which avoid the C library for the common cases; any
+  /// other conversion falls back to vsnprintf.
+  /// </summary>
   static GLM_STRING_FUNC_QUALIFIER int _vsnprintf(char *buff, size_t buff_len, const char *msg, ...) {
-    int length = 0;
+    char temp[128];  // Number conversion
+    size_t length = 0;
+    const char *p = msg;
 
-    va_list list;
+    va_list list, args;
     va_start(list, msg);
+    va_copy(args, list);
+    while (*p != '\0') {
+      const char *q = p;
+      while (*q != '\0' && *q != '%')
+        ++q;
+
+      _vsnappend(buff, buff_len, length, p, static_cast<size_t>(q - p));
+      if (*q++ == '\0')
+        break;
+
+      int n = -1;
+      if (*q == 's') {
+        const char *s = va_arg(list, const char *);
+        _vsnappend(buff, buff_len, length, s, strlen(s));
+        n = 0;
+      }
+      else if (*q == 'd')
+        n = lua_fmtinteger(temp, sizeof(temp), static_cast<lua_Integer>(va_arg(list, int)));
+      else if (q[0] == 'l' && q[1] == 'l' && q[2] == 'd' && sizeof(lua_Integer) >= sizeof(long long)) {
+        n = lua_fmtinteger(temp, sizeof(temp), static_cast<lua_Integer>(va_arg(list, long long)));
+        q += 2;
+      }
+#if LUA_FLOAT_TYPE == LUA_FLOAT_DOUBLE
+      else if (*q == 'f')
+        n = lua_fmtnumber(temp, sizeof(temp), 'f', 6, static_cast<lua_Number>(va_arg(list, double)));
+#endif
+
+      if (n < 0 || static_cast<size_t>(n) >= sizeof(temp)) {  // Unsupported conversion
+        va_end(list);
 #if (GLM_COMPILER & GLM_COMPILER_VC)
-    length = vsprintf_s(buff, buff_len, msg, list);
+        const int result = vsprintf_s(buff, buff_len, msg, args);
 #else
-    length = vsnprintf(buff, buff_len, msg, list);
+        const int result = vsnprintf(buff, buff_len, msg, args);
 #endif
+        va_end(args);
+        assert(result > 0);
+        return result;
+      }
+
+      if (*q != 's')
+        _vsnappend(buff, buff_len, length, temp, static_cast<size_t>(n));
+      p = q + 1;
+    }
     va_end(list);
+    va_end(args);
+
+    if (buff_len > 0)
+      buff[(length < buff_len) ? length : buff_len - 1] = '\0';
 
     assert(length > 0);
-    return length;
+    return static_cast<int>(length);
   }
 
   /// <summary>
@@ -70,6 +70,15 @@ LUA_API const char *glm_typename (lua_State *L, int idx);
 /* Push a string representing the vector/matrix object on top of the stack. */
 LUA_API const char *glm_pushstring (lua_State *L, int idx);
 
+/*
+** Write a string representing the vector/matrix object at the given index
+** into 'buff' (of 'len' bytes, including the terminating zero). Returns the
+** length of the complete representation, which may be greater or equal to
+** 'len' when the buffer is too small (see snprintf), or a negative value if
+** the object is not a vector/matrix.
+*/
+LUA_API int glm_tostringbuff (lua_State *L, int idx, char *buff, size_t len);
+
 /*
 ** Unpack an individual vector and place its contents to onto the Lua stack,
 ** returning the number of elements (i.e., dimensions of vector).
@@ -0,0 +1,658 @@
+/*
+** $Id: broadphase.hpp $
+** Sweep and Prune: an incremental broadphase over axis-aligned bounding boxes.
+**
+** Each axis maintains a persistent array of (min/max) endpoints that is kept
+** sorted with an insertion sort. As bounds are generally coherent between
+** updates the arrays are nearly sorted and each update is close to linear. A
+** pair of boxes begins (or stops) overlapping only when one endpoint moves
+** across another, i.e., overlapping pairs are maintained incrementally and
+** reported as added/removed deltas.
+**
+** Like polygons, a broadphase is a userdata whose metatable is also the
+** broadphase library, i.e., glm.broadphase.update(b) and b:update() are
+** equivalent.
+**
+** See Copyright Notice in lua.h
+*/
+#ifndef BINDING_BROADPHASE_HPP
+#define BINDING_BROADPHASE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "allocator.hpp"
+#include "bindings.hpp"
+#include "bulk.hpp"
+
+#include <glm/glm.hpp>
+
+/* Metatable of the broadphase userdata */
+#define LUAGLM_BROADPHASE "GLM_BROADPHASE"
+
+/// <summary>
+/// An endpoint of a proxy on an axis: (proxy << 1) | isMax.
+/// </summary>
+struct glmSapEndpoint {
+  glm_Float value;
+  uint32_t data;
+};
+
+/// <summary>
+/// Endpoint ordering: at equal values minimums precede maximums so touching
+/// boxes are considered overlapping (see glm::intersects).
+/// </summary>
+static GLM_INLINE bool glm_sap_less(const glmSapEndpoint &a, const glmSapEndpoint &b) {
+  return a.value < b.value || (a.value == b.value && (a.data & 1) < (b.data & 1));
+}
+
+/* Reserved glmSapPairs slot values; never a valid pair key */
+#define GLM_SAP_EMPTY (~static_cast<uint64_t>(0))
+#define GLM_SAP_DELETED (~static_cast<uint64_t>(0) - 1)
+
+/// <summary>
+/// An open-addressing (linear probing) set of proxy pairs; each pair is packed
+/// as (min(a, b) << 32) | max(a, b).
+/// </summary>
+struct glmSapPairs {
+  LuaVector<uint64_t> slots;  // Power-of-two capacity.
+  LuaVector<uint64_t> scratch;  // Rehash buffer.
+  size_t count;  // Number of pairs.
+  size_t used;  // Number of non-empty slots (pairs and tombstones).
+
+  glmSapPairs(lua_State *L, LuaCrtAllocator<uint64_t> &alloc)
+    : slots(L, alloc), scratch(L, alloc), count(0), used(0) {
+  }
+
+  void Validate(lua_State *L) {
+    slots.Validate(L);
+    scratch.Validate(L);
+  }
+
+  static GLM_INLINE uint64_t Key(uint32_t a, uint32_t b) {
+    return (a < b) ? ((static_cast<uint64_t>(a) << 32) | b) : ((static_cast<uint64_t>(b) << 32) | a);
+  }
+
+  static GLM_INLINE size_t Hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    return static_cast<size_t>(key);
+  }
+
+  void Clear() {
+    std::fill(slots.begin(), slots.end(), GLM_SAP_EMPTY);
+    count = used = 0;
+  }
+
+  void Rehash(size_t capacity) {
+    scratch.resize(slots.size());
+    if (slots.size() > 0)
+      std::memcpy(scratch.data(), slots.data(), slots.size() * sizeof(uint64_t));
+
+    slots.resize(capacity);
+    Clear();
+    for (size_t i = 0; i < scratch.size(); ++i) {
+      if (scratch[i] < GLM_SAP_DELETED)
+        Insert(scratch[i]);
+    }
+    scratch.clear();
+  }
+
+  /// <summary>
+  /// Returns true if the key was not already in the set.
+  /// </summary>
+  bool Insert(uint64_t key) {
+    if ((used + 1) * 4 > slots.size() * 3)  // Load factor: 3/4
+      Rehash(std::max<size_t>(16, (count + 1) * 2 > slots.size() ? slots.size() * 2 : slots.size()));
+
+    const size_t mask = slots.size() - 1;
+    size_t tomb = slots.size();
+    for (size_t i = Hash(key) & mask;; i = (i + 1) & mask) {
+      const uint64_t slot = slots[i];
+      if (slot == key)
+        return false;
+      else if (slot == GLM_SAP_DELETED && tomb == slots.size())
+        tomb = i;
+      else if (slot == GLM_SAP_EMPTY) {
+        if (tomb != slots.size())
+          i = tomb;
+        else
+          used++;
+        slots[i] = key;
+        count++;
+        return true;
+      }
+    }
+  }
+
+  /// <summary>
+  /// Returns true if the key was in the set.
+  /// </summary>
+  bool Erase(uint64_t key) {
+    if (count == 0)
+      return false;
+
+    const size_t mask = slots.size() - 1;
+    for (size_t i = Hash(key) & mask;; i = (i + 1) & mask) {
+      const uint64_t slot = slots[i];
+      if (slot == key) {
+        slots[i] = GLM_SAP_DELETED;
+        count--;
+        return true;
+      }
+      else if (slot == GLM_SAP_EMPTY)
+        return false;
+    }
+  }
+};
+
+/// <summary>
+/// Allocators of the broadphase containers; declared before (and constructed
+/// ahead of) the containers that reference them.
+/// </summary>
+struct glmBroadphaseAllocators {
+  LuaCrtAllocator<glmSapEndpoint> endpoints;
+  LuaCrtAllocator<glm_Float> floats;
+  LuaCrtAllocator<unsigned char> bytes;
+  LuaCrtAllocator<uint32_t> proxies;
+  LuaCrtAllocator<uint64_t> keys;
+
+  glmBroadphaseAllocators(lua_State *L)
+    : endpoints(L), floats(L), bytes(L), proxies(L), keys(L) {
+  }
+};
+
+/// <summary>
+/// Sweep and prune over 'dims' axes. Proxies are identified by their index;
+/// indices of removed proxies are recycled.
+/// </summary>
+struct glmBroadphase {
+  glmBroadphaseAllocators allocators;
+  LuaVector<glmSapEndpoint> x, y, z;  // Endpoints of each axis.
+  LuaVector<glm_Float> bounds;  // (min, max) per proxy: 2 * dims values.
+  LuaVector<unsigned char> alive;
+  LuaVector<uint32_t> freelist;
+  glmSapPairs pairs;
+  LuaVector<uint64_t> added;  // Pending pair deltas since the last update.
+  LuaVector<uint64_t> removed;
+  glm::length_t dims;
+  size_t count;  // Number of live proxies.
+  bool dead;  // Proxies were removed since the last compaction.
+
+  glmBroadphase(lua_State *L, glm::length_t dims_)
+    : allocators(L),
+      x(L, allocators.endpoints), y(L, allocators.endpoints), z(L, allocators.endpoints),
+      bounds(L, allocators.floats), alive(L, allocators.bytes),
+      freelist(L, allocators.proxies), pairs(L, allocators.keys),
+      added(L, allocators.keys), removed(L, allocators.keys),
+      dims(dims_), count(0), dead(false) {
+  }
+
+  LuaVector<glmSapEndpoint> &Axis(glm::length_t i) {
+    return (i == 0) ? x : ((i == 1) ? y : z);
+  }
+
+  void Validate(lua_State *L) {
+    x.Validate(L);
+    y.Validate(L);
+    z.Validate(L);
+    bounds.Validate(L);
+    alive.Validate(L);
+    freelist.Validate(L);
+    pairs.Validate(L);
+    added.Validate(L);
+    removed.Validate(L);
+  }
+
+  size_t capacity() const {
+    return alive.size();
+  }
+
+  bool valid(lua_Integer id) const {
+    return id >= 1 && static_cast<lua_Unsigned>(id) <= capacity() && alive[static_cast<size_t>(id - 1)];
+  }
+
+  glm_Float *Bounds(uint32_t proxy) {
+    return bounds.data() + static_cast<size_t>(proxy) * 2 * dims;
+  }
+
+  /// <summary>
+  /// Set the bounds of a proxy; the endpoint arrays are resorted on Update.
+  /// </summary>
+  void SetBounds(uint32_t proxy, const glm_Float *min, const glm_Float *max) {
+    glm_Float *b = Bounds(proxy);
+    for (glm::length_t i = 0; i < dims; ++i) {
+      b[i] = glm::min(min[i], max[i]);
+      b[dims + i] = glm::max(min[i], max[i]);
+    }
+  }
+
+  /// <summary>
+  /// Create a proxy. Its endpoints are appended to the end of each axis, i.e.,
+  /// overlapping nothing, and are swept into place by the next Update.
+  /// </summary>
+  uint32_t Insert(const glm_Float *min, const glm_Float *max) {
+    Compact();  // Release the endpoints of a recycled proxy.
+
+    uint32_t proxy;
+    if (freelist.size() > 0) {
+      proxy = freelist[freelist.size() - 1];
+      freelist.pop_back();
+    }
+    else {
+      proxy = static_cast<uint32_t>(capacity());
+      bounds.resize(bounds.size() + 2 * static_cast<size_t>(dims));
+      alive.push_back(0);
+    }
+
+    for (glm::length_t i = 0; i < dims; ++i) {
+      Axis(i).push_back(glmSapEndpoint { glm_Float(0), proxy << 1 });
+      Axis(i).push_back(glmSapEndpoint { glm_Float(0), (proxy << 1) | 1 });
+    }
+
+    alive[proxy] = 1;
+    SetBounds(proxy, min, max);
+    count++;
+    return proxy;
+  }
+
+  /// <summary>
+  /// Mark a proxy as removed; Compact releases its endpoints and pairs.
+  /// </summary>
+  void Remove(uint32_t proxy) {
+    alive[proxy] = 0;
+    freelist.push_back(proxy);
+    count--;
+    dead = true;
+  }
+
+  /// <summary>
+  /// Release the endpoints and pairs of removed proxies; the pairs are reported
+  /// as removed by the next update.
+  /// </summary>
+  void Compact() {
+    if (!dead)
+      return;
+
+    for (glm::length_t i = 0; i < dims; ++i) {
+      LuaVector<glmSapEndpoint> &axis = Axis(i);
+      size_t n = 0;
+      for (size_t j = 0; j < axis.size(); ++j) {
+        if (alive[axis[j].data >> 1])
+          axis[n++] = axis[j];
+      }
+      axis.resize(n);
+    }
+
+    for (size_t i = 0; i < pairs.slots.size(); ++i) {
+      const uint64_t key = pairs.slots[i];
+      if (key < GLM_SAP_DELETED && (!alive[static_cast<size_t>(key >> 32)] || !alive[static_cast<size_t>(key & 0xFFFFFFFF)])) {
+        pairs.slots[i] = GLM_SAP_DELETED;
+        pairs.count--;
+        removed.push_back(key);
+      }
+    }
+    dead = false;
+  }
+
+  /// <summary>
+  /// Closed-interval overlap test of two proxies on all axes.
+  /// </summary>
+  bool Overlaps(uint32_t a, uint32_t b) {
+    const glm_Float *ba = Bounds(a);
+    const glm_Float *bb = Bounds(b);
+    for (glm::length_t i = 0; i < dims; ++i) {
+      if (ba[i] > bb[dims + i] || bb[i] > ba[dims + i])
+        return false;
+    }
+    return true;
+  }
+
+  /// <summary>
+  /// Refresh the endpoint values of an axis and restore its order with an
+  /// insertion sort. A minimum moving below a maximum may begin an overlap, a
+  /// maximum moving below a minimum ends one.
+  /// </summary>
+  void SortAxis(glm::length_t axis) {
+    glmSapEndpoint *e = Axis(axis).data();
+    const size_t n = Axis(axis).size();
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t data = e[i].data;
+      e[i].value = Bounds(data >> 1)[(data & 1) * dims + axis];
+    }
+
+    for (size_t i = 1; i < n; ++i) {
+      const glmSapEndpoint key = e[i];
+      const uint32_t proxy = key.data >> 1;
+      size_t j = i;
+      for (; j > 0 && glm_sap_less(key, e[j - 1]); --j) {
+        const uint32_t other = e[j - 1].data >> 1;
+        if (other != proxy) {
+          const bool keyMax = (key.data & 1) != 0;
+          const bool otherMax = (e[j - 1].data & 1) != 0;
+          if (!keyMax && otherMax) {
+            if (Overlaps(proxy, other) && pairs.Insert(glmSapPairs::Key(proxy, other)))
+              added.push_back(glmSapPairs::Key(proxy, other));
+          }
+          else if (keyMax && !otherMax) {
+            if (pairs.Erase(glmSapPairs::Key(proxy, other)))
+              removed.push_back(glmSapPairs::Key(proxy, other));
+          }
+        }
+        e[j] = e[j - 1];
+      }
+      e[j] = key;
+    }
+  }
+
+  void Update() {
+    Compact();
+    for (glm::length_t i = 0; i < dims; ++i)
+      SortAxis(i);
+  }
+};
+
+/*
+** {==================================================================
+** Binding
+** ===================================================================
+*/
+
+static glmBroadphase *glm_broadphase_check(lua_State *L, int idx) {
+  glmBroadphase *bp = static_cast<glmBroadphase *>(luaL_checkudata(L, idx, LUAGLM_BROADPHASE));
+  bp->Validate(L);
+  return bp;
+}
+
+static uint32_t glm_broadphase_checkid(lua_State *L, int idx, const glmBroadphase *bp) {
+  const lua_Integer id = luaL_checkinteger(L, idx);
+  luaL_argcheck(L, bp->valid(id), idx, "invalid proxy");
+  return static_cast<uint32_t>(id - 1);
+}
+
+/// <summary>
+/// Parse a point of the broadphase dimensions: a number, vec2, or vec3.
+/// </summary>
+static void glm_broadphase_checkpoint(gLuaBase &LB, glm::length_t dims, glm_Float *out) {
+  switch (dims) {
+    case 1: {
+      out[0] = gLuaFloat::Next(LB);
+      break;
+    }
+    case 2: {
+      const glm::vec<2, glm_Float> v = gLuaVec2<>::Next(LB);
+      out[0] = v.x;
+      out[1] = v.y;
+      break;
+    }
+    case 3: {
+      const glm::vec<3, glm_Float> v = gLuaVec3<>::Next(LB);
+      out[0] = v.x;
+      out[1] = v.y;
+      out[2] = v.z;
+      break;
+    }
+    default: {
+      lua_assert(false);
+      break;
+    }
+  }
+}
+
+static int glm_broadphase_pushpoint(lua_State *L, glm::length_t dims, const glm_Float *v) {
+  switch (dims) {
+    case 1: return gLuaBase::Push(L, v[0]);
+    case 2: return gLuaBase::Push(L, glm::vec<2, glm_Float>(v[0], v[1]));
+    case 3: return gLuaBase::Push(L, glm::vec<3, glm_Float>(v[0], v[1], v[2]));
+    default: {
+      break;
+    }
+  }
+  lua_pushnil(L);
+  return 1;
+}
+
+/// <summary>
+/// Place the pair keys into a flat array of (one-based) proxy identifiers:
+/// { a1, b1, a2, b2, ... }. A table at 'arg' is recycled.
+/// </summary>
+static void glm_broadphase_pushpairs(lua_State *L, int arg, const uint64_t *keys, size_t n, bool skipGLM_SAP_EMPTY) {
+  if (lua_istable(L, arg))
+    lua_pushvalue(L, arg);
+  else if (lua_isnoneornil(L, arg))
+    lua_createtable(L, static_cast<int>(std::min<size_t>(2 * n, INT_MAX)), 0);
+  else
+    gLuaBase::typeerror(L, arg, "table or nil");
+
+  const int t = lua_gettop(L);
+  lua_Integer i = 0;
+  for (size_t k = 0; k < n; ++k) {
+    const uint64_t key = keys[k];
+    if (skipGLM_SAP_EMPTY && key >= GLM_SAP_DELETED)
+      continue;
+
+    lua_pushinteger(L, static_cast<lua_Integer>(key >> 32) + 1);
+    lua_rawseti(L, t, ++i);
+    lua_pushinteger(L, static_cast<lua_Integer>(key & 0xFFFFFFFF) + 1);
+    lua_rawseti(L, t, ++i);
+  }
+
+  // Truncate the array part of a recycled table.
+  for (++i; lua_rawgeti(L, t, i) != LUA_TNIL; ++i) {
+    lua_pop(L, 1);
+    lua_pushnil(L);
+    lua_rawseti(L, t, i);
+  }
+  lua_pop(L, 1);
+}
+
+/// <summary>
+/// glm.broadphase.new([dims]): a broadphase of intervals (1), rectangles (2),
+/// or boxes (3; default).
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_new) {
+  GLM_BINDING_BEGIN
+  const lua_Integer dims = luaL_optinteger(LB.L, 1, 3);
+  luaL_argcheck(LB.L, dims >= 1 && dims <= 3, 1, "invalid dimensions");
+
+  void *ptr = lua_newuserdatauv(LB.L, sizeof(glmBroadphase), 0);
+  ::new (ptr) glmBroadphase(LB.L, static_cast<glm::length_t>(dims));
+  luaL_setmetatable(LB.L, LUAGLM_BROADPHASE);
+  return 1;
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(broadphase_gc) {
+  glmBroadphase *bp = glm_broadphase_check(L, 1);
+  bp->~glmBroadphase();
+  return 0;
+}
+
+GLM_BINDING_QUALIFIER(broadphase_len) {
+  lua_pushinteger(L, static_cast<lua_Integer>(glm_broadphase_check(L, 1)->count));
+  return 1;
+}
+
+GLM_BINDING_QUALIFIER(broadphase_to_string) {
+  const glmBroadphase *bp = glm_broadphase_check(L, 1);
+  lua_pushfstring(L, "Broadphase<%d, %I>", static_cast<int>(bp->dims), static_cast<lua_Integer>(bp->count));
+  return 1;
+}
+
+/// <summary>
+/// broadphase:insert(min, max): returns the proxy identifier.
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_insert) {
+  GLM_BINDING_BEGIN
+  glm_Float min[3], max[3];
+  glmBroadphase *bp = glm_broadphase_check(LB.L, LB.idx++);
+  glm_broadphase_checkpoint(LB, bp->dims, min);
+  glm_broadphase_checkpoint(LB, bp->dims, max);
+  if (bp->freelist.size() == 0 && bp->capacity() >= (UINT32_MAX >> 1))
+    return luaL_error(LB.L, "too many proxies");
+
+  lua_pushinteger(LB.L, static_cast<lua_Integer>(bp->Insert(min, max)) + 1);
+  return 1;
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// broadphase:remove(id): pairs of the proxy are reported as removed by the
+/// next update.
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_remove) {
+  glmBroadphase *bp = glm_broadphase_check(L, 1);
+  bp->Remove(glm_broadphase_checkid(L, 2, bp));
+  lua_settop(L, 1);
+  return 1;
+}
+
+/// <summary>
+/// broadphase:move(id, min, max)
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_move) {
+  GLM_BINDING_BEGIN
+  glm_Float min[3], max[3];
+  glmBroadphase *bp = glm_broadphase_check(LB.L, LB.idx++);
+  const uint32_t proxy = glm_broadphase_checkid(LB.L, LB.idx++, bp);
+  glm_broadphase_checkpoint(LB, bp->dims, min);
+  glm_broadphase_checkpoint(LB, bp->dims, max);
+  bp->SetBounds(proxy, min, max);
+  lua_settop(LB.L, 1);
+  return 1;
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// broadphase:bounds(id): min, max
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_bounds) {
+  glmBroadphase *bp = glm_broadphase_check(L, 1);
+  const glm_Float *b = bp->Bounds(glm_broadphase_checkid(L, 2, bp));
+  glm_broadphase_pushpoint(L, bp->dims, b);
+  glm_broadphase_pushpoint(L, bp->dims, b + bp->dims);
+  return 2;
+}
+
+/// <summary>
+/// broadphase:set(mins, maxs)
+/// broadphase:set(blob) -- packed (min, max) pairs
+///
+/// Replace the bounds of all proxies: the i'th bounds belong to proxy 'i'.
+/// Proxies are created and removed so that identifiers 1 to n are live.
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_set) {
+  GLM_BINDING_BEGIN
+  glmBroadphase *bp = glm_broadphase_check(LB.L, 1);
+  const glm::length_t dims = bp->dims;
+
+  const glm_Float *mins = GLM_NULLPTR;
+  const glm_Float *maxs = GLM_NULLPTR;
+  size_t stride = static_cast<size_t>(dims), n = 0;
+#if defined(LUAGLM_EXT_BLOB)
+  if (lua_isstringblob(LB.L, 2)) {
+    size_t len = 0;
+    mins = reinterpret_cast<const glm_Float *>(lua_tostringblob(LB.L, 2, &len));
+    maxs = mins + dims;
+    stride = 2 * static_cast<size_t>(dims);
+    n = len / (stride * sizeof(glm_Float));
+  }
+  else
+#endif
+  if (dims == 1) {
+    luaL_checktype(LB.L, 2, LUA_TTABLE);
+    n = static_cast<size_t>(lua_rawlen(LB.L, 2));
+    mins = glm_bulk_toscalars(LB.L, 2, n);
+    maxs = glm_bulk_toscalars(LB.L, 3, n);
+  }
+  else {
+    int next = 2;
+    const glmBulkPoints pmin = glm_bulk_topoints(LB.L, 2, next);
+    const glmBulkPoints pmax = glm_bulk_topoints(LB.L, next, next);
+    luaL_argcheck(LB.L, pmin.count == 0 || pmin.dims == dims, 2, "invalid point dimensions");
+    luaL_argcheck(LB.L, pmax.count == pmin.count && (pmax.count == 0 || pmax.dims == dims), 3, "invalid array length");
+    mins = pmin.data;
+    maxs = pmax.data;
+    n = pmin.count;
+  }
+
+  if (n >= (UINT32_MAX >> 1))
+    return luaL_error(LB.L, "too many proxies");
+
+  // Remove proxies beyond 'n' and revive the others.
+  for (size_t i = n; i < bp->capacity(); ++i) {
+    if (bp->alive[i])
+      bp->Remove(static_cast<uint32_t>(i));
+  }
+  bp->Compact();
+  bp->freelist.clear();
+
+  const size_t live = std::min(n, bp->capacity());
+  bp->alive.resize(live);
+  bp->bounds.resize(live * 2 * static_cast<size_t>(dims));
+  for (size_t i = 0; i < live; ++i) {
+    if (bp->alive[i])
+      bp->SetBounds(static_cast<uint32_t>(i), mins + i * stride, maxs + i * stride);
+    else {
+      bp->freelist.push_back(static_cast<uint32_t>(i));
+      bp->Insert(mins + i * stride, maxs + i * stride);
+    }
+  }
+  for (size_t i = live; i < n; ++i)
+    bp->Insert(mins + i * stride, maxs + i * stride);
+
+  lua_settop(LB.L, 1);
+  return 1;
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// broadphase:update([added [, removed]]): sort the endpoints and return the
+/// pairs that began and stopped overlapping since the previous update. Each
+/// result is a flat array of proxy identifiers { a1, b1, a2, b2, ... }; pairs
+/// removed should be processed before pairs added as identifiers are recycled.
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_update) {
+  GLM_BINDING_BEGIN
+  glmBroadphase *bp = glm_broadphase_check(LB.L, 1);
+  bp->Update();
+  glm_broadphase_pushpairs(LB.L, 2, bp->added.data(), bp->added.size(), false);
+  glm_broadphase_pushpairs(LB.L, 3, bp->removed.data(), bp->removed.size(), false);
+  bp->added.clear();
+  bp->removed.clear();
+  return 2;
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// broadphase:pairs([out]): all overlapping pairs as of the last update.
+/// </summary>
+GLM_BINDING_QUALIFIER(broadphase_pairs) {
+  GLM_BINDING_BEGIN
+  glmBroadphase *bp = glm_broadphase_check(LB.L, 1);
+  glm_broadphase_pushpairs(LB.L, 2, bp->pairs.slots.data(), bp->pairs.slots.size(), true);
+  return 1;
+  GLM_BINDING_END
+}
+
+/* }================================================================== */
+
+static const luaL_Reg luaglm_broadphaselib[] = {
+  { "__index", GLM_NULLPTR },  // Placeholder; the metatable is the method table.
+  { "__gc", glm_broadphase_gc },
+  { "__len", glm_broadphase_len },
+  { "__tostring", glm_broadphase_to_string },
+  { "new", glm_broadphase_new },
+  { "insert", glm_broadphase_insert },
+  { "remove", glm_broadphase_remove },
+  { "move", glm_broadphase_move },
+  { "bounds", glm_broadphase_bounds },
+  { "set", glm_broadphase_set },
+  { "update", glm_broadphase_update },
+  { "pairs", glm_broadphase_pairs },
+  { GLM_NULLPTR, GLM_NULLPTR }
+};
+
+#endif
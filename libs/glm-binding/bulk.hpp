@@ -0,0 +1,1432 @@
+/*
+** $Id: bulk.hpp $
+** Bulk Generators: noise fields and pseudo-random vectors evaluated over entire
+** arrays with one function call; and frustum culling of packed bounding volumes.
+**
+** Each generator writes packed glm_Float values to a destination array: a
+** string blob (LUAGLM_EXT_BLOB) is written to directly, while a Lua table is
+** populated with numbers/vectors once generation completes. Arguments are
+** parsed once per call instead of once per sample.
+**
+** See Copyright Notice in lua.h
+*/
+#ifndef BINDING_BULK_HPP
+#define BINDING_BULK_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <limits>
+#include <algorithm>
+
+#include "bindings.hpp"
+#include "iterators.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/noise.hpp>
+#if defined(LUAGLM_BULK_THREADS)
+  #include <atomic>
+  #include <condition_variable>
+  #include <mutex>
+  #include <thread>
+  #include <vector>
+#endif
+
+/*
+@@ LUAGLM_BULK_GRAIN Minimum number of samples before a bulk operation is
+** distributed across the worker pool.
+@@ LUAGLM_BULK_MAXTHREADS Upper bound on the size of the worker pool.
+*/
+#if !defined(LUAGLM_BULK_GRAIN)
+  #define LUAGLM_BULK_GRAIN 4096
+#endif
+
+#if !defined(LUAGLM_BULK_MAXTHREADS)
+  #define LUAGLM_BULK_MAXTHREADS 64
+#endif
+
+/* Metatable of the random stream userdata */
+#define LUAGLM_BULK_RANDOM "GLM_RANDOM"
+
+/// <summary>
+/// A unit of work over the half-open range [begin, end). Tasks must not
+/// interact with a lua_State: they may be invoked from a worker thread.
+/// </summary>
+typedef void (*glmBulkTask)(void *ud, size_t begin, size_t end);
+
+/*
+** {==================================================================
+** Worker Pool
+** ===================================================================
+*/
+
+#if defined(LUAGLM_BULK_THREADS)
+/// <summary>
+/// A persistent fork-join pool shared by all Lua states. The invoking thread
+/// participates in each job and blocks until all chunks are processed.
+///
+/// Workers only ever operate on preallocated buffers, i.e., they do not
+/// allocate (Lua) memory or raise errors.
+/// </summary>
+class glmBulkPool {
+private:
+  std::mutex submit;  // Serialize jobs submitted by different (OS) threads.
+  std::mutex lock;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::vector<std::thread> workers;
+
+  glmBulkTask task = GLM_NULLPTR;
+  void *task_ud = GLM_NULLPTR;
+  size_t task_count = 0;
+  size_t task_chunk = 1;
+  std::atomic<size_t> task_next;
+  size_t pending = 0;  // Number of workers yet to finish the current job.
+  unsigned generation = 0;  // Incremented on each job submission.
+  bool stopping = false;
+
+  /// <summary>
+  /// Claim and process chunks of the current job until it is exhausted.
+  /// </summary>
+  void Run() {
+    size_t begin;
+    while ((begin = task_next.fetch_add(task_chunk)) < task_count) {
+      task(task_ud, begin, std::min(begin + task_chunk, task_count));
+    }
+  }
+
+  void Worker() {
+    unsigned seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        wake.wait(guard, [&] { return stopping || generation != seen; });
+        if (stopping)
+          return;
+        seen = generation;
+      }
+
+      Run();
+
+      std::lock_guard<std::mutex> guard(lock);
+      if (--pending == 0)
+        done.notify_one();
+    }
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : workers)
+      t.join();
+    workers.clear();
+    stopping = false;
+  }
+
+  glmBulkPool()
+    : task_next(0) {
+  }
+
+public:
+  ~glmBulkPool() {
+    Stop();
+  }
+
+  static glmBulkPool &Instance() {
+    static glmBulkPool pool;
+    return pool;
+  }
+
+  /// <summary>
+  /// Number of threads participating in each job (including the caller).
+  /// </summary>
+  size_t size() {
+    std::lock_guard<std::mutex> serial(submit);
+    return workers.size() + 1;
+  }
+
+  /// <summary>
+  /// Resize the pool so that 'threads' threads participate in each job.
+  /// </summary>
+  void Resize(size_t threads) {
+    std::lock_guard<std::mutex> serial(submit);
+    if (threads == workers.size() + 1)
+      return;
+
+    Stop();
+    for (size_t i = 1; i < threads; ++i)
+      workers.emplace_back(&glmBulkPool::Worker, this);
+  }
+
+  /// <summary>
+  /// Invoke 'fn' over [0, count) in chunks of (at most) 'chunk' elements.
+  /// </summary>
+  void ParallelFor(size_t count, size_t chunk, glmBulkTask fn, void *ud) {
+    std::lock_guard<std::mutex> serial(submit);
+    if (workers.empty() || count <= chunk) {
+      fn(ud, 0, count);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      task = fn;
+      task_ud = ud;
+      task_count = count;
+      task_chunk = chunk;
+      task_next.store(0);
+      pending = workers.size();
+      generation++;
+    }
+    wake.notify_all();
+
+    Run();
+
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [&] { return pending == 0; });
+  }
+};
+#endif
+
+/// <summary>
+/// Invoke 'task' over [0, n); where 'work' is the approximate number of samples
+/// generated by each element, e.g., the length of a lattice row.
+/// </summary>
+static void glm_bulk_for(size_t n, size_t work, glmBulkTask task, void *ud) {
+#if defined(LUAGLM_BULK_THREADS)
+  glmBulkPool &pool = glmBulkPool::Instance();
+  const size_t threads = pool.size();
+  if (threads > 1 && n > 1 && n >= (LUAGLM_BULK_GRAIN / std::max<size_t>(work, 1))) {
+    const size_t chunk = std::max<size_t>(1, n / (threads * 4));
+    pool.ParallelFor(n, chunk, task, ud);
+    return;
+  }
+#else
+  ((void)work);
+#endif
+  task(ud, 0, n);
+}
+
+/* }================================================================== */
+
+/*
+** {==================================================================
+** Arrays
+** ===================================================================
+*/
+
+/// <summary>
+/// How the elements of a bulk array are represented in a Lua table.
+/// </summary>
+enum glmBulkElement {
+  GLM_BULK_VECTOR,  // number or vector (dims <= 4)
+  GLM_BULK_QUAT,  // quaternion, packed w, x, y, z (dims = 4)
+  GLM_BULK_MAT4,  // column-major 4x4 matrix (dims = 16)
+};
+
+/// <summary>
+/// Destination of a bulk operation: 'count' elements of 'dims' glm_Float values.
+///
+/// A blob destination is written to directly; if the blob is too small then a
+/// new blob is created (see string.blob_pack). A table destination, or a new
+/// table when no destination is provided, is generated into a scratch userdata
+/// that is unpacked into the table by Push. Matrices already stored in the
+/// table are updated in place.
+/// </summary>
+struct glmBulkArray {
+  lua_State *L;
+  int idx;  // Absolute stack index of the destination object.
+  size_t count;  // Number of elements.
+  glm::length_t dims;  // Number of components per element.
+  glmBulkElement element;
+  glm_Float *data;
+  bool table;
+
+  glmBulkArray(lua_State *L_, int arg, size_t count_, glm::length_t dims_, glmBulkElement element_ = GLM_BULK_VECTOR)
+    : L(L_), idx(0), count(count_), dims(dims_), element(element_), data(GLM_NULLPTR), table(true) {
+    if (count_ > ((std::numeric_limits<size_t>::max)() / sizeof(glm_Float)) / static_cast<size_t>(dims_))
+      luaL_error(L_, "bulk array too large");
+
+    const size_t bytes = count_ * static_cast<size_t>(dims_) * sizeof(glm_Float);
+    switch (lua_type(L_, arg)) {
+      case LUA_TNONE:
+      case LUA_TNIL:
+        lua_createtable(L_, static_cast<int>(std::min<size_t>(count_, INT_MAX)), 0);
+        break;
+      case LUA_TTABLE:
+        lua_pushvalue(L_, arg);
+        break;
+#if defined(LUAGLM_EXT_BLOB)
+      case LUA_TSTRING:
+        if (lua_isstringblob(L_, arg)) {
+          size_t len = 0;
+          char *blob = lua_tostringblob(L_, arg, &len);
+          if (len >= bytes)
+            lua_pushvalue(L_, arg);
+          else
+            blob = lua_pushblob(L_, bytes);
+
+          lua_assert(reinterpret_cast<uintptr_t>(blob) % alignof(glm_Float) == 0);
+          data = reinterpret_cast<glm_Float *>(blob);
+          table = false;
+          break;
+        }
+        LUAGLM_FALLTHROUGH;
+#endif
+      default:
+        gLuaBase::typeerror(L_, arg, "table or blob");
+        break;
+    }
+
+    idx = lua_gettop(L_);
+    if (table)  // Scratch buffer; collected once the table is populated.
+      data = static_cast<glm_Float *>(lua_newuserdatauv(L_, bytes, 0));
+  }
+
+  /// <summary>
+  /// Store a 4x4 matrix at t[i]: an existing matrix is overwritten instead of
+  /// allocating a new collectible.
+  /// </summary>
+  void PushMatrix(lua_Integer i, const glm_Float *v) {
+    const glm::mat<4, 4, glm_Float> m(
+      v[0], v[1], v[2], v[3],
+      v[4], v[5], v[6], v[7],
+      v[8], v[9], v[10], v[11],
+      v[12], v[13], v[14], v[15]
+    );
+
+    if (lua_rawgeti(L, idx, i) == LUA_TMATRIX) {
+      lua_lock(L);
+      glm_mat_boundary(mvalue_ref(s2v(L->top - 1))) = glm_mat_realign(m, 4, 4, glm_Float, LUAGLM_Q);
+      lua_unlock(L);
+      lua_pop(L, 1);
+      return;
+    }
+
+    lua_pop(L, 1);
+    glm_pushmat(L, glmMatrix(m));
+    lua_rawseti(L, idx, i);
+  }
+
+  /// <summary>
+  /// Place the destination object on top of the stack; unpacking the generated
+  /// values into it if it is a table.
+  /// </summary>
+  int Push() {
+    if (table) {
+      const glm_Float *v = data;
+      for (size_t i = 0; i < count; ++i, v += dims) {
+        if (element == GLM_BULK_MAT4) {
+          PushMatrix(static_cast<lua_Integer>(i + 1), v);
+          continue;
+        }
+
+        switch (element == GLM_BULK_QUAT ? 0 : dims) {
+          case 0: gLuaBase::Push(L, glm::qua<glm_Float>(v[0], v[1], v[2], v[3])); break;
+          case 1: lua_pushnumber(L, static_cast<lua_Number>(v[0])); break;
+          case 2: gLuaBase::Push(L, glm::vec<2, glm_Float>(v[0], v[1])); break;
+          case 3: gLuaBase::Push(L, glm::vec<3, glm_Float>(v[0], v[1], v[2])); break;
+          case 4: gLuaBase::Push(L, glm::vec<4, glm_Float>(v[0], v[1], v[2], v[3])); break;
+          default: {
+            lua_assert(false);
+            lua_pushnil(L);
+            break;
+          }
+        }
+        lua_rawseti(L, idx, static_cast<lua_Integer>(i + 1));
+      }
+
+      // Truncate the array part of a recycled table.
+      for (lua_Integer i = static_cast<lua_Integer>(count) + 1; lua_rawgeti(L, idx, i) != LUA_TNIL; ++i) {
+        lua_pop(L, 1);
+        lua_pushnil(L);
+        lua_rawseti(L, idx, i);
+      }
+      lua_pop(L, 1);
+    }
+
+    lua_settop(L, idx);
+    return 1;
+  }
+};
+
+/// <summary>
+/// Source of a bulk operation: a table of vectors, or a blob of packed
+/// glm_Float coordinates with 'dims' components per point.
+/// </summary>
+struct glmBulkPoints {
+  const glm_Float *data;
+  size_t count;
+  glm::length_t dims;
+};
+
+template<glm::length_t D>
+static void glm_bulk_unpack(lua_State *L, int arg, glm_Float *dest) {
+  glmLuaArray<gLuaTrait<glm::vec<D, glm_Float>>> array(L, arg);
+  const auto e = array.end();
+  for (auto b = array.begin(); b != e; ++b, dest += D) {
+    const glm::vec<D, glm_Float> v = *b;
+    for (glm::length_t c = 0; c < D; ++c)
+      dest[c] = v[c];
+  }
+}
+
+/// <summary>
+/// Parse the array of points at 'arg'; 'next' is updated to reference the
+/// first argument after the point array description.
+/// </summary>
+static glmBulkPoints glm_bulk_topoints(lua_State *L, int arg, int &next) {
+  glmBulkPoints points = { GLM_NULLPTR, 0, 2 };
+  next = arg + 1;
+  if (lua_istable(L, arg)) {
+    points.count = static_cast<size_t>(lua_rawlen(L, arg));
+    if (points.count > 0) {
+      lua_rawgeti(L, arg, 1);
+      points.dims = glm_vector_length(L, lua_gettop(L));
+      lua_pop(L, 1);
+      if (points.dims < 2 || points.dims > 4)
+        luaL_error(L, "Invalid table index: %d for %s", 1, GLM_STRING_VECTOR);
+    }
+
+    // Packed copy of the table; anchored on the stack for the call duration.
+    const size_t bytes = points.count * static_cast<size_t>(points.dims) * sizeof(glm_Float);
+    glm_Float *dest = static_cast<glm_Float *>(lua_newuserdatauv(L, bytes, 0));
+    switch (points.dims) {
+      case 2: glm_bulk_unpack<2>(L, arg, dest); break;
+      case 3: glm_bulk_unpack<3>(L, arg, dest); break;
+      case 4: glm_bulk_unpack<4>(L, arg, dest); break;
+      default: break;
+    }
+    points.data = dest;
+  }
+#if defined(LUAGLM_EXT_BLOB)
+  else if (lua_isstringblob(L, arg)) {
+    const lua_Integer dims = luaL_checkinteger(L, arg + 1);
+    luaL_argcheck(L, dims >= 2 && dims <= 4, arg + 1, "invalid point dimensions");
+
+    size_t len = 0;
+    points.dims = static_cast<glm::length_t>(dims);
+    points.data = reinterpret_cast<const glm_Float *>(lua_tostringblob(L, arg, &len));
+    points.count = len / (static_cast<size_t>(dims) * sizeof(glm_Float));
+    next = arg + 2;
+  }
+#endif
+  else {
+    gLuaBase::typeerror(L, arg, "table or blob");
+  }
+  return points;
+}
+
+/* }================================================================== */
+
+/*
+** {==================================================================
+** Noise
+** ===================================================================
+*/
+
+struct glmBulkPerlin {
+  template<glm::length_t D>
+  GLM_INLINE glm_Float operator()(const glm::vec<D, glm_Float> &p) const {
+    return glm::perlin(p);
+  }
+};
+
+struct glmBulkSimplex {
+  template<glm::length_t D>
+  GLM_INLINE glm_Float operator()(const glm::vec<D, glm_Float> &p) const {
+    return glm::simplex(p);
+  }
+};
+
+/// <summary>
+/// Noise evaluated over a two or three-dimensional lattice. Samples are stored
+/// in row-major order (the x-axis being contiguous) and rows are distributed
+/// across the worker pool.
+/// </summary>
+template<glm::length_t D, typename Noise>
+struct glmBulkLattice {
+  glm_Float *out;
+  glm::vec<D, glm_Float> origin;
+  glm::vec<D, glm_Float> step;
+  size_t nx;  // Samples per row.
+  size_t ny;  // Rows per slice.
+
+  static void Rows(void *ud, size_t begin, size_t end) {
+    const glmBulkLattice *self = static_cast<const glmBulkLattice *>(ud);
+    const Noise noise = Noise();
+    for (size_t r = begin; r < end; ++r) {
+      glm::vec<D, glm_Float> p = self->origin;
+      p[1] += self->step[1] * static_cast<glm_Float>(r % self->ny);
+      GLM_IF_CONSTEXPR(D > 2) {
+        p[D - 1] += self->step[D - 1] * static_cast<glm_Float>(r / self->ny);
+      }
+
+      glm_Float *row = self->out + r * self->nx;
+      for (size_t x = 0; x < self->nx; ++x) {
+        p.x = self->origin.x + self->step.x * static_cast<glm_Float>(x);
+        row[x] = noise(p);
+      }
+    }
+  }
+};
+
+/// <summary>
+/// Noise evaluated over an array of packed points.
+/// </summary>
+template<glm::length_t D, typename Noise>
+struct glmBulkSamples {
+  glm_Float *out;
+  const glm_Float *points;
+
+  static void Range(void *ud, size_t begin, size_t end) {
+    const glmBulkSamples *self = static_cast<const glmBulkSamples *>(ud);
+    const Noise noise = Noise();
+    const glm_Float *src = self->points + begin * D;
+    for (size_t i = begin; i < end; ++i, src += D) {
+      glm::vec<D, glm_Float> p;
+      for (glm::length_t c = 0; c < D; ++c)
+        p[c] = src[c];
+      self->out[i] = noise(p);
+    }
+  }
+};
+
+template<glm::length_t D, typename Noise>
+static int glm_bulk_lattice(gLuaBase &LB) {
+  using Tr = gLuaTrait<glm::vec<D, glm_Float>>;
+  const int size_idx = LB.idx;
+  const glm::vec<D, glm_Float> size = Tr::Next(LB);
+  const glm::vec<D, glm_Float> origin = Tr::Next(LB);
+  glm::vec<D, glm_Float> step(1);
+  if (gLuaFloat::Is(LB.L, LB.idx))
+    step = glm::vec<D, glm_Float>(gLuaFloat::Next(LB));
+  else
+    step = Tr::Next(LB);
+
+  size_t extent[3] = { 1, 1, 1 };
+  size_t count = 1;
+  for (glm::length_t c = 0; c < D; ++c) {
+    if (!(size[c] >= glm_Float(0)) || size[c] >= static_cast<glm_Float>(INT_MAX))
+      return luaL_argerror(LB.L, size_idx, "invalid lattice dimensions");
+
+    extent[c] = static_cast<size_t>(size[c]);
+    if (extent[c] != 0 && count > (std::numeric_limits<size_t>::max)() / extent[c])
+      return luaL_argerror(LB.L, size_idx, "lattice too large");
+    count *= extent[c];
+  }
+
+  glmBulkArray out(LB.L, LB.idx, count, 1);
+  if (count > 0) {
+    glmBulkLattice<D, Noise> task;
+    task.out = out.data;
+    task.origin = origin;
+    task.step = step;
+    task.nx = extent[0];
+    task.ny = extent[1];
+    glm_bulk_for(extent[1] * extent[2], extent[0], &glmBulkLattice<D, Noise>::Rows, &task);
+  }
+  return out.Push();
+}
+
+template<glm::length_t D, typename Noise>
+static int glm_bulk_samples(lua_State *L, const glmBulkPoints &points, int out_idx) {
+  glmBulkArray out(L, out_idx, points.count, 1);
+  if (out.data == points.data)  // Output may not overlap with the input.
+    return luaL_argerror(L, out_idx, "destination aliases the sample points");
+
+  if (points.count > 0) {
+    glmBulkSamples<D, Noise> task;
+    task.out = out.data;
+    task.points = points.data;
+    glm_bulk_for(points.count, 1, &glmBulkSamples<D, Noise>::Range, &task);
+  }
+  return out.Push();
+}
+
+/// <summary>
+/// bulk.noise(size, origin, step [, out]) -- lattice
+/// bulk.noise(points [, out]) -- table of vectors
+/// bulk.noise(blob, dims [, out]) -- packed points
+/// </summary>
+template<typename Noise>
+static int glm_bulk_noise(lua_State *L) {
+  GLM_BINDING_BEGIN
+  switch (glm_vector_length(LB.L, LB.idx)) {
+    case 2: return glm_bulk_lattice<2, Noise>(LB);
+    case 3: return glm_bulk_lattice<3, Noise>(LB);
+    default: {
+      int next = LB.idx;
+      const glmBulkPoints points = glm_bulk_topoints(LB.L, LB.idx, next);
+      switch (points.dims) {
+        case 2: return glm_bulk_samples<2, Noise>(LB.L, points, next);
+        case 3: return glm_bulk_samples<3, Noise>(LB.L, points, next);
+        case 4: return glm_bulk_samples<4, Noise>(LB.L, points, next);
+        default:
+          break;
+      }
+      break;
+    }
+  }
+  return luaL_argerror(LB.L, 1, "invalid sample dimensions");
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(bulk_perlin) {
+  return glm_bulk_noise<glmBulkPerlin>(L);
+}
+
+GLM_BINDING_QUALIFIER(bulk_simplex) {
+  return glm_bulk_noise<glmBulkSimplex>(L);
+}
+
+GLM_BINDING_QUALIFIER(bulk_threads) {
+#if defined(LUAGLM_BULK_THREADS)
+  glmBulkPool &pool = glmBulkPool::Instance();
+  if (!lua_isnoneornil(L, 1)) {
+    lua_Integer threads = luaL_checkinteger(L, 1);
+    luaL_argcheck(L, threads >= 0 && threads <= LUAGLM_BULK_MAXTHREADS, 1, "invalid thread count");
+    if (threads == 0)  // Use all available hardware threads.
+      threads = std::min<lua_Integer>(std::max<lua_Integer>(std::thread::hardware_concurrency(), 1), LUAGLM_BULK_MAXTHREADS);
+    pool.Resize(static_cast<size_t>(threads));
+  }
+  lua_pushinteger(L, static_cast<lua_Integer>(pool.size()));
+#else
+  lua_pushinteger(L, 1);
+#endif
+  return 1;
+}
+
+/* }================================================================== */
+
+/*
+** {==================================================================
+** Random
+** ===================================================================
+*/
+
+/// <summary>
+/// A reproducible pseudo-random stream: four interleaved xoshiro128+
+/// generators advanced in lock-step. Uniform variates are produced four at a
+/// time (the state update is trivially vectorized) and consumed in order, i.e.,
+/// the stream is independent of how it is partitioned between calls.
+/// </summary>
+struct glmBulkRandom {
+  enum { Lanes = 4 };
+
+  uint32_t s0[Lanes];
+  uint32_t s1[Lanes];
+  uint32_t s2[Lanes];
+  uint32_t s3[Lanes];
+  uint32_t block[Lanes];  // Output of the most recent step.
+  size_t next;  // Index of the next unconsumed value in 'block'.
+
+  static GLM_INLINE uint64_t SplitMix(uint64_t &x) {
+    uint64_t z = (x += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+  }
+
+  /// <summary>
+  /// Uniform variate in [0, 1) with 24 bits of resolution.
+  /// </summary>
+  static GLM_INLINE glm_Float ToFloat(uint32_t x) {
+    return static_cast<glm_Float>(x >> 8) * static_cast<glm_Float>(1.0 / 16777216.0);
+  }
+
+  void Seed(lua_Integer seed) {
+    uint64_t x = static_cast<uint64_t>(seed);
+    for (size_t i = 0; i < Lanes; ++i) {
+      const uint64_t a = SplitMix(x);
+      const uint64_t b = SplitMix(x);
+      s0[i] = static_cast<uint32_t>(a);
+      s1[i] = static_cast<uint32_t>(a >> 32);
+      s2[i] = static_cast<uint32_t>(b);
+      s3[i] = static_cast<uint32_t>(b >> 32);
+      if ((s0[i] | s1[i] | s2[i] | s3[i]) == 0)  // The all-zero state is absorbing
+        s0[i] = 1;
+    }
+    next = Lanes;
+  }
+
+  GLM_INLINE void Step(uint32_t *out) {
+    for (size_t i = 0; i < Lanes; ++i) {
+      const uint32_t t = s1[i] << 9;
+      out[i] = s0[i] + s3[i];
+      s2[i] ^= s0[i];
+      s3[i] ^= s1[i];
+      s1[i] ^= s2[i];
+      s0[i] ^= s3[i];
+      s2[i] ^= t;
+      s3[i] = (s3[i] << 11) | (s3[i] >> 21);
+    }
+  }
+
+  /// <summary>
+  /// Populate 'out' with 'n' uniform variates.
+  /// </summary>
+  void Uniform(glm_Float *out, size_t n) {
+    size_t i = 0;
+    while (i < n && next < Lanes)
+      out[i++] = ToFloat(block[next++]);
+
+    uint32_t tmp[Lanes];
+    for (; i + Lanes <= n; i += Lanes) {
+      Step(tmp);
+      for (size_t j = 0; j < Lanes; ++j)
+        out[i + j] = ToFloat(tmp[j]);
+    }
+
+    if (i < n) {
+      Step(block);
+      next = 0;
+      while (i < n)
+        out[i++] = ToFloat(block[next++]);
+    }
+  }
+};
+
+static glmBulkRandom *glm_bulk_torandom(lua_State *L, int idx) {
+  return static_cast<glmBulkRandom *>(luaL_checkudata(L, idx, LUAGLM_BULK_RANDOM));
+}
+
+static size_t glm_bulk_checkcount(lua_State *L, int arg) {
+  const lua_Integer n = luaL_checkinteger(L, arg);
+  luaL_argcheck(L, n >= 0 && static_cast<lua_Unsigned>(n) <= (std::numeric_limits<size_t>::max)(), arg, "invalid element count");
+  return static_cast<size_t>(n);
+}
+
+/// <summary>
+/// Return the dimensions of the number/vector distribution parameter at 'arg'.
+/// </summary>
+static glm::length_t glm_bulk_dims(lua_State *L, int arg) {
+  if (gLuaFloat::Is(L, arg))
+    return 1;
+
+  const glm::length_t dims = glm_vector_length(L, arg);
+  if (dims < 2 || dims > 4)
+    gLuaBase::typeerror(L, arg, GLM_STRING_NUMBER " or " GLM_STRING_VECTOR);
+  return dims;
+}
+
+/// <summary>
+/// Parse a distribution parameter: numbers are broadcast to all components.
+/// </summary>
+template<glm::length_t D>
+static glm::vec<D, glm_Float> glm_bulk_checkvec(gLuaBase &LB) {
+  if (gLuaFloat::Is(LB.L, LB.idx))
+    return glm::vec<D, glm_Float>(gLuaFloat::Next(LB));
+  return gLuaTrait<glm::vec<D, glm_Float>>::Next(LB);
+}
+
+static glm_Float glm_bulk_checkradius(lua_State *L, int arg) {
+  gLuaBase LB(L, arg);
+  const glm_Float radius = gLuaFloat::Next(LB);
+  luaL_argcheck(L, radius > glm_Float(0), arg, "radius must be positive");  // @GLMAssert
+  return radius;
+}
+
+template<glm::length_t D>
+static int glm_bulk_linearRand(lua_State *L, glmBulkRandom *rng, size_t count) {
+  gLuaBase LB(L, 3);
+  const glm::vec<D, glm_Float> minv = glm_bulk_checkvec<D>(LB);
+  const glm::vec<D, glm_Float> range = glm_bulk_checkvec<D>(LB) - minv;
+
+  glmBulkArray out(L, LB.idx, count, D);
+  glm_Float *v = out.data;
+  rng->Uniform(v, count * D);
+  for (size_t i = 0; i < count; ++i, v += D) {
+    for (glm::length_t c = 0; c < D; ++c)
+      v[c] = minv[c] + range[c] * v[c];
+  }
+  return out.Push();
+}
+
+/// <summary>
+/// @NOTE: Mirrors glm::gaussRand, i.e., normal variates are scaled by the
+/// square of 'deviation'. Variates are generated with the Box-Muller transform
+/// (instead of rejection sampling) so each sample consumes a fixed number of
+/// uniform variates.
+/// </summary>
+template<glm::length_t D>
+static int glm_bulk_gaussRand(lua_State *L, glmBulkRandom *rng, size_t count) {
+  gLuaBase LB(L, 3);
+  const glm::vec<D, glm_Float> mean = glm_bulk_checkvec<D>(LB);
+  const glm::vec<D, glm_Float> deviation = glm_bulk_checkvec<D>(LB);
+  const glm::vec<D, glm_Float> scale = deviation * deviation;
+
+  glmBulkArray out(L, LB.idx, count, D);
+  glm_Float *v = out.data;
+  const size_t n = count * D;
+  rng->Uniform(v, n);
+  for (size_t i = 0; i + 1 < n; i += 2) {
+    const glm_Float r = glm::sqrt(glm_Float(-2) * glm::log(glm_Float(1) - v[i]));
+    const glm_Float theta = glm::two_pi<glm_Float>() * v[i + 1];
+    v[i] = r * glm::cos(theta);
+    v[i + 1] = r * glm::sin(theta);
+  }
+
+  if ((n & 1) != 0) {
+    glm_Float u;
+    rng->Uniform(&u, 1);
+    v[n - 1] = glm::sqrt(glm_Float(-2) * glm::log(glm_Float(1) - v[n - 1])) * glm::cos(glm::two_pi<glm_Float>() * u);
+  }
+
+  for (size_t i = 0; i < count; ++i, v += D) {
+    for (glm::length_t c = 0; c < D; ++c)
+      v[c] = mean[c] + scale[c] * v[c];
+  }
+  return out.Push();
+}
+
+/*
+** Bulk random API: rng:function(count, ... [, out])
+*/
+
+GLM_BINDING_QUALIFIER(bulk_random) {
+  glmBulkRandom *rng = static_cast<glmBulkRandom *>(lua_newuserdatauv(L, sizeof(glmBulkRandom), 0));
+  rng->Seed(luaL_optinteger(L, 1, 0));
+  luaL_setmetatable(L, LUAGLM_BULK_RANDOM);
+  return 1;
+}
+
+GLM_BINDING_QUALIFIER(random_seed) {
+  glm_bulk_torandom(L, 1)->Seed(luaL_optinteger(L, 2, 0));
+  lua_settop(L, 1);
+  return 1;
+}
+
+GLM_BINDING_QUALIFIER(random_to_string) {
+  lua_pushfstring(L, "Random<%p>", static_cast<void *>(glm_bulk_torandom(L, 1)));
+  return 1;
+}
+
+GLM_BINDING_QUALIFIER(random_linearRand) {
+  GLM_BINDING_BEGIN
+  glmBulkRandom *rng = glm_bulk_torandom(LB.L, 1);
+  const size_t count = glm_bulk_checkcount(LB.L, 2);
+  switch (glm_bulk_dims(LB.L, 3)) {
+    case 1: return glm_bulk_linearRand<1>(LB.L, rng, count);
+    case 2: return glm_bulk_linearRand<2>(LB.L, rng, count);
+    case 3: return glm_bulk_linearRand<3>(LB.L, rng, count);
+    case 4: return glm_bulk_linearRand<4>(LB.L, rng, count);
+    default:
+      break;
+  }
+  return luaL_argerror(LB.L, 3, "invalid dimensions");
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(random_gaussRand) {
+  GLM_BINDING_BEGIN
+  glmBulkRandom *rng = glm_bulk_torandom(LB.L, 1);
+  const size_t count = glm_bulk_checkcount(LB.L, 2);
+  switch (glm_bulk_dims(LB.L, 3)) {
+    case 1: return glm_bulk_gaussRand<1>(LB.L, rng, count);
+    case 2: return glm_bulk_gaussRand<2>(LB.L, rng, count);
+    case 3: return glm_bulk_gaussRand<3>(LB.L, rng, count);
+    case 4: return glm_bulk_gaussRand<4>(LB.L, rng, count);
+    default:
+      break;
+  }
+  return luaL_argerror(LB.L, 3, "invalid dimensions");
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(random_circularRand) {
+  GLM_BINDING_BEGIN
+  glmBulkRandom *rng = glm_bulk_torandom(LB.L, 1);
+  const size_t count = glm_bulk_checkcount(LB.L, 2);
+  const glm_Float radius = glm_bulk_checkradius(LB.L, 3);
+
+  glmBulkArray out(LB.L, 4, count, 2);
+  glm_Float *v = out.data;
+  rng->Uniform(v, count * 2);
+  for (size_t i = 0; i < count; ++i, v += 2) {
+    const glm_Float theta = glm::two_pi<glm_Float>() * v[0];
+    v[0] = radius * glm::cos(theta);
+    v[1] = radius * glm::sin(theta);
+  }
+  return out.Push();
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(random_diskRand) {
+  GLM_BINDING_BEGIN
+  glmBulkRandom *rng = glm_bulk_torandom(LB.L, 1);
+  const size_t count = glm_bulk_checkcount(LB.L, 2);
+  const glm_Float radius = glm_bulk_checkradius(LB.L, 3);
+
+  glmBulkArray out(LB.L, 4, count, 2);
+  glm_Float *v = out.data;
+  rng->Uniform(v, count * 2);
+  for (size_t i = 0; i < count; ++i, v += 2) {
+    const glm_Float r = radius * glm::sqrt(v[0]);
+    const glm_Float theta = glm::two_pi<glm_Float>() * v[1];
+    v[0] = r * glm::cos(theta);
+    v[1] = r * glm::sin(theta);
+  }
+  return out.Push();
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// Uniformly distributed points on a sphere: each sample consumes three uniform
+/// variates, the first two are used for its direction and the third for its
+/// distance from the origin (ballRand).
+/// </summary>
+template<bool Ball>
+static int glm_bulk_sphericalRand(lua_State *L) {
+  glmBulkRandom *rng = glm_bulk_torandom(L, 1);
+  const size_t count = glm_bulk_checkcount(L, 2);
+  const glm_Float radius = glm_bulk_checkradius(L, 3);
+
+  glmBulkArray out(L, 4, count, 3);
+  glm_Float *v = out.data;
+  rng->Uniform(v, count * 3);
+  for (size_t i = 0; i < count; ++i, v += 3) {
+    const glm_Float theta = glm::two_pi<glm_Float>() * v[0];
+    const glm_Float z = glm_Float(2) * v[1] - glm_Float(1);
+    const glm_Float r = glm::sqrt(glm::max(glm_Float(1) - z * z, glm_Float(0)));
+    const glm_Float len = Ball ? radius * glm::pow(v[2], glm_Float(1) / glm_Float(3)) : radius;
+    v[0] = len * r * glm::cos(theta);
+    v[1] = len * r * glm::sin(theta);
+    v[2] = len * z;
+  }
+  return out.Push();
+}
+
+GLM_BINDING_QUALIFIER(random_sphericalRand) {
+  GLM_BINDING_BEGIN
+  return glm_bulk_sphericalRand<false>(LB.L);
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(random_ballRand) {
+  GLM_BINDING_BEGIN
+  return glm_bulk_sphericalRand<true>(LB.L);
+  GLM_BINDING_END
+}
+
+/* }================================================================== */
+
+/*
+** {==================================================================
+** Frustum Culling
+** ===================================================================
+*/
+
+/* Number of volumes classified per block: one bit of a uint64_t per volume */
+#define LUAGLM_CULL_BLOCK 64
+
+/* Maximum number of planes of a culling volume */
+#define LUAGLM_CULL_PLANES 8
+
+/// <summary>
+/// Planes of a convex culling volume stored as a structure of arrays. The
+/// signed distance of a point to a plane is dot(normal, p) - d and is positive
+/// on the inside of the volume, i.e., the same convention as glm::Plane.
+/// </summary>
+template<typename T>
+struct glmFrustum {
+  T nx[LUAGLM_CULL_PLANES];
+  T ny[LUAGLM_CULL_PLANES];
+  T nz[LUAGLM_CULL_PLANES];
+  T d[LUAGLM_CULL_PLANES];
+  int count;
+
+  void Add(T x, T y, T z, T offset) {
+    nx[count] = x;
+    ny[count] = y;
+    nz[count] = z;
+    d[count] = offset;
+    count++;
+  }
+
+  /// <summary>
+  /// Add the half-space a*x + b*y + c*z + w >= 0; degenerate planes, e.g., the
+  /// far plane of an infinite perspective projection, are ignored.
+  /// </summary>
+  void AddEquation(T a, T b, T c, T w) {
+    const T len = glm::sqrt(a * a + b * b + c * c);
+    if (len > glm::epsilon<T>()) {
+      const T inv = T(1) / len;
+      Add(a * inv, b * inv, c * inv, -w * inv);
+    }
+  }
+};
+
+/// <summary>
+/// A block of culling volumes: centers and half-extents (AABB) or centers and
+/// radii (sphere; stored in 'ex'). The block is padded with zeros to a
+/// multiple of four volumes.
+/// </summary>
+template<typename T>
+struct glmCullBlock {
+  T cx[LUAGLM_CULL_BLOCK], cy[LUAGLM_CULL_BLOCK], cz[LUAGLM_CULL_BLOCK];
+  T ex[LUAGLM_CULL_BLOCK], ey[LUAGLM_CULL_BLOCK], ez[LUAGLM_CULL_BLOCK];
+};
+
+/// <summary>
+/// Extract the planes of a view-projection matrix (Gribb & Hartmann).
+/// </summary>
+template<typename T>
+static void glm_frustum_extract(const glm::mat<4, 4, T> &m, glmFrustum<T> &f) {
+  const glm::vec<4, T> r0 = glm::row(m, 0);
+  const glm::vec<4, T> r1 = glm::row(m, 1);
+  const glm::vec<4, T> r2 = glm::row(m, 2);
+  const glm::vec<4, T> r3 = glm::row(m, 3);
+#if defined(GLM_CLIP_CONTROL_ZO_BIT) && (GLM_CONFIG_CLIP_CONTROL & GLM_CLIP_CONTROL_ZO_BIT)
+  const glm::vec<4, T> nearPlane = r2;
+#else
+  const glm::vec<4, T> nearPlane = r3 + r2;
+#endif
+  const glm::vec<4, T> planes[6] = {
+    r3 + r0, r3 - r0,  // left, right
+    r3 + r1, r3 - r1,  // bottom, top
+    nearPlane, r3 - r2,  // near, far
+  };
+
+  f.count = 0;
+  for (int i = 0; i < 6; ++i)
+    f.AddEquation(planes[i].x, planes[i].y, planes[i].z, planes[i].w);
+}
+
+/// <summary>
+/// Classify a block of 'n' volumes against the planes set in 'planes'; returning
+/// a mask with a bit set for each volume that is not outside of a plane.
+/// </summary>
+template<typename T>
+struct glmCullKernel {
+  template<bool Sphere>
+  static uint64_t Test(const glmFrustum<T> &f, unsigned planes, const glmCullBlock<T> &b, size_t n) {
+    unsigned char visible[LUAGLM_CULL_BLOCK];
+    for (size_t i = 0; i < n; ++i)
+      visible[i] = 1;
+
+    for (int p = 0; p < f.count; ++p) {
+      if (planes & (1u << p)) {
+        const T nx = f.nx[p], ny = f.ny[p], nz = f.nz[p], d = f.d[p];
+        const T ax = glm::abs(nx), ay = glm::abs(ny), az = glm::abs(nz);
+        for (size_t i = 0; i < n; ++i) {
+          const T dist = nx * b.cx[i] + ny * b.cy[i] + nz * b.cz[i] - d;
+          const T r = Sphere ? b.ex[i] : (ax * b.ex[i] + ay * b.ey[i] + az * b.ez[i]);
+          visible[i] &= static_cast<unsigned char>(dist + r >= T(0));
+        }
+      }
+    }
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; ++i)
+      mask |= static_cast<uint64_t>(visible[i]) << i;
+    return mask;
+  }
+};
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+template<>
+struct glmCullKernel<float> {
+  template<bool Sphere>
+  static uint64_t Test(const glmFrustum<float> &f, unsigned planes, const glmCullBlock<float> &b, size_t n) {
+    const size_t n4 = (n + 3) & ~static_cast<size_t>(3);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    __m128 visible[LUAGLM_CULL_BLOCK / 4];
+    for (size_t i = 0; i < n4; i += 4)
+      visible[i >> 2] = _mm_cmpeq_ps(zero, zero);
+
+    for (int p = 0; p < f.count; ++p) {
+      if (planes & (1u << p)) {
+        const __m128 nx = _mm_set1_ps(f.nx[p]), ny = _mm_set1_ps(f.ny[p]), nz = _mm_set1_ps(f.nz[p]);
+        const __m128 ax = _mm_andnot_ps(sign, nx), ay = _mm_andnot_ps(sign, ny), az = _mm_andnot_ps(sign, nz);
+        const __m128 d = _mm_set1_ps(f.d[p]);
+        for (size_t i = 0; i < n4; i += 4) {
+          __m128 dist = _mm_mul_ps(nx, _mm_loadu_ps(b.cx + i));
+          dist = _mm_add_ps(dist, _mm_mul_ps(ny, _mm_loadu_ps(b.cy + i)));
+          dist = _mm_add_ps(dist, _mm_mul_ps(nz, _mm_loadu_ps(b.cz + i)));
+          dist = _mm_sub_ps(dist, d);
+
+          __m128 r = _mm_loadu_ps(b.ex + i);
+          if (!Sphere) {
+            r = _mm_mul_ps(ax, r);
+            r = _mm_add_ps(r, _mm_mul_ps(ay, _mm_loadu_ps(b.ey + i)));
+            r = _mm_add_ps(r, _mm_mul_ps(az, _mm_loadu_ps(b.ez + i)));
+          }
+          visible[i >> 2] = _mm_and_ps(visible[i >> 2], _mm_cmpge_ps(_mm_add_ps(dist, r), zero));
+        }
+      }
+    }
+
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n4; i += 4)
+      mask |= static_cast<uint64_t>(_mm_movemask_ps(visible[i >> 2])) << i;
+    return (n < 64) ? (mask & ((static_cast<uint64_t>(1) << n) - 1)) : mask;
+  }
+};
+#endif
+
+/// <summary>
+/// Packed culling volumes: AABBs stored as (minimum, maximum) pairs or spheres
+/// stored as (center, radius) pairs; 'stride' is in glm_Float values.
+/// </summary>
+struct glmCullVolumes {
+  const glm_Float *a;  // AABB minimum or sphere center.
+  const glm_Float *b;  // AABB maximum or sphere radius.
+  size_t astride, bstride;
+  size_t count;
+
+  template<bool Sphere>
+  void Load(glmCullBlock<glm_Float> &block, size_t first, size_t n) const {
+    const glm_Float *pa = a + first * astride;
+    const glm_Float *pb = b + first * bstride;
+    for (size_t i = 0; i < n; ++i, pa += astride, pb += bstride) {
+      if (Sphere) {
+        block.cx[i] = pa[0];
+        block.cy[i] = pa[1];
+        block.cz[i] = pa[2];
+        block.ex[i] = block.ey[i] = block.ez[i] = pb[0];
+      }
+      else {
+        block.cx[i] = glm_Float(0.5) * (pa[0] + pb[0]);
+        block.cy[i] = glm_Float(0.5) * (pa[1] + pb[1]);
+        block.cz[i] = glm_Float(0.5) * (pa[2] + pb[2]);
+        block.ex[i] = glm_Float(0.5) * (pb[0] - pa[0]);
+        block.ey[i] = glm_Float(0.5) * (pb[1] - pa[1]);
+        block.ez[i] = glm_Float(0.5) * (pb[2] - pa[2]);
+      }
+    }
+
+    for (size_t i = n; i < ((n + 3) & ~static_cast<size_t>(3)); ++i) {
+      block.cx[i] = block.cy[i] = block.cz[i] = glm_Float(0);
+      block.ex[i] = block.ey[i] = block.ez[i] = glm_Float(0);
+    }
+  }
+};
+
+/// <summary>
+/// Classify consecutive blocks of 'leaf' volumes. When hierarchical, the
+/// bounds of each block are tested first: blocks outside of a plane are
+/// rejected, and planes that contain the entire block are not tested per
+/// volume. Effective when the volumes are spatially ordered, e.g., the leaves
+/// of a spatial index or a Morton-sorted array.
+/// </summary>
+template<bool Sphere>
+struct glmCullTask {
+  const glmFrustum<glm_Float> *frustum;
+  const glmCullVolumes *volumes;
+  uint64_t *masks;  // One mask per block.
+  size_t leaf;
+  bool hierarchical;
+
+  static void Range(void *ud, size_t begin, size_t end) {
+    const glmCullTask *task = static_cast<const glmCullTask *>(ud);
+    const glmFrustum<glm_Float> &f = *task->frustum;
+    const unsigned all = (1u << f.count) - 1;
+
+    glmCullBlock<glm_Float> block;
+    for (size_t k = begin; k < end; ++k) {
+      const size_t first = k * task->leaf;
+      const size_t n = std::min(task->leaf, task->volumes->count - first);
+      task->volumes->template Load<Sphere>(block, first, n);
+
+      unsigned planes = all;
+      if (task->hierarchical) {
+        glm::vec<3, glm_Float> lo(block.cx[0] - block.ex[0], block.cy[0] - block.ey[0], block.cz[0] - block.ez[0]);
+        glm::vec<3, glm_Float> hi(block.cx[0] + block.ex[0], block.cy[0] + block.ey[0], block.cz[0] + block.ez[0]);
+        for (size_t i = 1; i < n; ++i) {
+          lo = glm::min(lo, glm::vec<3, glm_Float>(block.cx[i] - block.ex[i], block.cy[i] - block.ey[i], block.cz[i] - block.ez[i]));
+          hi = glm::max(hi, glm::vec<3, glm_Float>(block.cx[i] + block.ex[i], block.cy[i] + block.ey[i], block.cz[i] + block.ez[i]));
+        }
+
+        const glm::vec<3, glm_Float> c = glm_Float(0.5) * (lo + hi);
+        const glm::vec<3, glm_Float> e = glm_Float(0.5) * (hi - lo);
+        for (int p = 0; p < f.count; ++p) {
+          const glm_Float dist = f.nx[p] * c.x + f.ny[p] * c.y + f.nz[p] * c.z - f.d[p];
+          const glm_Float r = glm::abs(f.nx[p]) * e.x + glm::abs(f.ny[p]) * e.y + glm::abs(f.nz[p]) * e.z;
+          if (!(dist + r >= glm_Float(0))) {  // Outside (or NaN)
+            planes = ~0u;
+            break;
+          }
+          else if (dist - r >= glm_Float(0)) {  // Contains the block
+            planes &= ~(1u << p);
+          }
+        }
+
+        if (planes == ~0u) {
+          task->masks[k] = 0;
+          continue;
+        }
+        else if (planes == 0) {
+          task->masks[k] = (n < 64) ? ((static_cast<uint64_t>(1) << n) - 1) : ~static_cast<uint64_t>(0);
+          continue;
+        }
+      }
+      task->masks[k] = glmCullKernel<glm_Float>::template Test<Sphere>(f, planes, block, n);
+    }
+  }
+};
+
+/// <summary>
+/// Parse a culling volume: a view-projection matrix or an array of (at most
+/// LUAGLM_CULL_PLANES) planes each packed as vec4(normal, d).
+/// </summary>
+static void glm_frustum_check(lua_State *L, int idx, glmFrustum<glm_Float> &f) {
+  f.count = 0;
+  if (lua_istable(L, idx)) {
+    if (lua_rawlen(L, idx) > LUAGLM_CULL_PLANES)
+      luaL_argerror(L, idx, "too many planes");
+
+    glmLuaArray<gLuaVec4<>> array(L, idx);
+    const auto e = array.end();
+    for (auto b = array.begin(); b != e; ++b) {
+      const glm::vec<4, glm_Float> p = *b;
+      f.Add(p.x, p.y, p.z, p.w);
+    }
+  }
+  else {
+    gLuaBase LB(L, idx);
+    glm_frustum_extract<glm_Float>(gLuaMat4x4<>::Next(LB), f);
+  }
+}
+
+/// <summary>
+/// Push the result of a culling operation: an array of visible (one-based)
+/// indices, or a bitmask string of (count + 7) / 8 bytes where bit (i % 8) of
+/// byte (i / 8) corresponds to the (i + 1)th volume. The number of visible
+/// volumes is the second result.
+/// </summary>
+static int glm_cull_push(lua_State *L, int arg, bool bitmask, const uint64_t *masks, size_t leaf, size_t count) {
+  const size_t blocks = (count + leaf - 1) / leaf;
+  lua_Integer visible = 0;
+  if (bitmask) {
+    const size_t bytes = (count + 7) / 8;
+    luaL_Buffer buffer;
+    unsigned char *dest = GLM_NULLPTR;
+    bool inplace = false;
+#if defined(LUAGLM_EXT_BLOB)
+    if (lua_isstringblob(L, arg)) {
+      size_t len = 0;
+      char *blob = lua_tostringblob(L, arg, &len);
+      if (len >= bytes) {
+        dest = reinterpret_cast<unsigned char *>(blob);
+        inplace = true;
+        lua_pushvalue(L, arg);
+      }
+    }
+#endif
+    if (!inplace) {
+      if (!lua_isnoneornil(L, arg) && lua_type(L, arg) != LUA_TSTRING)
+        gLuaBase::typeerror(L, arg, "blob or nil");
+      dest = reinterpret_cast<unsigned char *>(luaL_buffinitsize(L, &buffer, bytes));
+    }
+
+    std::memset(dest, 0, bytes);
+    for (size_t k = 0; k < blocks; ++k) {
+      const uint64_t mask = masks[k];
+      for (size_t j = 0; j < leaf && mask != 0; ++j) {
+        if (mask & (static_cast<uint64_t>(1) << j)) {
+          const size_t i = k * leaf + j;
+          dest[i >> 3] = static_cast<unsigned char>(dest[i >> 3] | (1u << (i & 7)));
+          visible++;
+        }
+      }
+    }
+
+    if (!inplace)
+      luaL_pushresultsize(&buffer, bytes);
+  }
+  else {
+    if (lua_istable(L, arg))
+      lua_pushvalue(L, arg);
+    else if (lua_isnoneornil(L, arg))
+      lua_createtable(L, 0, 0);
+    else
+      gLuaBase::typeerror(L, arg, "table or nil");
+
+    const int t = lua_gettop(L);
+    for (size_t k = 0; k < blocks; ++k) {
+      const uint64_t mask = masks[k];
+      for (size_t j = 0; j < leaf && mask != 0; ++j) {
+        if (mask & (static_cast<uint64_t>(1) << j)) {
+          lua_pushinteger(L, static_cast<lua_Integer>(k * leaf + j + 1));
+          lua_rawseti(L, t, ++visible);
+        }
+      }
+    }
+
+    // Truncate the array part of a recycled table.
+    for (lua_Integer i = visible + 1; lua_rawgeti(L, t, i) != LUA_TNIL; ++i) {
+      lua_pop(L, 1);
+      lua_pushnil(L);
+      lua_rawseti(L, t, i);
+    }
+    lua_pop(L, 1);
+  }
+
+  lua_pushinteger(L, visible);
+  return 2;
+}
+
+/// <summary>
+/// Shared implementation of bulk.cullAABB and bulk.cullSphere: 'next' is the
+/// first argument after the volume description.
+/// </summary>
+template<bool Sphere>
+static int glm_bulk_cull(lua_State *L, const glmCullVolumes &volumes, int next) {
+  static const char *const results[] = { "indices", "mask", GLM_NULLPTR };
+  glmFrustum<glm_Float> frustum;
+  glm_frustum_check(L, 1, frustum);
+
+  const bool bitmask = luaL_checkoption(L, next, "indices", results) == 1;
+  const lua_Integer leafSize = luaL_optinteger(L, next + 1, 0);
+  luaL_argcheck(L, leafSize >= 0 && leafSize <= LUAGLM_CULL_BLOCK, next + 1, "invalid leaf size");
+
+  glmCullTask<Sphere> task;
+  task.frustum = &frustum;
+  task.volumes = &volumes;
+  task.leaf = (leafSize > 0) ? static_cast<size_t>(leafSize) : LUAGLM_CULL_BLOCK;
+  task.hierarchical = leafSize > 0;
+
+  const size_t blocks = (volumes.count + task.leaf - 1) / task.leaf;
+  task.masks = static_cast<uint64_t *>(lua_newuserdatauv(L, blocks * sizeof(uint64_t), 0));
+  glm_bulk_for(blocks, task.leaf, &glmCullTask<Sphere>::Range, &task);
+  return glm_cull_push(L, next + 2, bitmask, task.masks, task.leaf, volumes.count);
+}
+
+/// <summary>
+/// Unpack an array of numbers into a scratch userdata anchored on the stack.
+/// </summary>
+static const glm_Float *glm_bulk_toscalars(lua_State *L, int arg, size_t count) {
+  luaL_checktype(L, arg, LUA_TTABLE);
+  if (static_cast<size_t>(lua_rawlen(L, arg)) != count)
+    luaL_argerror(L, arg, "invalid array length");
+
+  glm_Float *dest = static_cast<glm_Float *>(lua_newuserdatauv(L, count * sizeof(glm_Float), 0));
+  glmLuaArray<gLuaFloat> array(L, arg);
+  glm_Float *v = dest;
+  const auto e = array.end();
+  for (auto b = array.begin(); b != e; ++b)
+    *v++ = *b;
+  return dest;
+}
+
+/// <summary>
+/// bulk.frustum(viewProjection [, out]): planes packed as vec4(normal, d).
+/// </summary>
+GLM_BINDING_QUALIFIER(bulk_frustum) {
+  GLM_BINDING_BEGIN
+  glmFrustum<glm_Float> frustum;
+  glm_frustum_extract<glm_Float>(gLuaMat4x4<>::Next(LB), frustum);
+
+  glmBulkArray out(LB.L, 2, static_cast<size_t>(frustum.count), 4);
+  for (int p = 0; p < frustum.count; ++p) {
+    out.data[4 * p + 0] = frustum.nx[p];
+    out.data[4 * p + 1] = frustum.ny[p];
+    out.data[4 * p + 2] = frustum.nz[p];
+    out.data[4 * p + 3] = frustum.d[p];
+  }
+  return out.Push();
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// bulk.cullAABB(frustum, mins, maxs [, result [, leafSize [, out]]])
+/// bulk.cullAABB(frustum, blob [, result [, leafSize [, out]]]) -- packed min/max pairs
+/// </summary>
+GLM_BINDING_QUALIFIER(bulk_cullAABB) {
+  GLM_BINDING_BEGIN
+  glmCullVolumes volumes = { GLM_NULLPTR, GLM_NULLPTR, 3, 3, 0 };
+#if defined(LUAGLM_EXT_BLOB)
+  if (lua_isstringblob(LB.L, 2)) {
+    size_t len = 0;
+    volumes.a = reinterpret_cast<const glm_Float *>(lua_tostringblob(LB.L, 2, &len));
+    volumes.b = volumes.a + 3;
+    volumes.astride = volumes.bstride = 6;
+    volumes.count = len / (6 * sizeof(glm_Float));
+    return glm_bulk_cull<false>(LB.L, volumes, 3);
+  }
+#endif
+  int next = 2;
+  const glmBulkPoints mins = glm_bulk_topoints(LB.L, 2, next);
+  const glmBulkPoints maxs = glm_bulk_topoints(LB.L, next, next);
+  luaL_argcheck(LB.L, mins.count == 0 || mins.dims == 3, 2, "expected " GLM_STRING_VECTOR "3");
+  luaL_argcheck(LB.L, maxs.count == mins.count && (maxs.count == 0 || maxs.dims == 3), 3, "invalid array length");
+
+  volumes.a = mins.data;
+  volumes.b = maxs.data;
+  volumes.count = mins.count;
+  return glm_bulk_cull<false>(LB.L, volumes, next);
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// bulk.cullSphere(frustum, centers, radii [, result [, leafSize [, out]]])
+/// bulk.cullSphere(frustum, spheres [, result [, leafSize [, out]]]) -- vec4(center, radius)
+/// bulk.cullSphere(frustum, blob [, result [, leafSize [, out]]]) -- packed center/radius pairs
+/// </summary>
+GLM_BINDING_QUALIFIER(bulk_cullSphere) {
+  GLM_BINDING_BEGIN
+  glmCullVolumes volumes = { GLM_NULLPTR, GLM_NULLPTR, 4, 4, 0 };
+#if defined(LUAGLM_EXT_BLOB)
+  if (lua_isstringblob(LB.L, 2)) {
+    size_t len = 0;
+    volumes.a = reinterpret_cast<const glm_Float *>(lua_tostringblob(LB.L, 2, &len));
+    volumes.b = volumes.a + 3;
+    volumes.count = len / (4 * sizeof(glm_Float));
+    return glm_bulk_cull<true>(LB.L, volumes, 3);
+  }
+#endif
+  int next = 2;
+  const glmBulkPoints centers = glm_bulk_topoints(LB.L, 2, next);
+  volumes.a = centers.data;
+  volumes.count = centers.count;
+  if (centers.dims == 3 || (centers.count == 0 && lua_istable(LB.L, next))) {
+    volumes.b = glm_bulk_toscalars(LB.L, next, centers.count);
+    volumes.astride = 3;
+    volumes.bstride = 1;
+    next++;
+  }
+  else if (centers.dims == 4 || centers.count == 0) {
+    volumes.b = (centers.count > 0) ? centers.data + 3 : centers.data;
+  }
+  else {
+    return luaL_argerror(LB.L, 2, "expected " GLM_STRING_VECTOR "3 or " GLM_STRING_VECTOR "4");
+  }
+  return glm_bulk_cull<true>(LB.L, volumes, next);
+  GLM_BINDING_END
+}
+
+/* }================================================================== */
+
+static const luaL_Reg luaglm_bulklib[] = {
+  { "perlin", glm_bulk_perlin },
+  { "simplex", glm_bulk_simplex },
+  { "random", glm_bulk_random },
+  { "threads", glm_bulk_threads },
+  { "frustum", glm_bulk_frustum },
+  { "cullAABB", glm_bulk_cullAABB },
+  { "cullSphere", glm_bulk_cullSphere },
+  { GLM_NULLPTR, GLM_NULLPTR }
+};
+
+static const luaL_Reg luaglm_randomlib[] = {
+  { "__index", GLM_NULLPTR },  // Placeholder; the metatable is the method table.
+  { "__tostring", glm_random_to_string },
+  { "seed", glm_random_seed },
+  { "linearRand", glm_random_linearRand },
+  { "gaussRand", glm_random_gaussRand },
+  { "circularRand", glm_random_circularRand },
+  { "diskRand", glm_random_diskRand },
+  { "sphericalRand", glm_random_sphericalRand },
+  { "ballRand", glm_random_ballRand },
+  { GLM_NULLPTR, GLM_NULLPTR }
+};
+
+#endif
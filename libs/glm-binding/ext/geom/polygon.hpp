@@ -37,6 +37,88 @@ namespace glm {
     Unidirectional,  // Boundary extends in both directions: [-0.5*dist, 0.5*dist]
   };
 
+  /// <summary>
+  /// Properties of a polygon that are lazily evaluated and cached.
+  /// </summary>
+  enum PolyCacheFlags : uint32_t {
+    PolyCachePlane = 0x1,  // planeCCW, basisU, and basisV
+    PolyCacheAABB = 0x2,  // minimalEnclosingAABB
+    PolyCacheConvex = 0x4,  // isConvex
+    PolyCacheWinding = 0x8,  // Signed area of the polygon in its local 2D space
+    PolyCacheTriangles = 0x10,  // triangulate
+    PolyCacheGrid = 0x20,  // Edge acceleration grid for 'contains'
+  };
+
+  /// <summary>
+  /// Classification of a cell in the 'contains' acceleration grid.
+  /// </summary>
+  enum class PolyCell : uint8_t {
+    Boundary,  // At least one edge overlaps the cell: use the crossings test.
+    Inside,  // The cell is entirely contained within the polygon.
+    Outside,  // The cell is entirely outside of the polygon.
+  };
+
+  /// <summary>
+  /// Lazily evaluated properties of a polygon.
+  ///
+  /// The cache is allocated alongside the vertex list of the Polygon userdata
+  /// and is shared between all copies of the Polygon structure. Any mutable
+  /// access to the polygon, e.g., the non-const subscript operator, invalidates
+  /// all cached properties.
+  /// </summary>
+  template<length_t L, typename T, qualifier Q>
+  struct PolygonCache {
+    uint32_t valid;  // Bitmask of PolyCacheFlags.
+    uint32_t queries;  // Number of 'contains' queries since the last mutation.
+
+    bool convex;
+    T winding;  // Signed area; positive when counter-clockwise in local space.
+    Plane<L, T, Q> plane;
+    vec<L, T, Q> bu;
+    vec<L, T, Q> bv;
+    AABB<L, T, Q> aabb;
+    List<uint32_t> triangles;  // Vertex indices, three per triangle.
+
+    // A uniform grid over the (local space) bounds of the polygon. Each row
+    // stores the edges that overlap it; each cell stores its classification.
+    // Edge 'i' joins the vertices 'i - 1' and 'i' (modulo the polygon size).
+    T gridMargin;
+    vec<2, T, Q> gridMin;
+    vec<2, T, Q> gridScale;  // Reciprocal of the cell dimensions.
+    uint32_t gridDim;  // Number of rows & columns; zero if no grid exists.
+    List<uint32_t> rowStart;  // Offset into rowEdges for each row (plus one).
+    List<uint32_t> rowEdges;
+    List<PolyCell> cells;
+
+    PolygonCache(lua_State *L, LuaCrtAllocator<uint32_t> &indexAlloc, LuaCrtAllocator<PolyCell> &cellAlloc)
+      : valid(0), queries(0), convex(false), winding(T(0)),
+        triangles(L, indexAlloc),
+        gridMargin(T(0)), gridMin(T(0)), gridScale(T(0)), gridDim(0),
+        rowStart(L, indexAlloc),
+        rowEdges(L, indexAlloc),
+        cells(L, cellAlloc) {
+    }
+
+    /// <summary>
+    /// See LuaVector::Validate
+    /// </summary>
+    void Validate(lua_State *L) {
+      triangles.Validate(L);
+      rowStart.Validate(L);
+      rowEdges.Validate(L);
+      cells.Validate(L);
+    }
+
+    GLM_FUNC_QUALIFIER bool has(uint32_t flag) const {
+      return (valid & flag) != 0;
+    }
+
+    GLM_FUNC_QUALIFIER void invalidate() {
+      valid = 0;
+      queries = 0;
+    }
+  };
+
   /// <summary>
   /// A two-dimensional closed surface in three-dimensional space.
   ///
@@ -57,31 +139,35 @@ namespace glm {
     // -- Data --
 
     List<point_type> *p;  // Stores the vertices of this polygon.
+    PolygonCache<L, T, Q> *cache;  // Optional: lazily evaluated properties of the vertices.
 
     // @LuaGLM Reference to the stack index the Polygon userdata belongs to;
     // note this is a Lua-specific hack.
     int stack_idx;
 
-    Polygon(List<point_type> *points = GLM_NULLPTR)
-      : p(points), stack_idx(-1) {
+    Polygon(List<point_type> *points = GLM_NULLPTR, PolygonCache<L, T, Q> *cache_ = GLM_NULLPTR)
+      : p(points), cache(cache_), stack_idx(-1) {
     }
 
     Polygon(const Polygon<L, T, Q> &poly)
-      : p(poly.p), stack_idx(poly.stack_idx) {
+      : p(poly.p), cache(poly.cache), stack_idx(poly.stack_idx) {
     }
 
 #if __cplusplus >= 201103L
     Polygon(Polygon<L, T, Q> &&poly)
-      : p(poly.p), stack_idx(poly.stack_idx) {
+      : p(poly.p), cache(poly.cache), stack_idx(poly.stack_idx) {
       poly.p = GLM_NULLPTR;
+      poly.cache = GLM_NULLPTR;
       poly.stack_idx = -1;
     }
 
     Polygon<L, T, Q> &operator=(Polygon<L, T, Q> &&poly) {
       p = poly.p;
+      cache = poly.cache;
       stack_idx = poly.stack_idx;
 
       poly.p = GLM_NULLPTR;
+      poly.cache = GLM_NULLPTR;
       poly.stack_idx = -1;
       return *this;
     }
@@ -89,10 +175,33 @@ namespace glm {
 
     Polygon<L, T, Q> &operator=(const Polygon<L, T, Q> &poly) {
       p = poly.p;
+      cache = poly.cache;
       stack_idx = poly.stack_idx;
       return *this;
     }
 
+    /// <summary>
+    /// Return true if the given property of the polygon has been cached.
+    /// </summary>
+    GLM_FUNC_QUALIFIER bool cached(uint32_t flag) const {
+      return cache != GLM_NULLPTR && cache->has(flag);
+    }
+
+    /// <summary>
+    /// Invalidate all cached properties of the polygon; must be invoked after
+    /// any mutation of its vertices.
+    /// </summary>
+    GLM_FUNC_QUALIFIER void invalidate() const {
+      if (cache != GLM_NULLPTR)
+        cache->invalidate();
+    }
+
+    GLM_FUNC_QUALIFIER void push_back(const point_type &point) {
+      lua_assert(p != GLM_NULLPTR);
+      invalidate();
+      p->push_back(point);
+    }
+
     GLM_FUNC_QUALIFIER size_t size() const {
       lua_assert(p != GLM_NULLPTR);
       return (p == GLM_NULLPTR) ? 0 : p->size();
@@ -105,6 +214,7 @@ namespace glm {
 
     GLM_FUNC_QUALIFIER point_type &operator[](size_t i) {
       lua_assert(p != GLM_NULLPTR);
+      invalidate();  // Reference may be used to mutate the vertex.
       return p->operator[](i);
     }
 
@@ -351,7 +461,9 @@ namespace glm {
   /// </summary>
   template<typename T, qualifier Q>
   GLM_GEOM_QUALIFIER vec<3, T, Q> basisU(const Polygon<3, T, Q> &polygon) {
-    if (polygon.size() < 2)
+    if (polygon.cached(PolyCachePlane))
+      return polygon.cache->bu;
+    else if (polygon.size() < 2)
       return glm::unit::right<T, Q>();
     return normalize(polygon[1] - polygon[0]);
   }
@@ -361,7 +473,9 @@ namespace glm {
   /// </summary>
   template<typename T, qualifier Q>
   GLM_GEOM_QUALIFIER vec<3, T, Q> basisV(const Polygon<3, T, Q> &polygon) {
-    if (polygon.size() < 2)
+    if (polygon.cached(PolyCachePlane))
+      return polygon.cache->bv;
+    else if (polygon.size() < 2)
       return glm::unit::up<T, Q>();
     return normalize(cross(normalCCW(polygon), basisU(polygon)));
   }
@@ -534,23 +648,29 @@ namespace glm {
       return false;
     else if (size <= 3)
       return true;
+    else if (polygon.cached(PolyCacheConvex))
+      return polygon.cache->convex;
 
     GLM_GEOM_ASSUME(isPlanar(polygon), false);
-    size_t i = size - 2;
-    size_t j = size - 1;
-    size_t k = 0;
-    while (k < size) {
-      const vec<2, T, Q> a = mapTo2D(polygon, i);
-      const vec<2, T, Q> b = mapTo2D(polygon, j);
+    bool convex = true;
+    vec<2, T, Q> a = mapTo2D(polygon, size - 2);
+    vec<2, T, Q> b = mapTo2D(polygon, size - 1);
+    for (size_t k = 0; k < size; ++k) {
       const vec<2, T, Q> c = mapTo2D(polygon, k);
-      if (!orientedCCW(a, b, c))
-        return false;
+      if (!orientedCCW(a, b, c)) {
+        convex = false;
+        break;
+      }
 
-      i = j;
-      j = k;
-      ++k;
+      a = b;
+      b = c;
     }
-    return true;
+
+    if (polygon.cache != GLM_NULLPTR) {
+      polygon.cache->convex = convex;
+      polygon.cache->valid |= PolyCacheConvex;
+    }
+    return convex;
   }
 
   /// <summary>
@@ -578,50 +698,71 @@ namespace glm {
     return polygon[0];  // LOG: Should not reach this.
   }
 
-  /// <summary>
-  /// Computes the plane the polygon is contained in.
-  ///
-  /// The normal vector of the plane points to the direction from which the
-  /// vertices wind in counter-clockwise order.
-  /// </summary>
-  template<typename T, qualifier Q>
-  GLM_GEOM_QUALIFIER_NOINLINE Plane<3, T, Q> planeCCW(const Polygon<3, T, Q> &polygon) {
-    const size_t p_size = polygon.size();
-    const vec<3, T, Q> hint = unit::forward<T, Q>();
-    const vec<3, T, Q> hint2 = unit::up<T, Q>();
-    if (p_size > 3) {
-      Plane<3, T, Q> plane;
-      for (size_t i = 0; i < p_size - 2; ++i) {
-        for (size_t j = i + 1; j < p_size - 1; ++j) {
-          const vec<3, T, Q> pij = polygon[j] - polygon[i];
-
-          for (size_t k = j + 1; k < p_size; ++k) {
-            plane.normal = cross(pij, polygon[k] - polygon[i]);
-
-            const T lenSq = length2(plane.normal);
-            if (lenSq > epsilon<T>()) {
-              plane.normal /= sqrt(lenSq);
-              plane.d = dot(plane.normal, polygon[i]);
-              return plane;
+  namespace detail {
+    /// <summary>
+    /// planeCCW without consulting the polygon cache.
+    /// </summary>
+    template<typename T, qualifier Q>
+    GLM_GEOM_QUALIFIER_NOINLINE Plane<3, T, Q> computePlaneCCW(const Polygon<3, T, Q> &polygon) {
+      const size_t p_size = polygon.size();
+      const vec<3, T, Q> hint = unit::forward<T, Q>();
+      const vec<3, T, Q> hint2 = unit::up<T, Q>();
+      if (p_size > 3) {
+        Plane<3, T, Q> plane;
+        for (size_t i = 0; i < p_size - 2; ++i) {
+          for (size_t j = i + 1; j < p_size - 1; ++j) {
+            const vec<3, T, Q> pij = polygon[j] - polygon[i];
+
+            for (size_t k = j + 1; k < p_size; ++k) {
+              plane.normal = cross(pij, polygon[k] - polygon[i]);
+
+              const T lenSq = length2(plane.normal);
+              if (lenSq > epsilon<T>()) {
+                plane.normal /= sqrt(lenSq);
+                plane.d = dot(plane.normal, polygon[i]);
+                return plane;
+              }
             }
           }
         }
+
+        const vec<3, T, Q> dir = normalize(polygon[1] - polygon[0]);  // Collinear points cannot form a plane.
+        return planeFrom(Line<3, T, Q>(polygon[0], dir), perpendicular(dir, hint, hint2));
       }
 
-      const vec<3, T, Q> dir = normalize(polygon[1] - polygon[0]);  // Collinear points cannot form a plane.
-      return planeFrom(Line<3, T, Q>(polygon[0], dir), perpendicular(dir, hint, hint2));
+      if (p_size == 3)
+        return planeFrom(polygon[0], polygon[1], polygon[2]);
+      else if (p_size == 2) {
+        const vec<3, T, Q> dir = normalize(polygon[1] - polygon[0]);
+        return planeFrom(Line<3, T, Q>(polygon[0], dir), perpendicular(dir, hint, hint2));
+      }
+      else if (p_size == 1)
+        return planeFrom(polygon[0], unit::up<T, Q>());
+      else
+        return Plane<3, T, Q>();
     }
+  }
 
-    if (p_size == 3)
-      return planeFrom(polygon[0], polygon[1], polygon[2]);
-    else if (p_size == 2) {
-      const vec<3, T, Q> dir = normalize(polygon[1] - polygon[0]);
-      return planeFrom(Line<3, T, Q>(polygon[0], dir), perpendicular(dir, hint, hint2));
+  /// <summary>
+  /// Computes the plane the polygon is contained in.
+  ///
+  /// The normal vector of the plane points to the direction from which the
+  /// vertices wind in counter-clockwise order.
+  /// </summary>
+  template<typename T, qualifier Q>
+  GLM_GEOM_QUALIFIER Plane<3, T, Q> planeCCW(const Polygon<3, T, Q> &polygon) {
+    if (polygon.cached(PolyCachePlane))
+      return polygon.cache->plane;
+
+    const Plane<3, T, Q> plane = detail::computePlaneCCW(polygon);
+    if (polygon.cache != GLM_NULLPTR) {
+      PolygonCache<3, T, Q> *cache = polygon.cache;
+      cache->bu = basisU(polygon);
+      cache->bv = (polygon.size() < 2) ? unit::up<T, Q>() : normalize(cross(plane.normal, cache->bu));
+      cache->plane = plane;
+      cache->valid |= PolyCachePlane;
     }
-    else if (p_size == 1)
-      return planeFrom(polygon[0], unit::up<T, Q>());
-    else
-      return Plane<3, T, Q>();
+    return plane;
   }
 
   /// <summary>
@@ -656,14 +797,325 @@ namespace glm {
   GLM_GEOM_QUALIFIER AABB<L, T, Q> minimalEnclosingAABB(const Polygon<L, T, Q> &polygon) {
     if (polygon.size() == 0)
       return AABB<L, T, Q>();
+    else if (polygon.cached(PolyCacheAABB))
+      return polygon.cache->aabb;
 
     AABB<L, T, Q> aabb;
     aabb.setNegativeInfinity();
     for (const typename Polygon<L, T, Q>::point_type &p : polygon)
       aabb.enclose(p);
+
+    if (polygon.cache != GLM_NULLPTR) {
+      polygon.cache->aabb = aabb;
+      polygon.cache->valid |= PolyCacheAABB;
+    }
     return aabb;
   }
 
+  /// <summary>
+  /// Return the signed area of the polygon in its local 2D space: positive if
+  /// the vertices wind counter-clockwise w.r.t. basisU and basisV.
+  /// </summary>
+  template<typename T, qualifier Q>
+  GLM_GEOM_QUALIFIER_NOINLINE T winding(const Polygon<3, T, Q> &polygon) {
+    const size_t size = polygon.size();
+    if (size < 3)
+      return T(0);
+    else if (polygon.cached(PolyCacheWinding))
+      return polygon.cache->winding;
+
+    T area(0);
+    vec<2, T, Q> a = mapTo2D(polygon, size - 1);
+    for (size_t i = 0; i < size; ++i) {
+      const vec<2, T, Q> b = mapTo2D(polygon, i);
+      area += a.x * b.y - b.x * a.y;
+      a = b;
+    }
+
+    area *= T(0.5);
+    if (polygon.cache != GLM_NULLPTR) {
+      polygon.cache->winding = area;
+      polygon.cache->valid |= PolyCacheWinding;
+    }
+    return area;
+  }
+
+  /// <summary>
+  /// Triangulate the polygon: convex polygons are fanned, otherwise ear
+  /// clipping (in the local 2D space of the polygon) is used. The result is a
+  /// list of vertex indices, three per triangle. An empty list is returned if
+  /// the polygon is degenerate or not simple.
+  ///
+  /// @NOTE: The triangulation is stored in the polygon cache, which must exist.
+  /// </summary>
+  template<typename T, qualifier Q>
+  GLM_GEOM_QUALIFIER_NOINLINE const List<uint32_t> &triangulate(const Polygon<3, T, Q> &polygon) {
+    lua_assert(polygon.cache != GLM_NULLPTR);
+    PolygonCache<3, T, Q> *cache = polygon.cache;
+    List<uint32_t> &indices = cache->triangles;
+    if (cache->has(PolyCacheTriangles))
+      return indices;
+
+    indices.clear();
+    const size_t size = polygon.size();
+    const T area = winding(polygon);
+    if (size < 3 || abs(area) <= epsilon<T>()) {
+      cache->valid |= PolyCacheTriangles;
+      return indices;
+    }
+    else if (isConvex(polygon)) {
+      indices.reserve(3 * (size - 2));
+      for (size_t i = 1; i + 1 < size; ++i) {
+        indices.push_back(0);
+        indices.push_back(static_cast<uint32_t>(i));
+        indices.push_back(static_cast<uint32_t>(i + 1));
+      }
+      cache->valid |= PolyCacheTriangles;
+      return indices;
+    }
+
+    // The list of vertices that remain to be clipped is stored after the (at
+    // most size - 2) triangles.
+    const size_t triangles = 3 * (size - 2);
+    indices.resize(triangles + size);
+    uint32_t *remaining = indices.data() + triangles;
+    for (size_t i = 0; i < size; ++i)
+      remaining[i] = static_cast<uint32_t>(i);
+
+    // Orientation of the triangle (a, b, c) relative to the polygon winding.
+    const T sign = (area > T(0)) ? T(1) : T(-1);
+    const auto orient = [sign](const vec<2, T, Q> &a, const vec<2, T, Q> &b, const vec<2, T, Q> &c) {
+      return sign * ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+    };
+
+    size_t count = 0;  // Number of emitted indices
+    size_t n = size;
+    size_t i = 0;
+    size_t attempts = 0;
+    while (n > 3) {
+      if (attempts++ > n) {  // No ear could be found: polygon is not simple.
+        indices.clear();
+        cache->valid |= PolyCacheTriangles;
+        return indices;
+      }
+
+      const uint32_t ia = remaining[(i + n - 1) % n];
+      const uint32_t ib = remaining[i % n];
+      const uint32_t ic = remaining[(i + 1) % n];
+      const vec<2, T, Q> a = mapTo2D(polygon, ia);
+      const vec<2, T, Q> b = mapTo2D(polygon, ib);
+      const vec<2, T, Q> c = mapTo2D(polygon, ic);
+
+      const T o = orient(a, b, c);
+      bool ear = o > T(0);
+      for (size_t j = 0; ear && j < n; ++j) {  // No other vertex within (a, b, c)
+        const uint32_t ip = remaining[j];
+        if (ip != ia && ip != ib && ip != ic) {
+          const vec<2, T, Q> pt = mapTo2D(polygon, ip);
+          ear = !(orient(a, b, pt) >= T(0) && orient(b, c, pt) >= T(0) && orient(c, a, pt) >= T(0));
+        }
+      }
+
+      if (ear || abs(o) <= epsilon<T>()) {  // Clip the ear; collinear vertices are dropped.
+        if (ear) {
+          indices[count++] = ia;
+          indices[count++] = ib;
+          indices[count++] = ic;
+        }
+
+        i %= n;
+        for (size_t j = i; j + 1 < n; ++j)
+          remaining[j] = remaining[j + 1];
+        n--;
+        attempts = 0;
+      }
+      else {
+        i++;
+      }
+    }
+
+    const uint32_t ia = remaining[0], ib = remaining[1], ic = remaining[2];
+    if (abs(orient(mapTo2D(polygon, ia), mapTo2D(polygon, ib), mapTo2D(polygon, ic))) > epsilon<T>()) {
+      indices[count++] = ia;
+      indices[count++] = ib;
+      indices[count++] = ic;
+    }
+    indices.resize(count);
+    cache->valid |= PolyCacheTriangles;
+    return indices;
+  }
+
+  namespace detail {
+    /// <summary>
+    /// The number of 'contains' queries, on an unmodified polygon, before the
+    /// edge acceleration grid is generated.
+    /// </summary>
+    static GLM_CONSTEXPR const uint32_t PolyGridQueries = 8;
+
+    /// <summary>
+    /// The minimum number of polygon vertices required for the edge
+    /// acceleration grid to be generated.
+    /// </summary>
+    static GLM_CONSTEXPR const size_t PolyGridMinSize = 16;
+
+    /// <summary>
+    /// Project a vertex onto the (bu, bv) basis relative to the query point for
+    /// the crossings test.
+    /// </summary>
+    template<typename T, qualifier Q>
+    GLM_GEOM_QUALIFIER vec<2, T, Q> crossingsPoint(const vec<3, T, Q> &vertex, const vec<3, T, Q> &point, const vec<3, T, Q> &bu, const vec<3, T, Q> &bv) {
+      const vec<3, T, Q> vt = vertex - point;
+      vec<2, T, Q> p = vec<2, T, Q>(dot(vt, bu), dot(vt, bv));
+      if (abs(p.y) < epsilon<T>())
+        p.y = -epsilon<T>();
+      return p;
+    }
+
+    /// <summary>
+    /// Return true if the edge (p0, p1) intersects the positive x-axis.
+    /// </summary>
+    template<typename T, qualifier Q>
+    GLM_GEOM_QUALIFIER bool crossingsEdge(const vec<2, T, Q> &p0, const vec<2, T, Q> &p1) {
+      if (p0.y * p1.y < T(0)) {
+        if (min(p0.x, p1.x) > T(0))
+          return true;
+        else if (max(p0.x, p1.x) > T(0)) {
+          const vec<2, T, Q> delta = p1 - p0;
+          if (epsilonNotEqual(delta.y, T(0), epsilon<T>())) {
+            const T t = -p0.y / delta.y;
+            const T x = p0.x + t * delta.x;
+            return t >= T(0) && t <= T(1) && x > T(0);
+          }
+        }
+      }
+      return false;
+    }
+
+    /// <summary>
+    /// Crossings test restricted to the edges that overlap a row of the
+    /// acceleration grid.
+    /// </summary>
+    template<typename T, qualifier Q>
+    GLM_GEOM_QUALIFIER bool crossingsRow(const Polygon<3, T, Q> &polygon, const vec<3, T, Q> &point, const vec<3, T, Q> &bu, const vec<3, T, Q> &bv, uint32_t row) {
+      const PolygonCache<3, T, Q> *cache = polygon.cache;
+      const size_t size = polygon.size();
+
+      size_t numIntersections = 0;
+      for (uint32_t e = cache->rowStart[row]; e < cache->rowStart[row + 1]; ++e) {
+        const size_t i = cache->rowEdges[e];
+        const vec<2, T, Q> p0 = crossingsPoint(polygon[(i + size - 1) % size], point, bu, bv);
+        const vec<2, T, Q> p1 = crossingsPoint(polygon[i], point, bu, bv);
+        if (crossingsEdge(p0, p1))
+          ++numIntersections;
+      }
+      return (numIntersections % 2) == 1;
+    }
+
+    /// <summary>
+    /// Generate a uniform grid over the local-space bounds of the polygon.
+    ///
+    /// Each row of the grid references all edges whose vertical extent overlaps
+    /// it: a crossings test only needs to consider those edges. Cells that do
+    /// not overlap any edge are classified, once, as inside or outside.
+    ///
+    /// Edges are dilated by a margin that bounds the numerical differences of
+    /// projecting a vertex relative to the polygon origin and relative to the
+    /// query point, so the accelerated test is consistent with the crossings
+    /// test of the complete polygon.
+    /// </summary>
+    template<typename T, qualifier Q>
+    GLM_GEOM_QUALIFIER_NOINLINE void buildContainsGrid(const Polygon<3, T, Q> &polygon) {
+      PolygonCache<3, T, Q> *cache = polygon.cache;
+      const size_t size = polygon.size();
+      const vec<3, T, Q> bu = basisU(polygon);
+      const vec<3, T, Q> bv = basisV(polygon);
+
+      cache->gridDim = 0;
+      cache->rowStart.clear();
+      cache->rowEdges.clear();
+      cache->cells.clear();
+      cache->valid |= PolyCacheGrid;
+
+      T scale(1);
+      vec<2, T, Q> minPt(std::numeric_limits<T>::infinity());
+      vec<2, T, Q> maxPt(-std::numeric_limits<T>::infinity());
+      for (size_t i = 0; i < size; ++i) {
+        const vec<2, T, Q> pt = mapTo2D(polygon, i);
+        minPt = min(minPt, pt);
+        maxPt = max(maxPt, pt);
+        scale = max(scale, compMax(abs(polygon[i])));
+      }
+
+      const T margin = epsilon<T>() * (T(1) + T(64) * scale);
+      const vec<2, T, Q> extent = (maxPt - minPt) + T(2) * margin;
+      if (!all(isfinite(extent)) || extent.x <= margin || extent.y <= margin)
+        return;
+
+      const uint32_t dim = static_cast<uint32_t>(clamp(ceil(sqrt(static_cast<T>(size))), T(4), T(64)));
+      cache->gridMargin = margin;
+      cache->gridMin = minPt - margin;
+      cache->gridScale = T(dim) / extent;
+
+      const auto cellOf = [cache, dim](T v, length_t axis) {
+        const T c = floor((v - cache->gridMin[axis]) * cache->gridScale[axis]);
+        return static_cast<uint32_t>(clamp(c, T(0), T(dim - 1)));
+      };
+
+      // Count the number of edges per row; then compute the prefix sum.
+      cache->rowStart.resize(dim + 1);
+      cache->cells.resize(dim * dim);
+      for (uint32_t r = 0; r <= dim; ++r)
+        cache->rowStart[r] = 0;
+      for (uint32_t c = 0; c < dim * dim; ++c)
+        cache->cells[c] = PolyCell::Outside;
+
+      vec<2, T, Q> a = mapTo2D(polygon, size - 1);
+      for (size_t i = 0; i < size; ++i) {
+        const vec<2, T, Q> b = mapTo2D(polygon, i);
+        const uint32_t r0 = cellOf(min(a.y, b.y) - margin, 1);
+        const uint32_t r1 = cellOf(max(a.y, b.y) + margin, 1);
+        const uint32_t c0 = cellOf(min(a.x, b.x) - margin, 0);
+        const uint32_t c1 = cellOf(max(a.x, b.x) + margin, 0);
+        for (uint32_t r = r0; r <= r1; ++r) {
+          cache->rowStart[r + 1]++;
+          for (uint32_t c = c0; c <= c1; ++c)
+            cache->cells[r * dim + c] = PolyCell::Boundary;
+        }
+        a = b;
+      }
+
+      for (uint32_t r = 0; r < dim; ++r)
+        cache->rowStart[r + 1] += cache->rowStart[r];
+
+      cache->rowEdges.resize(cache->rowStart[dim]);
+      for (uint32_t r = dim; r > 0; --r)  // Shift offsets; rowStart[r] is the fill cursor of row 'r'.
+        cache->rowStart[r] = cache->rowStart[r - 1];
+
+      a = mapTo2D(polygon, size - 1);
+      for (size_t i = 0; i < size; ++i) {
+        const vec<2, T, Q> b = mapTo2D(polygon, i);
+        const uint32_t r0 = cellOf(min(a.y, b.y) - margin, 1);
+        const uint32_t r1 = cellOf(max(a.y, b.y) + margin, 1);
+        for (uint32_t r = r0; r <= r1; ++r)
+          cache->rowEdges[cache->rowStart[r + 1]++] = static_cast<uint32_t>(i);
+        a = b;
+      }
+
+      // Classify all cells that do not overlap an edge by their center.
+      for (uint32_t r = 0; r < dim; ++r) {
+        for (uint32_t c = 0; c < dim; ++c) {
+          if (cache->cells[r * dim + c] != PolyCell::Boundary) {
+            const vec<2, T, Q> center = cache->gridMin + (vec<2, T, Q>(T(c), T(r)) + T(0.5)) / cache->gridScale;
+            const bool inside = crossingsRow(polygon, mapFrom2D(polygon, center), bu, bv, r);
+            cache->cells[r * dim + c] = inside ? PolyCell::Inside : PolyCell::Outside;
+          }
+        }
+      }
+
+      cache->gridDim = dim;
+    }
+  }
+
   // Tests if the given object (worldspace) is fully contained inside the polygon.
 
   template<typename T, qualifier Q>
@@ -695,35 +1147,41 @@ namespace glm {
     if (!contains)
       return false;
 
+    // Edge acceleration grid: generated after repeated queries on a polygon
+    // that has not been modified.
+    PolygonCache<3, T, Q> *cache = polygon.cache;
+    if (cache != GLM_NULLPTR && polygon.size() >= detail::PolyGridMinSize) {
+      if (!cache->has(PolyCacheGrid) && ++cache->queries >= detail::PolyGridQueries)
+        detail::buildContainsGrid(polygon);
+
+      if (cache->has(PolyCacheGrid) && cache->gridDim > 0) {
+        const vec<2, T, Q> local = mapTo2D(polygon, worldSpacePoint);
+        const vec<2, T, Q> cell = floor((local - cache->gridMin) * cache->gridScale);
+        const T dim = static_cast<T>(cache->gridDim);
+        if (!(cell.x >= T(0) && cell.y >= T(0) && cell.x < dim && cell.y < dim))
+          return false;
+
+        const uint32_t row = static_cast<uint32_t>(cell.y);
+        switch (cache->cells[row * cache->gridDim + static_cast<uint32_t>(cell.x)]) {
+          case PolyCell::Inside:
+            return true;
+          case PolyCell::Outside:
+            return false;
+          case PolyCell::Boundary:
+          default:
+            return detail::crossingsRow(polygon, worldSpacePoint, bu, bv, row);
+        }
+      }
+    }
+
     // Crossings Test
-    const T eps = epsilon<T>();
-    vec<3, T, Q> vt = polygon.back() - worldSpacePoint;
-    vec<2, T, Q> p0 = vec<2, T, Q>(dot(vt, bu), dot(vt, bv));
-    if (abs(p0.y) < eps)
-      p0.y = -eps;
+    vec<2, T, Q> p0 = detail::crossingsPoint(polygon.back(), worldSpacePoint, bu, bv);
 
     size_t numIntersections = 0;
     for (size_t i = 0; i < polygon.size(); ++i) {
-      vt = polygon[i] - worldSpacePoint;
-
-      vec<2, T, Q> p1 = vec<2, T, Q>(dot(vt, bu), dot(vt, bv));
-      if (abs(p1.y) < eps)
-        p1.y = -eps;
-
-      if (p0.y * p1.y < T(0)) {
-        if (min(p0.x, p1.x) > T(0))
-          ++numIntersections;
-        else if (max(p0.x, p1.x) > T(0)) {
-          const vec<2, T, Q> delta = p1 - p0;
-          if (delta.y != T(0)) {  // @TODO: notEqual(delta.y, T(0), epsilon<T>());
-            const T t = -p0.y / delta.y;
-            const T x = p0.x + t * delta.x;
-            if (t >= T(0) && t <= T(1) && x > T(0)) {
-              ++numIntersections;
-            }
-          }
-        }
-      }
+      const vec<2, T, Q> p1 = detail::crossingsPoint(polygon[i], worldSpacePoint, bu, bv);
+      if (detail::crossingsEdge(p0, p1))
+        ++numIntersections;
       p0 = p1;
     }
 
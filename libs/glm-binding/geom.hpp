@@ -365,6 +365,8 @@ struct gLuaPolygon : gLuaAbstractTrait<glm::Polygon<3, T>> {
       glm::Polygon<3, T> result = *(static_cast<glm::Polygon<3, T> *>(ptr));
       result.stack_idx = LB.idx - 1;
       result.p->Validate(LB.L);
+      if (result.cache != GLM_NULLPTR)
+        result.cache->Validate(LB.L);
       return result;
     }
     else {
@@ -1489,6 +1491,7 @@ TRAITS_DEFN(polygon_isNull, glm::isNull, gLuaPolygon<>)
 TRAITS_DEFN(polygon_isfinite, glm::isfinite, gLuaPolygon<>)
 TRAITS_DEFN(polygon_isDegenerate, glm::isDegenerate, gLuaPolygon<>, gLuaPolygon<>::eps_trait)
 TRAITS_DEFN(polygon_isConvex, glm::isConvex, gLuaPolygon<>)
+TRAITS_DEFN(polygon_winding, glm::winding, gLuaPolygon<>)
 TRAITS_DEFN(polygon_planeCCW, glm::planeCCW, gLuaPolygon<>)
 TRAITS_DEFN(polygon_normalCCW, glm::normalCCW, gLuaPolygon<>)
 TRAITS_DEFN(polygon_planeCW, glm::planeCW, gLuaPolygon<>)
@@ -1519,6 +1522,26 @@ GLM_BINDING_QUALIFIER(polygon_mapTo2D) {
   GLM_BINDING_END
 }
 
+/// <summary>
+/// Triangulate the polygon: returns an array of vertex indices, three per
+/// triangle.
+/// </summary>
+GLM_BINDING_QUALIFIER(polygon_triangulate) {
+  GLM_BINDING_BEGIN
+  const gLuaPolygon<>::type poly = gLuaPolygon<>::Next(LB);
+  if (l_unlikely(poly.cache == GLM_NULLPTR))
+    return luaL_argerror(LB.L, 1, gLuaPolygon<>::Label());
+
+  const glm::List<uint32_t> &indices = glm::triangulate(poly);
+  lua_createtable(LB.L, static_cast<int>(indices.size()), 0);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    lua_pushinteger(LB.L, static_cast<lua_Integer>(indices[i]) + 1);
+    lua_rawseti(LB.L, -2, static_cast<lua_Integer>(i) + 1);
+  }
+  return 1;
+  GLM_BINDING_END
+}
+
 GLM_BINDING_QUALIFIER(polygon_extremePoint) {
   GLM_BINDING_BEGIN
   gLuaPolygon<>::value_type distance(0);
@@ -1546,6 +1569,7 @@ GLM_BINDING_QUALIFIER(polygon_new) {
   gLuaPolygon<>::type *polygon = static_cast<gLuaPolygon<>::type *>(ptr);
   polygon->stack_idx = -1;
   polygon->p = GLM_NULLPTR;
+  polygon->cache = GLM_NULLPTR;
 
   // Setup metatable.
   if (luaL_getmetatable(LB.L, gLuaPolygon<>::Metatable()) == LUA_TTABLE) {  // [..., poly, meta]
@@ -1560,11 +1584,23 @@ GLM_BINDING_QUALIFIER(polygon_new) {
       return luaL_error(L, "polygon allocation error");
     }
 
+    // Lazily evaluated properties of the polygon, e.g., its plane and AABB.
+    using PolyCache = glm::PolygonCache<3, gLuaPolygon<>::value_type>;
+    PolyCache *cache = static_cast<PolyCache *>(allocator.realloc(GLM_NULLPTR, 0, sizeof(PolyCache)));
+    if (l_unlikely(cache == GLM_NULLPTR)) {
+      allocator.realloc(list, sizeof(PolyList), 0);
+      lua_pop(L, 1);
+      return luaL_error(L, "polygon allocation error");
+    }
+
     // Populate the polygon with an array of coordinates, if one exists.
   #if GLM_GEOM_EXCEPTIONS
     try {
   #endif
+      LuaCrtAllocator<uint32_t> indexAllocator(LB.L);
+      LuaCrtAllocator<glm::PolyCell> cellAllocator(LB.L);
       polygon->p = ::new (list) PolyList(LB.L, allocator);
+      polygon->cache = ::new (cache) PolyCache(LB.L, indexAllocator, cellAllocator);
 
       if (l_likely(top >= 1 && lua_istable(LB.L, LB.idx))) {
         glmLuaArray<gLuaPolygon<>::point_trait> lArray(LB.L, LB.idx);
@@ -1611,6 +1647,15 @@ GLM_BINDING_QUALIFIER(polygon_gc) {
     allocator.realloc(ud->p, sizeof(glm::List<gLuaPolygon<>::point_trait::type>), 0);  // Free allocation
     ud->p = GLM_NULLPTR;
   }
+
+  if (l_likely(ud->cache != GLM_NULLPTR)) {
+    using PolyCache = glm::PolygonCache<3, gLuaPolygon<>::value_type>;
+    LuaCrtAllocator<void> allocator(L);
+    ud->cache->Validate(L);
+    ud->cache->~PolyCache();
+    allocator.realloc(ud->cache, sizeof(PolyCache), 0);
+    ud->cache = GLM_NULLPTR;
+  }
   return 0;
 }
 
@@ -1667,7 +1712,7 @@ GLM_BINDING_QUALIFIER(polygon_newindex) {
     if (index >= 1 && index <= poly.size())
       poly[index - 1] = value;
     else if (index == poly.size() + 1)
-      poly.p->push_back(value);
+      poly.push_back(value);
     else {
       return luaL_error(LB.L, "Invalid polygon index");
     }
@@ -1744,6 +1789,8 @@ static const luaL_Reg luaglm_polylib[] = {
   { "isfinite", glm_polygon_isfinite },
   { "isDegenerate", glm_polygon_isDegenerate },
   { "isConvex", glm_polygon_isConvex },
+  { "winding", glm_polygon_winding },
+  { "triangulate", glm_polygon_triangulate },
   { "extremePoint", glm_polygon_extremePoint },
   { "projectToAxis", glm_polygon_projectToAxis },
   { "planeCCW", glm_polygon_planeCCW },
@@ -28,6 +28,9 @@
 #include "lglmlib.hpp"
 
 #include "api.hpp"
+#include "bulk.hpp"
+#include "track.hpp"
+#include "broadphase.hpp"
 #if defined(LUAGLM_INCLUDE_GEOM)
   #include "geom.hpp"
 #endif
@@ -166,6 +169,10 @@ static const luaL_Reg luaglm_lib[] = {
   { "segment2d", GLM_NULLPTR },
   { "circle", GLM_NULLPTR },
 #endif
+  /* Bulk API */
+  { "bulk", GLM_NULLPTR },
+  { "track", GLM_NULLPTR },
+  { "broadphase", GLM_NULLPTR },
   /* Library Details */
   { "_NAME", GLM_NULLPTR },
   { "_VERSION", GLM_NULLPTR },
@@ -199,6 +206,28 @@ extern "C" {
     // The "polygon" API is a reference to the polygon metatable stored in the registry.
     glm_newmetatable(L, gLuaPolygon<>::Metatable(), "polygon", luaglm_polylib);
 #endif
+    luaL_newlib(L, luaglm_bulklib); lua_setfield(L, -2, "bulk");
+    // Random streams are userdata whose metatable is also its method table.
+    if (luaL_newmetatable(L, LUAGLM_BULK_RANDOM)) {
+      luaL_setfuncs(L, luaglm_randomlib, 0);
+      lua_pushvalue(L, -1);
+      lua_setfield(L, -2, "__index");
+    }
+    lua_pop(L, 1);
+    // The "track" API is a reference to the track metatable stored in the registry.
+    if (luaL_newmetatable(L, LUAGLM_TRACK)) {
+      luaL_setfuncs(L, luaglm_tracklib, 0);
+      lua_pushvalue(L, -1);
+      lua_setfield(L, -2, "__index");
+    }
+    lua_setfield(L, -2, "track");
+    // The "broadphase" API is a reference to the broadphase metatable stored in the registry.
+    if (luaL_newmetatable(L, LUAGLM_BROADPHASE)) {
+      luaL_setfuncs(L, luaglm_broadphaselib, 0);
+      lua_pushvalue(L, -1);
+      lua_setfield(L, -2, "__index");
+    }
+    lua_setfield(L, -2, "broadphase");
 #if defined(CONSTANTS_HPP) || defined(EXT_SCALAR_CONSTANTS_HPP)
   #if GLM_VERSION >= 997  // @COMPAT: Added in 0.9.9.7
     GLM_CONSTANT(L, cos_one_over_two);
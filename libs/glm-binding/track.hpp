@@ -0,0 +1,672 @@
+/*
+** $Id: track.hpp $
+** Keyframe Animation Tracks: time-sorted keys of scalars, vectors, or
+** quaternions with batched sampling.
+**
+** A track is a userdata whose metatable is also the track library, i.e., like
+** polygons, glm.track.sample(t, ...) and t:sample(...) are equivalent.
+**
+** See Copyright Notice in lua.h
+*/
+#ifndef BINDING_TRACK_HPP
+#define BINDING_TRACK_HPP
+
+#include <algorithm>
+
+#include "allocator.hpp"
+#include "bindings.hpp"
+#include "bulk.hpp"
+
+#include <glm/glm.hpp>
+
+/* Metatable of the track userdata */
+#define LUAGLM_TRACK "GLM_TRACK"
+
+/// <summary>
+/// Interpolation mode of a keyframe track.
+/// </summary>
+enum glmTrackMode {
+  GLM_TRACK_STEP,  // Value of the preceding key.
+  GLM_TRACK_LINEAR,  // Component-wise linear interpolation; quaternions are normalized (nlerp).
+  GLM_TRACK_SLERP,  // Spherical linear interpolation; linear for non-quaternion tracks.
+  GLM_TRACK_CUBIC,  // Cubic Hermite spline with per-key in/out tangents.
+  GLM_TRACK_CATMULLROM,  // Uniform Catmull-Rom spline through the keys.
+};
+
+static const char *const glm_trackmodes[] = { "step", "linear", "slerp", "cubic", "catmullrom", GLM_NULLPTR };
+static const char *const glm_tracktypes[] = { "float", "vec3", "quat", GLM_NULLPTR };
+static const glm::length_t glm_trackdims[] = { 1, 3, 4 };
+
+/// <summary>
+/// A keyframe track: strictly increasing key times with packed key values.
+/// Each value has 'dims' components: 1 (float), 3 (vec3), or 4 (quaternion;
+/// stored w, x, y, z). Cubic tracks store three values per key: the in-tangent,
+/// value, and out-tangent (see glTF CUBICSPLINE).
+/// </summary>
+struct glmTrack {
+  LuaVector<glm_Float> times;
+  LuaVector<glm_Float> values;
+  glm::length_t dims;
+  glm::length_t stride;  // Number of glm_Float values per key.
+  glmTrackMode mode;
+  size_t cursor;  // Segment of the most recent sample (monotonic playback).
+
+  glmTrack(lua_State *L, LuaCrtAllocator<glm_Float> &alloc, glm::length_t dims_, glmTrackMode mode_)
+    : times(L, alloc), values(L, alloc), dims(dims_),
+      stride(mode_ == GLM_TRACK_CUBIC ? 3 * dims_ : dims_), mode(mode_), cursor(0) {
+  }
+
+  void Validate(lua_State *L) {
+    times.Validate(L);
+    values.Validate(L);
+  }
+
+  size_t size() const {
+    return times.size();
+  }
+
+  bool quat() const {
+    return dims == 4;
+  }
+
+  /// <summary>
+  /// Value of the key at index 'k' (tangents precede the value in cubic tracks).
+  /// </summary>
+  const glm_Float *value(size_t k) const {
+    return values.data() + k * stride + (mode == GLM_TRACK_CUBIC ? dims : 0);
+  }
+
+  /// <summary>
+  /// Insert a key maintaining the time order; replacing the key with an equal
+  /// time if one exists. 'key' is 'stride' glm_Float values.
+  /// </summary>
+  void Insert(glm_Float t, const glm_Float *key) {
+    const glm_Float *begin = times.data();
+    const size_t k = static_cast<size_t>(std::lower_bound(begin, begin + times.size(), t) - begin);
+    if (k < times.size() && times[k] == t) {
+      std::memcpy(values.data() + k * stride, key, stride * sizeof(glm_Float));
+      return;
+    }
+
+    const size_t n = times.size();
+    times.resize(n + 1);
+    values.resize((n + 1) * stride);
+    std::memmove(times.data() + k + 1, times.data() + k, (n - k) * sizeof(glm_Float));
+    std::memmove(values.data() + (k + 1) * stride, values.data() + k * stride, (n - k) * stride * sizeof(glm_Float));
+    times[k] = t;
+    std::memcpy(values.data() + k * stride, key, stride * sizeof(glm_Float));
+    cursor = 0;
+  }
+
+  /// <summary>
+  /// Return the index of the segment [k, k + 1] that contains 't'. The segment
+  /// of the previous sample is tested first, then its successor, before falling
+  /// back to a binary search. Assumes size() >= 2 and t in [front, back].
+  /// </summary>
+  size_t Segment(glm_Float t) {
+    const glm_Float *T = times.data();
+    const size_t n = times.size();
+    size_t k = (cursor < n - 1) ? cursor : 0;
+    if (t >= T[k]) {
+      if (t < T[k + 1] || k == n - 2)
+        return k;
+      if (t < T[k + 2] || k + 1 == n - 2)
+        return (cursor = k + 1);
+      k = static_cast<size_t>(std::upper_bound(T + k + 2, T + n, t) - T) - 1;
+    }
+    else {
+      k = static_cast<size_t>(std::upper_bound(T, T + k, t) - T);
+      k = (k == 0) ? 0 : k - 1;
+    }
+    return (cursor = std::min(k, n - 2));
+  }
+};
+
+/*
+** {==================================================================
+** Evaluation
+** ===================================================================
+*/
+
+template<glm::length_t D>
+static GLM_INLINE glm_Float glm_track_dot(const glm_Float *a, const glm_Float *b) {
+  glm_Float d(0);
+  for (glm::length_t c = 0; c < D; ++c)
+    d += a[c] * b[c];
+  return d;
+}
+
+/// <summary>
+/// Normalize the quaternion; an identity quaternion is returned on failure.
+/// </summary>
+static GLM_INLINE void glm_track_normalize(glm_Float *q) {
+  const glm_Float len = glm::sqrt(glm_track_dot<4>(q, q));
+  if (len <= glm::epsilon<glm_Float>()) {
+    q[0] = glm_Float(1);
+    q[1] = q[2] = q[3] = glm_Float(0);
+    return;
+  }
+
+  const glm_Float inv = glm_Float(1) / len;
+  for (int c = 0; c < 4; ++c)
+    q[c] *= inv;
+}
+
+/// <summary>
+/// Copy 'src' into 'dest' negating it if it lies in the opposite hemisphere of
+/// 'ref', i.e., the shortest path is taken when blending quaternions.
+/// </summary>
+static GLM_INLINE void glm_track_align(glm_Float *dest, const glm_Float *src, const glm_Float *ref) {
+  const glm_Float sign = (glm_track_dot<4>(src, ref) < glm_Float(0)) ? glm_Float(-1) : glm_Float(1);
+  for (int c = 0; c < 4; ++c)
+    dest[c] = sign * src[c];
+}
+
+/// <summary>
+/// Sample the track at time 't' (wrapped when looping; clamped otherwise)
+/// writing D values to 'out'.
+/// </summary>
+template<glm::length_t D>
+static void glm_track_eval(glmTrack &track, glm_Float t, bool loop, glm_Float *out) {
+  const size_t n = track.size();
+  if (n == 0) {
+    for (glm::length_t c = 0; c < D; ++c)
+      out[c] = glm_Float(0);
+    GLM_IF_CONSTEXPR(D == 4) out[0] = glm_Float(1);  // identity quaternion
+    return;
+  }
+  else if (n == 1) {
+    std::memcpy(out, track.value(0), D * sizeof(glm_Float));
+    return;
+  }
+
+  const glm_Float start = track.times[0];
+  const glm_Float end = track.times[n - 1];
+  if (loop && end > start) {
+    t = glm::mod(t - start, end - start) + start;
+  }
+  t = glm::clamp(t, start, end);
+
+  const size_t k = track.Segment(t);
+  const glm_Float dt = track.times[k + 1] - track.times[k];
+  const glm_Float s = (dt > glm_Float(0)) ? glm::clamp((t - track.times[k]) / dt, glm_Float(0), glm_Float(1)) : glm_Float(0);
+  const glm_Float *a = track.value(k);
+  const glm_Float *b = track.value(k + 1);
+  glm_Float tmp[4];
+
+  switch (track.mode) {
+    case GLM_TRACK_STEP: {
+      std::memcpy(out, (s >= glm_Float(1)) ? b : a, D * sizeof(glm_Float));
+      return;
+    }
+    case GLM_TRACK_SLERP:
+      GLM_IF_CONSTEXPR(D == 4) {
+        glm_track_align(tmp, b, a);
+        const glm_Float cosTheta = glm_track_dot<4>(a, tmp);
+        if (cosTheta < glm_Float(1) - glm::epsilon<glm_Float>()) {
+          const glm_Float angle = glm::acos(cosTheta);
+          const glm_Float inv = glm_Float(1) / glm::sin(angle);
+          const glm_Float wa = glm::sin((glm_Float(1) - s) * angle) * inv;
+          const glm_Float wb = glm::sin(s * angle) * inv;
+          for (int c = 0; c < 4; ++c)
+            out[c] = wa * a[c] + wb * tmp[c];
+          return;
+        }
+        b = tmp;  // Nearly parallel: fallback to nlerp
+      }
+      LUAGLM_FALLTHROUGH;
+    case GLM_TRACK_LINEAR: {
+      GLM_IF_CONSTEXPR(D == 4) {
+        if (b != tmp) {
+          glm_track_align(tmp, b, a);
+          b = tmp;
+        }
+      }
+      for (glm::length_t c = 0; c < D; ++c)
+        out[c] = a[c] + s * (b[c] - a[c]);
+      break;
+    }
+    case GLM_TRACK_CUBIC: {
+      const glm_Float s2 = s * s;
+      const glm_Float s3 = s2 * s;
+      const glm_Float h00 = glm_Float(2) * s3 - glm_Float(3) * s2 + glm_Float(1);
+      const glm_Float h10 = (s3 - glm_Float(2) * s2 + s) * dt;
+      const glm_Float h01 = glm_Float(3) * s2 - glm_Float(2) * s3;
+      const glm_Float h11 = (s3 - s2) * dt;
+      const glm_Float *m0 = a + D;  // out-tangent of 'a'
+      const glm_Float *m1 = b - D;  // in-tangent of 'b'
+      for (glm::length_t c = 0; c < D; ++c)
+        out[c] = h00 * a[c] + h10 * m0[c] + h01 * b[c] + h11 * m1[c];
+      break;
+    }
+    case GLM_TRACK_CATMULLROM: {
+      const glm_Float *p0 = track.value(k > 0 ? k - 1 : k);
+      const glm_Float *p3 = track.value(k + 2 < n ? k + 2 : k + 1);
+      glm_Float q0[4], q2[4], q3[4];
+      GLM_IF_CONSTEXPR(D == 4) {
+        glm_track_align(q0, p0, a);
+        glm_track_align(q2, b, a);
+        glm_track_align(q3, p3, q2);
+        p0 = q0;
+        b = q2;
+        p3 = q3;
+      }
+
+      const glm_Float s2 = s * s;
+      const glm_Float s3 = s2 * s;
+      const glm_Float w0 = -s3 + glm_Float(2) * s2 - s;
+      const glm_Float w1 = glm_Float(3) * s3 - glm_Float(5) * s2 + glm_Float(2);
+      const glm_Float w2 = glm_Float(-3) * s3 + glm_Float(4) * s2 + s;
+      const glm_Float w3 = s3 - s2;
+      for (glm::length_t c = 0; c < D; ++c)
+        out[c] = glm_Float(0.5) * (w0 * p0[c] + w1 * a[c] + w2 * b[c] + w3 * p3[c]);
+      break;
+    }
+    default: {
+      lua_assert(false);
+      break;
+    }
+  }
+
+  GLM_IF_CONSTEXPR(D == 4) {
+    glm_track_normalize(out);
+  }
+}
+
+static void glm_track_eval(glmTrack &track, glm_Float t, bool loop, glm_Float *out) {
+  switch (track.dims) {
+    case 1: glm_track_eval<1>(track, t, loop, out); break;
+    case 3: glm_track_eval<3>(track, t, loop, out); break;
+    case 4: glm_track_eval<4>(track, t, loop, out); break;
+    default: {
+      lua_assert(false);
+      break;
+    }
+  }
+}
+
+/* }================================================================== */
+
+/*
+** {==================================================================
+** Binding
+** ===================================================================
+*/
+
+static glmTrack *glm_track_check(lua_State *L, int idx) {
+  glmTrack *track = static_cast<glmTrack *>(luaL_checkudata(L, idx, LUAGLM_TRACK));
+  track->Validate(L);
+  return track;
+}
+
+/// <summary>
+/// Return the track at the given index; nil and false values are ignored.
+/// </summary>
+static glmTrack *glm_track_opt(lua_State *L, int idx) {
+  return lua_toboolean(L, idx) ? glm_track_check(L, idx) : GLM_NULLPTR;
+}
+
+/// <summary>
+/// Parse a (key) value of the given dimensions from the Lua stack.
+/// </summary>
+static void glm_track_checkvalue(gLuaBase &LB, glm::length_t dims, glm_Float *out) {
+  switch (dims) {
+    case 1: {
+      out[0] = gLuaFloat::Next(LB);
+      break;
+    }
+    case 3: {
+      const glm::vec<3, glm_Float> v = gLuaVec3<>::Next(LB);
+      out[0] = v.x;
+      out[1] = v.y;
+      out[2] = v.z;
+      break;
+    }
+    case 4: {
+      const glm::qua<glm_Float> q = gLuaQuat<>::Next(LB);
+      out[0] = q.w;
+      out[1] = q.x;
+      out[2] = q.y;
+      out[3] = q.z;
+      break;
+    }
+    default: {
+      lua_assert(false);
+      break;
+    }
+  }
+}
+
+static int glm_track_pushvalue(lua_State *L, glm::length_t dims, const glm_Float *v) {
+  switch (dims) {
+    case 1: return gLuaBase::Push(L, v[0]);
+    case 3: return gLuaBase::Push(L, glm::vec<3, glm_Float>(v[0], v[1], v[2]));
+    case 4: return gLuaBase::Push(L, glm::qua<glm_Float>(v[0], v[1], v[2], v[3]));
+    default: {
+      break;
+    }
+  }
+  lua_pushnil(L);
+  return 1;
+}
+
+/// <summary>
+/// Parse a key: a time, value, and for cubic tracks (optional) in/out tangents
+/// that default to zero; the out-tangent defaults to the in-tangent.
+/// </summary>
+static glm_Float glm_track_checkkey(gLuaBase &LB, const glmTrack &track, glm_Float *key) {
+  const glm_Float t = gLuaFloat::Next(LB);
+  if (glm::isnan(t) || glm::isinf(t))
+    luaL_argerror(LB.L, LB.idx - 1, "invalid key time");
+
+  if (track.mode == GLM_TRACK_CUBIC) {
+    glm_Float *in = key;
+    glm_Float *out = key + 2 * track.dims;
+    glm_track_checkvalue(LB, track.dims, key + track.dims);
+    if (lua_isnoneornil(LB.L, LB.idx)) {
+      std::fill(in, in + track.dims, glm_Float(0));
+      std::fill(out, out + track.dims, glm_Float(0));
+    }
+    else {
+      glm_track_checkvalue(LB, track.dims, in);
+      if (lua_isnoneornil(LB.L, LB.idx))
+        std::memcpy(out, in, track.dims * sizeof(glm_Float));
+      else
+        glm_track_checkvalue(LB, track.dims, out);
+    }
+  }
+  else {
+    glm_track_checkvalue(LB, track.dims, key);
+  }
+  return t;
+}
+
+/// <summary>
+/// Parse a table of keys: { { time, value [, inTangent [, outTangent]] }, ... }
+/// </summary>
+static void glm_track_insertkeys(lua_State *L, int idx, glmTrack &track) {
+  glm_Float key[12];
+  const lua_Integer n = static_cast<lua_Integer>(lua_rawlen(L, idx));
+  for (lua_Integer i = 1; i <= n; ++i) {
+    if (lua_rawgeti(L, idx, i) != LUA_TTABLE) {  // [..., key]
+      luaL_error(L, "Invalid table index: %d for key", static_cast<int>(i));
+      return;
+    }
+
+    const int top = lua_gettop(L);
+    const int count = static_cast<int>(lua_rawlen(L, top));
+    luaL_checkstack(L, count, "track key");
+    for (int j = 1; j <= count; ++j)
+      lua_rawgeti(L, top, j);  // [..., key, time, value, ...]
+
+    gLuaBase LB(L, top + 1);
+    const glm_Float t = glm_track_checkkey(LB, track, key);
+    track.Insert(t, key);
+    lua_settop(L, top - 1);  // [...]
+  }
+}
+
+/// <summary>
+/// glm.track.new(type [, mode [, keys]])
+/// </summary>
+GLM_BINDING_QUALIFIER(track_new) {
+  GLM_BINDING_BEGIN
+  const int type = luaL_checkoption(LB.L, 1, GLM_NULLPTR, glm_tracktypes);
+  const int mode = luaL_checkoption(LB.L, 2, "linear", glm_trackmodes);
+  if (!lua_isnoneornil(LB.L, 3))
+    luaL_checktype(LB.L, 3, LUA_TTABLE);
+
+  LuaCrtAllocator<glm_Float> allocator(LB.L);
+  void *ptr = lua_newuserdatauv(LB.L, sizeof(glmTrack), 0);  // [..., track]
+  glmTrack *track = ::new (ptr) glmTrack(LB.L, allocator, glm_trackdims[type], static_cast<glmTrackMode>(mode));
+  luaL_setmetatable(LB.L, LUAGLM_TRACK);
+  if (lua_istable(LB.L, 3))
+    glm_track_insertkeys(LB.L, 3, *track);
+  return 1;
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(track_gc) {
+  glmTrack *track = glm_track_check(L, 1);
+  track->~glmTrack();
+  return 0;
+}
+
+GLM_BINDING_QUALIFIER(track_len) {
+  lua_pushinteger(L, static_cast<lua_Integer>(glm_track_check(L, 1)->size()));
+  return 1;
+}
+
+GLM_BINDING_QUALIFIER(track_to_string) {
+  const glmTrack *track = glm_track_check(L, 1);
+  const char *type = (track->dims == 1) ? "float" : ((track->dims == 3) ? "vec3" : "quat");
+  lua_pushfstring(L, "Track<%s, %s, %I>", type, glm_trackmodes[track->mode], static_cast<lua_Integer>(track->size()));
+  return 1;
+}
+
+/// <summary>
+/// track:insert(time, value [, inTangent [, outTangent]])
+/// </summary>
+GLM_BINDING_QUALIFIER(track_insert) {
+  GLM_BINDING_BEGIN
+  glm_Float key[12];
+  glmTrack *track = glm_track_check(LB.L, LB.idx++);
+  const glm_Float t = glm_track_checkkey(LB, *track, key);
+  track->Insert(t, key);
+  lua_settop(LB.L, 1);
+  return 1;
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// track:set(keys): replace all keys of the track.
+/// </summary>
+GLM_BINDING_QUALIFIER(track_set) {
+  GLM_BINDING_BEGIN
+  glmTrack *track = glm_track_check(LB.L, 1);
+  luaL_checktype(LB.L, 2, LUA_TTABLE);
+  track->times.clear();
+  track->values.clear();
+  track->cursor = 0;
+  glm_track_insertkeys(LB.L, 2, *track);
+  lua_settop(LB.L, 1);
+  return 1;
+  GLM_BINDING_END
+}
+
+GLM_BINDING_QUALIFIER(track_clear) {
+  glmTrack *track = glm_track_check(L, 1);
+  track->times.clear();
+  track->values.clear();
+  track->cursor = 0;
+  lua_settop(L, 1);
+  return 1;
+}
+
+/// <summary>
+/// track:key(index): time, value [, inTangent, outTangent]
+/// </summary>
+GLM_BINDING_QUALIFIER(track_key) {
+  glmTrack *track = glm_track_check(L, 1);
+  const lua_Integer i = luaL_checkinteger(L, 2);
+  if (i < 1 || static_cast<lua_Unsigned>(i) > track->size()) {
+    luaL_pushfail(L);
+    return 1;
+  }
+
+  const size_t k = static_cast<size_t>(i - 1);
+  const glm_Float *v = track->value(k);
+  gLuaBase::Push(L, track->times[k]);
+  glm_track_pushvalue(L, track->dims, v);
+  if (track->mode == GLM_TRACK_CUBIC) {
+    glm_track_pushvalue(L, track->dims, v - track->dims);
+    glm_track_pushvalue(L, track->dims, v + track->dims);
+    return 4;
+  }
+  return 2;
+}
+
+/// <summary>
+/// track:duration(): the time of the last key minus the time of the first.
+/// </summary>
+GLM_BINDING_QUALIFIER(track_duration) {
+  const glmTrack *track = glm_track_check(L, 1);
+  const size_t n = track->size();
+  const glm_Float start = (n > 0) ? track->times[0] : glm_Float(0);
+  const glm_Float end = (n > 0) ? track->times[n - 1] : glm_Float(0);
+  gLuaBase::Push(L, end - start);
+  gLuaBase::Push(L, start);
+  gLuaBase::Push(L, end);
+  return 3;
+}
+
+/// <summary>
+/// track:sample(time [, loop])
+/// </summary>
+GLM_BINDING_QUALIFIER(track_sample) {
+  GLM_BINDING_BEGIN
+  glm_Float v[4];
+  glmTrack *track = glm_track_check(LB.L, LB.idx++);
+  const glm_Float t = gLuaFloat::Next(LB);
+  glm_track_eval(*track, t, lua_toboolean(LB.L, LB.idx), v);
+  return glm_track_pushvalue(LB.L, track->dims, v);
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// Sample time of the i'th track: a shared number or an array of numbers.
+/// </summary>
+static glm_Float glm_track_time(lua_State *L, int idx, lua_Integer i, bool shared, glm_Float t) {
+  if (shared)
+    return t;
+
+  lua_rawgeti(L, idx, i);
+  gLuaBase LB(L, lua_gettop(L));
+  t = gLuaFloat::Next(LB);
+  lua_pop(L, 1);
+  return t;
+}
+
+/// <summary>
+/// glm.track.sampleBatch(tracks, time [, loop [, out]]): all tracks must be of
+/// the same type.
+/// </summary>
+GLM_BINDING_QUALIFIER(track_sampleBatch) {
+  GLM_BINDING_BEGIN
+  luaL_checktype(LB.L, 1, LUA_TTABLE);
+  const bool shared = !lua_istable(LB.L, 2);
+  LB.idx = 2;
+  const glm_Float t = shared ? gLuaFloat::Next(LB) : glm_Float(0);
+  const bool loop = lua_toboolean(LB.L, 3);
+  const lua_Integer n = static_cast<lua_Integer>(lua_rawlen(LB.L, 1));
+
+  glm::length_t dims = 0;
+  if (n > 0) {
+    lua_rawgeti(LB.L, 1, 1);
+    dims = glm_track_check(LB.L, lua_gettop(LB.L))->dims;
+    lua_pop(LB.L, 1);
+  }
+
+  glmBulkArray out(LB.L, 4, static_cast<size_t>(n), std::max<glm::length_t>(dims, 1), dims == 4 ? GLM_BULK_QUAT : GLM_BULK_VECTOR);
+  glm_Float *v = out.data;
+  for (lua_Integer i = 1; i <= n; ++i, v += dims) {
+    lua_rawgeti(LB.L, 1, i);
+    glmTrack *track = glm_track_check(LB.L, lua_gettop(LB.L));
+    lua_pop(LB.L, 1);  // Anchored by the tracks table.
+    if (track->dims != dims)
+      return luaL_error(LB.L, "Invalid table index: %d for track (mixed track types)", static_cast<int>(i));
+    glm_track_eval(*track, glm_track_time(LB.L, 2, i, shared, t), loop, v);
+  }
+  return out.Push();
+  GLM_BINDING_END
+}
+
+/// <summary>
+/// glm.track.pose(translations, rotations, scales, time [, loop [, out]]):
+/// compose a column-major TRS matrix per bone. Each argument is an (optional)
+/// array of (optional) tracks: vec3 translations, quat rotations, vec3 scales.
+/// </summary>
+GLM_BINDING_QUALIFIER(track_pose) {
+  GLM_BINDING_BEGIN
+  lua_Integer n = 0;
+  for (int arg = 1; arg <= 3; ++arg) {
+    if (!lua_isnoneornil(LB.L, arg)) {
+      luaL_checktype(LB.L, arg, LUA_TTABLE);
+      n = std::max(n, static_cast<lua_Integer>(lua_rawlen(LB.L, arg)));
+    }
+  }
+
+  const bool shared = !lua_istable(LB.L, 4);
+  LB.idx = 4;
+  const glm_Float t = shared ? gLuaFloat::Next(LB) : glm_Float(0);
+  const bool loop = lua_toboolean(LB.L, 5);
+
+  glmBulkArray out(LB.L, 6, static_cast<size_t>(n), 16, GLM_BULK_MAT4);
+  glm_Float *m = out.data;
+  for (lua_Integer i = 1; i <= n; ++i, m += 16) {
+    const glm_Float time = glm_track_time(LB.L, 4, i, shared, t);
+    glm_Float tr[3] = { glm_Float(0), glm_Float(0), glm_Float(0) };
+    glm_Float q[4] = { glm_Float(1), glm_Float(0), glm_Float(0), glm_Float(0) };
+    glm_Float sc[3] = { glm_Float(1), glm_Float(1), glm_Float(1) };
+
+    static const glm::length_t expected[3] = { 3, 4, 3 };
+    glm_Float *dest[3] = { tr, q, sc };
+    for (int arg = 1; arg <= 3; ++arg) {
+      if (lua_istable(LB.L, arg)) {
+        lua_rawgeti(LB.L, arg, i);
+        glmTrack *track = glm_track_opt(LB.L, lua_gettop(LB.L));
+        lua_pop(LB.L, 1);  // Anchored by the tracks table.
+        if (track != GLM_NULLPTR) {
+          if (track->dims != expected[arg - 1])
+            return luaL_error(LB.L, "Invalid table index: %d for %s track", static_cast<int>(i), arg == 2 ? "quat" : "vec3");
+          glm_track_eval(*track, time, loop, dest[arg - 1]);
+        }
+      }
+    }
+
+    // mat4_cast(q) scaled per column with the translation in the last column.
+    const glm_Float w = q[0], x = q[1], y = q[2], z = q[3];
+    const glm_Float xx = x * x, yy = y * y, zz = z * z;
+    const glm_Float xy = x * y, xz = x * z, yz = y * z;
+    const glm_Float wx = w * x, wy = w * y, wz = w * z;
+    m[0] = (glm_Float(1) - glm_Float(2) * (yy + zz)) * sc[0];
+    m[1] = (glm_Float(2) * (xy + wz)) * sc[0];
+    m[2] = (glm_Float(2) * (xz - wy)) * sc[0];
+    m[3] = glm_Float(0);
+    m[4] = (glm_Float(2) * (xy - wz)) * sc[1];
+    m[5] = (glm_Float(1) - glm_Float(2) * (xx + zz)) * sc[1];
+    m[6] = (glm_Float(2) * (yz + wx)) * sc[1];
+    m[7] = glm_Float(0);
+    m[8] = (glm_Float(2) * (xz + wy)) * sc[2];
+    m[9] = (glm_Float(2) * (yz - wx)) * sc[2];
+    m[10] = (glm_Float(1) - glm_Float(2) * (xx + yy)) * sc[2];
+    m[11] = glm_Float(0);
+    m[12] = tr[0];
+    m[13] = tr[1];
+    m[14] = tr[2];
+    m[15] = glm_Float(1);
+  }
+  return out.Push();
+  GLM_BINDING_END
+}
+
+/* }================================================================== */
+
+static const luaL_Reg luaglm_tracklib[] = {
+  { "__index", GLM_NULLPTR },  // Placeholder; the metatable is the method table.
+  { "__gc", glm_track_gc },
+  { "__len", glm_track_len },
+  { "__tostring", glm_track_to_string },
+  { "new", glm_track_new },
+  { "insert", glm_track_insert },
+  { "set", glm_track_set },
+  { "clear", glm_track_clear },
+  { "key", glm_track_key },
+  { "duration", glm_track_duration },
+  { "sample", glm_track_sample },
+  { "sampleBatch", glm_track_sampleBatch },
+  { "pose", glm_track_pose },
+  { GLM_NULLPTR, GLM_NULLPTR }
+};
+
+#endif
@@ -0,0 +1,83 @@
+--[[
+================================================================================
+Array Benchmark: memory and loops over the array part of tables
+================================================================================
+Measures the array part of tables, where values and their tags are kept in
+separate vectors (see 'concretesize' in ltable.c), for arrays of integers,
+floats, and booleans:
+
+    (1) fill: append N values to an empty table (includes all resizes);
+    (2) indexed: a numeric 'for' reading 't[i]';
+    (3) ipairs: a generic 'for' over 'ipairs(t)'.
+
+Values are nanoseconds per element, the best of all rounds; 'MB' and 'B/elem'
+are the memory used by one filled array, from collectgarbage("count").
+
+Usage:
+    lua arrays.lua [elements] [rounds]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local os_clock = os.clock
+
+local Elements = tonumber(arg and arg[1]) or 10000000
+local Rounds = tonumber(arg and arg[2]) or 3
+
+--[[ Value generators: the 'i'-th element of each array --]]
+local Generators = {
+    { "integer", function(i) return i end },
+    { "float", function(i) return i + 0.5 end },
+    { "boolean", function(i) return i & 1 == 0 end },
+}
+
+--[[ Best time of 'f' over all rounds, in ns per element --]]
+local function Time(f)
+    local best = math.huge
+    for _=1,Rounds do
+        collectgarbage()
+        local t0 = os_clock()
+        f()
+        best = math.min(best, os_clock() - t0)
+    end
+    return best * 1e9 / Elements
+end
+
+local function Benchmark(name, gen)
+    local n = Elements
+
+    collectgarbage()
+    local before = collectgarbage("count")
+    local t = {}
+    for i=1,n do t[i] = gen(i) end
+    local kbytes = collectgarbage("count") - before
+
+    local fill = Time(function()
+        local u = {}
+        for i=1,n do u[i] = gen(i) end
+    end)
+
+    local count = 0
+    local indexed = Time(function()
+        for i=1,n do
+            if t[i] ~= nil then count = count + 1 end
+        end
+    end)
+
+    local iterated = Time(function()
+        for _,v in ipairs(t) do
+            if v ~= nil then count = count + 1 end
+        end
+    end)
+
+    assert(#t == n and count == 2 * Rounds * n)
+    print(("%-10s %8.1f %8.1f %8.1f %10.1f %8.1f"):format(name, kbytes / 1024,
+        kbytes * 1024 / n, fill, indexed, iterated))
+end
+
+print(("Elements: %d, Rounds: %d"):format(Elements, Rounds))
+print(("%-10s %8s %8s %8s %10s %8s"):format(
+    "array", "MB", "B/elem", "fill", "indexed", "ipairs"))
+for i=1,#Generators do
+    Benchmark(Generators[i][1], Generators[i][2])
+end
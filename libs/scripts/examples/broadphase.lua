@@ -0,0 +1,145 @@
+--[[
+================================================================================
+Broadphase Benchmark: glm.broadphase against the 'Interval' script (sat.lua)
+================================================================================
+Simulates a set of AABBs bouncing within a cube and, each frame, computes the
+overlapping pairs with:
+
+    (1) Interval: rebuild and sort the per-axis interval lists (see sat.lua)
+        followed by a sweep along the X axis;
+
+    (2) glm.broadphase: bulk update the proxy bounds and incrementally re-sort
+        the persistent endpoint arrays, consuming the added/removed deltas.
+
+Usage:
+    LUA_PATH="libs/scripts/spatial/?.lua;;" lua broadphase.lua [objects] [frames] [size]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local glm = require('glm')
+local Interval = Interval or require('sat')
+
+local vec3 = vec3
+local os_clock = os.clock
+local rand = math.random
+
+local glm_aabb_intersectsAABB = glm.aabb.intersectsAABB
+
+local ObjectCount = tonumber(arg[1]) or 2000
+local FrameCount = tonumber(arg[2]) or 100
+local WorldSize = tonumber(arg[3]) or 200.0
+local MaxExtent = 2.0
+local MaxSpeed = 1.0
+
+--[[ Create the initial positions, extents, and velocities of each object --]]
+local function CreateScene(count)
+    local scene = { position = {}, extent = {}, velocity = {}, mins = {}, maxs = {} }
+    for i=1,count do
+        scene.position[i] = vec3(rand(), rand(), rand()) * WorldSize
+        scene.extent[i] = vec3(rand(), rand(), rand()) * MaxExtent + 0.1
+        scene.velocity[i] = (vec3(rand(), rand(), rand()) * 2.0 - 1.0) * MaxSpeed
+        scene.mins[i] = scene.position[i] - scene.extent[i]
+        scene.maxs[i] = scene.position[i] + scene.extent[i]
+    end
+    return scene
+end
+
+--[[ Advance the simulation: objects bounce off the boundaries of the world --]]
+local function StepScene(scene)
+    local position,extent,velocity = scene.position,scene.extent,scene.velocity
+    local mins,maxs = scene.mins,scene.maxs
+    for i=1,#position do
+        local p,v = position[i] + velocity[i],velocity[i]
+        if p.x < 0 or p.x > WorldSize then v = vec3(-v.x, v.y, v.z) end
+        if p.y < 0 or p.y > WorldSize then v = vec3(v.x, -v.y, v.z) end
+        if p.z < 0 or p.z > WorldSize then v = vec3(v.x, v.y, -v.z) end
+
+        position[i],velocity[i] = p,v
+        mins[i],maxs[i] = p - extent[i],p + extent[i]
+    end
+end
+
+--[[ Count overlapping pairs by sorting the interval lists of the scene --]]
+local function IntervalPairs(intervals, scene)
+    local mins,maxs = scene.mins,scene.maxs
+
+    intervals:Clear()
+    for i=1,#mins do
+        intervals:AppendBounds(i, mins[i], maxs[i])
+    end
+
+    local sorted = intervals:SortIndex()[1]
+    local objects,nodeType = intervals.objects,intervals.nodeType
+    local Min = Interval.NodeType.Min
+
+    local pairs,active,activeCount = 0,{},0
+    for i=1,#sorted do
+        local index = sorted[i]
+        local object = objects[index]
+        if nodeType[index] == Min then
+            local omin,omax = mins[object],maxs[object]
+            for j=1,activeCount do
+                local other = active[j]
+                if glm_aabb_intersectsAABB(omin, omax, mins[other], maxs[other]) then
+                    pairs = pairs + 1
+                end
+            end
+
+            activeCount = activeCount + 1
+            active[activeCount] = object
+        else
+            for j=1,activeCount do
+                if active[j] == object then
+                    active[j] = active[activeCount]
+                    active[activeCount] = nil
+                    activeCount = activeCount - 1
+                    break
+                end
+            end
+        end
+    end
+    return pairs
+end
+
+local function Benchmark()
+    math.randomseed(ObjectCount)
+
+    local scene = CreateScene(ObjectCount)
+    local intervals = Interval()
+    local broadphase = glm.broadphase.new(3)
+    local added,removed = {},{}
+    local pairCount = 0
+
+    local intervalTime,broadphaseTime,mismatches = 0.0,0.0,0
+    for _=1,FrameCount do
+        StepScene(scene)
+
+        local t0 = os_clock()
+        local intervalPairs = IntervalPairs(intervals, scene)
+        local t1 = os_clock()
+        broadphase:set(scene.mins, scene.maxs)
+        added,removed = broadphase:update(added, removed)
+        pairCount = pairCount + (#added - #removed) // 2
+        local t2 = os_clock()
+
+        intervalTime = intervalTime + (t1 - t0)
+        broadphaseTime = broadphaseTime + (t2 - t1)
+        if intervalPairs ~= pairCount then
+            mismatches = mismatches + 1
+        end
+    end
+
+    print(("Objects: %d, Frames: %d, Pairs (last frame): %d"):format(ObjectCount, FrameCount, pairCount))
+    print(("Interval:       %10.3f ms/frame"):format(1000.0 * intervalTime / FrameCount))
+    print(("glm.broadphase: %10.3f ms/frame (%.1fx)"):format(
+        1000.0 * broadphaseTime / FrameCount,
+        intervalTime / glm.max(broadphaseTime, 1e-9)
+    ))
+
+    if mismatches > 0 then
+        print(("WARNING: %d frames with mismatching pair counts"):format(mismatches))
+    end
+end
+
+Benchmark()
@@ -0,0 +1,55 @@
+--[[
+================================================================================
+Bytecode Benchmark: instruction counts with and without optimizations
+================================================================================
+Compiles each file twice with luac, as 'luac -l -p' and 'luac -O -l -p', and
+compares the number of instructions of all of its functions, as reported by
+the listings. 'O' expands calls to small functions inline and then removes
+unreachable code, jumps to the next instruction, redundant moves and loads,
+and replaces jumps to returns by the returns themselves.
+
+Usage:
+    lua bytecode.lua luac file...
+
+For example:
+    lua bytecode.lua ./luac testes/*.lua libs/scripts/examples/smallpt.lua
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local Luac = arg and arg[1]
+if not Luac or not arg[2] then
+    print("usage: lua bytecode.lua luac file...")
+    return
+end
+
+--[[ Number of instructions in the listing of 'file' (nil on errors) --]]
+local function Count(file, options)
+    local f = assert(io.popen(("%s %s -l -p %q 2>&1"):format(Luac, options, file)))
+    local n, nfuncs = 0, 0
+    for line in f:lines() do
+        local k = line:match("^%a+ <.*> %((%d+) instructions? at")
+        if k then
+            n, nfuncs = n + tonumber(k), nfuncs + 1
+        end
+    end
+    f:close()
+    if nfuncs > 0 then
+        return n
+    end
+end
+
+local total, totalO = 0, 0
+print(("%-32s %10s %10s %8s"):format("file", "plain", "O", "change"))
+for i=2,#arg do
+    local n, nO = Count(arg[i], ""), Count(arg[i], "-O")
+    if n and nO then
+        total, totalO = total + n, totalO + nO
+        print(("%-32s %10d %10d %7.2f%%"):format(arg[i]:match("[^/]*$"), n, nO,
+            (nO - n) * 100 / n))
+    else
+        print(("%-32s %10s"):format(arg[i]:match("[^/]*$"), "(error)"))
+    end
+end
+print(("%-32s %10d %10d %7.2f%%"):format("total", total, totalO,
+    (totalO - total) * 100 / math.max(total, 1)))
@@ -0,0 +1,113 @@
+--[[
+================================================================================
+Camera Benchmark: intermediate matrices of arithmetic chains
+================================================================================
+Loads each kernel twice, as a plain chunk ("t") and as an optimized one ("tO").
+In optimized chunks, an arithmetic operator whose result is only consumed by
+the next one (e.g., 'P * V' in 'P * V * M') marks it as an intermediate value,
+so that the next operator writes its own result into that matrix instead of
+allocating another one (see 'marktemp' in lcode.c):
+
+    (1) camera: the example ported from GLM in README.md;
+    (2) mvp: a model-view-projection product with an extra identity;
+    (3) skinning: a linear blend of four weighted bone matrices.
+
+Matrices created by the binding library (glm.translate, glm.rotate, ...) are
+not affected, only those of arithmetic operators. Values are nanoseconds per
+call, the best of all rounds, and bytes allocated per call (with the collector
+stopped).
+
+Usage:
+    lua camera.lua [iterations] [rounds]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local Iterations = tonumber(arg and arg[1]) or 100000
+local Rounds = tonumber(arg and arg[2]) or 5
+
+local Kernels = {
+    { "camera", [[
+        local glm = glm
+        local function camera(Translate, Rotate)
+            local Projection = glm.perspective(glm.pi * 0.25, 4.0 / 3.0, 0.1, 100.0)
+            local View = glm.translate(glm.mat4(1.0), glm.vec3(0.0, 0.0, -Translate))
+            View = glm.rotate(View, Rotate.y, glm.vec3(-1.0, 0.0, 0.0))
+            View = glm.rotate(View, Rotate.x, glm.vec3(0.0, 1.0, 0.0))
+            local Model = glm.scale(glm.mat4(1.0), glm.vec3(0.5))
+            return Projection * View * Model
+        end
+        return function(n)
+            local r
+            for i=1,n do
+                r = camera(i * 0.001, glm.vec2(0.5, 0.25))
+            end
+            return r
+        end
+    ]] },
+    { "mvp", [[
+        local glm = glm
+        local P = glm.perspective(glm.pi * 0.25, 4.0 / 3.0, 0.1, 100.0)
+        local V = glm.translate(glm.mat4(1.0), glm.vec3(0.0, 0.0, -5.0))
+        local M = glm.scale(glm.mat4(1.0), glm.vec3(0.5))
+        local I = glm.mat4(1.0)
+        return function(n)
+            local r
+            for i=1,n do
+                r = P * V * M * I
+            end
+            return r
+        end
+    ]] },
+    { "skinning", [[
+        local glm = glm
+        local B1 = glm.translate(glm.mat4(1.0), glm.vec3(1.0, 0.0, 0.0))
+        local B2 = glm.translate(glm.mat4(1.0), glm.vec3(0.0, 1.0, 0.0))
+        local B3 = glm.scale(glm.mat4(1.0), glm.vec3(2.0))
+        local B4 = glm.mat4(1.0)
+        return function(n)
+            local r
+            for i=1,n do
+                local w = (i % 10) * 0.05
+                r = w * B1 + 0.25 * B2 + 0.25 * B3 + (0.5 - w) * B4
+            end
+            return r
+        end
+    ]] },
+}
+
+--[[ Time and bytes allocated of one 'f(Iterations)', per call --]]
+local function Run(f)
+    collectgarbage()
+    collectgarbage("stop")
+    local m0, t0 = collectgarbage("count"), os.clock()
+    f(Iterations)
+    local t1, m1 = os.clock(), collectgarbage("count")
+    collectgarbage("restart")
+    return (t1 - t0) * 1e9 / Iterations, (m1 - m0) * 1024 / Iterations
+end
+
+--[[ Best times and allocations of 'f' and 'g', interleaved --]]
+local function Measure(f, g)
+    local t, b, tg, bg = math.huge, math.huge, math.huge, math.huge
+    for _=1,Rounds do
+        local t1, b1 = Run(f)
+        local t2, b2 = Run(g)
+        t, b = math.min(t, t1), math.min(b, b1)
+        tg, bg = math.min(tg, t2), math.min(bg, b2)
+    end
+    return t, tg, b, bg
+end
+
+print(("Iterations: %d, Rounds: %d"):format(Iterations, Rounds))
+print(("%-12s %10s %10s %8s %10s %10s"):format("kernel", "t", "tO", "change",
+    "bytes t", "bytes tO"))
+for _, kernel in ipairs(Kernels) do
+    local name, source = kernel[1], kernel[2]
+    local plain = assert(load(source, "=" .. name, "t"))()
+    local optimized = assert(load(source, "=" .. name, "tO"))()
+    assert(plain(100) == optimized(100))
+    local t, tO, bt, btO = Measure(plain, optimized)
+    print(("%-12s %10.1f %10.1f %7.1f%% %10.0f %10.0f"):format(name, t, tO,
+        (tO - t) * 100 / t, bt, btO))
+end
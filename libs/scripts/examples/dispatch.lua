@@ -0,0 +1,184 @@
+--[[
+================================================================================
+Dispatch Benchmark: interpreter loops built with different dispatch methods
+================================================================================
+Runs the same kernels with several builds of the interpreter and compares their
+times. The main loop of the interpreter ('luaV_execute') can be built as:
+
+    (1) switch: a C switch over the opcodes (-DLUA_USE_JUMPTABLE=0);
+    (2) jump table: computed gotos, the default on gcc and compatible compilers
+        (-DLUA_USE_JUMPTABLE=1);
+    (3) tail calls: a function per opcode, chained by tail calls, with 'L',
+        'ci', 'pc', 'base', and 'k' kept in arguments (-DLUA_USE_TAILCALL=1,
+        or the CMake option of the same name; see ltailcall.h).
+
+Kernels are mostly dispatch: integer and float loops, field and vector reads,
+calls, and a generic 'for'. 'vectors' needs the glm bindings (vec3) and is
+skipped otherwise. Values are nanoseconds per loop iteration, the best of all
+rounds; the change is relative to the first interpreter.
+
+Usage:
+    lua dispatch.lua [-n iterations] [-r rounds] interpreter...
+
+For example:
+    lua dispatch.lua ./lua-switch ./lua-jumptable ./lua-tailcall
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local Iterations = 1000000
+local Rounds = 5
+local Interpreters = {}
+
+--[[ Kernels: each one returns a function of the number of iterations --]]
+local Kernels = {
+    { "integers", function()
+        return function(n)
+            local s, m = 0, 0
+            for i=1,n do
+                s = s + (i & 7) * 3 - 1
+                if s > 1000 then s = s - 1000 end
+                m = m ~ i
+            end
+            return s + m
+        end
+    end },
+    { "floats", function()
+        return function(n)
+            local x, v, dt = 0.0, 1.0, 0.001
+            for _=1,n do
+                v = v - x * dt
+                x = x + v * dt
+            end
+            return x
+        end
+    end },
+    { "fields", function()
+        local p = { x = 1, y = 2, pos = { x = 0, y = 0 } }
+        return function(n)
+            for i=1,n do
+                p.pos.x = p.pos.x + p.x
+                p.pos.y = p.pos.y + p.y
+                p.x, p.y = p.y, p.x
+            end
+            return p.pos.x + p.pos.y
+        end
+    end },
+    { "calls", function()
+        local function add(a, b) return a + b end
+        local obj = { n = 0 }
+        function obj:inc(k) self.n = self.n + k end
+        return function(n)
+            local s = 0
+            for i=1,n do
+                s = add(s, i)
+                obj:inc(1)
+            end
+            return s + obj.n
+        end
+    end },
+    { "ipairs", function()
+        local t = {}
+        for i=1,100 do t[i] = i end
+        return function(n)
+            local s = 0
+            for _=1,n // 100 do
+                for _, v in ipairs(t) do
+                    s = s + v
+                end
+            end
+            return s
+        end
+    end },
+    { "vectors", function()
+        if not vec3 then
+            return nil
+        end
+        local a, b = vec3(1, 2, 3), vec3(0.5, 0.25, 0.125)
+        return function(n)
+            local s = 0.0
+            for _=1,n do
+                s = s + a.x * b.x + a.y * b.y + a[3] * b[3]
+            end
+            return s
+        end
+    end },
+}
+
+--[[ Best time of 'kernel(Iterations)' in ns per iteration (nil if skipped) --]]
+local function Time(kernel)
+    local f = kernel()
+    if not f then
+        return nil
+    end
+    local best = math.huge
+    for _=1,Rounds do
+        local t0 = os.clock()
+        f(Iterations)
+        best = math.min(best, os.clock() - t0)
+    end
+    return best * 1e9 / Iterations
+end
+
+do
+    local i = 1
+    local child = false
+    while arg and arg[i] do
+        if arg[i] == "-n" then
+            Iterations = assert(tonumber(arg[i + 1]), "iterations expected")
+            i = i + 2
+        elseif arg[i] == "-r" then
+            Rounds = assert(tonumber(arg[i + 1]), "rounds expected")
+            i = i + 2
+        elseif arg[i] == "-k" then -- run one kernel (in a child process)
+            child = assert(tonumber(arg[i + 1]), "kernel expected")
+            i = i + 2
+        else
+            Interpreters[#Interpreters + 1] = arg[i]
+            i = i + 1
+        end
+    end
+
+    if child then
+        print(Time(Kernels[child][2]) or "-")
+        return
+    end
+end
+
+if #Interpreters == 0 then
+    print("usage: lua dispatch.lua [-n iterations] [-r rounds] interpreter...")
+    return
+end
+
+--[[ Time of kernel 'k' with 'interpreter' (nil if skipped or failed) --]]
+local function Run(interpreter, k)
+    local command = ("%s %q -n %d -r %d -k %d 2>&1"):format(interpreter, arg[0],
+        Iterations, Rounds, k)
+    local f = assert(io.popen(command))
+    local output = f:read("a")
+    f:close()
+    return tonumber(output:match("^%s*(%S+)"))
+end
+
+io.write(("%-10s"):format("kernel"))
+for j=1,#Interpreters do
+    io.write(("%16s"):format(Interpreters[j]:match("[^/]*$")))
+end
+io.write("\n")
+
+for k, kernel in ipairs(Kernels) do
+    io.write(("%-10s"):format(kernel[1]))
+    local first = nil
+    for j=1,#Interpreters do
+        local t = Run(Interpreters[j], k)
+        if not t then
+            io.write(("%16s"):format("-"))
+        elseif not first then
+            first = t
+            io.write(("%16.1f"):format(t))
+        else
+            io.write(("%8.1f %6.1f%%"):format(t, (t - first) * 100 / first))
+        end
+    end
+    io.write("\n")
+end
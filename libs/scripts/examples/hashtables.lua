@@ -0,0 +1,105 @@
+--[[
+================================================================================
+Hash Table Benchmark: insert, lookup, and delete across key types
+================================================================================
+Measures the hash part of tables (the array part is never used: integer keys
+are sparse) for integers, floats, short strings, long strings, vectors, and
+tables as keys:
+
+    (1) insert: fill an empty table with N keys (includes all rehashes);
+    (2) hit/miss: look up the N present keys and N absent ones;
+    (3) churn: replace each key by a new one (erase + insert);
+    (4) delete: erase all keys.
+
+Values are nanoseconds per operation; 'KB' is the memory used by the filled
+table. Compare builds with and without LUA_SWISS_TABLES.
+
+Usage:
+    lua hashtables.lua [keys] [rounds]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local os_clock = os.clock
+local string_rep = string.rep
+
+local KeyCount = tonumber(arg and arg[1]) or 100000
+local Rounds = tonumber(arg and arg[2]) or 10
+
+--[[ Key generators: 'i'-th key of each type; 2N keys, the second half absent --]]
+local Generators = {
+    { "integer", function(i) return i * 7919 + (1 << 40) end },
+    { "float", function(i) return i + 0.5 end },
+    { "short string", function(i) return "key" .. i end },
+    { "long string", function(i) return string_rep("k", 48) .. i end },
+    { "vec3", function(i) return vec3(i, i * 0.5, -i) end },
+    { "table", function(_) return {} end },
+}
+
+local function Keys(gen, first, count)
+    local keys = {}
+    for i=1,count do
+        keys[i] = gen(first + i)
+    end
+    return keys
+end
+
+--[[ Time 'f' over 'rounds' repetitions, returning ns per operation --]]
+local function Time(ops, rounds, f)
+    local t0 = os_clock()
+    for _=1,rounds do
+        f()
+    end
+    return (os_clock() - t0) * 1e9 / (ops * rounds)
+end
+
+local function Benchmark(name, gen)
+    local keys,absent = Keys(gen, 0, KeyCount),Keys(gen, KeyCount, KeyCount)
+    local n = #keys
+
+    local t
+    local insert = Time(n, Rounds, function()
+        t = {}
+        for i=1,n do t[keys[i]] = i end
+    end)
+
+    collectgarbage()
+    local before = collectgarbage("count")
+    local filled = {}
+    for i=1,n do filled[keys[i]] = i end
+    local kbytes = collectgarbage("count") - before
+
+    local sum = 0
+    local hit = Time(n, Rounds, function()
+        for i=1,n do sum = sum + t[keys[i]] end
+    end)
+
+    local miss = Time(n, Rounds, function()
+        for i=1,n do if t[absent[i]] then sum = sum + 1 end end
+    end)
+
+    local churn = Time(n, 1, function()
+        for i=1,n do
+            t[keys[i]] = nil
+            t[absent[i]] = i
+        end
+    end)
+
+    local delete = Time(n, 1, function()
+        for i=1,n do t[absent[i]] = nil end
+    end)
+
+    assert(sum == Rounds * n * (n + 1) // 2 and next(t) == nil)
+    print(("%-12s %8.1f %8.1f %8.1f %8.1f %8.1f %10.0f"):format(
+        name, insert, hit, miss, churn, delete, kbytes))
+end
+
+print(("Keys: %d, Rounds: %d"):format(KeyCount, Rounds))
+print(("%-12s %8s %8s %8s %8s %8s %10s"):format(
+    "key", "insert", "hit", "miss", "churn", "delete", "KB"))
+for i=1,#Generators do
+    local name,gen = Generators[i][1],Generators[i][2]
+    if name ~= "vec3" or vec3 then
+        Benchmark(name, gen)
+    end
+end
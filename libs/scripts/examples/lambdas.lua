@@ -0,0 +1,100 @@
+--[[
+================================================================================
+Lambda Benchmark: short functions created inside loops
+================================================================================
+Measures code that creates a closure (OP_CLOSURE) on each iteration of a loop,
+as the Short Function Notation (LUAGLM_EXT_LAMBDA) encourages:
+
+    (1) sort: sort small arrays with a comparator written inline, with no
+        upvalues and with an upvalue of the enclosing function;
+    (2) gsub: 'hexadump' strings with a callback written inline;
+    (3) map: apply an inline function to each element of an array.
+
+Values are nanoseconds per loop iteration, each of which evaluates one lambda
+expression. Compare builds before and after a change to closure creation.
+
+Usage:
+    lua lambdas.lua [iterations] [rounds]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local os_clock = os.clock
+local rand = math.random
+local string_format = string.format
+local table_sort = table.sort
+
+local Iterations = tonumber(arg and arg[1]) or 100000
+local Rounds = tonumber(arg and arg[2]) or 10
+
+--[[ Time 'f' over 'rounds' repetitions, returning ns per operation --]]
+local function Time(ops, rounds, f)
+    local t0 = os_clock()
+    for _=1,rounds do
+        f()
+    end
+    return (os_clock() - t0) * 1e9 / (ops * rounds)
+end
+
+local function Map(t, f)
+    local r = {}
+    for i=1,#t do
+        r[i] = f(t[i])
+    end
+    return r
+end
+
+--[[ Sort arrays of four elements --]]
+local function Sort()
+    local arrays = {}
+    for i=1,Iterations do
+        arrays[i] = { rand(), rand(), rand(), rand() }
+    end
+    return Time(Iterations, Rounds, function()
+        for i=1,#arrays do
+            table_sort(arrays[i], |a, b| a > b)
+        end
+    end)
+end
+
+local function SortKey()
+    local arrays = {}
+    for i=1,Iterations do
+        arrays[i] = { { w = rand() }, { w = rand() }, { w = rand() } }
+    end
+    local key = "w"
+    return Time(Iterations, Rounds, function()
+        for i=1,#arrays do
+            table_sort(arrays[i], |a, b| a[key] < b[key])
+        end
+    end)
+end
+
+--[[ string.gsub with a callback (from lua-MessagePack.lua) --]]
+local function Gsub()
+    local strings = {}
+    for i=1,64 do
+        strings[i] = string_format("%08x", rand(0, 0x7FFFFFFF))
+    end
+    return Time(Iterations, Rounds, function()
+        for i=1,Iterations do
+            local s = strings[(i & 63) + 1]
+            s:gsub('..', |c| string_format('%02X ', c:byte()))
+        end
+    end)
+end
+
+local function Mapping()
+    local values = { 1, 2, 3, 4 }
+    return Time(Iterations, Rounds, function()
+        for _=1,Iterations do
+            Map(values, |x| x * x - 1)
+        end
+    end)
+end
+
+print(("Iterations: %d, Rounds: %d"):format(Iterations, Rounds))
+print(("%-12s %8.1f"):format("sort", Sort()))
+print(("%-12s %8.1f"):format("sort upvalue", SortKey()))
+print(("%-12s %8.1f"):format("gsub", Gsub()))
+print(("%-12s %8.1f"):format("map", Mapping()))
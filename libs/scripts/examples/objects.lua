@@ -0,0 +1,156 @@
+--[[
+================================================================================
+Object Benchmark: field accesses and method calls with constant keys
+================================================================================
+Measures the instructions that index a table with a constant string, i.e.,
+'self.pos', 'obj:method()', and global variables, in object-style code:
+
+    (1) particles: integrate a set of particle objects whose methods are
+        found through the '__index' of their class;
+    (2) hierarchy: call methods and read defaults inherited through a
+        four-level class hierarchy ('__index' chains of tables);
+    (3) globals: read and write fields of the global table;
+    (4) orderedlist: k-nearest selection with OrderedList (orderedlist.lua).
+
+Values are nanoseconds per iteration (per object, global access, or
+insertion). Compare builds before and after a change to the VM.
+
+Usage:
+    LUA_PATH="libs/scripts/spatial/?.lua;;" lua objects.lua [objects] [rounds]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+glm = glm or { huge = math.huge } -- orderedlist.lua only needs glm.huge
+local OrderedList = OrderedList or require('orderedlist')
+
+local os_clock = os.clock
+local rand = math.random
+
+local ObjectCount = tonumber(arg and arg[1]) or 10000
+local Rounds = tonumber(arg and arg[2]) or 100
+
+--[[ Time 'f' over 'rounds' repetitions, returning ns per operation --]]
+local function Time(ops, rounds, f)
+    local t0 = os_clock()
+    for _=1,rounds do
+        f()
+    end
+    return (os_clock() - t0) * 1e9 / (ops * rounds)
+end
+
+--[[ A class with a handful of fields per object --]]
+local Particle = {}
+Particle.__index = Particle
+
+function Particle.New(x, y, z)
+    return setmetatable({
+        x = x, y = y, z = z,
+        vx = rand() - 0.5, vy = rand() - 0.5, vz = rand() - 0.5,
+        mass = rand() + 1.0,
+        age = 0,
+    }, Particle)
+end
+
+function Particle:Accelerate(dt)
+    local g = -9.8 * dt / self.mass
+    self.vy = self.vy + g
+end
+
+function Particle:Integrate(dt)
+    self.x = self.x + self.vx * dt
+    self.y = self.y + self.vy * dt
+    self.z = self.z + self.vz * dt
+    self.age = self.age + dt
+end
+
+function Particle:Bounce()
+    if self.y < 0 then
+        self.y = -self.y
+        self.vy = -self.vy * 0.9
+    end
+end
+
+local function Particles()
+    local particles = {}
+    for i=1,ObjectCount do
+        particles[i] = Particle.New(rand() * 100, rand() * 100, rand() * 100)
+    end
+    return Time(ObjectCount, Rounds, function()
+        for i=1,#particles do
+            local p = particles[i]
+            p:Accelerate(1 / 60)
+            p:Integrate(1 / 60)
+            p:Bounce()
+        end
+    end)
+end
+
+--[[ Entity <- Actor <- Character <- Player, each inheriting with '__index' --]]
+local function Class(base)
+    local class = {}
+    class.__index = class
+    return base and setmetatable(class, base) or class
+end
+
+local Entity = Class()
+Entity.speed = 1.0
+function Entity:Position() return self.x end
+
+local Actor = Class(Entity)
+Actor.health = 100
+function Actor:Damage(n) self.hp = (self.hp or self.health) - n end
+
+local Character = Class(Actor)
+function Character:Move(dt) self.x = self:Position() + self.speed * dt end
+
+local Player = Class(Character)
+function Player:Tick(dt)
+    self:Move(dt)
+    self:Damage(0)
+end
+
+local function Hierarchy()
+    local players = {}
+    for i=1,ObjectCount do
+        players[i] = setmetatable({ x = i }, Player)
+    end
+    return Time(ObjectCount, Rounds, function()
+        for i=1,#players do
+            players[i]:Tick(1 / 60)
+        end
+    end)
+end
+
+--[[ Read and write fields of the global table --]]
+BenchCounter = 0
+BenchStep = 1
+local function Globals()
+    return Time(ObjectCount, Rounds, function()
+        for _=1,ObjectCount do
+            BenchCounter = BenchCounter + BenchStep
+        end
+    end)
+end
+
+--[[ Keep the 16 nearest of a set of scored objects --]]
+local function Nearest()
+    local objects,scores = {},{}
+    for i=1,ObjectCount do
+        objects[i] = {}
+        scores[i] = rand()
+    end
+    return Time(ObjectCount, Rounds // 10 + 1, function()
+        local list = OrderedList.New(16)
+        for i=1,ObjectCount do
+            list:Insert(objects[i], scores[i])
+        end
+        assert(list:Size() >= 16)
+    end)
+end
+
+print(("Objects: %d, Rounds: %d"):format(ObjectCount, Rounds))
+print(("%-12s %8.1f"):format("particles", Particles()))
+print(("%-12s %8.1f"):format("hierarchy", Hierarchy()))
+print(("%-12s %8.1f"):format("globals", Globals()))
+print(("%-12s %8.1f"):format("orderedlist", Nearest()))
@@ -0,0 +1,113 @@
+--[[
+================================================================================
+Opcode Pairs: candidate superinstructions from representative scripts
+================================================================================
+Runs each script, counting the pairs of consecutive instructions that the
+interpreter executes (T.oppairs), and lists the most frequent ones:
+
+    super       the pair already runs as a superinstruction (see lopcodes.c);
+    candidate   a superinstruction could replace the pair;
+    -           the first opcode jumps, calls, returns, or skips, so the
+                interpreter cannot always go on to the second one.
+
+Scripts are loaded as optimized chunks ('O' in the load mode), like the code
+that superinstructions apply to, and run with no arguments. Counts of pairs in
+the C library, across calls, and across jumps are not included.
+
+Requires the test library (a build with 'ltests.h' as LUA_USER_H).
+
+Usage:
+    lua oppairs.lua [-n count] script...
+
+For example:
+    lua oppairs.lua -n 40 libs/scripts/examples/lambdas.lua testes/sort.lua
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+if not T then
+    print("oppairs.lua: requires the test library ('T')")
+    return
+end
+
+local Count = 30
+local Scripts = {}
+do
+    local i = 1
+    while arg and arg[i] do
+        if arg[i] == "-n" then
+            Count = assert(tonumber(arg[i + 1]), "count expected")
+            i = i + 2
+        else
+            Scripts[#Scripts + 1] = arg[i]
+            i = i + 1
+        end
+    end
+end
+
+if #Scripts == 0 then
+    print("usage: lua oppairs.lua [-n count] script...")
+    return
+end
+
+--[[ Opcodes after which the next instruction does not always run --]]
+local NoFallthrough = {}
+for op in ([[
+    JMP EQ LT LE EQK EQI LTI LEI GTI GEI TEST TESTSET CALL TAILCALL
+    RETURN RETURN0 RETURN1 FORLOOP FORPREP TFORPREP TFORCALL TFORLOOP
+    LFALSESKIP LOADKX NEWTABLE SETLIST MMBIN MMBINI MMBINK EXTRAARG
+]]):gmatch("%w+") do
+    NoFallthrough[op] = true
+end
+
+local Totals = {}
+local Super = {}
+local Sum = 0
+for _, script in ipairs(Scripts) do
+    local f, err = loadfile(script, "tO")
+    if not f then
+        print(err)
+    else
+        local args = arg
+        arg = {}
+        T.oppairs()  -- reset counts
+        local ok, msg = pcall(f)
+        arg = args
+        local counts
+        counts, Super = T.oppairs()
+        if not ok then
+            print(("%s: %s"):format(script, tostring(msg)))
+        end
+        for pair, n in pairs(counts) do
+            Totals[pair] = (Totals[pair] or 0) + n
+            Sum = Sum + n
+        end
+    end
+end
+
+local Pairs = {}
+for pair in pairs(Totals) do
+    Pairs[#Pairs + 1] = pair
+end
+table.sort(Pairs, function(a, b)
+    if Totals[a] ~= Totals[b] then
+        return Totals[a] > Totals[b]
+    end
+    return a < b
+end)
+
+print(("%-28s %12s %8s %8s  %s"):format("pair", "count", "share", "total", "status"))
+local cumulative = 0
+for i=1,math.min(Count, #Pairs) do
+    local pair = Pairs[i]
+    local first, second = pair:match("^(%S+) (%S+)$")
+    local status = "candidate"
+    if Super[pair] then
+        status = "super"
+    elseif NoFallthrough[first] or second:find("^MMBIN") then
+        status = "-"
+    end
+    cumulative = cumulative + Totals[pair]
+    print(("%-28s %12d %7.2f%% %7.2f%%  %s"):format(pair, Totals[pair],
+        Totals[pair] * 100 / Sum, cumulative * 100 / Sum, status))
+end
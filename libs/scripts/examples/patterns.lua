@@ -0,0 +1,120 @@
+--[[
+================================================================================
+Pattern Matching Benchmark
+================================================================================
+Applies a fixed set of log-parsing patterns to a generated corpus of lines with
+string.find, string.match, string.gmatch, and string.gsub. Each pattern is used
+many times, exercising the compiled pattern cache of the string library: most
+of the subject positions are skipped by the literal-prefix and first-character
+filters of the compiled patterns.
+
+Usage:
+    lua patterns.lua [lines] [iterations]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local os_clock = os.clock
+local string_find = string.find
+local string_match = string.match
+local string_gmatch = string.gmatch
+local string_gsub = string.gsub
+local rand = math.random
+
+local LineCount = tonumber(arg[1]) or 20000
+local Iterations = tonumber(arg[2]) or 5
+
+local Levels = { "DEBUG", "INFO", "WARN", "ERROR" }
+local Words = { "request", "session", "cache", "timeout", "handler", "socket", "worker", "queue" }
+
+--[[ Create a corpus of log lines --]]
+local function CreateCorpus(count)
+    local lines = {}
+    for i=1,count do
+        local msg = {}
+        for j=1,rand(4, 12) do
+            msg[j] = Words[rand(#Words)]
+        end
+
+        lines[i] = ("2024-%02d-%02d %02d:%02d:%02d [%s] id=%d ip=%d.%d.%d.%d %s (%d ms) user=\"u%d\""):format(
+            rand(12), rand(28), rand(0, 23), rand(0, 59), rand(0, 59),
+            Levels[rand(#Levels)], i,
+            rand(255), rand(255), rand(255), rand(255),
+            table.concat(msg, " "), rand(1000), rand(100)
+        )
+    end
+    return lines
+end
+
+local Benchmarks = {
+    { "find (prefix)", function(lines)
+        local n = 0
+        for i=1,#lines do
+            if string_find(lines[i], "ERROR%] id=%d+") then n = n + 1 end
+        end
+        return n
+    end },
+
+    { "find (anchored)", function(lines)
+        local n = 0
+        for i=1,#lines do
+            if string_find(lines[i], "^%d+%-0[1-6]") then n = n + 1 end
+        end
+        return n
+    end },
+
+    { "match (captures)", function(lines)
+        local n = 0
+        for i=1,#lines do
+            local a,b,c,d = string_match(lines[i], "ip=(%d+)%.(%d+)%.(%d+)%.(%d+)")
+            if a then n = n + 1 end
+        end
+        return n
+    end },
+
+    { "match (char set)", function(lines)
+        local n = 0
+        for i=1,#lines do
+            local ms = string_match(lines[i], "%((%d+) ms%)")
+            if ms then n = n + 1 end
+        end
+        return n
+    end },
+
+    { "gmatch (quoted)", function(lines)
+        local n = 0
+        for i=1,#lines do
+            for _ in string_gmatch(lines[i], "\"([^\"]*)\"") do n = n + 1 end
+        end
+        return n
+    end },
+
+    { "gsub (keys)", function(lines)
+        local n = 0
+        for i=1,#lines do
+            local _,count = string_gsub(lines[i], "id=%d+", "id=?")
+            n = n + count
+        end
+        return n
+    end },
+}
+
+local function Benchmark()
+    math.randomseed(LineCount)
+
+    local lines = CreateCorpus(LineCount)
+    print(("Lines: %d, Iterations: %d"):format(LineCount, Iterations))
+    for i=1,#Benchmarks do
+        local name,func = Benchmarks[i][1],Benchmarks[i][2]
+
+        local result = 0
+        local t0 = os_clock()
+        for _=1,Iterations do
+            result = func(lines)
+        end
+        local t1 = os_clock()
+        print(("%-18s %10.3f ms/iteration (%d results)"):format(name, 1000.0 * (t1 - t0) / Iterations, result))
+    end
+end
+
+Benchmark()
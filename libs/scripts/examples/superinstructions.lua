@@ -0,0 +1,116 @@
+--[[
+================================================================================
+Superinstruction Benchmark: pairs of opcodes fused by the 'O' load mode
+================================================================================
+Loads one kernel per pair of opcodes listed in lopcodes.c twice, as a plain
+chunk ("t") and as an optimized one ("tO"), where a superinstruction replaces
+each occurrence of the pair. Every kernel is a loop whose body repeats the pair
+four times; the kernels have no inlinable calls and no dead code, so the two
+chunks differ only in their superinstructions (check with 'luac -O -l').
+
+The kernel "control" loads the same chunk twice, without 'O': its change shows
+the noise of the machine, and a pair is only worth fusing when its change is
+clearly beyond that.
+
+Each round times both chunks, alternating which one runs first, and takes
+the ratio of their times; the columns are the first quartile, the median, and
+the third quartile of those ratios, as a change of "tO" relative to "t". A
+negative change means that the superinstruction is faster. On a busy machine
+use more rounds (and pin the process to one CPU, e.g. with 'taskset').
+
+Usage:
+    lua superinstructions.lua [iterations] [rounds] [pattern]
+
+@LICENSE
+    See Copyright Notice in lua.h
+--]]
+local os_clock = os.clock
+
+local Iterations = tonumber(arg and arg[1]) or 100000
+local Rounds = tonumber(arg and arg[2]) or 201
+local Pattern = arg and arg[3]
+
+--[[ Loop bodies: { name, body, mode of the second chunk } --]]
+local Kernels = {
+    { "control", "s = s + i", "t" },
+    { "MOVE_CALL", "id(a) id(a) id(a) id(a)" },
+    { "LOADI_CALL", "id(1) id(1) id(1) id(1)" },
+    { "GETTABLE_CALL", "fs[a]() fs[b]() fs[a]() fs[b]()" },
+    { "SELF_CALL", "obj:get() obj:get() obj:get() obj:get()" },
+    { "GETUPVAL_GETTABLE",
+        "local x1 = t[a] local x2 = t[a] local x3 = t[a] local x4 = t[a]" },
+    { "MOVE_GETTABLE", "g(u[a]) g(u[a]) g(u[a]) g(u[a])" },
+    { "GETTABUP_GETFIELD",
+        "local x1, x2, x3, x4 = math.pi, math.pi, math.pi, math.pi" },
+    { "GETFIELD_GETFIELD",
+        "local x1, x2, x3, x4 = q.pos.x, q.pos.y, q.pos.x, q.pos.y" },
+    { "MUL_ADD", "s = s + a * b + a * b + a * b + a * b" },
+    { "MODK_EQI", [[
+        if i % 3 == 0 then s = s + 1 end
+        if i % 5 == 0 then s = s + 1 end
+        if i % 7 == 0 then s = s + 1 end
+        if i % 11 == 0 then s = s + 1 end
+    ]] },
+}
+
+--[[ Source of the kernel that runs 'body' in a loop --]]
+local function Source(body)
+    return [[
+        local function nop() end
+        local function id(x) return x end
+        local fns = { nop, nop, nop }
+        local t = {}
+        for i=1,256 do t[i] = i end
+        local o = { pos = { x = 1, y = 2 } }
+        local obj = { n = 0 }
+        function obj:get() return self.n end
+        return function(n)
+            local s, a, b = 0, 1, 2
+            local u, fs, g, q = t, fns, id, o
+            for i=1,n do
+                ]] .. body .. [[
+
+            end
+            return s
+        end
+    ]]
+end
+
+local function Time(f)
+    local t0 = os_clock()
+    f(Iterations)
+    return os_clock() - t0
+end
+
+--[[ Quartiles of the changes of 'optimized' relative to 'plain', in % --]]
+local function Compare(plain, optimized)
+    local ratios = {}
+    for r=1,Rounds do
+        local t, tO
+        if r % 2 == 0 then
+            t = Time(plain); tO = Time(optimized)
+        else
+            tO = Time(optimized); t = Time(plain)
+        end
+        ratios[r] = tO / t
+    end
+    table.sort(ratios)
+    local function q(x)
+        return (ratios[math.floor(x * (Rounds - 1)) + 1] - 1) * 100
+    end
+    return q(0.25), q(0.5), q(0.75)
+end
+
+print(("Iterations: %d, Rounds: %d"):format(Iterations, Rounds))
+print(("%-18s %8s %8s %8s"):format("kernel", "q25", "median", "q75"))
+for _, kernel in ipairs(Kernels) do
+    local name, body, mode = kernel[1], kernel[2], kernel[3] or "tO"
+    if not Pattern or string.find(name, Pattern) then
+        local source = Source(body)
+        local plain = assert(load(source, "=" .. name, "t"))()
+        local optimized = assert(load(source, "=" .. name, mode))()
+        assert(plain(100) == optimized(100))
+        print(("%-18s %7.1f%% %7.1f%% %7.1f%%"):format(name,
+            Compare(plain, optimized)))
+    end
+end
@@ -53,6 +53,9 @@ static const luaL_Reg loadedlibs[] = {
   {LUA_MATHLIBNAME, luaopen_math},
   {LUA_UTF8LIBNAME, luaopen_utf8},
   {LUA_DBLIBNAME, luaopen_debug},
+#if defined(LUA_USE_JIT)
+  {LUA_JITLIBNAME, luaopen_jit},
+#endif
 #if defined(LUA_INCLUDE_LIBGLM)
   {LUA_GLMLIBNAME, luaopen_glm},
 #endif
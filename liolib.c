@@ -662,13 +662,12 @@ static int g_write (lua_State *L, FILE *f, int arg) {
   int status = 1;
   for (; nargs--; arg++) {
     if (lua_type(L, arg) == LUA_TNUMBER) {
-      /* optimization: could be done exactly as for strings */
+      char buff[64];  /* enough for LUA_INTEGER_FMT and LUA_NUMBER_FMT */
       int len = lua_isinteger(L, arg)
-                ? fprintf(f, LUA_INTEGER_FMT,
-                             (LUAI_UACINT)lua_tointeger(L, arg))
-                : fprintf(f, LUA_NUMBER_FMT,
-                             (LUAI_UACNUMBER)lua_tonumber(L, arg));
-      status = status && (len > 0);
+                ? lua_fmtinteger(buff, sizeof(buff), lua_tointeger(L, arg))
+                : lua_fmtnumber(buff, sizeof(buff), 0, 0, lua_tonumber(L, arg));
+      status = status && (len > 0) &&
+               (fwrite(buff, sizeof(char), len, f) == (size_t)len);
     }
     else {
       size_t l;
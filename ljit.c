@@ -0,0 +1,1341 @@
+/*
+** $Id: ljit.c $
+** Baseline JIT compiler (copy-and-patch)
+** See Copyright Notice in lua.h
+*/
+
+#define ljit_c
+#define LUA_CORE
+
+#if !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE  /* 'MAP_ANONYMOUS' in <sys/mman.h> */
+#endif
+
+#include "lprefix.h"
+
+
+#include <stddef.h>
+#include <string.h>
+
+#include "lua.h"
+
+#include "ldebug.h"
+#include "lfunc.h"
+#include "ljit.h"
+#include "lobject.h"
+#include "lopcodes.h"
+#include "lstate.h"
+#include "ltable.h"
+
+
+#if defined(LUA_USE_JIT)
+
+/*
+** The compiler translates a whole prototype to native code by copying,
+** for each instruction, precompiled fragments of machine code (the
+** stencils in 'ljitstencils.h', generated from 'etc/jitstencils.s')
+** and patching their holes: register offsets, constants, and jump
+** targets. Native code works on the frame exactly like the interpreter
+** and never calls anything: whatever it cannot do (calls, metamethods,
+** errors, allocation) goes back to 'luaV_execute' through an exit,
+** which returns the instruction where the interpreter must go on.
+**
+** Stencils are chosen by the types that a forward analysis expects in
+** the registers (seeded with the values in the frame when the function
+** gets hot), but each stencil checks the tags it depends on. When the
+** checks of an instruction fail too often, the instruction goes up one
+** level and the function is compiled again: level 0 uses the analysis,
+** level 1 uses the tags seen when the checks failed, and level 2 is an
+** exit to the interpreter.
+**
+** The interpreter enters native code (see 'jitrun' in 'lvm.c') when a
+** function starts or a call returns to it, and at the back jumps of
+** loops; native code goes back to the interpreter at loop heads when
+** 'trap' is set, so that hooks and signals see the same instructions
+** they would see in the interpreter.
+*/
+
+
+/*
+** Only x86-64 (System V) has stencils; elsewhere the 'jit' library
+** exists but never compiles anything. The stencils also assume the
+** tags below.
+*/
+#if defined(__x86_64__) && defined(__linux__) &&  \
+    LUA_VNUMINT == 0x03 && LUA_VNUMFLT == 0x13 && LUA_VNIL == 0x00 &&  \
+    LUA_VFALSE == 0x01 && LUA_VTRUE == 0x11 && LUA_TVECTOR == 0x04 &&  \
+    LUA_VVECTOR2 == 0x04 && LUA_VVECTOR3 == 0x14 &&  \
+    LUA_VVECTOR4 == 0x24 && ctb(LUA_VTABLE) == 0x46 &&  \
+    BIT_ISCOLLECTABLE == 0x40 && LUA_FLOAT_TYPE == LUA_FLOAT_DOUBLE &&  \
+    LUA_INT_TYPE == LUA_INT_LONGLONG
+#define JIT_ARCH	"x64"
+#endif
+
+
+#if defined(JIT_ARCH)
+
+#include <sys/mman.h>
+
+
+/* kinds of holes (relocations) */
+enum JitRelocation {
+  JR_64,  /* 64-bit value */
+  JR_32,  /* 32-bit unsigned value */
+  JR_32S,  /* 32-bit signed value */
+  JR_8,  /* 8-bit unsigned value */
+  JR_PC32  /* 32-bit offset relative to the hole */
+};
+
+
+typedef struct JitHole {
+  unsigned short offset;  /* offset of the hole in its stencil */
+  lu_byte kind;  /* 'JitRelocation' */
+  lu_byte hole;  /* value patched in it ('JitHoleName') */
+  int addend;
+} JitHole;
+
+
+typedef struct JitStencil {
+  const lu_byte *code;
+  size_t size;
+  const JitHole *holes;
+  size_t nholes;
+} JitStencil;
+
+
+#define jitstencil(n)  \
+	{n##_code, sizeof(n##_code), n##_holes, sizeof(n##_holes)/sizeof(JitHole)}
+#define jitstencil0(n)	{n##_code, sizeof(n##_code), NULL, 0}
+
+#include "ljitstencils.h"
+
+
+/* native code of a prototype, from instruction 'pc' */
+typedef size_t (*JitFunction) (StkId base, CallInfo *ci, LClosure *cl);
+
+
+/* 'JitCode.entries' of instructions that native code cannot start */
+#define NOENTRY		(~0u)
+
+/* levels of instructions (see the comment at the top of the file) */
+#define JL_HINTS	1
+#define JL_EXIT		2
+
+/* guard exits of an instruction before it goes up one level */
+#if !defined(LUAI_JITMAXEXITS)
+#define LUAI_JITMAXEXITS	64
+#endif
+
+
+typedef struct JitCode {
+  lu_byte *mcode;  /* native code (NULL when not compiled yet) */
+  size_t sizemcode;  /* size of 'mcode' */
+  int hot;  /* entries left before compiling the function */
+  int failed;  /* true when the function could not be compiled */
+  int nnative;  /* number of instructions with native code */
+  int nexit;  /* number of instructions compiled as exits */
+  unsigned int *entries;  /* offset of each instruction in 'mcode' */
+  unsigned short *exits;  /* guard exits taken at each instruction */
+  lu_byte *level;  /* level of each instruction */
+  lu_byte *hint;  /* types seen at guard exits (2 per instruction) */
+} JitCode;
+
+
+/* types in the forward analysis (a set of them per register) */
+#define TY_INT		1
+#define TY_FLT		2
+#define TY_VEC2		4
+#define TY_VEC3		8
+#define TY_VEC4		16
+#define TY_OTHER	32
+#define TY_NUM		(TY_INT | TY_FLT)
+#define TY_VEC		(TY_VEC2 | TY_VEC3 | TY_VEC4)
+#define TY_ALL		(TY_NUM | TY_VEC | TY_OTHER)
+
+/* sets of types are 'a' in 'b' */
+#define tyin(a,b)	((a) != 0 && ((a) & ~(b)) == 0)
+
+/* maximum number of sweeps of the analysis */
+#define JIT_MAXSWEEPS	10
+
+/* maximum size (instructions times registers) of the analysis */
+#define JIT_MAXTYPES	(1 << 20)
+
+/* maximum size of the native code of a function */
+#define JIT_MAXCODE	(1 << 24)
+
+
+/* flags of instructions while compiling */
+#define JF_LOOP		1  /* head of a loop */
+#define JF_EXIT		2  /* needs a guard exit */
+#define JF_LEAVE	4  /* needs an exit for 'trap' */
+#define JF_SEEN		8  /* reached by the analysis */
+
+
+typedef struct JitState {
+  LClosure *cl;
+  Proto *p;
+  JitCode *jc;
+  lu_byte *code;  /* native code (NULL in the dry pass) */
+  size_t size;  /* size of the code so far */
+  size_t *pos;  /* position of the code of each instruction */
+  size_t *stub;  /* positions of the exits of each instruction (2 each) */
+  lu_byte *flags;  /* flags of each instruction ('JF_*') */
+  lu_byte *seed;  /* types of the registers in the frame */
+  lu_byte *types;  /* types of registers before each instruction */
+  lu_byte *temp;  /* types while analyzing an instruction */
+  size_t pool;  /* position of the pool of integer constants */
+  int npool;  /* number of integer constants in the pool */
+  int n;  /* instruction being compiled */
+  ptrdiff_t hv[NUM_HOLES];  /* values for the holes of the stencils */
+} JitState;
+
+
+
+/*
+** {======================================================
+** Memory
+** =======================================================
+*/
+
+/*
+** Blocks of the compiler use the raw allocation function, so that
+** compiling never runs the collector or raises errors; when there is
+** no memory, the function just stays interpreted.
+*/
+static void *jitalloc (global_State *g, size_t size) {
+  return (*g->frealloc)(g->ud, NULL, 0, size);
+}
+
+
+static void jitfree (global_State *g, void *block, size_t size) {
+  (*g->frealloc)(g->ud, block, size, 0);
+}
+
+
+static size_t sizejitcode (int n) {
+  return sizeof(JitCode) + cast_sizet(n) * (sizeof(unsigned int) +
+         sizeof(unsigned short) + 3 * sizeof(lu_byte));
+}
+
+
+static JitCode *newjitcode (lua_State *L, Proto *p) {
+  int n = p->sizecode;
+  JitCode *jc = cast(JitCode *, jitalloc(G(L), sizejitcode(n)));
+  if (jc != NULL) {
+    int i;
+    jc->mcode = NULL;
+    jc->sizemcode = 0;
+    jc->hot = LUAI_JITHOT;
+    jc->failed = 0;
+    jc->nnative = jc->nexit = 0;
+    jc->entries = cast(unsigned int *, jc + 1);
+    jc->exits = cast(unsigned short *, jc->entries + n);
+    jc->level = cast(lu_byte *, jc->exits + n);
+    jc->hint = jc->level + n;
+    for (i = 0; i < n; i++) {
+      jc->entries[i] = NOENTRY;
+      jc->exits[i] = 0;
+      jc->level[i] = 0;
+      jc->hint[2 * i] = jc->hint[2 * i + 1] = 0;
+    }
+  }
+  return jc;
+}
+
+
+static void freemcode (JitCode *jc) {
+  if (jc->mcode != NULL) {
+    munmap(jc->mcode, jc->sizemcode);
+    jc->mcode = NULL;
+    jc->sizemcode = 0;
+  }
+}
+
+
+static void freejitcode (lua_State *L, Proto *p) {
+  JitCode *jc = p->jit;
+  if (jc != NULL) {
+    freemcode(jc);
+    jitfree(G(L), jc, sizejitcode(p->sizecode));
+    p->jit = NULL;
+  }
+}
+
+/* }====================================================== */
+
+
+
+/*
+** {======================================================
+** Analysis of types
+** =======================================================
+*/
+
+static int tymask (const TValue *o) {
+  switch (ttypetag(o)) {
+    case LUA_VNUMINT: return TY_INT;
+    case LUA_VNUMFLT: return TY_FLT;
+    case LUA_VVECTOR2: return TY_VEC2;
+    case LUA_VVECTOR3: return TY_VEC3;
+    case LUA_VVECTOR4: return TY_VEC4;
+    default: return TY_OTHER;
+  }
+}
+
+
+/* kinds of arithmetic stencils, by the types of their operands */
+#define AV_II	0  /* two integers */
+#define AV_FF	1  /* two floats */
+#define AV_NN	2  /* two numbers */
+#define AV_VV	3  /* two vectors of the same size */
+#define AV_VN	4  /* a vector and a number */
+#define AV_NV	5  /* a number and a vector */
+#define AV_N	6
+
+
+/* arithmetic opcodes with stencils (-1 for missing stencils) */
+#define AO_ADD	0
+#define AO_SUB	1
+#define AO_MUL	2
+#define AO_DIV	3
+#define AO_MOD	4
+#define AO_IDIV	5
+#define AO_BAND	6
+#define AO_BOR	7
+#define AO_BXOR	8
+
+static const short arithstencils[][AV_N] = {
+  {ST_ADD_II, ST_ADD_FF, ST_ADD_NN, ST_ADD_VV, ST_ADD_VN, ST_ADD_NV},
+  {ST_SUB_II, ST_SUB_FF, ST_SUB_NN, ST_SUB_VV, ST_SUB_VN, ST_SUB_NV},
+  {ST_MUL_II, ST_MUL_FF, ST_MUL_NN, ST_MUL_VV, ST_MUL_VN, ST_MUL_NV},
+  {-1, ST_DIV_FF, ST_DIV_NN, ST_DIV_VV, ST_DIV_VN, ST_DIV_NV},
+  {ST_MOD_II, -1, -1, -1, -1, -1},
+  {ST_IDIV_II, -1, -1, -1, -1, -1},
+  {ST_BAND_II, -1, -1, -1, -1, -1},
+  {ST_BOR_II, -1, -1, -1, -1, -1},
+  {ST_BXOR_II, -1, -1, -1, -1, -1}
+};
+
+
+/*
+** Arithmetic stencils of opcode 'op' ('AO_*'), or -1 when it has none.
+** 'c' is how it gets its second operand: 'r' (a register), 'k' (a
+** constant), or 'i' (an immediate).
+*/
+static int arithop (OpCode op, int *c) {
+  *c = 'r';
+  switch (op) {
+    case OP_ADDI: *c = 'i'; return AO_ADD;
+    case OP_ADDK: *c = 'k'; return AO_ADD;
+    case OP_SUBK: *c = 'k'; return AO_SUB;
+    case OP_MULK: *c = 'k'; return AO_MUL;
+    case OP_DIVK: *c = 'k'; return AO_DIV;
+    case OP_MODK: *c = 'k'; return AO_MOD;
+    case OP_IDIVK: *c = 'k'; return AO_IDIV;
+    case OP_BANDK: *c = 'k'; return AO_BAND;
+    case OP_BORK: *c = 'k'; return AO_BOR;
+    case OP_BXORK: *c = 'k'; return AO_BXOR;
+    case OP_ADD: return AO_ADD;
+    case OP_SUB: return AO_SUB;
+    case OP_MUL: return AO_MUL;
+    case OP_DIV: return AO_DIV;
+    case OP_MOD: return AO_MOD;
+    case OP_IDIV: return AO_IDIV;
+    case OP_BAND: return AO_BAND;
+    case OP_BOR: return AO_BOR;
+    case OP_BXOR: return AO_BXOR;
+    default: return -1;
+  }
+}
+
+
+/* kind of arithmetic stencil for operands of types 'b' and 'c' */
+static int arithkind (int b, int c) {
+  if (b == TY_INT && c == TY_INT)
+    return AV_II;
+  else if (b == TY_FLT && c == TY_FLT)
+    return AV_FF;
+  else if (tyin(b, TY_VEC) && tyin(c, TY_VEC))
+    return AV_VV;
+  else if (tyin(b, TY_VEC) && tyin(c, TY_NUM))
+    return AV_VN;
+  else if (tyin(b, TY_NUM) && tyin(c, TY_VEC))
+    return AV_NV;
+  else
+    return AV_NN;
+}
+
+
+/* types of the result of arithmetic opcode 'ao' */
+static int arithtype (int ao, OpCode op, int b, int c) {
+  int r = 0;
+  if ((b | c) & TY_OTHER)  /* strings or metamethods? */
+    return TY_ALL;
+  if (ao < 0) {  /* no stencils? */
+    if (op == OP_POW || op == OP_POWK)
+      r = TY_FLT;
+    else  /* shifts */
+      r = TY_INT;
+  }
+  else if (ao >= AO_BAND)
+    r = TY_INT;
+  else if ((b & TY_NUM) && (c & TY_NUM)) {
+    if (ao == AO_DIV)
+      r = TY_FLT;
+    else {
+      if ((b & TY_INT) && (c & TY_INT)) r |= TY_INT;
+      if ((b | c) & TY_FLT) r |= TY_FLT;
+    }
+  }
+  r |= b & TY_VEC;  /* vector op vector or vector op number */
+  if (b & TY_NUM)
+    r |= c & TY_VEC;  /* number op vector */
+  if ((b | c) & TY_VEC && ao >= AO_MOD)
+    return TY_ALL;
+  return (r != 0) ? r : TY_ALL;
+}
+
+
+/* set 'n' registers from 'r' to types 't' */
+static void settypes (const Proto *p, lu_byte *s, int r, int n, int t) {
+  for (; n > 0 && r < p->maxstacksize; n--, r++)
+    s[r] = cast_byte(t);
+}
+
+
+/* types of the registers after instruction 'i', from types 's' before */
+static void transfer (JitState *J, lu_byte *s, Instruction i) {
+  const Proto *p = J->p;
+  OpCode op = getBaseOp(GET_OPCODE(i));
+  int a = GETARG_A(i);
+  int all = p->maxstacksize;  /* all registers from 'a' */
+  int c;
+  int ao = arithop(op, &c);
+  if (op >= OP_ADDI && op <= OP_SHR) {  /* arithmetic? */
+    int tb = s[GETARG_B(i)];
+    int tc = (op == OP_ADDI || op == OP_SHRI || op == OP_SHLI) ? TY_INT
+           : (op < OP_SHRI) ? tymask(&p->k[GETARG_C(i)])  /* OP_*K */
+           : s[GETARG_C(i)];
+    s[a] = cast_byte(arithtype(ao, op, tb, tc));
+    return;
+  }
+  switch (op) {
+    case OP_MOVE: s[a] = s[GETARG_B(i)]; break;
+    case OP_LOADI: s[a] = TY_INT; break;
+    case OP_LOADF: s[a] = TY_FLT; break;
+    case OP_LOADK: s[a] = cast_byte(tymask(&p->k[GETARG_Bx(i)])); break;
+    case OP_LOADNIL: settypes(p, s, a, GETARG_B(i) + 1, TY_OTHER); break;
+    case OP_LOADFALSE: case OP_LFALSESKIP: case OP_LOADTRUE:
+    case OP_NOT: {
+      s[a] = TY_OTHER;
+      break;
+    }
+    case OP_GETUPVAL: {
+      s[a] = cast_byte(tymask(J->cl->upvals[GETARG_B(i)]->v));
+      break;
+    }
+    case OP_UNM: {
+      int tb = s[GETARG_B(i)];
+      s[a] = cast_byte((tb & TY_OTHER) ? TY_ALL : tb);
+      break;
+    }
+    case OP_GETTABLE: case OP_GETI: case OP_GETFIELD: {
+      int tb = s[GETARG_B(i)];  /* components of vectors are floats */
+      s[a] = cast_byte(((tb & TY_VEC) ? TY_FLT : 0) |
+                       ((tb & ~TY_VEC) ? TY_ALL : 0));
+      break;
+    }
+    case OP_FORPREP: {
+      int intloop = (s[a] & TY_INT) && (s[a + 2] & TY_INT);
+      int fltloop = !(s[a] == TY_INT && s[a + 2] == TY_INT);
+      settypes(p, s, a, 4, (intloop ? TY_INT : 0) | (fltloop ? TY_FLT : 0));
+      break;
+    }
+    case OP_SELF: settypes(p, s, a, 2, TY_ALL); break;
+    case OP_CALL: case OP_VARARG: settypes(p, s, a, all, TY_ALL); break;
+    case OP_TFORCALL: settypes(p, s, a + 4, all, TY_ALL); break;
+    case OP_TFORLOOP: s[a + 2] = s[a + 4]; break;
+    default: {
+      if (testAMode(op))
+        s[a] = TY_ALL;
+      break;
+    }
+  }
+}
+
+
+/* successors of instruction 'n' (returns how many) */
+static int successors (const Proto *p, int n, int *succ) {
+  Instruction i = p->code[n];
+  OpCode op = getBaseOp(GET_OPCODE(i));
+  int ns = 0;
+  switch (op) {
+    case OP_JMP: succ[ns++] = n + 1 + GETARG_sJ(i); break;
+    case OP_FORLOOP: case OP_TFORLOOP: {
+      succ[ns++] = n + 1;
+      succ[ns++] = n + 1 - GETARG_Bx(i);
+      break;
+    }
+    case OP_FORPREP: {
+      succ[ns++] = n + 1;
+      succ[ns++] = n + 2 + GETARG_Bx(i);
+      break;
+    }
+    case OP_TFORPREP: succ[ns++] = n + 1 + GETARG_Bx(i); break;
+    case OP_LFALSESKIP: succ[ns++] = n + 2; break;
+    case OP_RETURN: case OP_RETURN0: case OP_RETURN1:
+    case OP_TAILCALL: {
+      break;
+    }
+    default: {
+      succ[ns++] = n + 1;
+      if (testTMode(op))
+        succ[ns++] = n + 2;
+      break;
+    }
+  }
+  return ns;
+}
+
+
+/*
+** Forward analysis of the types in the registers, from the types in
+** the frame at instruction 'start'. Instructions that the analysis does
+** not reach (e.g., before 'start') use the types in the frame.
+*/
+static void analyze (JitState *J, int start) {
+  Proto *p = J->p;
+  int fs = p->maxstacksize;
+  int sweep, changed, n, k;
+  if (J->types == NULL)
+    return;
+  memcpy(J->types + cast_sizet(start) * fs, J->seed, fs);
+  J->flags[start] |= JF_SEEN;
+  for (sweep = 0, changed = 1; changed && sweep < JIT_MAXSWEEPS; sweep++) {
+    changed = 0;
+    for (n = 0; n < p->sizecode; n++) {
+      int succ[2];
+      int ns;
+      if (!(J->flags[n] & JF_SEEN))
+        continue;
+      memcpy(J->temp, J->types + cast_sizet(n) * fs, fs);
+      transfer(J, J->temp, p->code[n]);
+      ns = successors(p, n, succ);
+      while (ns--) {
+        int s = succ[ns];
+        lu_byte *ts;
+        if (s < 0 || s >= p->sizecode)
+          continue;
+        ts = J->types + cast_sizet(s) * fs;
+        if (!(J->flags[s] & JF_SEEN)) {
+          memcpy(ts, J->temp, fs);
+          J->flags[s] |= JF_SEEN;
+          changed = 1;
+        }
+        else {
+          for (k = 0; k < fs; k++) {
+            if ((ts[k] | J->temp[k]) != ts[k]) {
+              ts[k] |= J->temp[k];
+              changed = 1;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+
+/* types of register 'r' before the current instruction */
+static int regtype (JitState *J, int r) {
+  const lu_byte *s = J->seed;
+  if (J->types != NULL && (J->flags[J->n] & JF_SEEN))
+    s = J->types + cast_sizet(J->n) * J->p->maxstacksize;
+  return (s[r] != 0) ? s[r] : TY_ALL;
+}
+
+
+/*
+** Types of operand 'o' (0 or 1, see 'seen') with expected types 't':
+** at level 'JL_HINTS' they are the types seen at guard exits.
+*/
+static int optype (JitState *J, int o, int t) {
+  int n = J->n;
+  if (J->jc->level[n] == JL_HINTS && J->jc->hint[2 * n + o] != 0)
+    return J->jc->hint[2 * n + o];
+  return t;
+}
+
+/* }====================================================== */
+
+
+
+/*
+** {======================================================
+** Code generation
+** =======================================================
+*/
+
+/* address of position 'pos' of the code (0 in the dry pass) */
+static ptrdiff_t codeaddr (JitState *J, size_t pos) {
+  return (J->code != NULL) ? cast(ptrdiff_t, J->code + pos) : 0;
+}
+
+
+static void patch (JitState *J, lu_byte *at, const JitHole *h) {
+  lu_byte *ph = at + h->offset;
+  ptrdiff_t v = J->hv[h->hole] + h->addend;
+  size_t u;
+  int nbytes = 4;
+  switch (h->kind) {
+    case JR_64: nbytes = 8; break;
+    case JR_32: lua_assert(0 <= v && v <= 0xffffffffL); break;
+    case JR_32S: lua_assert(-0x80000000L <= v && v <= 0x7fffffffL); break;
+    case JR_8: lua_assert(0 <= v && v <= 0xff); nbytes = 1; break;
+    default: {
+      lua_assert(h->kind == JR_PC32);
+      v -= cast(ptrdiff_t, ph);
+      lua_assert(-0x80000000L <= v && v <= 0x7fffffffL);
+      break;
+    }
+  }
+  for (u = cast_sizet(v); nbytes > 0; nbytes--, u >>= 8)
+    *ph++ = cast_byte(u & 0xff);
+}
+
+
+/* append stencil 'st' to the code */
+static void emit (JitState *J, int st) {
+  const JitStencil *s = &jitstencils[st];
+  size_t h;
+  if (J->code != NULL) {
+    lu_byte *at = J->code + J->size;
+    memcpy(at, s->code, s->size);
+    for (h = 0; h < s->nholes; h++)
+      patch(J, at, &s->holes[h]);
+  }
+  else {  /* dry pass: find which exits the instruction needs */
+    for (h = 0; h < s->nholes; h++) {
+      if (s->holes[h].hole == JH_EXIT)
+        J->flags[J->n] |= JF_EXIT;
+      else if (s->holes[h].hole == JH_LEAVE)
+        J->flags[J->n] |= JF_LEAVE;
+    }
+  }
+  J->size += s->size;
+}
+
+
+#define regoffset(r)	cast(ptrdiff_t, (r) * sizeof(StackValue))
+
+/* operands of a stencil in '%r10' (A), '%r8' (B), and '%r9' (C) */
+static void opra (JitState *J, int r) {
+  J->hv[JH_RA] = regoffset(r);
+  emit(J, ST_RA);
+}
+
+
+static void oprb (JitState *J, int r) {
+  J->hv[JH_RB] = regoffset(r);
+  emit(J, ST_RB);
+}
+
+
+static void oprc (JitState *J, int r) {
+  J->hv[JH_RC] = regoffset(r);
+  emit(J, ST_RC);
+}
+
+
+static void opkb (JitState *J, const TValue *k) {
+  J->hv[JH_KB] = cast(ptrdiff_t, k);
+  emit(J, ST_KB);
+}
+
+
+static void opkc (JitState *J, const TValue *k) {
+  J->hv[JH_KC] = cast(ptrdiff_t, k);
+  emit(J, ST_KC);
+}
+
+
+/* integer constant 'v' in the pool, which follows the code */
+static const TValue *poolint (JitState *J, lua_Integer v) {
+  TValue *o = NULL;
+  if (J->code != NULL) {
+    o = cast(TValue *, J->code + J->pool) + J->npool;
+    setivalue(o, v);
+  }
+  J->npool++;
+  return o;
+}
+
+
+/* jump hole 'h' goes to the code of instruction 'n' */
+static void jumpto (JitState *J, int h, int n) {
+  lua_assert(0 <= n && n < J->p->sizecode);
+  J->hv[h] = codeaddr(J, J->pos[n]);
+}
+
+
+/*
+** Set the holes of a test at the current instruction, which goes on
+** with the jump after it when the test is equal to 'k' and skips that
+** jump otherwise (see 'docondjump' in 'lvm.c').
+*/
+static int condjump (JitState *J, int k) {
+  int n = J->n;
+  Instruction ni;
+  if (n + 2 >= J->p->sizecode)
+    return 0;
+  ni = J->p->code[n + 1];
+  if (GET_OPCODE(ni) != OP_JMP)
+    return 0;
+  jumpto(J, k ? JH_TRUE : JH_FALSE, n + 2 + GETARG_sJ(ni));
+  jumpto(J, k ? JH_FALSE : JH_TRUE, n + 2);
+  return 1;
+}
+
+
+/* store 'v' and 'tag' in register 'r' */
+static void loadv (JitState *J, int r, ptrdiff_t v, int tag) {
+  J->hv[JH_RA] = regoffset(r);
+  J->hv[JH_VAL] = v;
+  J->hv[JH_TAG] = tag;
+  emit(J, ST_LOADV);
+}
+
+
+static void settag (JitState *J, int r, int tag) {
+  J->hv[JH_RA] = regoffset(r);
+  J->hv[JH_TAG] = tag;
+  emit(J, ST_SETTAG);
+}
+
+
+/* bits of a float (to load them in a 64-bit register) */
+static ptrdiff_t fltbits (lua_Number f) {
+  ptrdiff_t v;
+  memcpy(&v, &f, sizeof(v));
+  return v;
+}
+
+
+/* whether stencils can work with vectors of this build */
+#define jitvectors()	(sizeof(lua_VecF) == 4)
+
+
+/* component of vectors that short string 'ts' accesses (or -1) */
+static int vecfield (const TString *ts) {
+  if (tsslen(ts) != 1)
+    return -1;
+  switch (*getstr(ts)) {
+    case 'x': case 'r': case '1': return 0;
+    case 'y': case 'g': case '2': return 1;
+    case 'z': case 'b': case '3': return 2;
+    case 'w': case 'a': case '4': return 3;
+    default: return -1;
+  }
+}
+
+
+/* R[A] := R[B].x for the component 'lane' */
+static void vgetfield (JitState *J, int a, int b, int lane) {
+  static const lu_byte mintags[] = {  /* smallest vector with 'lane' */
+    LUA_VVECTOR2, LUA_VVECTOR2, LUA_VVECTOR3, LUA_VVECTOR4
+  };
+  opra(J, a);
+  oprb(J, b);
+  J->hv[JH_TAG] = mintags[lane];
+  J->hv[JH_LANE] = cast(ptrdiff_t, lane * sizeof(lua_VecF));
+  emit(J, ST_VGETFIELD);
+}
+
+
+static int arith (JitState *J, Instruction i, int ao, int c) {
+  const Proto *p = J->p;
+  int tb = optype(J, 0, regtype(J, GETARG_B(i)));
+  int tc = optype(J, 1, (c == 'i') ? TY_INT
+                      : (c == 'k') ? tymask(&p->k[GETARG_C(i)])
+                      : regtype(J, GETARG_C(i)));
+  int kind = arithkind(tb, tc);
+  int st = arithstencils[ao][kind];
+  if (st < 0 && kind >= AV_VV)
+    return 0;  /* no stencil for these vectors */
+  if (st < 0)
+    st = arithstencils[ao][AV_NN];
+  if (st < 0)
+    st = arithstencils[ao][AV_II];
+  if (kind >= AV_VV && !jitvectors())
+    return 0;
+  /* the following OP_MMBIN* does the fallback of the interpreter */
+  if (J->n + 1 >= p->sizecode || !testMMMode(GET_OPCODE(p->code[J->n + 1])))
+    return 0;
+  opra(J, GETARG_A(i));
+  oprb(J, GETARG_B(i));
+  if (c == 'i')
+    opkc(J, poolint(J, GETARG_sC(i)));
+  else if (c == 'k')
+    opkc(J, &p->k[GETARG_C(i)]);
+  else
+    oprc(J, GETARG_C(i));
+  emit(J, st);
+  return 1;
+}
+
+
+/* R[A] == K[B] */
+static int eqk (JitState *J, Instruction i) {
+  const TValue *k = &J->p->k[GETARG_B(i)];
+  int st;
+  switch (ttypetag(k)) {
+    case LUA_VNIL: case LUA_VFALSE: case LUA_VTRUE: {
+      st = ST_EQKTAG;
+      break;
+    }
+    case LUA_VSHRSTR: {
+      J->hv[JH_VAL] = cast(ptrdiff_t, gcvalue(k));
+      st = ST_EQKSTR;
+      break;
+    }
+    case LUA_VNUMINT: {
+      J->hv[JH_VAL] = cast(ptrdiff_t, ivalue(k));
+      st = ST_EQKINT;
+      break;
+    }
+    case LUA_VNUMFLT: {
+      J->hv[JH_VAL] = fltbits(fltvalue(k));
+      st = ST_EQKFLT;
+      break;
+    }
+    default: return 0;
+  }
+  J->hv[JH_TAG] = rawtt(k);
+  if (!condjump(J, GETARG_k(i)))
+    return 0;
+  opra(J, GETARG_A(i));
+  emit(J, st);
+  return 1;
+}
+
+
+/* numerical 'for' loops */
+static int forloop (JitState *J, Instruction i) {
+  int a = GETARG_A(i);
+  int t = optype(J, 0, regtype(J, a + 2));
+  int st = ST_FORLOOP;
+  if (J->jc->level[J->n] == 0)
+    st = (t == TY_INT) ? ST_FORLOOP_I : (t == TY_FLT) ? ST_FORLOOP_F
+       : ST_FORLOOP;
+  jumpto(J, JH_TARGET, J->n + 1 - GETARG_Bx(i));
+  opra(J, a);
+  emit(J, st);
+  return 1;
+}
+
+
+static int forprep (JitState *J, Instruction i) {
+  int a = GETARG_A(i);
+  int ti = optype(J, 0, regtype(J, a));
+  int ts = optype(J, 1, regtype(J, a + 2));
+  if (!(ti & TY_INT) || !(ts & TY_INT))  /* not an integer loop? */
+    return 0;
+  if (J->n + 2 + GETARG_Bx(i) >= J->p->sizecode)
+    return 0;
+  jumpto(J, JH_TARGET, J->n + 2 + GETARG_Bx(i));
+  opra(J, a);
+  emit(J, ST_FORPREP);
+  return 1;
+}
+
+
+/*
+** Code for the current instruction. Returns 0 when it has no code, so
+** that it becomes an exit to the interpreter. (Nothing may be emitted
+** before the instruction knows it has code.)
+*/
+static int instruction (JitState *J, Instruction i) {
+  const Proto *p = J->p;
+  OpCode op = getBaseOp(GET_OPCODE(i));
+  int a = GETARG_A(i);
+  int c;
+  int ao = arithop(op, &c);
+  if (ao >= 0)
+    return arith(J, i, ao, c);
+  switch (op) {
+    case OP_MOVE: {
+      J->hv[JH_RA] = regoffset(a);
+      J->hv[JH_RB] = regoffset(GETARG_B(i));
+      emit(J, ST_MOVE);
+      return 1;
+    }
+    case OP_LOADI: {
+      loadv(J, a, cast(ptrdiff_t, GETARG_sBx(i)), LUA_VNUMINT);
+      return 1;
+    }
+    case OP_LOADF: {
+      loadv(J, a, fltbits(cast_num(GETARG_sBx(i))), LUA_VNUMFLT);
+      return 1;
+    }
+    case OP_LOADK: {
+      const TValue *k = &p->k[GETARG_Bx(i)];
+      if (ttisinteger(k))
+        loadv(J, a, cast(ptrdiff_t, ivalue(k)), LUA_VNUMINT);
+      else if (ttisfloat(k))
+        loadv(J, a, fltbits(fltvalue(k)), LUA_VNUMFLT);
+      else if (ttisstring(k))
+        loadv(J, a, cast(ptrdiff_t, gcvalue(k)), rawtt(k));
+      else
+        return 0;
+      return 1;
+    }
+    case OP_LOADFALSE: settag(J, a, LUA_VFALSE); return 1;
+    case OP_LOADTRUE: settag(J, a, LUA_VTRUE); return 1;
+    case OP_LFALSESKIP: {
+      if (J->n + 2 >= p->sizecode)
+        return 0;
+      settag(J, a, LUA_VFALSE);
+      jumpto(J, JH_TARGET, J->n + 2);
+      emit(J, ST_JMP);
+      return 1;
+    }
+    case OP_LOADNIL: {
+      int b = GETARG_B(i);
+      do {
+        settag(J, a++, LUA_VNIL);
+      } while (b--);
+      return 1;
+    }
+    case OP_GETUPVAL: {
+      J->hv[JH_RA] = regoffset(a);
+      J->hv[JH_UPVAL] = cast(ptrdiff_t, offsetof(LClosure, upvals) +
+                                        GETARG_B(i) * sizeof(UpVal *));
+      emit(J, ST_GETUPVAL);
+      return 1;
+    }
+    case OP_GETTABLE: {
+      if (tyin(optype(J, 0, regtype(J, GETARG_B(i))), TY_VEC))
+        return 0;
+      opra(J, a);
+      oprb(J, GETARG_B(i));
+      oprc(J, GETARG_C(i));
+      emit(J, ST_GETTABLE);
+      return 1;
+    }
+    case OP_GETI: {
+      int tb = optype(J, 0, regtype(J, GETARG_B(i)));
+      int n = GETARG_C(i);
+      if (tyin(tb, TY_VEC)) {
+        if (!jitvectors() || n < 1 || n > 4)
+          return 0;
+        vgetfield(J, a, GETARG_B(i), n - 1);
+        return 1;
+      }
+      opra(J, a);
+      oprb(J, GETARG_B(i));
+      opkc(J, poolint(J, n));
+      emit(J, ST_GETTABLE);
+      return 1;
+    }
+    case OP_GETFIELD: {
+      int tb = optype(J, 0, regtype(J, GETARG_B(i)));
+      int lane = vecfield(tsvalue(&p->k[GETARG_C(i)]));
+      if (!tyin(tb, TY_VEC) || !jitvectors() || lane < 0)
+        return 0;
+      vgetfield(J, a, GETARG_B(i), lane);
+      return 1;
+    }
+    case OP_SETTABLE: case OP_SETI: {
+      opra(J, a);
+      if (op == OP_SETI)
+        opkb(J, poolint(J, GETARG_B(i)));
+      else
+        oprb(J, GETARG_B(i));
+      if (GETARG_k(i))
+        opkc(J, &p->k[GETARG_C(i)]);
+      else
+        oprc(J, GETARG_C(i));
+#if defined(LUAGLM_EXT_READONLY)
+      emit(J, ST_SETTABLE_RO);
+#else
+      emit(J, ST_SETTABLE);
+#endif
+      return 1;
+    }
+    case OP_UNM: case OP_NOT: {
+      opra(J, a);
+      oprb(J, GETARG_B(i));
+      emit(J, (op == OP_UNM) ? ST_UNM : ST_NOT);
+      return 1;
+    }
+    case OP_JMP: {
+      jumpto(J, JH_TARGET, J->n + 1 + GETARG_sJ(i));
+      emit(J, ST_JMP);
+      return 1;
+    }
+    case OP_EQ: case OP_LT: case OP_LE: {
+      if (!condjump(J, GETARG_k(i)))
+        return 0;
+      opra(J, a);
+      oprb(J, GETARG_B(i));
+      emit(J, (op == OP_EQ) ? ST_EQ : (op == OP_LT) ? ST_LT : ST_LE);
+      return 1;
+    }
+    case OP_EQK: return eqk(J, i);
+    case OP_EQI: case OP_LTI: case OP_LEI: case OP_GTI: case OP_GEI: {
+      static const short st[] = {ST_EQI, ST_LTI, ST_LEI, ST_GTI, ST_GEI};
+      if (!condjump(J, GETARG_k(i)))
+        return 0;
+      J->hv[JH_IMM] = GETARG_sB(i);
+      opra(J, a);
+      emit(J, st[op - OP_EQI]);
+      return 1;
+    }
+    case OP_TEST: {
+      if (!condjump(J, GETARG_k(i)))
+        return 0;
+      opra(J, a);
+      emit(J, ST_TEST);
+      return 1;
+    }
+    case OP_FORPREP: return forprep(J, i);
+    case OP_FORLOOP: return forloop(J, i);
+    default: return 0;
+  }
+}
+
+
+/* mark the heads of loops (targets of jumps back) */
+static void markloops (JitState *J) {
+  const Proto *p = J->p;
+  int n;
+  for (n = 0; n < p->sizecode; n++) {
+    Instruction i = p->code[n];
+    int target = -1;
+    switch (getBaseOp(GET_OPCODE(i))) {
+      case OP_JMP: {
+        if (GETARG_sJ(i) < 0)
+          target = n + 1 + GETARG_sJ(i);
+        break;
+      }
+      case OP_FORLOOP: case OP_TFORLOOP: {
+        target = n + 1 - GETARG_Bx(i);
+        break;
+      }
+      default: break;
+    }
+    if (target >= 0)
+      J->flags[target] |= JF_LOOP;
+  }
+}
+
+
+/* code of all instructions (in both passes) */
+static void instructions (JitState *J) {
+  const Proto *p = J->p;
+  JitCode *jc = J->jc;
+  int n;
+  J->size = 0;
+  J->npool = 0;
+  for (n = 0; n < p->sizecode; n++) {
+    Instruction i = p->code[n];
+    OpCode op = GET_OPCODE(i);
+    J->n = n;
+    lua_assert(J->code == NULL || J->pos[n] == J->size);
+    J->pos[n] = J->size;
+    J->hv[JH_EXIT] = codeaddr(J, J->stub[2 * n]);
+    J->hv[JH_LEAVE] = codeaddr(J, J->stub[2 * n + 1]);
+    jc->entries[n] = NOENTRY;
+    if (testMMMode(op) || op == OP_EXTRAARG)
+      continue;  /* never runs by itself */
+    if (J->flags[n] & JF_LOOP)
+      emit(J, ST_LOOP);
+    if (jc->level[n] < JL_EXIT && instruction(J, i)) {
+      jc->entries[n] = cast_uint(J->pos[n]);
+      jc->nnative++;
+    }
+    else {  /* exit to the interpreter at this instruction */
+      J->hv[JH_PC] = cast(ptrdiff_t, n) << 1;
+      emit(J, ST_EXIT);
+      jc->nexit++;
+    }
+  }
+}
+
+
+/* exits after the code: a guard exit and a 'trap' exit */
+static void exits (JitState *J) {
+  int n;
+  for (n = 0; n < J->p->sizecode; n++) {
+    J->n = n;
+    if (J->flags[n] & JF_EXIT) {
+      J->stub[2 * n] = J->size;
+      J->hv[JH_PC] = (cast(ptrdiff_t, n) << 1) | 1;
+      emit(J, ST_EXIT);
+    }
+    if (J->flags[n] & JF_LEAVE) {
+      J->stub[2 * n + 1] = J->size;
+      J->hv[JH_PC] = cast(ptrdiff_t, n) << 1;
+      emit(J, ST_EXIT);
+    }
+  }
+}
+
+
+/*
+** Compile the function of 'ci', which is at instruction 'start'. Both
+** passes generate the same code; the first one (with no code) finds
+** where each instruction starts and which exits it needs.
+*/
+static int compile (lua_State *L, CallInfo *ci, JitCode *jc, int start) {
+  global_State *g = G(L);
+  JitState J;
+  StkId base = ci->func + 1;
+  Proto *p = clLvalue(s2v(ci->func))->p;
+  size_t ncode = cast_sizet(p->sizecode);
+  size_t fs = cast_sizet(p->maxstacksize);
+  size_t ntypes = (ncode * fs <= JIT_MAXTYPES) ? ncode * fs : 0;
+  size_t sizescratch = (3 * ncode + 1) * sizeof(size_t) + ncode +
+                       2 * fs + ntypes;
+  size_t total;
+  lu_byte *mcode;
+  void *scratch = jitalloc(g, sizescratch);
+  int r;
+  if (scratch == NULL)
+    return 0;
+  J.cl = clLvalue(s2v(ci->func));
+  J.p = p;
+  J.jc = jc;
+  J.code = NULL;
+  J.pos = cast(size_t *, scratch);
+  J.stub = J.pos + ncode + 1;
+  J.flags = cast(lu_byte *, J.stub + 2 * ncode);
+  J.seed = J.flags + ncode;
+  J.temp = J.seed + fs;
+  J.types = (ntypes > 0) ? J.temp + fs : NULL;
+  memset(J.pos, 0, (3 * ncode + 1) * sizeof(size_t));
+  memset(J.flags, 0, ncode);
+  memset(J.hv, 0, sizeof(J.hv));
+  J.hv[JH_TRAP] = cast(ptrdiff_t, offsetof(CallInfo, u.l.trap));
+  J.hv[JH_UPVALV] = cast(ptrdiff_t, offsetof(UpVal, v));
+  J.hv[JH_ALIMIT] = cast(ptrdiff_t, offsetof(Table, alimit));
+  J.hv[JH_ARRAY] = cast(ptrdiff_t, offsetof(Table, array));
+#if defined(LUAGLM_EXT_READONLY)
+  J.hv[JH_RONLY] = cast(ptrdiff_t, offsetof(Table, readonly));
+#endif
+  for (r = 0; r < p->maxstacksize; r++)
+    J.seed[r] = cast_byte(tymask(s2v(base + r)));
+  markloops(&J);
+  analyze(&J, start);
+  jc->nnative = jc->nexit = 0;
+  instructions(&J);  /* dry pass */
+  exits(&J);
+  J.pool = (J.size + 15) & ~cast_sizet(15);
+  total = J.pool + cast_sizet(J.npool) * sizeof(TValue);
+  mcode = NULL;
+  if (total <= JIT_MAXCODE) {
+    void *m = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (m != MAP_FAILED)
+      mcode = cast(lu_byte *, m);
+  }
+  if (mcode != NULL) {
+    J.code = mcode;
+    jc->nnative = jc->nexit = 0;
+    instructions(&J);
+    exits(&J);
+    lua_assert(J.size <= J.pool);
+    if (mprotect(mcode, total, PROT_READ | PROT_EXEC) == 0) {
+      jc->mcode = mcode;
+      jc->sizemcode = total;
+    }
+    else
+      munmap(mcode, total);
+  }
+  jitfree(g, scratch, sizescratch);
+  return (jc->mcode != NULL);
+}
+
+
+/*
+** Record the types that made a guard of instruction 'n' fail (the
+** operands that 'optype' looks at).
+*/
+static void seen (JitCode *jc, int n, Instruction i, StkId base,
+                  const TValue *k) {
+  OpCode op = getBaseOp(GET_OPCODE(i));
+  const TValue *o1 = NULL;
+  const TValue *o2 = NULL;
+  int c;
+  if (arithop(op, &c) >= 0) {
+    o1 = s2v(base + GETARG_B(i));
+    if (c == 'r') o2 = s2v(base + GETARG_C(i));
+    else if (c == 'k') o2 = k + GETARG_C(i);
+  }
+  else {
+    switch (op) {
+      case OP_GETTABLE: case OP_GETI: case OP_GETFIELD: {
+        o1 = s2v(base + GETARG_B(i));
+        break;
+      }
+      case OP_FORPREP: {
+        o1 = s2v(base + GETARG_A(i));
+        o2 = s2v(base + GETARG_A(i) + 2);
+        break;
+      }
+      case OP_FORLOOP: o1 = s2v(base + GETARG_A(i) + 2); break;
+      default: break;
+    }
+  }
+  if (o1 != NULL)
+    jc->hint[2 * n] |= cast_byte(tymask(o1));
+  if (o2 != NULL)
+    jc->hint[2 * n + 1] |= cast_byte(tymask(o2));
+}
+
+/* }====================================================== */
+
+
+
+/* architecture of the stencils (NULL when they do not fit this build) */
+const char *luaJ_arch (void) {
+  if (sizeof(StackValue) == 24 && sizeof(Value) == 16 &&
+      offsetof(TValue, tt_) == 16 && sizeof(lua_Integer) == 8 &&
+      sizeof(((CallInfo *)0)->u.l.trap) == 4 &&
+      sizeof(((Table *)0)->alimit) == 4)
+    return JIT_ARCH;
+  else
+    return NULL;
+}
+
+
+/*
+** Run native code of the function of 'ci' from 'pc' (the instruction
+** the interpreter was about to run), compiling it when it gets hot.
+** Returns where the interpreter must go on.
+*/
+const Instruction *luaJ_run (lua_State *L, CallInfo *ci,
+                             const Instruction *pc) {
+  LClosure *cl = clLvalue(s2v(ci->func));
+  Proto *p = cl->p;
+  JitCode *jc = p->jit;
+  int n = cast_int(pc - p->code);
+  size_t res;
+  if (l_unlikely(jc == NULL || jc->mcode == NULL)) {
+    if (jc == NULL) {
+      if (luaJ_arch() == NULL || (jc = p->jit = newjitcode(L, p)) == NULL)
+        return pc;
+      if (p->jitmode == JIT_ON)
+        jc->hot = 0;
+    }
+    if (jc->failed || --jc->hot > 0)
+      return pc;
+    jc->hot = 0;
+    if (!compile(L, ci, jc, n)) {
+      jc->failed = 1;
+      return pc;
+    }
+  }
+  if (jc->entries[n] == NOENTRY)
+    return pc;
+  res = (*cast(JitFunction, cast_sizet(jc->mcode + jc->entries[n])))
+          (ci->func + 1, ci, cl);
+  n = cast_int(res >> 1);
+  lua_assert(0 <= n && n < p->sizecode);
+  if (res & 1) {  /* a guard failed? */
+    seen(jc, n, p->code[n], ci->func + 1, p->k);
+    if (++jc->exits[n] >= LUAI_JITMAXEXITS && jc->level[n] < JL_EXIT) {
+      jc->level[n]++;
+      jc->exits[n] = 0;
+      freemcode(jc);  /* compile it again at the next entry */
+    }
+  }
+  return p->code + n;
+}
+
+
+void luaJ_flush (lua_State *L, Proto *p, int recursive) {
+  freejitcode(L, p);
+  if (recursive) {
+    int i;
+    for (i = 0; i < p->sizep; i++)
+      luaJ_flush(L, p->p[i], recursive);
+  }
+}
+
+
+int luaJ_status (const Proto *p, int *nnative, int *nexit) {
+  const JitCode *jc = p->jit;
+  if (jc == NULL || jc->mcode == NULL) {
+    *nnative = *nexit = 0;
+    return 0;
+  }
+  *nnative = jc->nnative;
+  *nexit = jc->nexit;
+  return 1;
+}
+
+
+#else  /* }{ */
+
+/* no stencils for this platform: everything stays interpreted */
+
+const char *luaJ_arch (void) {
+  return NULL;
+}
+
+
+const Instruction *luaJ_run (lua_State *L, CallInfo *ci,
+                             const Instruction *pc) {
+  UNUSED(L); UNUSED(ci);
+  return pc;
+}
+
+
+void luaJ_flush (lua_State *L, Proto *p, int recursive) {
+  UNUSED(L); UNUSED(p); UNUSED(recursive);
+}
+
+
+int luaJ_status (const Proto *p, int *nnative, int *nexit) {
+  UNUSED(p);
+  *nnative = *nexit = 0;
+  return 0;
+}
+
+
+static void freejitcode (lua_State *L, Proto *p) {
+  UNUSED(L);
+  p->jit = NULL;
+}
+
+#endif  /* } */
+
+
+/*
+** Set the mode of 'p' (and of the functions inside it, if 'recursive');
+** with no 'p', turn the compiler on or off for functions in the default
+** mode.
+*/
+void luaJ_setmode (lua_State *L, Proto *p, int mode, int recursive) {
+  if (p == NULL) {
+    G(L)->jiton = cast_byte(mode == JIT_ON && luaJ_arch() != NULL);
+    return;
+  }
+  p->jitmode = cast_byte((luaJ_arch() != NULL) ? mode : JIT_OFF);
+  if (p->jitmode == JIT_OFF)
+    freejitcode(L, p);
+  if (recursive) {
+    int i;
+    for (i = 0; i < p->sizep; i++)
+      luaJ_setmode(L, p->p[i], mode, recursive);
+  }
+}
+
+
+void luaJ_freeproto (lua_State *L, Proto *p) {
+  freejitcode(L, p);
+}
+
+#endif
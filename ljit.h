@@ -0,0 +1,48 @@
+/*
+** $Id: ljit.h $
+** Baseline JIT compiler (copy-and-patch)
+** See Copyright Notice in lua.h
+*/
+
+#ifndef ljit_h
+#define ljit_h
+
+#include "lobject.h"
+#include "lstate.h"
+
+
+#if defined(LUA_USE_JIT)
+
+/* JIT modes of a prototype ('Proto.jitmode') */
+#define JIT_DEFAULT	0	/* compile it when 'G(L)->jiton' */
+#define JIT_ON		1	/* compile it on its first run */
+#define JIT_OFF		2	/* never compile it */
+
+
+/*
+** Number of times the interpreter must enter a function in the default
+** mode (in a call, at a loop, or after a call returns) before the JIT
+** compiles it.
+*/
+#if !defined(LUAI_JITHOT)
+#define LUAI_JITHOT	50
+#endif
+
+
+/* whether the interpreter should try native code for prototype 'p' */
+#define luaJ_active(L,p)  \
+	((p)->jitmode == JIT_ON || ((p)->jitmode == JIT_DEFAULT && G(L)->jiton))
+
+
+LUAI_FUNC const char *luaJ_arch (void);
+LUAI_FUNC const Instruction *luaJ_run (lua_State *L, CallInfo *ci,
+                                       const Instruction *pc);
+LUAI_FUNC void luaJ_setmode (lua_State *L, Proto *p, int mode,
+                             int recursive);
+LUAI_FUNC void luaJ_flush (lua_State *L, Proto *p, int recursive);
+LUAI_FUNC int luaJ_status (const Proto *p, int *nnative, int *nexit);
+LUAI_FUNC void luaJ_freeproto (lua_State *L, Proto *p);
+
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/*
+** $Id: ljitlib.c $
+** Library to control the JIT compiler
+** See Copyright Notice in lua.h
+*/
+
+#define ljitlib_c
+#define LUA_CORE
+
+#include "lprefix.h"
+
+
+#include "lua.h"
+
+#include "lauxlib.h"
+#include "lualib.h"
+
+#include "ljit.h"
+#include "lobject.h"
+#include "lstate.h"
+
+
+#if defined(LUA_USE_JIT)
+
+/*
+** Prototype of the Lua function at 'arg', or NULL when there is no
+** argument (functions of the library then work on the whole compiler).
+*/
+static Proto *optproto (lua_State *L, int arg) {
+  if (lua_isnoneornil(L, arg))
+    return NULL;
+  luaL_argexpected(L, lua_isfunction(L, arg) && !lua_iscfunction(L, arg),
+                   arg, "Lua function");
+  return cast(const LClosure *, lua_topointer(L, arg))->p;
+}
+
+
+static int setmode (lua_State *L, int mode) {
+  Proto *p = optproto(L, 1);
+  luaJ_setmode(L, p, mode, lua_toboolean(L, 2));
+  return 0;
+}
+
+
+static int jit_on (lua_State *L) {
+  return setmode(L, JIT_ON);
+}
+
+
+static int jit_off (lua_State *L) {
+  return setmode(L, JIT_OFF);
+}
+
+
+static int jit_flush (lua_State *L) {
+  Proto *p = optproto(L, 1);
+  luaL_argexpected(L, p != NULL, 1, "Lua function");
+  luaJ_flush(L, p, lua_toboolean(L, 2));
+  return 0;
+}
+
+
+/*
+** With no function, whether the compiler is on; with a function,
+** whether it has native code, and how many of its instructions run
+** natively and how many go back to the interpreter.
+*/
+static int jit_status (lua_State *L) {
+  Proto *p = optproto(L, 1);
+  if (p == NULL) {
+    lua_pushboolean(L, G(L)->jiton);
+    return 1;
+  }
+  else {
+    int nnative, nexit;
+    lua_pushboolean(L, luaJ_status(p, &nnative, &nexit));
+    lua_pushinteger(L, nnative);
+    lua_pushinteger(L, nexit);
+    return 3;
+  }
+}
+
+
+static const luaL_Reg jit_funcs[] = {
+  {"on", jit_on},
+  {"off", jit_off},
+  {"flush", jit_flush},
+  {"status", jit_status},
+  /* placeholders */
+  {"arch", NULL},
+  {NULL, NULL}
+};
+
+
+LUAMOD_API int luaopen_jit (lua_State *L) {
+  luaL_newlib(L, jit_funcs);
+  if (luaJ_arch() != NULL) {
+    lua_pushstring(L, luaJ_arch());
+    lua_setfield(L, -2, "arch");
+  }
+  return 1;
+}
+
+#endif
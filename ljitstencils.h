@@ -0,0 +1,1003 @@
+/*
+** $Id: ljitstencils.h $
+** Stencils of the baseline JIT compiler (x86-64)
+** Generated by 'etc/jitstencils.lua' from 'etc/jitstencils.s'; do not
+** edit it by hand
+** See Copyright Notice in lua.h
+*/
+
+/* holes ('jit_*' symbols) */
+enum JitHoleName {
+  JH_ALIMIT,
+  JH_ARRAY,
+  JH_EXIT,
+  JH_FALSE,
+  JH_IMM,
+  JH_KB,
+  JH_KC,
+  JH_LANE,
+  JH_LEAVE,
+  JH_PC,
+  JH_RA,
+  JH_RB,
+  JH_RC,
+  JH_RONLY,
+  JH_TAG,
+  JH_TARGET,
+  JH_TRAP,
+  JH_TRUE,
+  JH_UPVAL,
+  JH_UPVALV,
+  JH_VAL,
+  NUM_HOLES
+};
+
+static const lu_byte st_ra_code[] = {
+  0x4c, 0x8d, 0x97, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_ra_holes[] = {
+  {3, JR_32S, JH_RA, 0}
+};
+
+static const lu_byte st_rb_code[] = {
+  0x4c, 0x8d, 0x87, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_rb_holes[] = {
+  {3, JR_32S, JH_RB, 0}
+};
+
+static const lu_byte st_rc_code[] = {
+  0x4c, 0x8d, 0x8f, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_rc_holes[] = {
+  {3, JR_32S, JH_RC, 0}
+};
+
+static const lu_byte st_kb_code[] = {
+  0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_kb_holes[] = {
+  {2, JR_64, JH_KB, 0}
+};
+
+static const lu_byte st_kc_code[] = {
+  0x49, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_kc_holes[] = {
+  {2, JR_64, JH_KC, 0}
+};
+
+static const lu_byte st_exit_code[] = {
+  0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc3
+};
+static const JitHole st_exit_holes[] = {
+  {2, JR_64, JH_PC, 0}
+};
+
+static const lu_byte st_loop_code[] = {
+  0x83, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00
+};
+static const JitHole st_loop_holes[] = {
+  {2, JR_32S, JH_TRAP, 0},
+  {9, JR_PC32, JH_LEAVE, -4}
+};
+
+static const lu_byte st_move_code[] = {
+  0xf3, 0x0f, 0x6f, 0x87, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xb6, 0x87, 0x00,
+  0x00, 0x00, 0x00, 0xf3, 0x0f, 0x7f, 0x87, 0x00, 0x00, 0x00, 0x00, 0x88,
+  0x87, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_move_holes[] = {
+  {4, JR_32S, JH_RB, 0},
+  {11, JR_32S, JH_RB, 16},
+  {19, JR_32S, JH_RA, 0},
+  {25, JR_32S, JH_RA, 16}
+};
+
+static const lu_byte st_loadv_code[] = {
+  0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89,
+  0x87, 0x00, 0x00, 0x00, 0x00, 0xc6, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_loadv_holes[] = {
+  {2, JR_64, JH_VAL, 0},
+  {13, JR_32S, JH_RA, 0},
+  {19, JR_32S, JH_RA, 16},
+  {23, JR_8, JH_TAG, 0}
+};
+
+static const lu_byte st_settag_code[] = {
+  0xc6, 0x87, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_settag_holes[] = {
+  {2, JR_32S, JH_RA, 16},
+  {6, JR_8, JH_TAG, 0}
+};
+
+static const lu_byte st_getupval_code[] = {
+  0x48, 0x8b, 0x82, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x80, 0x00, 0x00,
+  0x00, 0x00, 0xf3, 0x0f, 0x6f, 0x00, 0x0f, 0xb6, 0x48, 0x10, 0xf3, 0x0f,
+  0x7f, 0x87, 0x00, 0x00, 0x00, 0x00, 0x88, 0x8f, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_getupval_holes[] = {
+  {3, JR_32S, JH_UPVAL, 0},
+  {10, JR_32S, JH_UPVALV, 0},
+  {26, JR_32S, JH_RA, 0},
+  {32, JR_32S, JH_RA, 16}
+};
+
+static const lu_byte st_add_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x00, 0x49, 0x03, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03
+};
+static const JitHole st_add_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_add_ff_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xf2, 0x41, 0x0f, 0x58, 0x01, 0xf2, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0xc6, 0x42, 0x10, 0x13
+};
+static const JitHole st_add_ff_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_add_nn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x15, 0x83, 0xf9, 0x03, 0x75, 0x20, 0x49, 0x8b, 0x00, 0x49,
+  0x03, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03, 0xeb, 0x3d,
+  0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41, 0x0f,
+  0x10, 0x00, 0xeb, 0x05, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0x83, 0xf9, 0x13,
+  0x75, 0x07, 0xf2, 0x41, 0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03,
+  0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2,
+  0x0f, 0x58, 0xc1, 0xf2, 0x41, 0x0f, 0x11, 0x02, 0x41, 0xc6, 0x42, 0x10,
+  0x13
+};
+static const JitHole st_add_nn_holes[] = {
+  {41, JR_PC32, JH_EXIT, -4},
+  {74, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_add_vv_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x38, 0x41, 0x10, 0x0f, 0x85, 0x00,
+  0x00, 0x00, 0x00, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8, 0x24, 0x74,
+  0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f,
+  0x10, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x58, 0xc1, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_add_vv_holes[] = {
+  {11, JR_PC32, JH_EXIT, -4},
+  {30, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_add_vn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2, 0x0f, 0x5a, 0xc9, 0x0f,
+  0xc6, 0xc9, 0x00, 0x41, 0x0f, 0x10, 0x00, 0x0f, 0x58, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_add_vn_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_add_nv_code[] = {
+  0x41, 0x0f, 0xb6, 0x41, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0xf2, 0x0f, 0x5a, 0xc0, 0x0f,
+  0xc6, 0xc0, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x58, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_add_nv_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_sub_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x00, 0x49, 0x2b, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03
+};
+static const JitHole st_sub_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_sub_ff_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xf2, 0x41, 0x0f, 0x5c, 0x01, 0xf2, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0xc6, 0x42, 0x10, 0x13
+};
+static const JitHole st_sub_ff_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_sub_nn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x15, 0x83, 0xf9, 0x03, 0x75, 0x20, 0x49, 0x8b, 0x00, 0x49,
+  0x2b, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03, 0xeb, 0x3d,
+  0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41, 0x0f,
+  0x10, 0x00, 0xeb, 0x05, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0x83, 0xf9, 0x13,
+  0x75, 0x07, 0xf2, 0x41, 0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03,
+  0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2,
+  0x0f, 0x5c, 0xc1, 0xf2, 0x41, 0x0f, 0x11, 0x02, 0x41, 0xc6, 0x42, 0x10,
+  0x13
+};
+static const JitHole st_sub_nn_holes[] = {
+  {41, JR_PC32, JH_EXIT, -4},
+  {74, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_sub_vv_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x38, 0x41, 0x10, 0x0f, 0x85, 0x00,
+  0x00, 0x00, 0x00, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8, 0x24, 0x74,
+  0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f,
+  0x10, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x5c, 0xc1, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_sub_vv_holes[] = {
+  {11, JR_PC32, JH_EXIT, -4},
+  {30, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_sub_vn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2, 0x0f, 0x5a, 0xc9, 0x0f,
+  0xc6, 0xc9, 0x00, 0x41, 0x0f, 0x10, 0x00, 0x0f, 0x5c, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_sub_vn_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_sub_nv_code[] = {
+  0x41, 0x0f, 0xb6, 0x41, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0xf2, 0x0f, 0x5a, 0xc0, 0x0f,
+  0xc6, 0xc0, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x5c, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_sub_nv_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mul_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x00, 0x49, 0x0f, 0xaf, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10,
+  0x03
+};
+static const JitHole st_mul_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mul_ff_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xf2, 0x41, 0x0f, 0x59, 0x01, 0xf2, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0xc6, 0x42, 0x10, 0x13
+};
+static const JitHole st_mul_ff_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mul_nn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x16, 0x83, 0xf9, 0x03, 0x75, 0x21, 0x49, 0x8b, 0x00, 0x49,
+  0x0f, 0xaf, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03, 0xeb,
+  0x3d, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xeb, 0x05, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0x83, 0xf9,
+  0x13, 0x75, 0x07, 0xf2, 0x41, 0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9,
+  0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09,
+  0xf2, 0x0f, 0x59, 0xc1, 0xf2, 0x41, 0x0f, 0x11, 0x02, 0x41, 0xc6, 0x42,
+  0x10, 0x13
+};
+static const JitHole st_mul_nn_holes[] = {
+  {42, JR_PC32, JH_EXIT, -4},
+  {75, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mul_vv_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x38, 0x41, 0x10, 0x0f, 0x85, 0x00,
+  0x00, 0x00, 0x00, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8, 0x24, 0x74,
+  0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f,
+  0x10, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x59, 0xc1, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_mul_vv_holes[] = {
+  {11, JR_PC32, JH_EXIT, -4},
+  {30, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mul_vn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2, 0x0f, 0x5a, 0xc9, 0x0f,
+  0xc6, 0xc9, 0x00, 0x41, 0x0f, 0x10, 0x00, 0x0f, 0x59, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_mul_vn_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mul_nv_code[] = {
+  0x41, 0x0f, 0xb6, 0x41, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0xf2, 0x0f, 0x5a, 0xc0, 0x0f,
+  0xc6, 0xc0, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x59, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_mul_nv_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_div_ff_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xf2, 0x41, 0x0f, 0x5e, 0x01, 0xf2, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0xc6, 0x42, 0x10, 0x13
+};
+static const JitHole st_div_ff_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_div_nn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x11, 0x83, 0xf9, 0x03, 0x75, 0x1c, 0xf2, 0x49, 0x0f, 0x2a,
+  0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xeb, 0x2f, 0x83, 0xf8, 0x13, 0x0f,
+  0x85, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41, 0x0f, 0x10, 0x00, 0xeb, 0x05,
+  0xf2, 0x49, 0x0f, 0x2a, 0x00, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2, 0x0f, 0x5e, 0xc1, 0xf2,
+  0x41, 0x0f, 0x11, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x13
+};
+static const JitHole st_div_nn_holes[] = {
+  {37, JR_PC32, JH_EXIT, -4},
+  {70, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_div_vv_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x41, 0x38, 0x41, 0x10, 0x0f, 0x85, 0x00,
+  0x00, 0x00, 0x00, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8, 0x24, 0x74,
+  0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f,
+  0x10, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x5e, 0xc1, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_div_vv_holes[] = {
+  {11, JR_PC32, JH_EXIT, -4},
+  {30, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_div_vn_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x49, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x09, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x09, 0xf2, 0x0f, 0x5a, 0xc9, 0x0f,
+  0xc6, 0xc9, 0x00, 0x41, 0x0f, 0x10, 0x00, 0x0f, 0x5e, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_div_vn_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_div_nv_code[] = {
+  0x41, 0x0f, 0xb6, 0x41, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf9, 0x13, 0x75, 0x07, 0xf2, 0x41,
+  0x0f, 0x10, 0x00, 0xeb, 0x0e, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0xf2, 0x49, 0x0f, 0x2a, 0x00, 0xf2, 0x0f, 0x5a, 0xc0, 0x0f,
+  0xc6, 0xc0, 0x00, 0x41, 0x0f, 0x10, 0x09, 0x0f, 0x5e, 0xc1, 0x41, 0x0f,
+  0x11, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_div_nv_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {46, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_band_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x00, 0x49, 0x23, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03
+};
+static const JitHole st_band_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_bor_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x00, 0x49, 0x0b, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03
+};
+static const JitHole st_bor_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_bxor_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x00, 0x49, 0x33, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03
+};
+static const JitHole st_bxor_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_mod_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x09, 0x48, 0x8d, 0x41, 0x01, 0x48, 0x83, 0xf8, 0x01, 0x0f, 0x86, 0x00,
+  0x00, 0x00, 0x00, 0x49, 0x8b, 0x00, 0x49, 0x89, 0xd3, 0x48, 0x99, 0x48,
+  0xf7, 0xf9, 0x48, 0x85, 0xd2, 0x74, 0x0b, 0x48, 0x89, 0xd0, 0x48, 0x31,
+  0xc8, 0x79, 0x03, 0x48, 0x01, 0xca, 0x49, 0x89, 0x12, 0x41, 0xc6, 0x42,
+  0x10, 0x03, 0x4c, 0x89, 0xda
+};
+static const JitHole st_mod_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4},
+  {35, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_idiv_ii_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x09, 0x48, 0x8d, 0x41, 0x01, 0x48, 0x83, 0xf8, 0x01, 0x0f, 0x86, 0x00,
+  0x00, 0x00, 0x00, 0x49, 0x8b, 0x00, 0x49, 0x89, 0xd3, 0x48, 0x99, 0x48,
+  0xf7, 0xf9, 0x48, 0x85, 0xd2, 0x74, 0x09, 0x49, 0x33, 0x08, 0x79, 0x04,
+  0x48, 0x83, 0xe8, 0x01, 0x49, 0x89, 0x02, 0x41, 0xc6, 0x42, 0x10, 0x03,
+  0x4c, 0x89, 0xda
+};
+static const JitHole st_idiv_ii_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4},
+  {35, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_unm_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x49, 0x8b, 0x08, 0x83, 0xf8, 0x03, 0x75,
+  0x05, 0x48, 0xf7, 0xd9, 0xeb, 0x0e, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00,
+  0x00, 0x00, 0x00, 0x48, 0x0f, 0xba, 0xf9, 0x3f, 0x49, 0x89, 0x0a, 0x41,
+  0x88, 0x42, 0x10
+};
+static const JitHole st_unm_holes[] = {
+  {23, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_not_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x83, 0xf8, 0x01, 0x74, 0x0b, 0xa8, 0x0f,
+  0x74, 0x07, 0x41, 0xc6, 0x42, 0x10, 0x01, 0xeb, 0x05, 0x41, 0xc6, 0x42,
+  0x10, 0x11
+};
+
+static const lu_byte st_gettable_code[] = {
+  0x41, 0x80, 0x78, 0x10, 0x46, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x79, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x4d, 0x8b,
+  0x18, 0x49, 0x8b, 0x09, 0x48, 0x83, 0xe9, 0x01, 0x41, 0x8b, 0x83, 0x00,
+  0x00, 0x00, 0x00, 0x48, 0x39, 0xc1, 0x0f, 0x83, 0x00, 0x00, 0x00, 0x00,
+  0x4d, 0x8b, 0x9b, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f, 0xb6, 0x04, 0x0b,
+  0xa8, 0x0f, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xc1, 0x01,
+  0x48, 0xc1, 0xe1, 0x04, 0x49, 0x29, 0xcb, 0xf3, 0x41, 0x0f, 0x6f, 0x03,
+  0xf3, 0x41, 0x0f, 0x7f, 0x02, 0x41, 0x88, 0x42, 0x10
+};
+static const JitHole st_gettable_holes[] = {
+  {35, JR_32S, JH_ALIMIT, 0},
+  {51, JR_32S, JH_ARRAY, 0},
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4},
+  {44, JR_PC32, JH_EXIT, -4},
+  {64, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_settable_code[] = {
+  0x41, 0x80, 0x7a, 0x10, 0x46, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f,
+  0xb6, 0x41, 0x10, 0xa8, 0x40, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x4d,
+  0x8b, 0x1a, 0x49, 0x8b, 0x08, 0x48, 0x83, 0xe9, 0x01, 0x41, 0x8b, 0x83,
+  0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0xc1, 0x0f, 0x83, 0x00, 0x00, 0x00,
+  0x00, 0x4d, 0x8b, 0x9b, 0x00, 0x00, 0x00, 0x00, 0x41, 0xf6, 0x04, 0x0b,
+  0x0f, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f, 0xb6, 0x41, 0x10,
+  0x41, 0x88, 0x04, 0x0b, 0x48, 0x83, 0xc1, 0x01, 0x48, 0xc1, 0xe1, 0x04,
+  0x49, 0x29, 0xcb, 0xf3, 0x41, 0x0f, 0x6f, 0x01, 0xf3, 0x41, 0x0f, 0x7f,
+  0x03
+};
+static const JitHole st_settable_holes[] = {
+  {48, JR_32S, JH_ALIMIT, 0},
+  {64, JR_32S, JH_ARRAY, 0},
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4},
+  {31, JR_PC32, JH_EXIT, -4},
+  {57, JR_PC32, JH_EXIT, -4},
+  {75, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_settable_ro_code[] = {
+  0x41, 0x80, 0x7a, 0x10, 0x46, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x78, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f,
+  0xb6, 0x41, 0x10, 0xa8, 0x40, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x4d,
+  0x8b, 0x1a, 0x41, 0x80, 0xbb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x85,
+  0x00, 0x00, 0x00, 0x00, 0x49, 0x8b, 0x08, 0x48, 0x83, 0xe9, 0x01, 0x41,
+  0x8b, 0x83, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0xc1, 0x0f, 0x83, 0x00,
+  0x00, 0x00, 0x00, 0x4d, 0x8b, 0x9b, 0x00, 0x00, 0x00, 0x00, 0x41, 0xf6,
+  0x04, 0x0b, 0x0f, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0f, 0xb6,
+  0x41, 0x10, 0x41, 0x88, 0x04, 0x0b, 0x48, 0x83, 0xc1, 0x01, 0x48, 0xc1,
+  0xe1, 0x04, 0x49, 0x29, 0xcb, 0xf3, 0x41, 0x0f, 0x6f, 0x01, 0xf3, 0x41,
+  0x0f, 0x7f, 0x03
+};
+static const JitHole st_settable_ro_holes[] = {
+  {41, JR_32S, JH_RONLY, 0},
+  {62, JR_32S, JH_ALIMIT, 0},
+  {78, JR_32S, JH_ARRAY, 0},
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4},
+  {31, JR_PC32, JH_EXIT, -4},
+  {48, JR_PC32, JH_EXIT, -4},
+  {71, JR_PC32, JH_EXIT, -4},
+  {89, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_vgetfield_code[] = {
+  0x41, 0x0f, 0xb6, 0x40, 0x10, 0x83, 0xf8, 0x14, 0x74, 0x0e, 0x83, 0xf8,
+  0x24, 0x74, 0x09, 0x83, 0xf8, 0x04, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x3d, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x82, 0x00, 0x00, 0x00, 0x00, 0xf3,
+  0x41, 0x0f, 0x5a, 0x80, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x41, 0x0f, 0x11,
+  0x02, 0x41, 0xc6, 0x42, 0x10, 0x13
+};
+static const JitHole st_vgetfield_holes[] = {
+  {25, JR_32, JH_TAG, 0},
+  {40, JR_32S, JH_LANE, 0},
+  {20, JR_PC32, JH_EXIT, -4},
+  {31, JR_PC32, JH_EXIT, -4}
+};
+
+static const lu_byte st_jmp_code[] = {
+  0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_jmp_holes[] = {
+  {1, JR_PC32, JH_TARGET, -4}
+};
+
+static const lu_byte st_lt_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x1a, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x49, 0x8b, 0x02, 0x49, 0x3b, 0x00, 0x0f, 0x8c, 0x00, 0x00, 0x00, 0x00,
+  0xe9, 0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0x83, 0xf9, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2,
+  0x41, 0x0f, 0x10, 0x00, 0x66, 0x41, 0x0f, 0x2e, 0x02, 0x0f, 0x87, 0x00,
+  0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_lt_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {32, JR_PC32, JH_TRUE, -4},
+  {37, JR_PC32, JH_FALSE, -4},
+  {46, JR_PC32, JH_EXIT, -4},
+  {55, JR_PC32, JH_EXIT, -4},
+  {71, JR_PC32, JH_TRUE, -4},
+  {76, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_le_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x1a, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x49, 0x8b, 0x02, 0x49, 0x3b, 0x00, 0x0f, 0x8e, 0x00, 0x00, 0x00, 0x00,
+  0xe9, 0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0x83, 0xf9, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2,
+  0x41, 0x0f, 0x10, 0x00, 0x66, 0x41, 0x0f, 0x2e, 0x02, 0x0f, 0x83, 0x00,
+  0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_le_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {32, JR_PC32, JH_TRUE, -4},
+  {37, JR_PC32, JH_FALSE, -4},
+  {46, JR_PC32, JH_EXIT, -4},
+  {55, JR_PC32, JH_EXIT, -4},
+  {71, JR_PC32, JH_TRUE, -4},
+  {76, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_eq_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x41, 0x0f, 0xb6, 0x48, 0x10, 0x83, 0xf8,
+  0x03, 0x75, 0x1a, 0x83, 0xf9, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,
+  0x49, 0x8b, 0x02, 0x49, 0x3b, 0x00, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00,
+  0xe9, 0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00,
+  0x00, 0x00, 0x83, 0xf9, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2,
+  0x41, 0x0f, 0x10, 0x02, 0x66, 0x41, 0x0f, 0x2e, 0x00, 0x0f, 0x8a, 0x00,
+  0x00, 0x00, 0x00, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00,
+  0x00, 0x00
+};
+static const JitHole st_eq_holes[] = {
+  {20, JR_PC32, JH_EXIT, -4},
+  {32, JR_PC32, JH_TRUE, -4},
+  {37, JR_PC32, JH_FALSE, -4},
+  {46, JR_PC32, JH_EXIT, -4},
+  {55, JR_PC32, JH_EXIT, -4},
+  {71, JR_PC32, JH_FALSE, -4},
+  {77, JR_PC32, JH_TRUE, -4},
+  {82, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_lti_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x03, 0x75, 0x12, 0x49, 0x81,
+  0x3a, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x8c, 0x00, 0x00, 0x00, 0x00, 0xe9,
+  0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00, 0x48, 0xc7, 0xc1, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x48, 0x0f, 0x2a,
+  0xc9, 0xf2, 0x41, 0x0f, 0x10, 0x02, 0x66, 0x0f, 0x2e, 0xc8, 0x0f, 0x87,
+  0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_lti_holes[] = {
+  {13, JR_32S, JH_IMM, 0},
+  {40, JR_32S, JH_IMM, 0},
+  {19, JR_PC32, JH_TRUE, -4},
+  {24, JR_PC32, JH_FALSE, -4},
+  {33, JR_PC32, JH_EXIT, -4},
+  {60, JR_PC32, JH_TRUE, -4},
+  {65, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_lei_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x03, 0x75, 0x12, 0x49, 0x81,
+  0x3a, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x8e, 0x00, 0x00, 0x00, 0x00, 0xe9,
+  0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00, 0x48, 0xc7, 0xc1, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x48, 0x0f, 0x2a,
+  0xc9, 0xf2, 0x41, 0x0f, 0x10, 0x02, 0x66, 0x0f, 0x2e, 0xc8, 0x0f, 0x83,
+  0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_lei_holes[] = {
+  {13, JR_32S, JH_IMM, 0},
+  {40, JR_32S, JH_IMM, 0},
+  {19, JR_PC32, JH_TRUE, -4},
+  {24, JR_PC32, JH_FALSE, -4},
+  {33, JR_PC32, JH_EXIT, -4},
+  {60, JR_PC32, JH_TRUE, -4},
+  {65, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_gti_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x03, 0x75, 0x12, 0x49, 0x81,
+  0x3a, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x8f, 0x00, 0x00, 0x00, 0x00, 0xe9,
+  0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00, 0x48, 0xc7, 0xc1, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x48, 0x0f, 0x2a,
+  0xc9, 0xf2, 0x41, 0x0f, 0x10, 0x02, 0x66, 0x0f, 0x2e, 0xc1, 0x0f, 0x87,
+  0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_gti_holes[] = {
+  {13, JR_32S, JH_IMM, 0},
+  {40, JR_32S, JH_IMM, 0},
+  {19, JR_PC32, JH_TRUE, -4},
+  {24, JR_PC32, JH_FALSE, -4},
+  {33, JR_PC32, JH_EXIT, -4},
+  {60, JR_PC32, JH_TRUE, -4},
+  {65, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_gei_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x03, 0x75, 0x12, 0x49, 0x81,
+  0x3a, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x8d, 0x00, 0x00, 0x00, 0x00, 0xe9,
+  0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00, 0x48, 0xc7, 0xc1, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x48, 0x0f, 0x2a,
+  0xc9, 0xf2, 0x41, 0x0f, 0x10, 0x02, 0x66, 0x0f, 0x2e, 0xc1, 0x0f, 0x83,
+  0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_gei_holes[] = {
+  {13, JR_32S, JH_IMM, 0},
+  {40, JR_32S, JH_IMM, 0},
+  {19, JR_PC32, JH_TRUE, -4},
+  {24, JR_PC32, JH_FALSE, -4},
+  {33, JR_PC32, JH_EXIT, -4},
+  {60, JR_PC32, JH_TRUE, -4},
+  {65, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_eqi_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x03, 0x75, 0x12, 0x49, 0x81,
+  0x3a, 0x00, 0x00, 0x00, 0x00, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9,
+  0x00, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00, 0x48, 0xc7, 0xc1, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x48, 0x0f, 0x2a,
+  0xc9, 0x66, 0x41, 0x0f, 0x2e, 0x0a, 0x0f, 0x8a, 0x00, 0x00, 0x00, 0x00,
+  0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_eqi_holes[] = {
+  {13, JR_32S, JH_IMM, 0},
+  {40, JR_32S, JH_IMM, 0},
+  {19, JR_PC32, JH_TRUE, -4},
+  {24, JR_PC32, JH_FALSE, -4},
+  {33, JR_PC32, JH_FALSE, -4},
+  {56, JR_PC32, JH_FALSE, -4},
+  {62, JR_PC32, JH_TRUE, -4},
+  {67, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_eqktag_code[] = {
+  0x41, 0x80, 0x7a, 0x10, 0x00, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9,
+  0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_eqktag_holes[] = {
+  {4, JR_8, JH_TAG, 0},
+  {7, JR_PC32, JH_TRUE, -4},
+  {12, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_eqkstr_code[] = {
+  0x41, 0x80, 0x7a, 0x10, 0x00, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x48,
+  0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0x39, 0x02,
+  0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_eqkstr_holes[] = {
+  {4, JR_8, JH_TAG, 0},
+  {13, JR_64, JH_VAL, 0},
+  {7, JR_PC32, JH_FALSE, -4},
+  {26, JR_PC32, JH_TRUE, -4},
+  {31, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_eqkint_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x03, 0x75, 0x18, 0x48, 0xb8,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0x39, 0x02, 0x0f,
+  0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00, 0x83, 0xf8,
+  0x13, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_eqkint_holes[] = {
+  {12, JR_64, JH_VAL, 0},
+  {25, JR_PC32, JH_TRUE, -4},
+  {30, JR_PC32, JH_FALSE, -4},
+  {39, JR_PC32, JH_EXIT, -4},
+  {44, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_eqkflt_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x13, 0x75, 0x25, 0x48, 0xb8,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0x48, 0x0f, 0x6e,
+  0xc8, 0x66, 0x41, 0x0f, 0x2e, 0x0a, 0x0f, 0x8a, 0x00, 0x00, 0x00, 0x00,
+  0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00, 0x83,
+  0xf8, 0x03, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00, 0x00, 0x00,
+  0x00
+};
+static const JitHole st_eqkflt_holes[] = {
+  {12, JR_64, JH_VAL, 0},
+  {32, JR_PC32, JH_FALSE, -4},
+  {38, JR_PC32, JH_TRUE, -4},
+  {43, JR_PC32, JH_FALSE, -4},
+  {52, JR_PC32, JH_EXIT, -4},
+  {57, JR_PC32, JH_FALSE, -4}
+};
+
+static const lu_byte st_test_code[] = {
+  0x41, 0x0f, 0xb6, 0x42, 0x10, 0x83, 0xf8, 0x01, 0x0f, 0x84, 0x00, 0x00,
+  0x00, 0x00, 0xa8, 0x0f, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0xe9, 0x00,
+  0x00, 0x00, 0x00
+};
+static const JitHole st_test_holes[] = {
+  {10, JR_PC32, JH_FALSE, -4},
+  {18, JR_PC32, JH_FALSE, -4},
+  {23, JR_PC32, JH_TRUE, -4}
+};
+
+static const lu_byte st_forprep_code[] = {
+  0x41, 0x80, 0x7a, 0x10, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41,
+  0x80, 0x7a, 0x28, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x41, 0x80,
+  0x7a, 0x40, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b, 0x4a,
+  0x30, 0x48, 0x85, 0xc9, 0x0f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x49, 0x8b,
+  0x02, 0x49, 0x89, 0x42, 0x48, 0x41, 0xc6, 0x42, 0x58, 0x03, 0x4d, 0x8b,
+  0x5a, 0x18, 0x48, 0x85, 0xc9, 0x78, 0x17, 0x4c, 0x39, 0xd8, 0x0f, 0x8f,
+  0x00, 0x00, 0x00, 0x00, 0x49, 0x29, 0xc3, 0x48, 0x83, 0xf9, 0x01, 0x74,
+  0x2a, 0x4c, 0x89, 0xd8, 0xeb, 0x17, 0x4c, 0x39, 0xd8, 0x0f, 0x8c, 0x00,
+  0x00, 0x00, 0x00, 0x4c, 0x29, 0xd8, 0x48, 0x83, 0xc1, 0x01, 0x48, 0xf7,
+  0xd9, 0x48, 0x83, 0xc1, 0x01, 0x49, 0x89, 0xd1, 0x31, 0xd2, 0x48, 0xf7,
+  0xf1, 0x4c, 0x89, 0xca, 0x49, 0x89, 0xc3, 0x4d, 0x89, 0x5a, 0x18
+};
+static const JitHole st_forprep_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {18, JR_PC32, JH_EXIT, -4},
+  {29, JR_PC32, JH_EXIT, -4},
+  {42, JR_PC32, JH_EXIT, -4},
+  {72, JR_PC32, JH_TARGET, -4},
+  {95, JR_PC32, JH_TARGET, -4}
+};
+
+static const lu_byte st_forloop_i_code[] = {
+  0x41, 0x80, 0x7a, 0x40, 0x03, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0x49,
+  0x8b, 0x42, 0x18, 0x48, 0x85, 0xc0, 0x74, 0x20, 0x48, 0x83, 0xe8, 0x01,
+  0x49, 0x89, 0x42, 0x18, 0x49, 0x8b, 0x0a, 0x49, 0x03, 0x4a, 0x30, 0x49,
+  0x89, 0x0a, 0x49, 0x89, 0x4a, 0x48, 0x41, 0xc6, 0x42, 0x58, 0x03, 0xe9,
+  0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_forloop_i_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {48, JR_PC32, JH_TARGET, -4}
+};
+
+static const lu_byte st_forloop_f_code[] = {
+  0x41, 0x80, 0x7a, 0x40, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00, 0x00, 0xf2,
+  0x41, 0x0f, 0x10, 0x02, 0xf2, 0x41, 0x0f, 0x58, 0x42, 0x30, 0xf2, 0x41,
+  0x0f, 0x10, 0x4a, 0x30, 0x66, 0x0f, 0x57, 0xd2, 0x66, 0x0f, 0x2e, 0xca,
+  0x77, 0x0a, 0x66, 0x41, 0x0f, 0x2e, 0x42, 0x18, 0x73, 0x0e, 0xeb, 0x21,
+  0xf2, 0x41, 0x0f, 0x10, 0x4a, 0x18, 0x66, 0x0f, 0x2e, 0xc8, 0x72, 0x15,
+  0xf2, 0x41, 0x0f, 0x11, 0x02, 0xf2, 0x41, 0x0f, 0x11, 0x42, 0x48, 0x41,
+  0xc6, 0x42, 0x58, 0x13, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_forloop_f_holes[] = {
+  {7, JR_PC32, JH_EXIT, -4},
+  {77, JR_PC32, JH_TARGET, -4}
+};
+
+static const lu_byte st_forloop_code[] = {
+  0x41, 0x80, 0x7a, 0x40, 0x03, 0x75, 0x2b, 0x49, 0x8b, 0x42, 0x18, 0x48,
+  0x85, 0xc0, 0x74, 0x20, 0x48, 0x83, 0xe8, 0x01, 0x49, 0x89, 0x42, 0x18,
+  0x49, 0x8b, 0x0a, 0x49, 0x03, 0x4a, 0x30, 0x49, 0x89, 0x0a, 0x49, 0x89,
+  0x4a, 0x48, 0x41, 0xc6, 0x42, 0x58, 0x03, 0xe9, 0x00, 0x00, 0x00, 0x00,
+  0xeb, 0x51, 0x41, 0x80, 0x7a, 0x40, 0x13, 0x0f, 0x85, 0x00, 0x00, 0x00,
+  0x00, 0xf2, 0x41, 0x0f, 0x10, 0x02, 0xf2, 0x41, 0x0f, 0x58, 0x42, 0x30,
+  0xf2, 0x41, 0x0f, 0x10, 0x4a, 0x30, 0x66, 0x0f, 0x57, 0xd2, 0x66, 0x0f,
+  0x2e, 0xca, 0x77, 0x0a, 0x66, 0x41, 0x0f, 0x2e, 0x42, 0x18, 0x73, 0x0e,
+  0xeb, 0x21, 0xf2, 0x41, 0x0f, 0x10, 0x4a, 0x18, 0x66, 0x0f, 0x2e, 0xc8,
+  0x72, 0x15, 0xf2, 0x41, 0x0f, 0x11, 0x02, 0xf2, 0x41, 0x0f, 0x11, 0x42,
+  0x48, 0x41, 0xc6, 0x42, 0x58, 0x13, 0xe9, 0x00, 0x00, 0x00, 0x00
+};
+static const JitHole st_forloop_holes[] = {
+  {44, JR_PC32, JH_TARGET, -4},
+  {57, JR_PC32, JH_EXIT, -4},
+  {127, JR_PC32, JH_TARGET, -4}
+};
+
+enum JitStencilName {
+  ST_RA,
+  ST_RB,
+  ST_RC,
+  ST_KB,
+  ST_KC,
+  ST_EXIT,
+  ST_LOOP,
+  ST_MOVE,
+  ST_LOADV,
+  ST_SETTAG,
+  ST_GETUPVAL,
+  ST_ADD_II,
+  ST_ADD_FF,
+  ST_ADD_NN,
+  ST_ADD_VV,
+  ST_ADD_VN,
+  ST_ADD_NV,
+  ST_SUB_II,
+  ST_SUB_FF,
+  ST_SUB_NN,
+  ST_SUB_VV,
+  ST_SUB_VN,
+  ST_SUB_NV,
+  ST_MUL_II,
+  ST_MUL_FF,
+  ST_MUL_NN,
+  ST_MUL_VV,
+  ST_MUL_VN,
+  ST_MUL_NV,
+  ST_DIV_FF,
+  ST_DIV_NN,
+  ST_DIV_VV,
+  ST_DIV_VN,
+  ST_DIV_NV,
+  ST_BAND_II,
+  ST_BOR_II,
+  ST_BXOR_II,
+  ST_MOD_II,
+  ST_IDIV_II,
+  ST_UNM,
+  ST_NOT,
+  ST_GETTABLE,
+  ST_SETTABLE,
+  ST_SETTABLE_RO,
+  ST_VGETFIELD,
+  ST_JMP,
+  ST_LT,
+  ST_LE,
+  ST_EQ,
+  ST_LTI,
+  ST_LEI,
+  ST_GTI,
+  ST_GEI,
+  ST_EQI,
+  ST_EQKTAG,
+  ST_EQKSTR,
+  ST_EQKINT,
+  ST_EQKFLT,
+  ST_TEST,
+  ST_FORPREP,
+  ST_FORLOOP_I,
+  ST_FORLOOP_F,
+  ST_FORLOOP,
+  NUM_STENCILS
+};
+
+static const JitStencil jitstencils[NUM_STENCILS] = {
+  jitstencil(st_ra),
+  jitstencil(st_rb),
+  jitstencil(st_rc),
+  jitstencil(st_kb),
+  jitstencil(st_kc),
+  jitstencil(st_exit),
+  jitstencil(st_loop),
+  jitstencil(st_move),
+  jitstencil(st_loadv),
+  jitstencil(st_settag),
+  jitstencil(st_getupval),
+  jitstencil(st_add_ii),
+  jitstencil(st_add_ff),
+  jitstencil(st_add_nn),
+  jitstencil(st_add_vv),
+  jitstencil(st_add_vn),
+  jitstencil(st_add_nv),
+  jitstencil(st_sub_ii),
+  jitstencil(st_sub_ff),
+  jitstencil(st_sub_nn),
+  jitstencil(st_sub_vv),
+  jitstencil(st_sub_vn),
+  jitstencil(st_sub_nv),
+  jitstencil(st_mul_ii),
+  jitstencil(st_mul_ff),
+  jitstencil(st_mul_nn),
+  jitstencil(st_mul_vv),
+  jitstencil(st_mul_vn),
+  jitstencil(st_mul_nv),
+  jitstencil(st_div_ff),
+  jitstencil(st_div_nn),
+  jitstencil(st_div_vv),
+  jitstencil(st_div_vn),
+  jitstencil(st_div_nv),
+  jitstencil(st_band_ii),
+  jitstencil(st_bor_ii),
+  jitstencil(st_bxor_ii),
+  jitstencil(st_mod_ii),
+  jitstencil(st_idiv_ii),
+  jitstencil(st_unm),
+  jitstencil0(st_not),
+  jitstencil(st_gettable),
+  jitstencil(st_settable),
+  jitstencil(st_settable_ro),
+  jitstencil(st_vgetfield),
+  jitstencil(st_jmp),
+  jitstencil(st_lt),
+  jitstencil(st_le),
+  jitstencil(st_eq),
+  jitstencil(st_lti),
+  jitstencil(st_lei),
+  jitstencil(st_gti),
+  jitstencil(st_gei),
+  jitstencil(st_eqi),
+  jitstencil(st_eqktag),
+  jitstencil(st_eqkstr),
+  jitstencil(st_eqkint),
+  jitstencil(st_eqkflt),
+  jitstencil(st_test),
+  jitstencil(st_forprep),
+  jitstencil(st_forloop_i),
+  jitstencil(st_forloop_f),
+  jitstencil(st_forloop)
+};
@@ -110,6 +110,16 @@ static const void *const disptab[NUM_OPCODES] = {
 #endif
 &&L_OP_VARARG,
 &&L_OP_VARARGPREP,
-&&L_OP_EXTRAARG
+&&L_OP_EXTRAARG,
+&&L_OP_MOVE_CALL,
+&&L_OP_LOADI_CALL,
+&&L_OP_GETTABLE_CALL,
+&&L_OP_SELF_CALL,
+&&L_OP_GETUPVAL_GETTABLE,
+&&L_OP_MOVE_GETTABLE,
+&&L_OP_GETTABUP_GETFIELD,
+&&L_OP_GETFIELD_GETFIELD,
+&&L_OP_MUL_ADD,
+&&L_OP_MODK_EQI
 
 };
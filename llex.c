@@ -20,8 +20,10 @@
 #include "ldo.h"
 #include "lgc.h"
 #include "llex.h"
+#include "lmem.h"
 #include "lobject.h"
 #include "lparser.h"
+#include "lsimd.h"
 #include "lstate.h"
 #include "lstring.h"
 #include "ltable.h"
@@ -75,6 +77,117 @@ static void save (LexState *ls, int c) {
 }
 
 
+/*
+** {======================================================
+** Bulk scanning: the characters of the input that follow 'current'
+** are contiguous in the ZIO buffer (the whole chunk when loading a
+** string, large blocks when loading a file), so runs of characters
+** that need no individual treatment are consumed in one step instead
+** of one 'zgetc' at a time. Runs never cross the end of the buffer;
+** the lexer handles what is left one character at a time, as usual.
+** Only valid while 'current' is not EOZ.
+** =======================================================
+*/
+
+/*
+** Length of the run of characters in the buffer before the first one
+** equal to 'c0', 'c1', 'c2', or 'c3' (not necessarily different).
+*/
+static size_t stopspan (ZIO *z, int c0, int c1, int c2, int c3) {
+  const char *p = z->p;
+  size_t n = z->n;
+  size_t i = 0;
+#if defined(LUA_SIMD)
+  const __m128i s0 = _mm_set1_epi8(cast_char(c0));
+  const __m128i s1 = _mm_set1_epi8(cast_char(c1));
+  const __m128i s2 = _mm_set1_epi8(cast_char(c2));
+  const __m128i s3 = _mm_set1_epi8(cast_char(c3));
+  for (; n - i >= 16; i += 16) {
+    const __m128i b = _mm_loadu_si128((const __m128i *)(p + i));
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(b, s0), _mm_cmpeq_epi8(b, s1)),
+                   _mm_or_si128(_mm_cmpeq_epi8(b, s2), _mm_cmpeq_epi8(b, s3))));
+    if (mask != 0)
+      return i + l_ctz(mask);
+  }
+#endif
+  for (; i < n; i++) {
+    int c = cast_uchar(p[i]);
+    if (c == c0 || c == c1 || c == c2 || c == c3)
+      break;
+  }
+  return i;
+}
+
+
+/* length of the run of characters in the buffer that can continue a name */
+static size_t namespan (ZIO *z) {
+  const char *p = z->p;
+  size_t n = z->n;
+  size_t i = 0;
+  while (i < n && lislalnum(cast_uchar(p[i])))
+    i++;
+  return i;
+}
+
+
+/* length of the run of digits and dots in the buffer */
+static size_t digitspan (ZIO *z) {
+  const char *p = z->p;
+  size_t n = z->n;
+  size_t i = 0;
+  while (i < n && (lisdigit(cast_uchar(p[i])) || p[i] == '.'))
+    i++;
+  return i;
+}
+
+
+/* length of the run of spaces and tabs in the buffer */
+static size_t blankspan (ZIO *z) {
+  const char *p = z->p;
+  size_t n = z->n;
+  size_t i = 0;
+  while (i < n && (p[i] == ' ' || p[i] == '\t'))
+    i++;
+  return i;
+}
+
+
+/*
+** Save the current character and the next 'n' characters of the
+** buffer, then read the character after them.
+*/
+static void save_run (LexState *ls, size_t n) {
+  Mbuffer *b = ls->buff;
+  ZIO *z = ls->z;
+  save(ls, ls->current);
+  if (luaZ_sizebuffer(b) - luaZ_bufflen(b) < n) {
+    size_t newsize = luaZ_sizebuffer(b);
+    do {
+      if (newsize >= MAX_SIZE/2)
+        lexerror(ls, "lexical element too long", 0);
+      newsize *= 2;
+    } while (newsize - luaZ_bufflen(b) < n);
+    luaZ_resizebuffer(ls->L, b, newsize);
+  }
+  memcpy(b->buffer + luaZ_bufflen(b), z->p, n);
+  luaZ_bufflen(b) += n;
+  z->p += n;
+  z->n -= n;
+  ls_next(ls);
+}
+
+
+/* skip the current character and the next 'n' characters of the buffer */
+static void skip_run (LexState *ls, size_t n) {
+  ls->z->p += n;
+  ls->z->n -= n;
+  ls_next(ls);
+}
+
+/* }====================================================== */
+
+
 void luaX_init (lua_State *L) {
 #if defined(LUA_NO_PARSER)
   UNUSED(L);
@@ -149,13 +262,13 @@ l_noret luaX_syntaxerror (LexState *ls, const char *msg) {
 TString *luaX_newstring (LexState *ls, const char *str, size_t l) {
   lua_State *L = ls->L;
   TString *ts = luaS_newlstr(L, str, l);  /* create new string */
-  const TValue *o = luaH_getstr(ls->h, ts);
+  const TValue *o = luaH_Hgetstr(ls->h, ts);
   if (!ttisnil(o))  /* string already present? */
     ts = keystrval(nodefromval(o));  /* get saved copy */
   else {  /* not in use yet */
     TValue *stv = s2v(L->top++);  /* reserve stack space for string */
     setsvalue(L, stv, ts);  /* temporarily anchor the string */
-    luaH_finishset(L, ls->h, stv, o, stv);  /* t[string] = string */
+    luaH_set(L, ls->h, stv, stv);  /* t[string] = string */
     /* table is not a metatable, so it does not need to invalidate cache */
     luaC_checkGC(L);
     L->top--;  /* remove string from stack */
@@ -191,6 +304,10 @@ void luaX_setinput (lua_State *L, LexState *ls, ZIO *z, TString *source,
   ls->lastline = 1;
   ls->source = source;
   ls->envn = luaS_newliteral(L, LUA_ENV);  /* get env name */
+  ls->inl = NULL;
+  ls->record = -1;  /* not recording tokens */
+  ls->replay = -1;  /* not replaying tokens */
+  ls->replayend = 0;
   luaZ_resizebuffer(ls->L, ls->buff, LUA_MINBUFFER);  /* initialize buffer */
 }
 
@@ -250,7 +367,9 @@ static int read_numeral (LexState *ls, SemInfo *seminfo) {
   for (;;) {
     if (check_next2(ls, expo))  /* exponent mark? */
       check_next2(ls, "-+");  /* optional exponent sign */
-    else if (lisxdigit(ls->current) || ls->current == '.')  /* '%x|%.' */
+    else if (lisdigit(ls->current) || ls->current == '.')  /* '%d|%.' */
+      save_run(ls, digitspan(ls->z));
+    else if (lisxdigit(ls->current))  /* '%x' */
       save_and_next(ls);
     else break;
   }
@@ -320,8 +439,9 @@ static void read_long_string (LexState *ls, SemInfo *seminfo, size_t sep) {
         break;
       }
       default: {
-        if (seminfo) save_and_next(ls);
-        else ls_next(ls);
+        size_t n = stopspan(ls->z, ']', '\n', '\r', ']');
+        if (seminfo) save_run(ls, n);
+        else skip_run(ls, n);
       }
     }
   } endloop:
@@ -448,7 +568,7 @@ static void read_string (LexState *ls, int del, SemInfo *seminfo) {
        no_save: break;
       }
       default:
-        save_and_next(ls);
+        save_run(ls, stopspan(ls->z, del, '\\', '\n', '\r'));
     }
   }
   save_and_next(ls);  /* skip delimiter */
@@ -466,7 +586,7 @@ static int llex (LexState *ls, SemInfo *seminfo) {
         break;
       }
       case ' ': case '\f': case '\t': case '\v': {  /* spaces */
-        ls_next(ls);
+        skip_run(ls, blankspan(ls->z));
         break;
       }
       case '-': {  /* '-' or '--' (comment) */
@@ -486,9 +606,9 @@ static int llex (LexState *ls, SemInfo *seminfo) {
             break;
           }
         }
-        /* else short comment */
+        /* else short comment: skip until end of line (or end of file) */
         while (!currIsNewline(ls) && ls->current != EOZ)
-          ls_next(ls);  /* skip until end of line (or end of file) */
+          skip_run(ls, stopspan(ls->z, '\n', '\r', '\n', '\r'));
         break;
       }
       case '[': {  /* long string or simply '[' */
@@ -643,7 +763,7 @@ static int llex (LexState *ls, SemInfo *seminfo) {
         if (lislalpha(ls->current)) {  /* identifier or reserved word? */
           TString *ts;
           do {
-            save_and_next(ls);
+            save_run(ls, namespan(ls->z));
           } while (lislalnum(ls->current));
           ts = luaX_newstring(ls, luaZ_buffer(ls->buff),
                                   luaZ_bufflen(ls->buff));
@@ -665,20 +785,52 @@ static int llex (LexState *ls, SemInfo *seminfo) {
 }
 
 
+/*
+** Read the next token into 't'. While replaying (see 'inlinecall' in
+** lparser.c), tokens come from 'dyd->tok', and a TK_EOS marks their
+** end.
+*/
+static void nexttoken (LexState *ls, Token *t) {
+  if (ls->replay < 0)
+    t->token = llex(ls, &t->seminfo);
+  else if (ls->replay < ls->replayend)
+    *t = ls->dyd->tok.arr[ls->replay++];
+  else
+    t->token = TK_EOS;  /* end of replayed tokens */
+}
+
+
+/*
+** Save the token being consumed in 'dyd->tok' when the parser is
+** recording tokens (and they do not come from a replay). Recording
+** stops, with 'record' equal to 0, when it reaches its limit.
+*/
+static void recordtoken (LexState *ls) {
+  if (ls->record > 0 && ls->replay < 0) {
+    Dyndata *dyd = ls->dyd;
+    luaM_growvector(ls->L, dyd->tok.arr, dyd->tok.n + 1, dyd->tok.size,
+                    Token, MAX_INT, "tokens");
+    dyd->tok.arr[dyd->tok.n++] = ls->t;
+    ls->record--;
+  }
+}
+
+
 void luaX_next (LexState *ls) {
   ls->lastline = ls->linenumber;
+  recordtoken(ls);
   if (ls->lookahead.token != TK_EOS) {  /* is there a look-ahead token? */
     ls->t = ls->lookahead;  /* use this one */
     ls->lookahead.token = TK_EOS;  /* and discharge it */
   }
   else
-    ls->t.token = llex(ls, &ls->t.seminfo);  /* read next token */
+    nexttoken(ls, &ls->t);  /* read next token */
 }
 
 
 int luaX_lookahead (LexState *ls) {
   lua_assert(ls->lookahead.token == TK_EOS);
-  ls->lookahead.token = llex(ls, &ls->lookahead.seminfo);
+  nexttoken(ls, &ls->lookahead);
   return ls->lookahead.token;
 }
 
@@ -87,6 +87,10 @@ typedef struct LexState {
   struct Dyndata *dyd;  /* dynamic structures used by the parser */
   TString *source;  /* current source name */
   TString *envn;  /* environment variable name */
+  struct Inlinecall *inl;  /* innermost call being expanded inline */
+  int record;  /* tokens that may still be recorded in 'dyd->tok' (or -1) */
+  int replay;  /* next token to replay from 'dyd->tok' (or -1) */
+  int replayend;  /* end of the tokens being replayed */
 } LexState;
 
 
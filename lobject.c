@@ -130,7 +130,7 @@ void luaO_arith (lua_State *L, int op, const TValue *p1, const TValue *p2,
                  StkId res) {
   if (!luaO_rawarith(L, op, p1, p2, s2v(res))) {
     /* could not perform raw operation; try metamethod */
-    luaT_trybinTM(L, p1, p2, res, cast(TMS, (op - LUA_OPADD) + TM_ADD));
+    luaT_trybinTM(L, p1, p2, res, cast(TMS, (op - LUA_OPADD) + TM_ADD), 0);
   }
 }
 
@@ -148,6 +148,66 @@ static int isneg (const char **s) {
 }
 
 
+/*
+** The fast conversions between floats and numerals work on the binary
+** representation of IEEE doubles and need 64-bit integer arithmetic.
+*/
+#if !defined(LUA_USE_C89) && defined(LLONG_MAX) && \
+    LUA_FLOAT_TYPE == LUA_FLOAT_DOUBLE && \
+    l_floatatt(MANT_DIG) == 53 && l_floatatt(MAX_EXP) == 1024	/* { */
+
+#define LUAI_FASTNUM
+
+typedef unsigned long long l_uint64;
+
+#define DBLHIDDENBIT	(cast(l_uint64, 1) << 52)
+#define DBLSIGMASK	(DBLHIDDENBIT - 1)
+#define DBLINFINITY	(cast(l_uint64, 0x7FF) << 52)
+
+#include "lnumtab.h"
+
+
+/*
+** Full product of 'a' and 'b': return its upper 64 bits and put the
+** lower ones in '*lo'.
+*/
+static l_uint64 mul128 (l_uint64 a, l_uint64 b, l_uint64 *lo) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 l_uint128;
+  l_uint128 p = cast(l_uint128, a) * b;
+  *lo = cast(l_uint64, p);
+  return cast(l_uint64, p >> 64);
+#else
+  const l_uint64 M32 = 0xFFFFFFFFu;
+  l_uint64 a1 = a >> 32, a0 = a & M32;
+  l_uint64 b1 = b >> 32, b0 = b & M32;
+  l_uint64 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0;
+  l_uint64 mid = (p00 >> 32) + (p01 & M32) + (p10 & M32);
+  *lo = (mid << 32) | (p00 & M32);
+  return a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+
+/* number of leading zero bits of (nonzero) 'x' */
+static int clz64 (l_uint64 x) {
+#if defined(__GNUC__)
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  int s;
+  for (s = 32; s > 0; s >>= 1) {
+    if ((x >> (64 - s)) == 0) {
+      n += s;
+      x <<= s;
+    }
+  }
+  return n;
+#endif
+}
+
+#endif						/* } */
+
 
 /*
 ** {==================================================================
@@ -223,6 +283,246 @@ static lua_Number lua_strx2number (const char *s, char **endptr) {
 #define L_MAXLENNUM	200
 #endif
 
+
+/*
+** {==================================================================
+** Fast conversion of numerals to floats
+** ===================================================================
+*/
+
+#if defined(LUAI_FASTNUM)	/* { */
+
+/* maximum number of significant decimal digits that fit in 64 bits */
+#define MAXDECDIG	19
+
+/* maximum number of significant hexadecimal digits that fit in 64 bits */
+#define MAXHEXDIG	16
+
+/* exponents are saturated at this value (without changing results) */
+#define MAXNUMEXP	100000
+
+
+/*
+** Eisel-Lemire algorithm (Daniel Lemire, "Number Parsing at a Gigabyte
+** per Second", 2021; with the proof by Noble Mushtak and Daniel Lemire
+** that it needs no fallback): return the bits of the double nearest to
+** w * 10^q, for a nonzero 'w' and 'q' in [MINPOW5, MAXPOW5].
+*/
+static l_uint64 eiselemire (l_uint64 w, int q) {
+  const l_uint64 *p5 = pow5tab + 2 * (q - MINPOW5);
+  int lz = clz64(w);
+  int upper, shift, e;
+  l_uint64 hi, lo, m;
+  w <<= lz;  /* normalize */
+  hi = mul128(w, p5[0], &lo);
+  if ((hi & 0x1FF) == 0x1FF) {  /* lower bits may change the result? */
+    l_uint64 lo2;
+    l_uint64 hi2 = mul128(w, p5[1], &lo2);
+    lo += hi2;
+    if (hi2 > lo) hi++;  /* carry */
+  }
+  upper = cast_int(hi >> 63);
+  shift = upper + 64 - 52 - 3;
+  m = hi >> shift;  /* 54 bits (one to round) */
+  /* biased exponent: floor(q * log2(10)) + 63 + upper - lz + 1023 */
+  e = ((217706 * q) >> 16) + 63 + upper - lz + 1023;
+  if (e <= 0) {  /* subnormal? */
+    if (-e + 1 >= 64)
+      return 0;  /* too small: zero */
+    m >>= -e + 1;
+    m += m & 1;  /* round up (no ties are possible here) */
+    return m >> 1;  /* may carry into the smallest normal */
+  }
+  if (lo <= 1 && -4 <= q && q <= 23 && (m & 3) == 1 &&
+      (m << shift) == hi)  /* exactly halfway between two doubles? */
+    m &= ~cast(l_uint64, 1);  /* round to even (down) */
+  m += m & 1;  /* round up */
+  m >>= 1;
+  if (m >= (DBLHIDDENBIT << 1)) {  /* carry out of the significand? */
+    m = DBLHIDDENBIT;
+    e++;
+  }
+  if (e >= 0x7FF)
+    return DBLINFINITY;
+  return (cast(l_uint64, e) << 52) | (m & DBLSIGMASK);
+}
+
+
+/*
+** Read the exponent of a numeral after its mark, adding it to '*e'.
+** Return the end of the exponent or NULL if it has no digits.
+*/
+static const char *readexp (const char *s, int *e) {
+  int neg = isneg(&s);
+  int ex = 0;
+  if (!lisdigit(cast_uchar(*s)))
+    return NULL;  /* must have at least one digit */
+  for (; lisdigit(cast_uchar(*s)); s++) {
+    if (ex < MAXNUMEXP)
+      ex = ex * 10 + (*s - '0');
+  }
+  *e += (neg) ? -ex : ex;
+  return s;
+}
+
+
+/*
+** Convert a hexadecimal numeral (after its '0x') to a float, with the
+** exact rounding of 'strtod'. Return the end of the numeral (after any
+** trailing spaces) or NULL.
+*/
+static const char *l_hex2dfast (const char *s, lua_Number *result) {
+  l_uint64 m = 0;  /* significant digits */
+  int nd = 0;  /* number of significant digits in 'm' */
+  int e = 0;  /* binary exponent of 'm' */
+  int sticky = 0;  /* true if dropped digits are not all zeros */
+  int any = 0;  /* true if numeral has some digit */
+  int hasdot = 0;
+  for (;; s++) {
+    if (*s == '.') {
+      if (hasdot) return NULL;
+      hasdot = 1;
+    }
+    else if (lisxdigit(cast_uchar(*s))) {
+      int d = luaO_hexavalue(*s);
+      any = 1;
+      if (nd < MAXHEXDIG) {
+        m = m * 16 + d;
+        if (m != 0) nd++;
+        if (hasdot) e -= 4;
+        if (e < -4 * L_MAXLENNUM) return NULL;  /* too many zeros */
+      }
+      else {
+        sticky |= (d != 0);
+        if (!hasdot) e += 4;
+        if (e > 4 * L_MAXLENNUM) return NULL;  /* too many digits */
+      }
+    }
+    else break;
+  }
+  if (!any)
+    return NULL;
+  if ((*s == 'p' || *s == 'P') && (s = readexp(s + 1, &e)) == NULL)
+    return NULL;
+  while (lisspace(cast_uchar(*s))) s++;  /* skip trailing spaces */
+  if (*s != '\0')
+    return NULL;
+  if (m == 0)
+    *result = 0;
+  else {
+    int lz = clz64(m);
+    int E;  /* binary exponent of the leading bit */
+    m <<= lz;
+    E = e - lz + 63;
+    if (E > 1023)
+      *result = HUGE_VAL;
+    else {
+      int shift = (E >= -1022) ? 11 : 11 - 1022 - E;  /* bits to drop */
+      if (shift > 64)  /* less than half the smallest subnormal? */
+        *result = 0;
+      else {
+        l_uint64 mant = (shift < 64) ? m >> shift : 0;
+        l_uint64 rem = (shift < 64) ? m & ((cast(l_uint64, 1) << shift) - 1)
+                                    : m;
+        l_uint64 half = cast(l_uint64, 1) << (shift - 1);
+        if (rem > half || (rem == half && (sticky || (mant & 1))))
+          mant++;  /* round to nearest, ties to even */
+        *result = l_mathop(ldexp)(cast_num(mant),
+                                  (E >= -1022) ? E - 52 : -1074);
+      }
+    }
+  }
+  return s;
+}
+
+
+/*
+** Convert a numeral with a dot as its radix mark to a float, as
+** 'strtod' would but independently of the locale. Return the end of
+** the numeral (after any trailing spaces), or NULL if 's' is not such a
+** numeral or its value cannot be determined exactly.
+*/
+static const char *l_str2dfast (const char *s, lua_Number *result) {
+  l_uint64 w = 0;  /* first MAXDECDIG significant digits */
+  l_uint64 bits;
+  int nd = 0;  /* number of significant digits in 'w' */
+  int q = 0;  /* decimal exponent of 'w' */
+  int many = 0;  /* true if nonzero digits were dropped */
+  int any = 0;  /* true if numeral has some digit */
+  int neg;
+  while (lisspace(cast_uchar(*s))) s++;  /* skip initial spaces */
+  neg = isneg(&s);
+  if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {  /* hexadecimal? */
+    s = l_hex2dfast(s + 2, result);
+    if (s != NULL && neg) *result = -*result;
+    return s;
+  }
+  for (; lisdigit(cast_uchar(*s)); s++) {  /* integral part */
+    any = 1;
+    if (nd < MAXDECDIG) {
+      w = w * 10 + cast_uint(*s - '0');
+      if (w != 0) nd++;
+    }
+    else {
+      many |= (*s != '0');
+      if (++q > L_MAXLENNUM) return NULL;  /* too many digits */
+    }
+  }
+  if (*s == '.') {  /* fractional part */
+    for (s++; lisdigit(cast_uchar(*s)); s++) {
+      any = 1;
+      if (nd < MAXDECDIG) {
+        w = w * 10 + cast_uint(*s - '0');
+        if (w != 0) nd++;
+        if (--q < -L_MAXLENNUM) return NULL;  /* too many zeros */
+      }
+      else
+        many |= (*s != '0');
+    }
+  }
+  if (!any)
+    return NULL;
+  if ((*s == 'e' || *s == 'E') && (s = readexp(s + 1, &q)) == NULL)
+    return NULL;
+  while (lisspace(cast_uchar(*s))) s++;  /* skip trailing spaces */
+  if (*s != '\0')
+    return NULL;
+  if (w == 0 || q < MINPOW5)
+    bits = 0;
+  else if (q > MAXPOW5)
+    bits = DBLINFINITY;
+  else {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double pow10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (!many && -22 <= q && q <= 22 && w <= (DBLHIDDENBIT << 1)) {
+      /* both 'w' and 10^|q| are exact doubles: one rounding (Clinger) */
+      lua_Number n = cast_num(w);
+      n = (q < 0) ? n / pow10[-q] : n * pow10[q];
+      *result = (neg) ? -n : n;
+      return s;
+    }
+#endif
+    bits = eiselemire(w, q);
+    if (many && bits != eiselemire(w + 1, q))
+      return NULL;  /* dropped digits may change the result */
+  }
+  if (neg)
+    bits |= cast(l_uint64, 1) << 63;
+  memcpy(result, &bits, sizeof(bits));
+  return s;
+}
+
+#else						/* }{ */
+
+#define l_str2dfast(s,r)	((void)(s), (void)(r), (const char *)NULL)
+
+#endif						/* } */
+
+/* }====================================================== */
+
 /*
 ** Convert string 's' to a Lua number (put in 'result'). Return NULL on
 ** fail or the address of the ending '\0' on success. ('mode' == 'x')
@@ -252,9 +552,13 @@ static const char *l_str2dloc (const char *s, lua_Number *result, int mode) {
 ** - '.' just optimizes the search for the common case (no special chars)
 */
 static const char *l_str2d (const char *s, lua_Number *result) {
-  const char *endptr;
-  const char *pmode = strpbrk(s, ".xXnN");  /* look for special chars */
-  int mode = pmode ? ltolower(cast_uchar(*pmode)) : 0;
+  const char *endptr = l_str2dfast(s, result);
+  const char *pmode;
+  int mode;
+  if (endptr != NULL)  /* common case: converted without the C library */
+    return endptr;
+  pmode = strpbrk(s, ".xXnN");  /* look for special chars */
+  mode = pmode ? ltolower(cast_uchar(*pmode)) : 0;
   if (mode == 'n')  /* reject 'inf' and 'nan' */
     return NULL;
   endptr = l_str2dloc(s, result, mode);  /* try to convert */
@@ -352,6 +656,471 @@ int luaO_utf8esc (char *buff, unsigned long x) {
 #define MAXNUMBER2STR	44
 
 
+/*
+** {==================================================================
+** Fast number formatting
+** ===================================================================
+*/
+
+/* decimal digit pairs "00" to "99" */
+static const char digitpairs[] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+
+/*
+** Copy the 'len' characters at 'str' into 'buff' with the semantics of
+** 'snprintf': the result is truncated to 'sz' - 1 characters and is
+** always terminated; the returned length is the non-truncated one.
+*/
+static int copyfmt (char *buff, size_t sz, const char *str, int len) {
+  if (sz > 0) {
+    size_t n = (cast_sizet(len) < sz) ? cast_sizet(len) : sz - 1;
+    memcpy(buff, str, n);
+    buff[n] = '\0';
+  }
+  return len;
+}
+
+
+/*
+** Convert an integer to a string, as 'lua_integer2str' with the default
+** LUA_INTEGER_FMT would, two digits at a time.
+*/
+int luaO_fmtint (char *buff, size_t sz, lua_Integer x) {
+  char temp[MAXNUMBER2STR];
+  char *p = temp + MAXNUMBER2STR;
+  lua_Unsigned u = l_castS2U(x);
+  if (x < 0) u = 0u - u;
+  while (u >= 100) {
+    const char *d = digitpairs + (u % 100) * 2;
+    u /= 100;
+    *--p = d[1];
+    *--p = d[0];
+  }
+  if (u >= 10) {
+    *--p = digitpairs[u * 2 + 1];
+    *--p = digitpairs[u * 2];
+  }
+  else
+    *--p = cast_char('0' + u);
+  if (x < 0)
+    *--p = '-';
+  return copyfmt(buff, sz, p, cast_int(temp + MAXNUMBER2STR - p));
+}
+
+
+/* precision that makes 'luaO_fmtnum' produce round-trip representations */
+#define MAXFMTPREC	17
+
+
+/*
+** Format 'n' through the C library, as "%.<prec><conv>".
+*/
+static int fmtnumC (char *buff, size_t sz, int conv, int prec, lua_Number n) {
+  char form[16];
+  int i = 0;
+  form[i++] = '%';
+  form[i++] = '.';
+  if (prec >= 10)
+    form[i++] = cast_char('0' + prec / 10);
+  form[i++] = cast_char('0' + prec % 10);
+  strcpy(form + i, LUA_NUMBER_FRMLEN);
+  i += cast_int(sizeof(LUA_NUMBER_FRMLEN)) - 1;
+  form[i++] = cast_char(conv);
+  form[i] = '\0';
+  return l_sprintf(buff, sz, form, (LUAI_UACNUMBER)n);
+}
+
+
+#if defined(LUA_NUMBER_SHORTEST)
+/*
+** Format 'n' through the C library as the shortest string that reads
+** back as 'n'. With at most l_floatatt(DIG) digits, only one decimal of
+** each length can read back as a normal 'n', so "%.<DIG>g" (without
+** trailing zeros) finds any that short; longer ones, and those of
+** subnormals (with fewer significant bits), need each precision tried.
+*/
+static int fmtshortC (char *buff, size_t sz, lua_Number n) {
+  int prec = (l_mathop(fabs)(n) < l_floatatt(MIN)) ? 1 : l_floatatt(DIG);
+  for (; prec < MAXFMTPREC; prec++) {
+    int len = fmtnumC(buff, sz, 'g', prec, n);
+    if (cast_sizet(len) < sz && lua_str2number(buff, NULL) == n)
+      return len;
+  }
+  return fmtnumC(buff, sz, 'g', MAXFMTPREC, n);
+}
+#endif
+
+
+#if defined(LUAI_FASTNUM)	/* { */
+
+/*
+** A "do-it-yourself floating point" number: f * 2^e.
+*/
+typedef struct DiyFp {
+  l_uint64 f;
+  int e;
+} DiyFp;
+
+
+/* product of two DiyFp, rounded to the upper 64 bits */
+static DiyFp diymul (DiyFp x, DiyFp y) {
+  DiyFp r;
+  l_uint64 lo;
+  r.f = mul128(x.f, y.f, &lo);
+  r.f += lo >> 63;  /* round */
+  r.e = x.e + y.e + 64;
+  return r;
+}
+
+
+
+
+/*
+** Get the cached power of ten that brings a product with binary exponent
+** 'e' into the range [-60, -32]; '*K' receives its negated decimal
+** exponent.
+*/
+static DiyFp cachedpower (int e, int *K) {
+  double dk = (-61 - e) * 0.30102999566398114 + 347;  /* log10(2) */
+  int k = cast_int(dk);
+  int i;
+  DiyFp r;
+  if (dk - k > 0.0) k++;
+  i = (k >> 3) + 1;
+  *K = -(-348 + i * 8);
+  r.f = cachedpowF[i];
+  r.e = cachedpowE[i];
+  return r;
+}
+
+
+/*
+** Number of decimal digits of 'n'.
+*/
+static int countdigits (unsigned int n) {
+  int d = 1;
+  while (n >= 10) {
+    n /= 10;
+    d++;
+  }
+  return d;
+}
+
+
+/*
+** Move the last generated digit towards 'W' while the result stays
+** inside the rounding interval.
+*/
+static void grisuround (char *digits, int len, l_uint64 delta, l_uint64 rest,
+                        l_uint64 tenkappa, l_uint64 wpw) {
+  while (rest < wpw && delta - rest >= tenkappa &&
+         (rest + tenkappa < wpw || wpw - rest > rest + tenkappa - wpw)) {
+    digits[len - 1]--;
+    rest += tenkappa;
+  }
+}
+
+
+/*
+** Generate the digits of the (scaled) value 'W', whose upper boundary is
+** 'Mp' and whose rounding interval has size 'delta'. Return the number
+** of digits and add their exponent to '*K'.
+*/
+static int digitgen (DiyFp W, DiyFp Mp, l_uint64 delta, char *digits,
+                     int *K) {
+  static const l_uint64 pow10[] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u,
+    100000000u, 1000000000u, 10000000000u, 100000000000u,
+    1000000000000u, 10000000000000u, 100000000000000u,
+    1000000000000000u, 10000000000000000u, 100000000000000000u,
+    1000000000000000000u, 10000000000000000000u
+  };
+  const int shift = -Mp.e;
+  const l_uint64 one = cast(l_uint64, 1) << shift;
+  const l_uint64 wpw = Mp.f - W.f;
+  unsigned int p1 = cast_uint(Mp.f >> shift);  /* integral part */
+  l_uint64 p2 = Mp.f & (one - 1);  /* fractional part */
+  int kappa = countdigits(p1);
+  int len = 0;
+  while (kappa > 0) {
+    unsigned int d;
+    l_uint64 rest;
+    switch (kappa) {  /* constant divisors are much cheaper */
+      case 10: d = p1 / 1000000000u; p1 %= 1000000000u; break;
+      case 9: d = p1 / 100000000u; p1 %= 100000000u; break;
+      case 8: d = p1 / 10000000u; p1 %= 10000000u; break;
+      case 7: d = p1 / 1000000u; p1 %= 1000000u; break;
+      case 6: d = p1 / 100000u; p1 %= 100000u; break;
+      case 5: d = p1 / 10000u; p1 %= 10000u; break;
+      case 4: d = p1 / 1000u; p1 %= 1000u; break;
+      case 3: d = p1 / 100u; p1 %= 100u; break;
+      case 2: d = p1 / 10u; p1 %= 10u; break;
+      default: d = p1; p1 = 0; break;
+    }
+    if (d || len)
+      digits[len++] = cast_char('0' + d);
+    kappa--;
+    rest = (cast(l_uint64, p1) << shift) + p2;
+    if (rest <= delta) {
+      *K += kappa;
+      grisuround(digits, len, delta, rest, pow10[kappa] << shift, wpw);
+      return len;
+    }
+  }
+  for (;;) {  /* kappa <= 0 */
+    char d;
+    p2 *= 10;
+    delta *= 10;
+    d = cast_char(p2 >> shift);
+    if (d || len)
+      digits[len++] = cast_char('0' + d);
+    p2 &= one - 1;
+    kappa--;
+    if (p2 < delta) {
+      *K += kappa;
+      grisuround(digits, len, delta, p2, one,
+                 (-kappa < 20) ? wpw * pow10[-kappa] : 0);
+      return len;
+    }
+  }
+}
+
+
+/*
+** Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+** Accurately with Integers", 2010): write into 'digits' a short decimal
+** significand that reads back as the positive normal double with
+** significand 'f' (including its hidden bit) and exponent 'e', and
+** return its length. The value of the result is 'digits' * 10^K. The
+** significand is the shortest possible in the vast majority of cases.
+*/
+static int grisu2 (l_uint64 f, int e, char *digits, int *K) {
+  DiyFp v, mp, mm, c;
+  v.f = f << 11; v.e = e - 11;  /* normalize */
+  mp.f = ((f << 1) + 1) << 10; mp.e = e - 1 - 10;  /* upper boundary */
+  if (f == DBLHIDDENBIT)  /* lower boundary is closer? */
+    mm.f = ((f << 2) - 1) << 9;
+  else
+    mm.f = ((f << 1) - 1) << 10;
+  mm.e = mp.e;
+  c = cachedpower(mp.e, K);
+  v = diymul(v, c);
+  mp = diymul(mp, c);
+  mm = diymul(mm, c);
+  mm.f++; mp.f--;  /* be conservative */
+  return digitgen(v, mp, mp.f - mm.f, digits, K);
+}
+
+
+/*
+** Round the 'n' digits in 'd', the decimal significand of the double
+** with (53-bit) significand 'f', to 's' digits. These digits are only
+** within half an ulp of the double, so give up (return -1) when they are
+** too close to a rounding tie to decide its direction. Otherwise return
+** the new number of digits, incrementing the decimal exponent '*x' of
+** the first digit on a carry.
+*/
+static int rounddigits (char *d, int n, int s, int *x, l_uint64 f) {
+  l_uint64 D = 0, T = 0, H = 5;  /* digits, tail, and half */
+  double diff;
+  int i;
+  if (n <= s)  /* nothing to round? */
+    return n;
+  for (i = 0; i < n; i++) {
+    D = D * 10 + cast_uint(d[i] - '0');
+    if (i >= s) T = T * 10 + cast_uint(d[i] - '0');
+    if (i > s) H *= 10;
+  }
+  diff = (T > H) ? cast(double, T - H) : cast(double, H - T);
+  /* half an ulp of the double is about D / (2 * f) units of the tail */
+  if (diff * 2.0 * cast(double, f) <= cast(double, D) * 1.000001)
+    return -1;
+  else if (T < H)  /* round down */
+    return s;
+  for (i = s; i > 0 && d[i - 1] == '9'; i--) ;  /* round up */
+  if (i == 0) {  /* carry out of the first digit */
+    d[0] = '1';
+    (*x)++;
+    return 1;
+  }
+  d[i - 1]++;
+  return i;
+}
+
+
+/*
+** Write the 'n' digits 'd' (where the first digit has decimal exponent
+** 'x') as "%.<p>g" would.
+*/
+static int layoutg (char *out, const char *d, int n, int x, int p) {
+  char *o = out;
+  int i;
+  while (n > 1 && d[n - 1] == '0') n--;  /* remove trailing zeros */
+  if (x < -4 || x >= p) {  /* exponential notation? */
+    int ex = (x < 0) ? -x : x;
+    *o++ = d[0];
+    if (n > 1) {
+      *o++ = lua_getlocaledecpoint();
+      memcpy(o, d + 1, n - 1);
+      o += n - 1;
+    }
+    *o++ = 'e';
+    *o++ = (x < 0) ? '-' : '+';
+    if (ex >= 100) {
+      *o++ = cast_char('0' + ex / 100);
+      ex %= 100;
+    }
+    *o++ = digitpairs[ex * 2];
+    *o++ = digitpairs[ex * 2 + 1];
+  }
+  else if (x < 0) {  /* 0.0ddd */
+    *o++ = '0';
+    *o++ = lua_getlocaledecpoint();
+    for (i = -1; i > x; i--) *o++ = '0';
+    memcpy(o, d, n);
+    o += n;
+  }
+  else {
+    for (i = 0; i <= x; i++) *o++ = (i < n) ? d[i] : '0';
+    if (n > x + 1) {
+      *o++ = lua_getlocaledecpoint();
+      memcpy(o, d + x + 1, n - x - 1);
+      o += n - x - 1;
+    }
+  }
+  return cast_int(o - out);
+}
+
+
+/*
+** Write the 'n' digits 'd' (where the first digit has decimal exponent
+** 'x') as "%.<p>f" would, padding them with zeros.
+*/
+static int layoutf (char *out, const char *d, int n, int x, int p) {
+  char *o = out;
+  int i;
+  if (x < 0)
+    *o++ = '0';
+  else {
+    for (i = 0; i <= x; i++) *o++ = (i < n) ? d[i] : '0';
+  }
+  if (p > 0) {
+    *o++ = lua_getlocaledecpoint();
+    for (i = x + 1; i <= x + p; i++) *o++ = (0 <= i && i < n) ? d[i] : '0';
+  }
+  return cast_int(o - out);
+}
+
+
+/*
+** Maximum number of significant digits that can be correctly rounded
+** from the digits generated by 'grisu2'.
+*/
+#define MAXROUNDDIGITS	15
+
+/* room for a sign, MAXROUNDDIGITS + 1 integral digits and 99 decimals */
+#define MAXFMTBUFF	128
+
+
+/*
+** Format a double without the C library when possible. 'prec' is the
+** precision of the conversion 'conv' ('f' or 'g'); a negative 'prec'
+** asks for the shortest representation that reads back as 'n'. Values
+** that cannot be formatted this way (infinities, NaNs, subnormals,
+** digits beyond MAXROUNDDIGITS, ties too close to call, or digits of
+** 'grisu2' that may not be the shortest ones) return -1.
+*/
+static int fmtdouble (char *buff, size_t sz, int conv, int prec,
+                      lua_Number n) {
+  char temp[MAXFMTBUFF];
+  char digits[32];
+  l_uint64 bits, f;
+  int be, nd, x, len = 0;
+  memcpy(&bits, &n, sizeof(bits));
+  be = cast_int((bits >> 52) & 0x7FF);  /* biased exponent */
+  f = bits & DBLSIGMASK;
+  if (be == 0x7FF || (be == 0 && f != 0) || prec > 99)
+    return -1;  /* infinity, NaN, or subnormal */
+  if (bits >> 63)
+    temp[len++] = '-';
+  if (be == 0) {  /* zero */
+    digits[0] = '0';
+    nd = 1;
+    x = 0;
+  }
+  else {
+    int K;
+    f |= DBLHIDDENBIT;
+    nd = grisu2(f, be - 1075, digits, &K);
+    x = nd + K - 1;
+  }
+  if (prec < 0) {  /* shortest? */
+    while (nd > 1 && digits[nd - 1] == '0') nd--;
+    /* 'grisu2' misses a shorter result only when it lies in the margins
+       left at both ends of the rounding interval; then it gives more
+       than l_floatatt(DIG) digits, as only up to that many digits a
+       single decimal of each length fits in the interval */
+    if (nd > l_floatatt(DIG))
+      return -1;
+    len += layoutg(temp + len, digits, nd, x, MAXFMTPREC);
+  }
+  else {
+    int s = (conv == 'f') ? x + 1 + prec : (prec == 0) ? 1 : prec;
+    if (s > MAXROUNDDIGITS)
+      return -1;
+    else if (s < 0)  /* rounds to zero */
+      nd = 0;
+    else if ((nd = rounddigits(digits, nd, s, &x, f)) < 0)
+      return -1;
+    if (conv == 'f')
+      len += layoutf(temp + len, digits, nd, x, prec);
+    else
+      len += layoutg(temp + len, digits, nd, x, (prec == 0) ? 1 : prec);
+  }
+  return copyfmt(buff, sz, temp, len);
+}
+
+#else						/* }{ */
+
+#define fmtdouble(b,sz,c,p,n)	((void)(b), (void)(sz), (void)(c), (void)(p), \
+                                 (void)(n), -1)
+
+#endif						/* } */
+
+
+/*
+** Convert a float to a string, as 'snprintf' with the format
+** "%.<prec><conv>" would ('prec' must be in [0, 99]). A 'conv' of zero
+** uses LUA_NUMBER_FMT, or, with LUA_NUMBER_SHORTEST, the shortest string
+** that reads back as the same float.
+*/
+int luaO_fmtnum (char *buff, size_t sz, int conv, int prec, lua_Number n) {
+  int len = -1;
+  if (conv == 0) {
+#if defined(LUA_NUMBER_SHORTEST)
+    if ((len = fmtdouble(buff, sz, 'g', -1, n)) < 0)
+      len = fmtshortC(buff, sz, n);
+    return len;
+#elif defined(LUA_NUMBER_PREC)
+    conv = 'g';
+    prec = LUA_NUMBER_PREC;
+#else
+    return lua_number2str(buff, sz, n);
+#endif
+  }
+  if (conv == 'f' || conv == 'g')
+    len = fmtdouble(buff, sz, conv, prec, n);
+  return (len < 0) ? fmtnumC(buff, sz, conv, prec, n) : len;
+}
+
+/* }================================================================== */
+
+
 /*
 ** Convert a number object to a string, adding it to a buffer
 */
@@ -359,9 +1128,9 @@ static int tostringbuff (TValue *obj, char *buff) {
   int len;
   lua_assert(ttisnumber(obj));
   if (ttisinteger(obj))
-    len = lua_integer2str(buff, MAXNUMBER2STR, ivalue(obj));
+    len = luaO_fmtint(buff, MAXNUMBER2STR, ivalue(obj));
   else {
-    len = lua_number2str(buff, MAXNUMBER2STR, fltvalue(obj));
+    len = luaO_fmtnum(buff, MAXNUMBER2STR, 0, 0, fltvalue(obj));
     if (buff[strspn(buff, "-0123456789")] == '\0') {  /* looks like an int? */
       buff[len++] = lua_getlocaledecpoint();
       buff[len++] = '0';  /* adds '.0' to result */
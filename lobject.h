@@ -179,6 +179,9 @@ typedef StackValue *LUA_RESTRICT StkId;
 /* Value returned for a key not found in a table (absent key) */
 #define LUA_VABSTKEY	makevariant(LUA_TNIL, 2)
 
+/* Special variant to signal that a fast get is accessing a non-table */
+#define LUA_VNOTABLE	makevariant(LUA_TNIL, 3)
+
 
 /* macro to test for (any kind of) nil */
 #define ttisnil(v)		checktype((v), LUA_TNIL)
@@ -208,6 +211,10 @@ typedef StackValue *LUA_RESTRICT StkId;
 #define isempty(v)		ttisnil(v)
 
 
+/* test whether a tag (as returned by the table getters) is empty */
+#define tagisempty(tag)		(novariant(tag) == LUA_TNIL)
+
+
 /* macro defining a value corresponding to an absent key */
 #define ABSTKEYCONSTANT		{NULL}, LUA_VABSTKEY
 
@@ -353,14 +360,22 @@ typedef struct GCObject {
 #if defined(LUAGLM_EXT_BLOB)
   #define LUA_VBLOBSTR makevariant(LUA_TSTRING, 2)  /* long blobs */
 #endif
+#if defined(LUAGLM_EXT_SLICE)
+  #define LUA_VSLCSTR makevariant(LUA_TSTRING, 3)  /* long string slices */
+#endif
 
 #define ttisstring(o)		checktype((o), LUA_TSTRING)
 #define ttisshrstring(o)	checktag((o), ctb(LUA_VSHRSTR))
 #define ttislngstring(o)	checktag((o), ctb(LUA_VLNGSTR))
 #if defined(LUAGLM_EXT_BLOB)
   #define ttisblobstring(o)	checktag((o), ctb(LUA_VBLOBSTR))
-  #define islongstring(tt) ((tt) == LUA_VLNGSTR || (tt) == LUA_VBLOBSTR)
 #endif
+#if defined(LUAGLM_EXT_SLICE)
+  #define ttisslicestring(o)	checktag((o), ctb(LUA_VSLCSTR))
+#endif
+
+/* string variants with an explicit length (i.e., all but short strings) */
+#define islongstring(tt) (novariant(tt) == LUA_TSTRING && (tt) != LUA_VSHRSTR)
 
 #define tsvalueraw(v)	(gco2ts((v).gc))
 
@@ -395,10 +410,34 @@ typedef struct TString {
 
 
 
+#if defined(LUAGLM_EXT_SLICE)
+/*
+** Contents of a string slice: a range of a parent long string, which is
+** kept alive by the slice. Slices are not zero-terminated.
+*/
+typedef struct TSliceRef {
+  char *data;  /* first character of the slice (inside 'parent') */
+  struct TString *parent;
+} TSliceRef;
+
+#define getslice(ts)	cast(TSliceRef *, (ts)->contents)
+
+l_sinline char *getstrslice (const TString *ts) {
+  if (ts->tt == LUA_VSLCSTR)
+    return getslice(ts)->data;
+  return cast_charp(ts->contents);
+}
+#endif
+
+
 /*
 ** Get the actual string (array of bytes) from a 'TString'.
 */
+#if defined(LUAGLM_EXT_SLICE)
+#define getstr(ts)  getstrslice(ts)
+#else
 #define getstr(ts)  ((ts)->contents)
+#endif
 
 
 /* get the actual string (array of bytes) from a Lua value */
@@ -552,6 +591,9 @@ typedef struct Proto {
   lu_byte numparams;  /* number of fixed (named) parameters */
   lu_byte is_vararg;
   lu_byte maxstacksize;  /* number of registers needed by this function */
+#if defined(LUA_USE_JIT)
+  lu_byte jitmode;  /* JIT compilation of this function (see 'ljit.h') */
+#endif
   int sizeupvalues;  /* size of 'upvalues' */
   int sizek;  /* size of 'k' */
   int sizecode;
@@ -563,7 +605,12 @@ typedef struct Proto {
   int lastlinedefined;  /* debug information  */
   TValue *k;  /* constants used by the function */
   Instruction *code;  /* opcodes */
+  unsigned int *icache;  /* inline caches of field accesses (see 'lfunc.c') */
   struct Proto **p;  /* functions defined inside the function */
+  struct LClosure *cache;  /* last-created closure with this prototype */
+#if defined(LUA_USE_JIT)
+  struct JitCode *jit;  /* native code (see 'ljit.c') */
+#endif
   Upvaldesc *upvalues;  /* upvalue information */
   ls_byte *lineinfo;  /* information about source lines (debug information) */
   AbsLineInfo *abslineinfo;  /* idem */
@@ -724,6 +771,12 @@ typedef union Node {
 ** real size of 'array'. Otherwise, the real size of 'array' is the
 ** smallest power of two not smaller than 'alimit' (or zero iff 'alimit'
 ** is zero); 'alimit' is then used as a hint for #t.
+**
+** The array part keeps the values and the tags of its entries in two
+** separate vectors, so that entries take 'sizeof(Value) + 1' bytes
+** instead of a padded 'TValue'. Both vectors live in a single block:
+** 'array' points to its middle, with the values before it, in reverse
+** order, and the tags after it. (See 'getArrVal' and 'getArrTag'.)
 */
 
 #define BITRAS		(1 << 7)
@@ -740,9 +793,14 @@ typedef struct Table {
 #endif
   lu_byte lsizenode;  /* log2 of size of 'node' array */
   unsigned int alimit;  /* "limit" of 'array' array */
-  TValue *array;  /* array part */
+  Value *array;  /* array part */
   Node *node;
+#if defined(LUA_SWISS_TABLES)
+  lu_byte *ctrl;  /* control bytes of 'node' (NULL with the dummy node) */
+  unsigned int growthleft;  /* number of new keys 'node' can still take */
+#else
   Node *lastfree;  /* any free position is before this position */
+#endif
   struct Table *metatable;
   GCObject *gclist;
 } Table;
@@ -838,12 +896,23 @@ typedef struct Table {
 
 typedef struct GCMatrix {
   CommonHeader;
+  lu_byte istemp;  /* only in the register of an intermediate result? */
   lua_Mat4 mat4;
 } GCMatrix;
 
 #define LUA_VMATRIX makevariant(LUA_TMATRIX, 0)
 
 #define ttismatrix(o) checktag((o), ctb(LUA_VMATRIX))
+
+/*
+** A temporary matrix ('istemp') may be overwritten by the operator that
+** consumes it (see 'glm_trybinTM'). It stops being one as soon as it can
+** be seen from anywhere else.
+*/
+#define glm_escapemat(o)                                \
+  LUA_MLM_BEGIN                                         \
+  if (ttismatrix(o)) gco2mat(val_(o).gc)->istemp = 0;  \
+  LUA_MLM_END
 #define mvalue(o)	check_exp(ttismatrix(o), gco2mat(val_(o).gc)->mat4)
 #define mvalue_ref(o)	check_exp(ttismatrix(o), &gco2mat(val_(o).gc)->mat4)
 #define mvalue_dims(o)	mvalue(o).dimensions
@@ -877,6 +946,9 @@ LUAI_FUNC void luaO_arith (lua_State *L, int op, const TValue *p1,
 LUAI_FUNC size_t luaO_str2num (const char *s, TValue *o);
 LUAI_FUNC int luaO_hexavalue (int c);
 LUAI_FUNC void luaO_tostring (lua_State *L, TValue *obj);
+LUAI_FUNC int luaO_fmtint (char *buff, size_t sz, lua_Integer x);
+LUAI_FUNC int luaO_fmtnum (char *buff, size_t sz, int conv, int prec,
+                           lua_Number n);
 LUAI_FUNC const char *luaO_pushvfstring (lua_State *L, const char *fmt,
                                                        va_list argp);
 LUAI_FUNC const char *luaO_pushfstring (lua_State *L, const char *fmt, ...);
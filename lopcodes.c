@@ -103,5 +103,35 @@ LUAI_DDEF const lu_byte luaP_opmodes[NUM_OPCODES] = {
  ,opmode(0, 1, 0, 0, 1, iABC)		/* OP_VARARG */
  ,opmode(0, 0, 1, 0, 1, iABC)		/* OP_VARARGPREP */
  ,opmode(0, 0, 0, 0, 0, iAx)		/* OP_EXTRAARG */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_MOVE_CALL */
+ ,opmode(0, 0, 0, 0, 1, iAsBx)		/* OP_LOADI_CALL */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_GETTABLE_CALL */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_SELF_CALL */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_GETUPVAL_GETTABLE */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_MOVE_GETTABLE */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_GETTABUP_GETFIELD */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_GETFIELD_GETFIELD */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_MUL_ADD */
+ ,opmode(0, 0, 0, 0, 1, iABC)		/* OP_MODK_EQI */
+};
+
+
+/*
+** Superinstructions replace the most frequent pairs of consecutive
+** opcodes in representative scripts, as counted by 'T.oppairs' (see
+** 'libs/scripts/examples/oppairs.lua'), that are measurably faster
+** when fused (see 'libs/scripts/examples/superinstructions.lua').
+*/
+LUAI_DDEF const lu_byte luaP_superops[NUM_OPCODES - NUM_BASEOPS][2] = {
+  {OP_MOVE, OP_CALL}		/* OP_MOVE_CALL */
+ ,{OP_LOADI, OP_CALL}		/* OP_LOADI_CALL */
+ ,{OP_GETTABLE, OP_CALL}	/* OP_GETTABLE_CALL */
+ ,{OP_SELF, OP_CALL}		/* OP_SELF_CALL */
+ ,{OP_GETUPVAL, OP_GETTABLE}	/* OP_GETUPVAL_GETTABLE */
+ ,{OP_MOVE, OP_GETTABLE}	/* OP_MOVE_GETTABLE */
+ ,{OP_GETTABUP, OP_GETFIELD}	/* OP_GETTABUP_GETFIELD */
+ ,{OP_GETFIELD, OP_GETFIELD}	/* OP_GETFIELD_GETFIELD */
+ ,{OP_MUL, OP_ADD}		/* OP_MUL_ADD */
+ ,{OP_MODK, OP_EQI}		/* OP_MODK_EQI */
 };
 
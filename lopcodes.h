@@ -182,6 +182,12 @@ enum OpMode {iABC, iABx, iAsBx, iAx, isJ};  /* basic instruction formats */
 #define NO_REG		MAXARG_A
 
 
+/*
+** value of B in an OP_NEWTABLE that copies a table template
+*/
+#define TEMPLATEB	MAXARG_B
+
+
 /*
 ** R[x] - register
 ** K[x] - constant (in constant table)
@@ -309,11 +315,26 @@ OP_VARARG,/*	A C	R[A], R[A+1], ..., R[A+C-2] = vararg		*/
 
 OP_VARARGPREP,/*A	(adjust vararg parameters)			*/
 
-OP_EXTRAARG/*	Ax	extra (larger) argument for previous opcode	*/
+OP_EXTRAARG,/*	Ax	extra (larger) argument for previous opcode	*/
+
+/* superinstructions: OP_X_Y runs OP_X and then the OP_Y after it (*) */
+OP_MOVE_CALL,
+OP_LOADI_CALL,
+OP_GETTABLE_CALL,
+OP_SELF_CALL,
+OP_GETUPVAL_GETTABLE,
+OP_MOVE_GETTABLE,
+OP_GETTABUP_GETFIELD,
+OP_GETFIELD_GETFIELD,
+OP_MUL_ADD,
+OP_MODK_EQI
 } OpCode;
 
 
-#define NUM_OPCODES	((int)(OP_EXTRAARG) + 1)
+#define NUM_OPCODES	((int)(OP_MODK_EQI) + 1)
+
+/* number of opcodes that are not superinstructions */
+#define NUM_BASEOPS	((int)(OP_EXTRAARG) + 1)
 
 
 
@@ -349,7 +370,8 @@ OP_EXTRAARG/*	Ax	extra (larger) argument for previous opcode	*/
 
   (*) In OP_NEWTABLE, B is log2 of the hash size (which is always a
   power of 2) plus 1, or zero for size zero. If not k, the array size
-  is C. Otherwise, the array size is EXTRAARG _ C.
+  is C. Otherwise, the array size is EXTRAARG _ C. If B is TEMPLATEB,
+  the new table is a copy of the template K[EXTRAARG] instead.
 
   (*) For comparisons, k specifies what condition the test should accept
   (true or false).
@@ -357,6 +379,10 @@ OP_EXTRAARG/*	Ax	extra (larger) argument for previous opcode	*/
   (*) In OP_MMBINI/OP_MMBINK, k means the arguments were flipped
    (the constant is the first operand).
 
+  (*) In arithmetic instructions and OP_UNM, k means the result is an
+  intermediate value that only the next arithmetic operator consumes
+  (so that it may reuse a matrix created for it).
+
   (*) All 'skips' (pc++) assume that next instruction is a jump.
 
   (*) In instructions OP_RETURN/OP_TAILCALL, 'k' specifies that the
@@ -368,6 +394,14 @@ OP_EXTRAARG/*	Ax	extra (larger) argument for previous opcode	*/
   original operand was a float. (It must be corrected in case of
   metamethods.)
 
+  (*) A superinstruction OP_X_Y has the arguments of the OP_X that it
+  replaces, and the OP_Y stays in the next instruction (or after the
+  OP_MMBIN* that follows an arithmetic OP_X). So, jumps into OP_Y and
+  debug information are not affected. After OP_X, the interpreter goes
+  directly to the code of OP_Y, or it dispatches the next instruction
+  as usual when an arithmetic OP_X needs its metamethod. The compiler
+  emits them only in optimized chunks ('O' in the load mode).
+
 ===========================================================================*/
 
 
@@ -398,6 +432,17 @@ LUAI_DDEC(const lu_byte luaP_opmodes[NUM_OPCODES];)
 /* "in top" (uses top from previous instruction) */
 #define isIT(i)		(testITMode(GET_OPCODE(i)) && GETARG_B(i) == 0)
 
+/*
+** opcodes that a superinstruction runs (see 'luaP_superops' and
+** 'luaK_finish')
+*/
+LUAI_DDEC(const lu_byte luaP_superops[NUM_OPCODES - NUM_BASEOPS][2];)
+
+/* opcode that a superinstruction runs first ('o' for other opcodes) */
+#define getBaseOp(o)  \
+	((o) < NUM_BASEOPS ? (o)  \
+	                   : cast(OpCode, luaP_superops[(o) - NUM_BASEOPS][0]))
+
 #define opmode(mm,ot,it,t,a,m)  \
     (((mm) << 7) | ((ot) << 6) | ((it) << 5) | ((t) << 4) | ((a) << 3) | (m))
 
@@ -99,6 +99,16 @@ static const char *const opnames[] = {
   "VARARG",
   "VARARGPREP",
   "EXTRAARG",
+  "MOVE_CALL",
+  "LOADI_CALL",
+  "GETTABLE_CALL",
+  "SELF_CALL",
+  "GETUPVAL_GETTABLE",
+  "MOVE_GETTABLE",
+  "GETTABUP_GETFIELD",
+  "GETFIELD_GETFIELD",
+  "MUL_ADD",
+  "MODK_EQI",
   NULL
 };
 
@@ -36,6 +36,13 @@
 #define MAXVARS		200
 
 
+/* maximum number of tokens of an inlinable function (see 'newinline') */
+#define MAXINLINE	48
+
+/* maximum depth of calls expanded inline inside each other */
+#define MAXINLINEDEPTH	4
+
+
 #define hasmultret(k)		((k) == VCALL || (k) == VVARARG)
 
 
@@ -58,6 +65,17 @@ typedef struct BlockCnt {
 } BlockCnt;
 
 
+/*
+** nodes for the list of calls being expanded inline
+*/
+typedef struct Inlinecall {
+  struct Inlinecall *previous;  /* chain */
+  int desc;  /* index of the inlinable function in 'dyd->inl' */
+  int base;  /* register of its first parameter */
+  int depth;  /* number of enclosing calls expanded inline plus one */
+} Inlinecall;
+
+
 
 /*
 ** prototypes for recursive non-terminal functions
@@ -210,6 +228,7 @@ static int new_localvar (LexState *ls, TString *name) {
                   dyd->actvar.size, Vardesc, USHRT_MAX, "local variables");
   var = &dyd->actvar.arr[dyd->actvar.n++];
   var->vd.kind = VDKREG;  /* default */
+  var->vd.inl = 0;  /* not inlinable */
   var->vd.name = name;
   return dyd->actvar.n - 1 - fs->firstlocal;
 }
@@ -250,7 +269,8 @@ static int reglevel (FuncState *fs, int nvar) {
 ** function.
 */
 int luaY_nvarstack (FuncState *fs) {
-  return reglevel(fs, fs->nactvar);
+  int level = reglevel(fs, fs->nactvar);
+  return (level < fs->inlinetop) ? fs->inlinetop : level;
 }
 
 
@@ -465,13 +485,38 @@ static void singlevaraux (FuncState *fs, TString *n, expdesc *var, int base) {
 }
 
 
+/*
+** Search the parameters of the innermost call being expanded inline
+** for one with the given name 'n'. Return its index or -1.
+*/
+static int searchinlineparam (LexState *ls, TString *n) {
+  if (ls->inl != NULL) {
+    Dyndata *dyd = ls->dyd;
+    Inlinedesc *d = &dyd->inl.arr[ls->inl->desc];
+    int i;
+    for (i = d->nparams - 1; i >= 0; i--) {
+      if (eqstr(n, dyd->inlname.arr[d->name + i].name))
+        return i;
+    }
+  }
+  return -1;  /* not found */
+}
+
+
 /*
 ** Find a variable with the given name 'n', handling global variables
-** too.
+** too. (Parameters of calls expanded inline are kept in registers
+** that are not local variables: see 'inlinecall'.)
 */
 static void singlevar (LexState *ls, expdesc *var) {
   TString *varname = str_checkname(ls);
   FuncState *fs = ls->fs;
+  int param = searchinlineparam(ls, varname);
+  if (param >= 0) {  /* parameter of a call being expanded inline? */
+    init_exp(var, VLOCAL, 0);
+    var->u.var.ridx = cast_byte(ls->inl->base + param);
+    return;
+  }
   singlevaraux(fs, varname, var, 1);
   if (var->k == VVOID) {  /* global name? */
     expdesc key;
@@ -756,6 +801,7 @@ static void open_func (LexState *ls, FuncState *fs, BlockCnt *bl) {
   fs->iwthabs = 0;
   fs->lasttarget = 0;
   fs->freereg = 0;
+  fs->inlinetop = 0;
   fs->nk = 0;
   fs->nabslineinfo = 0;
   fs->np = 0;
@@ -789,6 +835,7 @@ static void close_func (LexState *ls) {
   luaM_shrinkvector(L, f->p, f->sizep, fs->np, Proto *);
   luaM_shrinkvector(L, f->locvars, f->sizelocvars, fs->ndebugvars, LocVar);
   luaM_shrinkvector(L, f->upvalues, f->sizeupvalues, fs->nups, Upvaldesc);
+  luaF_initcache(L, f);
   ls->fs = fs->prev;
   luaC_checkGC(L);
 }
@@ -861,14 +908,94 @@ typedef struct ConsControl {
   int nh;  /* total number of 'record' elements */
   int na;  /* number of array elements already stored */
   int tostore;  /* number of array elements pending to be stored */
+  int firstcf;  /* index of first constant field (in 'dyd->cfield.arr') */
+  int nk;  /* number of constants before the constructor */
+  int isconst;  /* true while all fields are constants */
 } ConsControl;
 
 
+/* key of list items, and key and value of marks, in 'dyd->cfield' */
+static const TValue nilfield = {{NULL}, LUA_VNIL};
+
+
+/*
+** Constructors whose fields are all constants (including nested
+** constant constructors) are compiled into a template, a prebuilt
+** table that OP_NEWTABLE copies. While such a constructor is parsed,
+** its fields are also collected in 'dyd->cfield'.
+*/
+static void addconstfield (LexState *ls, const TValue *key,
+                                         const TValue *val) {
+  Dyndata *dyd = ls->dyd;
+  Constfield *cf;
+  luaM_growvector(ls->L, dyd->cfield.arr, dyd->cfield.n, dyd->cfield.size,
+                  Constfield, MAX_INT, "constant fields");
+  cf = &dyd->cfield.arr[dyd->cfield.n++];
+  setobj(ls->L, &cf->key, key);
+  setobj(ls->L, &cf->val, val);
+}
+
+
+/*
+** Check whether 'e' can be a value in a template: a non-nil constant
+** or the copy of another template. If so, put it in 'v'.
+*/
+static int constfieldval (FuncState *fs, expdesc *e, TValue *v) {
+  return (luaK_exp2const(fs, e, v) && !ttisnil(v)) ||
+         luaK_exp2template(fs, e, v);
+}
+
+
+/* mark that the pending list items are stored */
+static void constlistmark (LexState *ls, ConsControl *cc) {
+  if (cc->isconst)
+    addconstfield(ls, &nilfield, &nilfield);
+}
+
+
+/*
+** Build the template for a constructor with only constant fields and
+** code it in place of the constructor. Fields are stored in the order
+** the constructor would store them: record fields as they appear and
+** list items when they are flushed.
+*/
+static void codetemplate (LexState *ls, ConsControl *cc, int pc) {
+  lua_State *L = ls->L;
+  Constfield *cf = ls->dyd->cfield.arr;
+  int n = ls->dyd->cfield.n;
+  int pending = cc->firstcf;  /* first list item not stored yet */
+  lua_Integer item = 1;  /* index of next list item */
+  int i;
+  Table *t = luaH_new(L);
+  sethvalue2s(L, L->top, t);  /* anchor template (uses extra stack space) */
+  L->top++;
+  luaH_resize(L, t, cast_uint(cc->na), cast_uint(cc->nh));
+  for (i = cc->firstcf; i < n; i++) {
+    if (!ttisnil(&cf[i].key)) {  /* record field? */
+      luaH_set(L, t, &cf[i].key, &cf[i].val);
+      luaC_barrierback(L, obj2gco(t), &cf[i].val);
+    }
+    else if (ttisnil(&cf[i].val)) {  /* mark? */
+      for (; pending < i; pending++) {  /* store pending list items */
+        if (ttisnil(&cf[pending].key)) {
+          luaH_setint(L, t, item++, &cf[pending].val);
+          luaC_barrierback(L, obj2gco(t), &cf[pending].val);
+        }
+      }
+      pending = i + 1;  /* skip the mark */
+    }
+  }
+  luaK_settemplate(ls->fs, pc, cc->t->u.info, cc->nk, s2v(L->top - 1));
+  L->top--;  /* remove template (now anchored by the constants) */
+}
+
+
 static void recfield (LexState *ls, ConsControl *cc) {
   /* recfield -> (NAME | '['exp']') = exp */
   FuncState *fs = ls->fs;
   int reg = ls->fs->freereg;
   expdesc tab, key, val;
+  TValue kv, vv;  /* key and value, if constants */
   if (ls->t.token == TK_NAME) {
     checklimit(fs, cc->nh, MAX_INT, "items in a constructor");
     codename(ls, &key);
@@ -882,6 +1009,8 @@ static void recfield (LexState *ls, ConsControl *cc) {
   else  /* ls->t.token == '[' */
     yindex(ls, &key);
   cc->nh++;
+  if (cc->isconst)  /* key must be a non-nil constant */
+    cc->isconst = luaK_exp2const(fs, &key, &kv) && !ttisnil(&kv);
   tab = *cc->t;
 #if defined(LUAGLM_EXT_TABINIT)
   if (ls->t.token == '=') {
@@ -898,6 +1027,10 @@ static void recfield (LexState *ls, ConsControl *cc) {
   luaK_indexed(fs, &tab, &key);
   expr(ls, &val);
 #endif
+  if (cc->isconst && constfieldval(fs, &val, &vv))
+    addconstfield(ls, &kv, &vv);
+  else
+    cc->isconst = 0;
   luaK_storevar(fs, &tab, &val);
   fs->freereg = reg;  /* free registers */
 }
@@ -909,6 +1042,7 @@ static void closelistfield (FuncState *fs, ConsControl *cc) {
   cc->v.k = VVOID;
   if (cc->tostore == LFIELDS_PER_FLUSH) {
     luaK_setlist(fs, cc->t->u.info, cc->na, cc->tostore);  /* flush */
+    constlistmark(fs->ls, cc);
     cc->na += cc->tostore;
     cc->tostore = 0;  /* no more items pending */
   }
@@ -927,14 +1061,20 @@ static void lastlistfield (FuncState *fs, ConsControl *cc) {
       luaK_exp2nextreg(fs, &cc->v);
     luaK_setlist(fs, cc->t->u.info, cc->na, cc->tostore);
   }
+  constlistmark(fs->ls, cc);
   cc->na += cc->tostore;
 }
 
 
 static void listfield (LexState *ls, ConsControl *cc) {
   /* listfield -> exp */
+  TValue v;
   expr(ls, &cc->v);
   cc->tostore++;
+  if (cc->isconst && constfieldval(ls->fs, &cc->v, &v))
+    addconstfield(ls, &nilfield, &v);
+  else
+    cc->isconst = 0;
 }
 
 
@@ -972,6 +1112,9 @@ static void constructor (LexState *ls, expdesc *t) {
   ConsControl cc;
   luaK_code(fs, 0);  /* space for extra arg. */
   cc.na = cc.nh = cc.tostore = 0;
+  cc.firstcf = ls->dyd->cfield.n;
+  cc.nk = fs->nk;
+  cc.isconst = 1;
   cc.t = t;
   init_exp(t, VNONRELOC, fs->freereg);  /* table will be at stack top */
   luaK_reserveregs(fs, 1);
@@ -985,7 +1128,11 @@ static void constructor (LexState *ls, expdesc *t) {
   } while (testnext(ls, ',') || testnext(ls, ';'));
   check_match(ls, '}', '{', line);
   lastlistfield(fs, &cc);
-  luaK_settablesize(fs, pc, t->u.info, cc.na, cc.nh);
+  if (cc.isconst && ls->dyd->cfield.n > cc.firstcf)  /* constant, not empty? */
+    codetemplate(ls, &cc, pc);
+  else
+    luaK_settablesize(fs, pc, t->u.info, cc.na, cc.nh);
+  ls->dyd->cfield.n = cc.firstcf;  /* remove its fields */
 }
 
 /* }====================================================================== */
@@ -1176,6 +1323,226 @@ static void funcargs (LexState *ls, expdesc *f, int line) {
 }
 
 
+/*
+** {======================================================================
+** Inline expansion
+** (With optimizations on, a call 'f(args)' to a <const> local variable
+** 'f' that holds a small function whose body is a single expression is
+** replaced by the code of that expression.)
+** =======================================================================
+*/
+
+
+/*
+** Return the absolute index in 'actvar.arr' of the active variable that
+** name 'n' denotes in function 'fs', or -1 if it denotes a global.
+*/
+static int varindex (FuncState *fs, TString *n) {
+  for (; fs != NULL; fs = fs->prev) {
+    int i;
+    for (i = cast_int(fs->nactvar) - 1; i >= 0; i--) {
+      if (eqstr(n, getlocalvardesc(fs, i)->vd.name))
+        return fs->firstlocal + i;
+    }
+  }
+  return -1;  /* global name */
+}
+
+
+/*
+** Start recording the tokens of the function being assigned to a
+** <const> local variable. Return where they start in 'dyd->tok' (or -1
+** when the expression does not start a function).
+*/
+static int startinline (LexState *ls) {
+  if (!ls->dyd->optimize || ls->record >= 0)
+    return -1;  /* no optimizations, or already recording */
+#if defined(LUAGLM_EXT_LAMBDA)
+  if (ls->t.token != TK_FUNCTION && ls->t.token != '|')
+#else
+  if (ls->t.token != TK_FUNCTION)
+#endif
+    return -1;
+  ls->record = MAXINLINE + 1;  /* reaches 0 only after MAXINLINE tokens */
+  return ls->dyd->tok.n;
+}
+
+
+static void newinlinename (LexState *ls, TString *name, int var) {
+  Dyndata *dyd = ls->dyd;
+  luaM_growvector(ls->L, dyd->inlname.arr, dyd->inlname.n + 1,
+                  dyd->inlname.size, Inlinename, MAX_INT, "inlined names");
+  dyd->inlname.arr[dyd->inlname.n].name = name;
+  dyd->inlname.arr[dyd->inlname.n++].var = var;
+}
+
+
+/*
+** Add name 'n' from the body of an inlinable function to its list of
+** names (parameters first), unless it is already there. Return whether
+** it is a global name.
+*/
+static int addinlinename (LexState *ls, int first, TString *n) {
+  Dyndata *dyd = ls->dyd;
+  int i, var;
+  for (i = first; i < dyd->inlname.n; i++) {
+    if (eqstr(n, dyd->inlname.arr[i].name))
+      return 0;  /* already listed */
+  }
+  var = varindex(ls->fs, n);
+  newinlinename(ls, n, var);
+  return (var < 0);
+}
+
+
+/*
+** Finish recording the function assigned to a <const> local variable,
+** whose tokens start at 'first' in 'dyd->tok', and check whether it can
+** be expanded inline: the expression list 'e' ('nexps' expressions) must
+** be only a closure (see 'codeclosure'), of a function without nested
+** functions nor varargs, whose body is '| parlist | expr' or 'function
+** (parlist) return expr end' with a single-valued 'expr'. Keep the
+** tokens of 'expr', its parameters, and the variables that its other
+** names denote here. Return the index of the new entry in 'dyd->inl',
+** or -1.
+*/
+static int newinline (LexState *ls, int first, int nexps, expdesc *e) {
+  FuncState *fs = ls->fs;
+  Dyndata *dyd = ls->dyd;
+  Token *tok = dyd->tok.arr + first;
+  int ntok = dyd->tok.n - first;
+  int name = dyd->inlname.n;
+  Instruction last = fs->f->code[fs->pc - 1];  /* 'codeclosure' code */
+  int i, nparams, global;
+  Proto *p;
+  int full = (ls->record == 0);  /* more than MAXINLINE tokens? */
+  ls->record = -1;  /* stop recording */
+  if (full || nexps != 1 || e->k != VNONRELOC || e->t != e->f ||
+      GET_OPCODE(last) != OP_CLOSURE || GETARG_A(last) != e->u.info ||
+      dyd->inl.n >= USHRT_MAX)
+    goto reject;  /* too long, or not only a function */
+  p = fs->f->p[GETARG_Bx(last)];
+  if (p->sizep > 0 || p->is_vararg)
+    goto reject;
+  i = (tok[0].token == TK_FUNCTION) ? 2 : 1;  /* skip 'function (' or '|' */
+  for (nparams = 0; tok[i].token == TK_NAME; nparams++) {  /* parameters */
+    newinlinename(ls, tok[i++].seminfo.ts, -1);
+    if (tok[i].token == ',') i++;
+  }
+  lua_assert(nparams == p->numparams);
+  i++;  /* skip ')' or '|' */
+  if (tok[0].token == TK_FUNCTION) {  /* 'return expr [;] end'? */
+    /* position of its OP_RETURN1 (the optimizer removes the final return) */
+    int ret = p->sizecode - (dyd->optimize ? 1 : 2);
+    if (tok[i].token != TK_RETURN || ret < 0 ||
+        GET_OPCODE(p->code[ret]) != OP_RETURN1)
+      goto reject;
+    i++;  /* skip 'return' */
+    ntok--;  /* skip 'end' */
+    if (tok[ntok - 1].token == ';') ntok--;
+  }
+  global = 0;
+  for (ntok -= i, tok += i, i = 0; i < ntok; i++) {  /* names in 'expr' */
+    if (tok[i].token == TK_NAME &&  /* not a field name? */
+        (i == 0 || (tok[i - 1].token != '.' && tok[i - 1].token != ':')))
+      global |= addinlinename(ls, name, tok[i].seminfo.ts);
+  }
+  if (global)  /* globals must be in the same environment */
+    addinlinename(ls, name, ls->envn);
+  memmove(dyd->tok.arr + first, tok, ntok * sizeof(Token));
+  dyd->tok.n = first + ntok;
+  luaM_growvector(ls->L, dyd->inl.arr, dyd->inl.n + 1, dyd->inl.size,
+                  Inlinedesc, USHRT_MAX, "inlinable functions");
+  dyd->inl.arr[dyd->inl.n].tok = first;
+  dyd->inl.arr[dyd->inl.n].ntok = ntok;
+  dyd->inl.arr[dyd->inl.n].name = name;
+  dyd->inl.arr[dyd->inl.n].nparams = cast_byte(nparams);
+  dyd->inl.arr[dyd->inl.n].nnames = cast_byte(dyd->inlname.n - name);
+  return dyd->inl.n++;
+ reject:
+  dyd->tok.n = first;
+  dyd->inlname.n = name;
+  return -1;
+}
+
+
+/*
+** Expand inline a call to 'name', whose value was put in 'v', when it
+** is an inlinable function and the names in its body still denote the
+** same variables here. The arguments, adjusted to the number of
+** parameters, go to consecutive registers, which then act as the
+** parameters of the body while the lexer replays its tokens. (These
+** registers are not local variables, so that they can be above
+** temporaries of the enclosing expression; 'inlinetop' keeps them from
+** being freed.) The code of the body has the line of the call. Return
+** 0, without doing anything, when the call cannot be expanded.
+*/
+static int inlinecall (LexState *ls, expdesc *v, TString *name, int line) {
+  FuncState *fs = ls->fs;
+  Dyndata *dyd = ls->dyd;
+  Inlinecall ic;
+  Inlinedesc *d;
+  Token next;
+  expdesc args, e;
+  int i, var, nargs, oldtop, oldline, oldreplay, oldreplayend;
+  if (!dyd->optimize || searchinlineparam(ls, name) >= 0 ||
+      (var = varindex(fs, name)) < 0 || dyd->actvar.arr[var].vd.inl == 0)
+    return 0;  /* not a call to an inlinable function */
+  ic.desc = dyd->actvar.arr[var].vd.inl - 1;
+  ic.depth = (ls->inl != NULL) ? ls->inl->depth + 1 : 1;
+  if (ic.depth > MAXINLINEDEPTH)
+    return 0;
+  d = &dyd->inl.arr[ic.desc];
+  for (i = d->nparams; i < d->nnames; i++) {  /* check its other names */
+    Inlinename *n = &dyd->inlname.arr[d->name + i];
+    if (varindex(fs, n->name) != n->var)
+      return 0;  /* name is shadowed here */
+  }
+  lua_assert(ls->lookahead.token == TK_EOS);
+  ic.base = fs->freereg;
+  luaX_next(ls);  /* skip '(' */
+  if (ls->t.token == ')') {  /* arg list is empty? */
+    args.k = VVOID;
+    nargs = 0;
+  }
+  else
+    nargs = explist(ls, &args);
+  check_match(ls, ')', '(', line);
+  d = &dyd->inl.arr[ic.desc];  /* arguments may have reallocated 'inl' */
+  adjust_assign(ls, d->nparams, nargs, &args);
+  lua_assert(fs->freereg == ic.base + d->nparams);
+  next = ls->t;  /* save token after the call */
+  oldline = ls->linenumber;
+  oldreplay = ls->replay;
+  oldreplayend = ls->replayend;
+  oldtop = fs->inlinetop;
+  ic.previous = ls->inl;
+  ls->inl = &ic;
+  fs->inlinetop = fs->freereg;  /* protect parameters */
+  ls->linenumber = line;
+  ls->replay = d->tok;
+  ls->replayend = d->tok + d->ntok;
+  luaX_next(ls);  /* read first token of the body */
+  expr(ls, &e);
+  lua_assert(ls->t.token == TK_EOS);  /* body is a single expression */
+  init_exp(v, VLOCAL, 0);
+  v->u.var.ridx = cast_byte(ic.base);
+  luaK_storevar(fs, v, &e);  /* result goes to the first register */
+  ls->inl = ic.previous;
+  fs->inlinetop = oldtop;
+  ls->replay = oldreplay;
+  ls->replayend = oldreplayend;
+  ls->linenumber = oldline;
+  ls->t = next;
+  fs->freereg = ic.base;  /* remove parameters... */
+  luaK_reserveregs(fs, 1);  /* ...and leave one result */
+  init_exp(v, VNONRELOC, ic.base);
+  return 1;
+}
+
+/* }====================================================================== */
+
+
 
 
 /*
@@ -1257,11 +1624,17 @@ static void safe_navigation (LexState *ls, expdesc *v) {
 }
 #endif
 
-static void suffixedexp (LexState *ls, expdesc *v) {
+/*
+** Return whether the last suffix was a call expanded inline (see
+** 'inlinecall').
+*/
+static int suffixedexp (LexState *ls, expdesc *v) {
   /* suffixedexp ->
        primaryexp { '.' NAME | '[' exp ']' | ':' NAME funcargs | funcargs } */
   FuncState *fs = ls->fs;
   int line = ls->linenumber;
+  TString *name = (ls->t.token == TK_NAME) ? ls->t.seminfo.ts : NULL;
+  int inlined = 0;
   primaryexp(ls, v);
   for (;;) {
     switch (ls->t.token) {
@@ -1296,12 +1669,20 @@ static void suffixedexp (LexState *ls, expdesc *v) {
       case '(':
       case TK_STRING:
       case '{': {  /* funcargs */
+        if (ls->t.token == '(' && name != NULL &&
+            inlinecall(ls, v, name, line)) {
+          inlined = 1;
+          name = NULL;
+          continue;
+        }
         luaK_exp2nextreg(fs, v);
         funcargs(ls, v, line);
         break;
       }
-      default: return;
+      default: return inlined;
     }
+    name = NULL;  /* only calls to names can be expanded inline */
+    inlined = 0;
   }
 }
 
@@ -2078,6 +2459,7 @@ static void localstat (LexState *ls) {
   int vidx, kind;  /* index and kind of last variable */
   int nvars = 0;
   int nexps;
+  int inl = -1;  /* inlinable function (if any) */
   expdesc e;
   do {
     vidx = new_localvar(ls, str_checkname(ls));
@@ -2117,8 +2499,13 @@ static void localstat (LexState *ls) {
     return;
   }
 #endif
-  if (testnext(ls, '='))
+  if (testnext(ls, '=')) {
+    if (nvars == 1 && kind == RDKCONST)  /* may hold an inlinable function? */
+      inl = startinline(ls);
     nexps = explist(ls, &e);
+    if (inl >= 0)
+      inl = newinline(ls, inl, nexps, &e);
+  }
   else {
     e.k = VVOID;
     nexps = 0;
@@ -2134,6 +2521,7 @@ static void localstat (LexState *ls) {
   else {
     adjust_assign(ls, nvars, nexps, &e);
     adjustlocalvars(ls, nvars);
+    var->vd.inl = cast(unsigned short, inl + 1);
   }
   checktoclose(fs, toclose);
 }
@@ -2170,7 +2558,7 @@ static void exprstat (LexState *ls) {
   /* stat -> func | assignment */
   FuncState *fs = ls->fs;
   struct LHS_assign v;
-  suffixedexp(ls, &v.v);
+  int inlined = suffixedexp(ls, &v.v);
 #if defined(LUAGLM_EXT_COMPOUND)
   if (ls->t.token == '=' || ls->t.token == ',' || opeqexpr(ls->t.token)) { /* stat -> assignment ? */
 #else
@@ -2187,6 +2575,8 @@ static void exprstat (LexState *ls) {
 #endif
   else {  /* stat -> func */
     Instruction *inst;
+    if (inlined)  /* call expanded inline? */
+      return;  /* its result is just discarded */
     check_condition(ls, v.v.k == VCALL, "syntax error");
     inst = &getinstruction(fs, &v.v);
     SETARG_C(*inst, 1);  /* call statement uses no results */
@@ -2363,7 +2753,8 @@ LClosure *luaY_parser (lua_State *L, ZIO *z, Mbuffer *buff,
   luaC_objbarrier(L, funcstate.f, funcstate.f->source);
   lexstate.buff = buff;
   lexstate.dyd = dyd;
-  dyd->actvar.n = dyd->gt.n = dyd->label.n = 0;
+  dyd->actvar.n = dyd->gt.n = dyd->label.n = dyd->cfield.n = 0;
+  dyd->tok.n = dyd->inl.n = dyd->inlname.n = 0;
   luaX_setinput(L, &lexstate, z, funcstate.f->source, firstchar);
   mainfunc(&lexstate, &funcstate);
   lua_assert(!funcstate.prev && funcstate.nups == 1 && !lexstate.fs);
@@ -7,6 +7,7 @@
 #ifndef lparser_h
 #define lparser_h
 
+#include "llex.h"
 #include "llimits.h"
 #include "lobject.h"
 #include "lzio.h"
@@ -99,6 +100,7 @@ typedef union Vardesc {
     lu_byte kind;
     lu_byte ridx;  /* register holding the variable */
     short pidx;  /* index of the variable in the Proto's 'locvars' array */
+    unsigned short inl;  /* inlinable function in 'dyd->inl' + 1 (or 0) */
     TString *name;  /* variable name */
   } vd;
   TValue k;  /* constant value (if any) */
@@ -124,6 +126,40 @@ typedef struct Labellist {
 } Labellist;
 
 
+/*
+** description of a constant field in a table constructor; list items
+** have a nil key, and a pair of nils marks where the pending list
+** items are stored
+*/
+typedef struct Constfield {
+  TValue key;
+  TValue val;
+} Constfield;
+
+
+/*
+** description of a function whose calls can be expanded inline: its
+** body is the expression made by tokens 'tok' to 'tok + ntok - 1' (in
+** 'dyd->tok'), its parameters are the first 'nparams' names from
+** 'name' (in 'dyd->inlname'), and its other 'nnames - nparams' names
+** must resolve to the same variables where it is called
+*/
+typedef struct Inlinedesc {
+  int tok;
+  int ntok;
+  int name;
+  lu_byte nparams;
+  lu_byte nnames;
+} Inlinedesc;
+
+
+/* name used by an inlinable function */
+typedef struct Inlinename {
+  TString *name;
+  int var;  /* absolute index of its variable in 'actvar.arr' (-1 if none) */
+} Inlinename;
+
+
 /* dynamic structures used by the parser */
 typedef struct Dyndata {
   struct {  /* list of all active local variables */
@@ -133,6 +169,31 @@ typedef struct Dyndata {
   } actvar;
   Labellist gt;  /* list of pending gotos */
   Labellist label;   /* list of active labels */
+  struct {  /* list of constant fields of active constructors */
+    Constfield *arr;
+    int n;
+    int size;
+  } cfield;
+  struct {  /* tokens of the bodies of inlinable functions */
+    Token *arr;
+    int n;
+    int size;
+  } tok;
+  struct {  /* list of inlinable functions */
+    Inlinedesc *arr;
+    int n;
+    int size;
+  } inl;
+  struct {  /* names used by inlinable functions */
+    Inlinename *arr;
+    int n;
+    int size;
+  } inlname;
+  struct {  /* scratch space of the optimizer (see 'lcode.c') */
+    int *arr;
+    int size;
+  } pcs;
+  lu_byte optimize;  /* optimize the code? ('O' in the load mode) */
 } Dyndata;
 
 
@@ -158,6 +219,7 @@ typedef struct FuncState {
   lu_byte nactvar;  /* number of active local variables */
   lu_byte nups;  /* number of upvalues */
   lu_byte freereg;  /* first free register */
+  lu_byte inlinetop;  /* registers used by inlined calls (see 'inlinecall') */
   lu_byte iwthabs;  /* instructions issued since last absolute line info */
   lu_byte needclose;  /* function needs to close upvalues when returning */
 } FuncState;
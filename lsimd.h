@@ -0,0 +1,50 @@
+/*
+** $Id: lsimd.h $
+** SIMD support shared by the lexer, the string library, and tables
+** See Copyright Notice in lua.h
+*/
+
+#ifndef lsimd_h
+#define lsimd_h
+
+
+/*
+** Use SSE2 (part of every x86-64 CPU, so no run-time detection is
+** needed) to scan sixteen bytes at a time. Define LUA_NOSIMD to
+** disable it.
+*/
+#if !defined(LUA_NOSIMD) && !defined(LUA_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUA_SIMD
+#endif
+#endif
+
+#if defined(LUA_SIMD)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+
+/* index of the lowest set bit of a non-zero mask */
+#if defined(_MSC_VER) && !defined(__clang__)
+static int l_ctz (unsigned int x) {
+  unsigned long i;
+  _BitScanForward(&i, x);
+  return (int)i;
+}
+#elif defined(__GNUC__)
+#define l_ctz(x)	__builtin_ctz(x)
+#else
+static int l_ctz (unsigned int x) {
+  int i = 0;
+  for (; !(x & 1u); x >>= 1) i++;
+  return i;
+}
+#endif
+
+
+#endif
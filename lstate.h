@@ -268,6 +268,9 @@ typedef struct global_State {
   lu_byte gcpause;  /* size of pause between successive GCs */
   lu_byte gcstepmul;  /* GC "speed" */
   lu_byte gcstepsize;  /* (log2 of) GC granularity */
+#if defined(LUA_USE_JIT)
+  lu_byte jiton;  /* JIT compiler on for functions in default mode */
+#endif
   GCObject *allgc;  /* list of all collectable objects */
   GCObject **sweepgc;  /* current position of sweep in list */
   GCObject *finobj;  /* list of collectable objects with finalizers */
@@ -293,6 +296,10 @@ typedef struct global_State {
   TString *tmname[TM_N];  /* array with tag-method names */
   struct Table *mt[LUA_NUMTAGS];  /* metatables for basic types */
   TString *strcache[STRCACHE_N][STRCACHE_M];  /* cache for strings in API */
+  struct IndexChain *chaincache;  /* cache of '__index' chains (see 'ltm.c') */
+  unsigned int chainepoch;  /* current version of 'chaincache' */
+  lua_CFunction iternext;  /* 'next' (see 'lua_setiterators') */
+  lua_CFunction iterinext;  /* iteration function of 'ipairs' */
   lua_WarnFunction warnf;  /* warning function */
   void *ud_warn;         /* auxiliary data to 'warnf' */
 } global_State;
@@ -33,11 +33,7 @@
 */
 int luaS_eqlngstr (TString *a, TString *b) {
   size_t len = a->u.lnglen;
-#if defined(LUAGLM_EXT_BLOB)
   lua_assert(islongstring(a->tt) && islongstring(b->tt));
-#else
-  lua_assert(a->tt == LUA_VLNGSTR && b->tt == LUA_VLNGSTR);
-#endif
   return (a == b) ||  /* same instance or... */
     ((len == b->u.lnglen) &&  /* equal length and ... */
      (memcmp(getstr(a), getstr(b), len) == 0));  /* equal contents */
@@ -53,11 +49,7 @@ unsigned int luaS_hash (const char *str, size_t l, unsigned int seed) {
 
 
 unsigned int luaS_hashlongstr (TString *ts) {
-#if defined(LUAGLM_EXT_BLOB)
   lua_assert(islongstring(ts->tt));
-#else
-  lua_assert(ts->tt == LUA_VLNGSTR);
-#endif
   if (ts->extra == 0) {  /* no hash? */
     size_t len = ts->u.lnglen;
 #if defined(LUAGLM_EXT_BLOB)
@@ -270,6 +262,88 @@ TString *luaS_asblob (lua_State *L, TString *str) {
 }
 #endif
 
+#if defined(LUAGLM_EXT_SLICE)
+TString *luaS_newslice (lua_State *L, TString *str, size_t i, size_t l) {
+  lua_assert(i + l <= tsslen(str));
+  if (l <= LUAI_MAXSHORTLEN)  /* short strings are always internalized */
+    return luaS_newlstr(L, getstr(str) + i, l);
+#if defined(LUAGLM_EXT_BLOB)
+  else if (str->tt == LUA_VBLOBSTR)  /* blobs are mutable: copy range */
+    return luaS_newlstr(L, getstr(str) + i, l);
+#endif
+  else if (i == 0 && l == str->u.lnglen)
+    return str;  /* the whole string */
+  else {
+    GCObject *o = luaC_newobj(L, LUA_VSLCSTR, sizeslice);
+    TString *ts = gco2ts(o);
+    ts->hash = G(L)->seed;
+    ts->extra = 0;
+    ts->u.lnglen = l;
+    getslice(ts)->data = getstr(str) + i;
+    /* a slice of a slice refers to the original parent */
+    getslice(ts)->parent = (str->tt == LUA_VSLCSTR) ? getslice(str)->parent
+                                                    : str;
+    return ts;
+  }
+}
+
+
+TString *luaS_fromslice (lua_State *L, TString *ts) {
+  size_t l = ts->u.lnglen;
+  TString *str;
+  lua_assert(ts->tt == LUA_VSLCSTR);
+  str = luaS_createlngstrobj(L, l);
+  memcpy(getstr(str), getstr(ts), l * sizeof(char));
+  if (ts->extra) {  /* slice already has its hash? */
+    str->hash = ts->hash;
+    str->extra = 1;
+  }
+  return str;
+}
+#endif
+
+#if defined(LUAGLM_EXT_BUILDER)
+/*
+** A string buffer is the contents of a long string object that is not
+** (yet) linked into the collector: 'buff' points to where the contents of
+** that object start.
+*/
+#define buff2block(buff)	((buff) - offsetof(TString, contents))
+
+char *luaS_resizebuff (lua_State *L, char *buff, size_t osz, size_t nsz) {
+  char *block = (buff == NULL) ? NULL : buff2block(buff);
+  size_t oblock = (buff == NULL) ? 0 : sizelstring(osz);
+  if (nsz == 0) {  /* free the buffer */
+    if (block != NULL)
+      luaM_freemem(L, block, oblock);
+    return NULL;
+  }
+  block = luaM_reallocvchar(L, block, oblock, sizelstring(nsz));
+  return block + offsetof(TString, contents);
+}
+
+
+TString *luaS_frombuff (lua_State *L, char *buff, size_t sz, size_t l) {
+  TString *ts;
+  lua_assert(buff != NULL && l <= sz);
+  if (l <= LUAI_MAXSHORTLEN) {  /* short strings are always internalized */
+    ts = internshrstr(L, buff, l);
+    luaS_resizebuff(L, buff, sz, 0);
+  }
+  else {  /* trim the buffer and turn it into the string object */
+    GCObject *o;
+    buff = luaS_resizebuff(L, buff, sz, l);
+    o = luaC_linkobj(L, buff2block(buff), LUA_VLNGSTR);
+    ts = gco2ts(o);
+    ts->hash = G(L)->seed;
+    ts->extra = 0;
+    ts->u.lnglen = l;
+    getstr(ts)[l] = '\0';  /* ending 0 */
+  }
+  return ts;
+}
+#endif
+
 /*
 ** Create or reuse a zero-terminated string, first checking in the
 ** cache (using the string address as a key). The cache can contain
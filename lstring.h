@@ -68,4 +68,41 @@ LUAI_FUNC TString *luaS_newblob (lua_State *L, size_t l);
 LUAI_FUNC TString *luaS_asblob (lua_State *L, TString *str);
 #endif
 
+#if defined(LUAGLM_EXT_SLICE)
+/*
+** Size of a string slice: the header plus a reference to its contents.
+*/
+#define sizeslice	(offsetof(TString, contents) + sizeof(TSliceRef))
+
+/*
+** Create a string with the 'l' characters of 'str' starting at offset
+** 'i'. Long results reference the contents of 'str' (or of its parent,
+** when 'str' is itself a slice) instead of copying them.
+*/
+LUAI_FUNC TString *luaS_newslice (lua_State *L, TString *str, size_t i,
+                                                              size_t l);
+
+/*
+** Create a (zero-terminated) long string with the contents of a slice.
+*/
+LUAI_FUNC TString *luaS_fromslice (lua_State *L, TString *ts);
+#endif
+
+#if defined(LUAGLM_EXT_BUILDER)
+/*
+** Resize (or create, when 'buff' is NULL, or free, when 'nsz' is zero) a
+** string buffer: a block of 'nsz' characters that can later become the
+** contents of a long string without being copied.
+*/
+LUAI_FUNC char *luaS_resizebuff (lua_State *L, char *buff, size_t osz,
+                                                           size_t nsz);
+
+/*
+** Create a string with the first 'l' characters of the string buffer
+** 'buff' of size 'sz', which is consumed.
+*/
+LUAI_FUNC TString *luaS_frombuff (lua_State *L, char *buff, size_t sz,
+                                                            size_t l);
+#endif
+
 #endif
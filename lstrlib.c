@@ -24,6 +24,8 @@
 
 #include "lauxlib.h"
 #include "lualib.h"
+#include "lgrit_lib.h"
+#include "lsimd.h"
 
 
 /*
@@ -50,6 +52,18 @@
 	(sizeof(size_t) < sizeof(int) ? MAX_SIZET : (size_t)(INT_MAX))
 
 
+/*
+** Push the 'l' characters starting at 's' of the string at index 'arg',
+** whose contents start at 'b'. With string slices, long substrings are
+** not copied.
+*/
+#if defined(LUAGLM_EXT_SLICE)
+#define pushsubstr(L,arg,b,s,l)	lua_pushslice(L, arg, (size_t)((s) - (b)), l)
+#else
+#define pushsubstr(L,arg,b,s,l)	((void)(b), lua_pushlstring(L, s, l))
+#endif
+
+
 
 
 static int str_len (lua_State *L) {
@@ -103,7 +117,7 @@ static int str_sub (lua_State *L) {
   size_t start = posrelatI(luaL_checkinteger(L, 2), l);
   size_t end = getendpos(L, 3, -1, l);
   if (start <= end)
-    lua_pushlstring(L, s + start - 1, (end - start) + 1);
+    pushsubstr(L, 1, s, s + start - 1, (end - start) + 1);
   else lua_pushliteral(L, "");
   return 1;
 }
@@ -193,38 +207,29 @@ static int str_trim (lua_State *L) {
 static int str_split (lua_State *L) {
   const char *delimiter = luaL_checkstring(L, 1);
   const char *str = luaL_checkstring(L, 2);
+  const char *base = str;
   int limit = luaL_optint(L, 3, 0);
   int count = 0;
 
-  lua_settop(L, 0); /* clear new slots */
+  lua_settop(L, 2); /* clear new slots; keep strings alive */
   if (limit == 0 || limit > 1) {
     const char *end;
-    for (end = str; *end; ++end) {
-      const char *s;
-      int split = 0;
-      for (s = delimiter; *s; ++s) {
-        if (*s == *end) {
-          split = 1;
-          break;
-        }
-      }
-
-      if (split) {
-        luaL_checkstack(L, count + 1, "too many results");
-        lua_pushlstring(L, str, (end - str));
-
-        ++count;
-        str = end + 1;
-        if (count == (limit - 1)) {
-          break;
-        }
+    /* 'strcspn' skips to the next character of the delimiter set */
+    for (end = str + strcspn(str, delimiter); *end; end += strcspn(end, delimiter)) {
+      luaL_checkstack(L, count + 1, "too many results");
+      pushsubstr(L, 2, base, str, (end - str));
+
+      ++count;
+      str = ++end;
+      if (count == (limit - 1)) {
+        break;
       }
     }
   }
 
   /* Trailing characters */
   luaL_checkstack(L, count + 1, "too many results");
-  lua_pushstring(L, str);
+  pushsubstr(L, 2, base, str, strlen(str));
   return count + 1;
 }
 
@@ -487,6 +492,7 @@ typedef struct MatchState {
   const char *src_end;  /* end ('\0') of source string */
   const char *p_end;  /* end ('\0') of pattern */
   lua_State *L;
+  int srcarg;  /* stack index of the source string */
   int matchdepth;  /* control for recursive depth (to avoid C stack overflow) */
   unsigned char level;  /* total number of captures (finished or unfinished) */
   struct {
@@ -527,19 +533,23 @@ static int capture_to_close (MatchState *ms) {
 }
 
 
-static const char *classend (MatchState *ms, const char *p) {
+/*
+** Return the end of the single-char class at 'p', or NULL if the class
+** is malformed.
+*/
+static const char *findclassend (const char *p, const char *p_end) {
   switch (*p++) {
     case L_ESC: {
-      if (l_unlikely(p == ms->p_end))
-        luaL_error(ms->L, "malformed pattern (ends with '%%')");
+      if (l_unlikely(p == p_end))
+        return NULL;
       return p+1;
     }
     case '[': {
       if (*p == '^') p++;
       do {  /* look for a ']' */
-        if (l_unlikely(p == ms->p_end))
-          luaL_error(ms->L, "malformed pattern (missing ']')");
-        if (*(p++) == L_ESC && p < ms->p_end)
+        if (l_unlikely(p == p_end))
+          return NULL;
+        if (*(p++) == L_ESC && p < p_end)
           p++;  /* skip escapes (e.g. '%]') */
       } while (*p != ']');
       return p+1;
@@ -551,6 +561,18 @@ static const char *classend (MatchState *ms, const char *p) {
 }
 
 
+static const char *classend (MatchState *ms, const char *p) {
+  const char *ep = findclassend(p, ms->p_end);
+  if (l_unlikely(ep == NULL)) {
+    if (*p == L_ESC)
+      luaL_error(ms->L, "malformed pattern (ends with '%%')");
+    else
+      luaL_error(ms->L, "malformed pattern (missing ']')");
+  }
+  return ep;
+}
+
+
 static int match_class (int c, int cl) {
   int res;
   switch (tolower(cl)) {
@@ -797,17 +819,60 @@ static const char *match (MatchState *ms, const char *s, const char *p) {
 
 
 
+#if defined(LUA_SIMD)
+
+/*
+** Search 's2' (with 'l2 >= 2') inside 's1' (with 'l1 >= l2') sixteen
+** positions at a time: a position is only compared with 'memcmp' when
+** both its first and its last characters match those of 's2', which
+** keeps repetitive subjects from degrading into a 'memcmp' per byte.
+*/
+static const char *simdmemfind (const char *s1, size_t l1,
+                                  const char *s2, size_t l2) {
+  const __m128i first = _mm_set1_epi8(s2[0]);
+  const __m128i last = _mm_set1_epi8(s2[l2 - 1]);
+  size_t n = l1 - l2 + 1;  /* number of possible positions */
+  size_t i = 0;
+  for (; n - i >= 16; i += 16) {
+    const __m128i bf = _mm_loadu_si128((const __m128i *)(s1 + i));
+    const __m128i bl = _mm_loadu_si128((const __m128i *)(s1 + i + l2 - 1));
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(
+      _mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl)));
+    while (mask != 0) {
+      const char *init = s1 + i + l_ctz(mask);
+      if (memcmp(init + 1, s2 + 1, l2 - 2) == 0)
+        return init;
+      mask &= mask - 1;  /* clear lowest bit */
+    }
+  }
+  for (; i < n; i++) {  /* remaining positions */
+    if (s1[i] == s2[0] && s1[i + l2 - 1] == s2[l2 - 1] &&
+        memcmp(s1 + i + 1, s2 + 1, l2 - 2) == 0)
+      return s1 + i;
+  }
+  return NULL;  /* not found */
+}
+
+#endif
+
+
 static const char *lmemfind (const char *s1, size_t l1,
                                const char *s2, size_t l2) {
   if (l2 == 0) return s1;  /* empty strings are everywhere */
   else if (l2 > l1) return NULL;  /* avoids a negative 'l1' */
+  else if (l2 == 1) return (const char *)memchr(s1, *s2, l1);
+#if defined(LUA_SIMD)
+  else return simdmemfind(s1, l1, s2, l2);
+#else
   else {
     const char *init;  /* to search for a '*s2' inside 's1' */
+    const char s2last = s2[l2 - 1];
     l2--;  /* 1st char will be checked by 'memchr' */
     l1 = l1-l2;  /* 's2' cannot be found after that */
     while (l1 > 0 && (init = (const char *)memchr(s1, *s2, l1)) != NULL) {
       init++;   /* 1st char is already checked */
-      if (memcmp(init, s2+1, l2) == 0)
+      /* check last char before comparing everything */
+      if (init[l2 - 1] == s2last && memcmp(init, s2+1, l2) == 0)
         return init-1;
       else {  /* correct 'l1' and 's1' to try again */
         l1 -= init-s1;
@@ -816,6 +881,7 @@ static const char *lmemfind (const char *s1, size_t l1,
     }
     return NULL;  /* not found */
   }
+#endif
 }
 
 
@@ -854,7 +920,7 @@ static void push_onecapture (MatchState *ms, int i, const char *s,
   const char *cap;
   ptrdiff_t l = get_onecapture(ms, i, s, e, &cap);
   if (l != CAP_POSITION)
-    lua_pushlstring(ms->L, cap, l);
+    pushsubstr(ms->L, ms->srcarg, ms->src_init, cap, l);
   /* else position was already pushed */
 }
 
@@ -884,6 +950,7 @@ static int nospecials (const char *p, size_t l) {
 static void prepstate (MatchState *ms, lua_State *L,
                        const char *s, size_t ls, const char *p, size_t lp) {
   ms->L = L;
+  ms->srcarg = 1;
   ms->matchdepth = MAXCCALLS;
   ms->src_init = s;
   ms->src_end = s + ls;
@@ -897,35 +964,274 @@ static void reprepstate (MatchState *ms) {
 }
 
 
+/*
+** {======================================================
+** PATTERN CACHE
+** =======================================================
+*/
+
+/*
+** A compiled pattern summarizes what a match must start with, so the
+** searching loops can skip positions where 'match' cannot succeed.
+** Matching itself is still done by 'match', hence semantics and limits
+** (e.g., MAXCCALLS) are unchanged: a skipped position is one where
+** 'match' would fail on the leading (literal or single-char class)
+** items of the pattern, before reaching anything that could raise an
+** error or go deeper than the opening captures.
+*/
+
+/* maximum length of the literal prefix of a compiled pattern */
+#if !defined(LUA_PATTERNPREFIX)
+#define LUA_PATTERNPREFIX	32
+#endif
+
+/* number of compiled patterns cached by the string library */
+#if !defined(LUA_PATTERNCACHE)
+#define LUA_PATTERNCACHE	16
+#endif
+
+/* kinds of start filters */
+#define PF_NONE		0	/* a match may start anywhere */
+#define PF_PREFIX	1	/* a match starts with 'prefix' */
+#define PF_SET		2	/* a match starts with a character in 'set' */
+
+#define PF_SETSIZE	((UCHAR_MAX / CHAR_BIT) + 1)
+#define pf_testbit(set,c)	((set)[uchar(c) / CHAR_BIT] & (1u << (uchar(c) % CHAR_BIT)))
+
+
+typedef struct PatternInfo {
+  unsigned char filter;  /* kind of start filter */
+  unsigned char anchor;  /* pattern starts with '^' */
+  unsigned char plain;  /* pattern has no special characters */
+  unsigned char literal;  /* 'match' also sees only literal characters */
+  size_t lprefix;  /* length of 'prefix' */
+  char prefix[LUA_PATTERNPREFIX];
+  unsigned char set[PF_SETSIZE];  /* possible first characters */
+} PatternInfo;
+
+
+/*
+** Keys are kept apart from the compiled patterns so a lookup only
+** touches a couple of cache lines.
+*/
+typedef struct PatternCache {
+  const char *p[LUA_PATTERNCACHE];  /* patterns (kept alive as user values) */
+  size_t lp[LUA_PATTERNCACHE];  /* pattern lengths */
+  unsigned int stamp[LUA_PATTERNCACHE];  /* last access of each entry */
+  unsigned int clock;  /* stamp of the most recent access */
+  PatternInfo pi[LUA_PATTERNCACHE];  /* compiled patterns */
+} PatternCache;
+
+
+/* check whether an item is optional, i.e., followed by '*', '?' or '-' */
+static int optitem (const char *ep, const char *p_end) {
+  return (ep < p_end && (*ep == '*' || *ep == '?' || *ep == '-'));
+}
+
+
+/*
+** Compile the start filter of pattern 'p' (already without a '^'
+** anchor). This never raises errors: anything unusual, including
+** malformed patterns, just leaves the pattern without a filter so
+** 'match' reports it as usual.
+*/
+static void compilefilter (PatternInfo *pi, const char *p, size_t lp) {
+  MatchState ms;
+  const char *p_end = p + lp;
+  const char *ep;
+  char c;
+  int level = 0;
+  pi->filter = PF_NONE;
+  pi->lprefix = 0;
+  prepstate(&ms, NULL, &c, 1, p, lp);
+  while (p < p_end && *p == '(') {  /* captures do not consume characters */
+    if (++level > LUA_MAXCAPTURES)
+      return;  /* let 'match' raise the error */
+    if (++p < p_end && *p == ')')
+      p++;  /* position capture */
+  }
+  /* collect literal prefix */
+  while (p < p_end && pi->lprefix < LUA_PATTERNPREFIX) {
+    if (*p == L_ESC) {
+      if (p + 1 == p_end || isalnum(uchar(*(p + 1))))
+        break;  /* class, '%b', '%f', back reference, or malformed */
+      c = *(p + 1);
+      ep = p + 2;
+    }
+    else if (*p == ')' || *p == '\0' || strchr(SPECIALS, *p) != NULL)
+      break;
+    else {
+      c = *p;
+      ep = p + 1;
+    }
+    if (optitem(ep, p_end))
+      break;
+    pi->prefix[pi->lprefix++] = c;
+    if (ep < p_end && *ep == '+')
+      break;  /* the remaining repetitions are not fixed */
+    p = ep;
+  }
+  if (pi->lprefix > 0) {
+    pi->filter = PF_PREFIX;
+    return;
+  }
+  /* else try a set with the possible first characters */
+  if (p == p_end || *p == ')' || *p == '.' || (*p == '$' && p + 1 == p_end))
+    return;
+  else if (*p == L_ESC && p + 1 < p_end && *(p + 1) == 'b') {
+    if (p + 3 < p_end) {  /* well formed? */
+      pi->prefix[pi->lprefix++] = *(p + 2);  /* opening character */
+      pi->filter = PF_PREFIX;
+    }
+    return;
+  }
+  else if (*p == L_ESC && p + 1 < p_end &&
+           (*(p + 1) == 'f' || isdigit(uchar(*(p + 1)))))
+    return;  /* frontier or back reference */
+  ep = findclassend(p, p_end);
+  if (ep != NULL && !optitem(ep, p_end)) {
+    int i, n = 0;
+    memset(pi->set, 0, sizeof(pi->set));
+    for (i = 0; i <= UCHAR_MAX; i++) {
+      c = (char)i;
+      if (singlematch(&ms, &c, p, ep)) {
+        pi->set[i / CHAR_BIT] |= (unsigned char)(1u << (i % CHAR_BIT));
+        pi->prefix[0] = c;
+        n++;
+      }
+    }
+    if (n == 1) {  /* single character: search it with 'memchr' */
+      pi->lprefix = 1;
+      pi->filter = PF_PREFIX;
+    }
+    else if (n <= UCHAR_MAX)
+      pi->filter = PF_SET;
+  }
+}
+
+
+static void compilepattern (PatternInfo *pi, const char *p, size_t lp) {
+  pi->plain = (unsigned char)nospecials(p, lp);
+  pi->literal = pi->plain && memchr(p, ')', lp) == NULL;
+  pi->anchor = (*p == '^');
+  if (pi->anchor)
+    compilefilter(pi, p + 1, lp - 1);
+  else
+    compilefilter(pi, p, lp);
+}
+
+
+/*
+** Return the compiled form of the pattern at index 2. Patterns are
+** cached by the address of their (immutable) contents, which is sound
+** as the cache keeps each pattern alive through its user values.
+** Patterns that may change (blobs) are compiled into 'aux'.
+*/
+static const PatternInfo *getpattern (lua_State *L, PatternInfo *aux) {
+  PatternCache *pc = (PatternCache *)lua_touserdata(L, lua_upvalueindex(1));
+  size_t lp;
+  const char *p = lua_tolstring(L, 2, &lp);
+  int i, lru = 0;
+#if defined(LUAGLM_EXT_BLOB)
+  if (lua_isstringblob(L, 2))
+    pc = NULL;
+#endif
+  if (pc == NULL) {
+    compilepattern(aux, p, lp);
+    return aux;
+  }
+  for (i = 0; i < LUA_PATTERNCACHE; i++) {
+    if (pc->p[i] == p && pc->lp[i] == lp) {  /* hit? */
+      pc->stamp[i] = ++pc->clock;
+      return &pc->pi[i];
+    }
+  }
+  /* miss: replace the least recently used entry */
+  for (i = 1; i < LUA_PATTERNCACHE; i++) {
+    if (pc->stamp[i] < pc->stamp[lru])
+      lru = i;
+  }
+  compilepattern(&pc->pi[lru], p, lp);
+  lua_pushvalue(L, 2);
+  lua_setiuservalue(L, lua_upvalueindex(1), lru + 1);
+  pc->p[lru] = p;
+  pc->lp[lru] = lp;
+  pc->stamp[lru] = ++pc->clock;
+  return &pc->pi[lru];
+}
+
+
+/*
+** Return the first position in 's'..'e' where a match of a pattern
+** may start, or NULL if there is none.
+*/
+static const char *nextcandidate (const PatternInfo *pi, const char *s,
+                                                         const char *e) {
+  switch (pi->filter) {
+    case PF_PREFIX:
+      return lmemfind(s, e - s, pi->prefix, pi->lprefix);
+    case PF_SET: {
+      for (; s < e; s++) {
+        if (pf_testbit(pi->set, *s))
+          return s;
+      }
+      return NULL;
+    }
+    default:
+      return s;
+  }
+}
+
+
+static void newpatterncache (lua_State *L) {
+  PatternCache *pc = (PatternCache *)lua_newuserdatauv(L,
+                                   sizeof(PatternCache), LUA_PATTERNCACHE);
+  memset(pc, 0, sizeof(PatternCache));
+}
+
+/* }====================================================== */
+
+
 static int str_find_aux (lua_State *L, int find) {
   size_t ls, lp;
   const char *s = luaL_checklstring(L, 1, &ls);
   const char *p = luaL_checklstring(L, 2, &lp);
   size_t init = posrelatI(luaL_optinteger(L, 3, 1), ls) - 1;
+  const PatternInfo *pi;
+  PatternInfo aux;
   if (init > ls) {  /* start after string's end? */
     luaL_pushfail(L);  /* cannot find anything */
     return 1;
   }
   /* explicit request or no special characters? */
-  if (find && (lua_toboolean(L, 4) || nospecials(p, lp))) {
+  pi = (find && lua_toboolean(L, 4)) ? NULL : getpattern(L, &aux);
+  if (pi == NULL || (find ? pi->plain : pi->literal)) {
     /* do a plain search */
     const char *s2 = lmemfind(s + init, ls - init, p, lp);
     if (s2) {
-      lua_pushinteger(L, (s2 - s) + 1);
-      lua_pushinteger(L, (s2 - s) + lp);
-      return 2;
+      if (find) {
+        lua_pushinteger(L, (s2 - s) + 1);
+        lua_pushinteger(L, (s2 - s) + lp);
+        return 2;
+      }
+      else {  /* the whole match is the pattern itself */
+        lua_pushlstring(L, s2, lp);
+        return 1;
+      }
     }
   }
   else {
     MatchState ms;
     const char *s1 = s + init;
-    int anchor = (*p == '^');
+    int anchor = pi->anchor;
     if (anchor) {
       p++; lp--;  /* skip anchor character */
     }
     prepstate(&ms, L, s, ls, p, lp);
     do {
       const char *res;
+      if (!anchor && (s1 = nextcandidate(pi, s1, ms.src_end)) == NULL)
+        break;  /* no more positions where a match can start */
       reprepstate(&ms);
       if ((res=match(&ms, s1, p)) != NULL) {
         if (find) {
@@ -958,7 +1264,9 @@ typedef struct GMatchState {
   const char *src;  /* current position */
   const char *p;  /* pattern */
   const char *lastmatch;  /* end of last match */
+  size_t lplain;  /* length of a plain (non-empty) pattern, or 0 */
   MatchState ms;  /* match state */
+  PatternInfo pi;  /* compiled pattern */
 } GMatchState;
 
 
@@ -966,8 +1274,19 @@ static int gmatch_aux (lua_State *L) {
   GMatchState *gm = (GMatchState *)lua_touserdata(L, lua_upvalueindex(3));
   const char *src;
   gm->ms.L = L;
+  if (gm->lplain > 0) {  /* plain pattern? */
+    if (gm->src > gm->ms.src_end ||
+       (src = lmemfind(gm->src, gm->ms.src_end - gm->src,
+                       gm->p, gm->lplain)) == NULL)
+      return 0;  /* not found */
+    reprepstate(&gm->ms);
+    gm->src = gm->lastmatch = src + gm->lplain;
+    return push_captures(&gm->ms, src, gm->src);
+  }
   for (src = gm->src; src <= gm->ms.src_end; src++) {
     const char *e;
+    if ((src = nextcandidate(&gm->pi, src, gm->ms.src_end)) == NULL)
+      break;  /* no more positions where a match can start */
     reprepstate(&gm->ms);
     if ((e = match(&gm->ms, src, gm->p)) != NULL && e != gm->lastmatch) {
       gm->src = gm->lastmatch = e;
@@ -990,6 +1309,15 @@ static int gmatch (lua_State *L) {
     init = ls + 1;  /* avoid overflows in 's + init' */
   prepstate(&gm->ms, L, s, ls, p, lp);
   gm->src = s + init; gm->p = p; gm->lastmatch = NULL;
+  gm->ms.srcarg = lua_upvalueindex(1);  /* 's' for 'gmatch_aux' */
+  compilefilter(&gm->pi, p, lp);  /* 'gmatch' has no anchor */
+  gm->lplain = (nospecials(p, lp) && memchr(p, ')', lp) == NULL) ? lp : 0;
+#if defined(LUAGLM_EXT_BLOB)
+  if (lua_isstringblob(L, 2)) {  /* pattern may change between calls? */
+    gm->pi.filter = PF_NONE;
+    gm->lplain = 0;
+  }
+#endif
   lua_pushcclosure(L, gmatch_aux, 3);
   return 1;
 }
@@ -1073,7 +1401,10 @@ static int str_gsub (lua_State *L) {
   const char *lastmatch = NULL;  /* end of last match */
   int tr = lua_type(L, 3);  /* replacement type */
   lua_Integer max_s = luaL_optinteger(L, 4, srcl + 1);  /* max replacements */
-  int anchor = (*p == '^');
+  PatternInfo aux;
+  const PatternInfo *pi = getpattern(L, &aux);  /* compiled pattern */
+  int anchor = pi->anchor;
+  int plain = pi->literal && lp > 0;  /* matches are found by 'lmemfind' */
   lua_Integer n = 0;  /* replacement count */
   int changed = 0;  /* change flag */
   MatchState ms;
@@ -1088,8 +1419,16 @@ static int str_gsub (lua_State *L) {
   prepstate(&ms, L, src, srcl, p, lp);
   while (n < max_s) {
     const char *e;
+    if (!anchor) {  /* skip positions where a match cannot start */
+      const char *s1 = (plain) ? lmemfind(src, ms.src_end - src, p, lp)
+                               : nextcandidate(pi, src, ms.src_end);
+      if (s1 == NULL) break;  /* no more matches */
+      luaL_addlstring(&b, src, s1 - src);
+      src = s1;
+    }
     reprepstate(&ms);  /* (re)prepare state for new match */
-    if ((e = match(&ms, src, p)) != NULL && e != lastmatch) {  /* match? */
+    e = (plain) ? src + lp : match(&ms, src, p);
+    if (e != NULL && e != lastmatch) {  /* match? */
       n++;
       changed = add_value(&ms, &b, src, e, tr) | changed;
       src = lastmatch = e;
@@ -1384,6 +1723,22 @@ static const char *getformat (lua_State *L, const char *strfrmt,
 }
 
 
+/*
+** Precision of a float format without flags nor width (e.g., "%g" or
+** "%.3f"), or -1 for other formats.
+*/
+static int simpleprec (const char *form) {
+  const char *p = form + 1;  /* skip '%' */
+  int prec = 6;  /* default precision */
+  if (*p == '.') {
+    prec = 0;
+    while (isdigit(uchar(*++p)))
+      prec = prec * 10 + (*p - '0');
+  }
+  return (*(p + 1) == '\0') ? prec : -1;  /* only the conversion left? */
+}
+
+
 /*
 ** add length modifier into formats
 */
@@ -1436,8 +1791,12 @@ static int str_format (lua_State *L) {
          intcase: {
           lua_Integer n = luaL_checkinteger(L, arg);
           checkformat(L, form, flags, 1);
-          addlenmod(form, LUA_INTEGER_FRMLEN);
-          nb = l_sprintf(buff, maxitem, form, (LUAI_UACINT)n);
+          if (form[2] == '\0' && (form[1] == 'd' || form[1] == 'i'))
+            nb = lua_fmtinteger(buff, maxitem, n);  /* plain '%d' */
+          else {
+            addlenmod(form, LUA_INTEGER_FRMLEN);
+            nb = l_sprintf(buff, maxitem, form, (LUAI_UACINT)n);
+          }
           break;
         }
         case 'a': case 'A':
@@ -1452,9 +1811,15 @@ static int str_format (lua_State *L) {
           /* FALLTHROUGH */
         case 'e': case 'E': case 'g': case 'G': {
           lua_Number n = luaL_checknumber(L, arg);
+          int conv = *(strfrmt - 1);
+          int prec;
           checkformat(L, form, L_FMTFLAGSF, 1);
-          addlenmod(form, LUA_NUMBER_FRMLEN);
-          nb = l_sprintf(buff, maxitem, form, (LUAI_UACNUMBER)n);
+          if ((conv == 'f' || conv == 'g') && (prec = simpleprec(form)) >= 0)
+            nb = lua_fmtnumber(buff, maxitem, conv, prec, n);
+          else {
+            addlenmod(form, LUA_NUMBER_FRMLEN);
+            nb = l_sprintf(buff, maxitem, form, (LUAI_UACNUMBER)n);
+          }
           break;
         }
         case 'p': {
@@ -2039,6 +2404,245 @@ static int str_blobunpack (lua_State *L) {
 /* }====================================================== */
 
 
+#if defined(LUAGLM_EXT_BUILDER)
+/*
+** {======================================================
+** STRING BUILDER
+** =======================================================
+*/
+
+#define LUA_BUILDERHANDLE	"StringBuilder"
+
+/* minimum size of the buffer of a builder */
+#define MINBUILDERSIZE	LUAL_BUFFERSIZE
+
+
+/*
+** A mutable string: its contents live in a string buffer (see
+** 'lua_resizebuffer'), owned by the builder until 'finish' turns it into
+** a string without copying it.
+*/
+typedef struct StrBuilder {
+  char *b;  /* buffer (NULL when nothing was allocated yet) */
+  size_t n;  /* number of characters in buffer */
+  size_t size;  /* buffer size */
+} StrBuilder;
+
+
+#define checkbuilder(L,i)  \
+	((StrBuilder *)luaL_checkudata(L, i, LUA_BUILDERHANDLE))
+
+
+/*
+** Returns a pointer to a free area with at least 'sz' bytes in the buffer
+** of builder 'sb'.
+*/
+static char *builderprep (lua_State *L, StrBuilder *sb, size_t sz) {
+  if (sb->size - sb->n < sz) {  /* not enough space? */
+    size_t newsize = sb->size * 2;  /* double buffer size */
+    if (l_unlikely(MAX_SIZET - sz < sb->n))  /* overflow in (n + sz)? */
+      luaL_error(L, "buffer too large");
+    if (newsize < sb->n + sz)  /* double is not big enough? */
+      newsize = sb->n + sz;
+    if (newsize < MINBUILDERSIZE)
+      newsize = MINBUILDERSIZE;
+    sb->b = lua_resizebuffer(L, sb->b, sb->size, newsize);
+    sb->size = newsize;
+  }
+  return sb->b + sb->n;
+}
+
+
+static void builderaddlstring (lua_State *L, StrBuilder *sb, const char *s,
+                                                             size_t l) {
+  if (l > 0) {
+    char *b = builderprep(L, sb, l);
+    memcpy(b, s, l * sizeof(char));
+    sb->n += l;
+  }
+}
+
+
+/*
+** Format a number directly into the buffer; same representation as
+** 'tostring'.
+*/
+static void builderaddnumber (lua_State *L, StrBuilder *sb, int arg) {
+  char *buff = builderprep(L, sb, MAX_ITEM);
+  int len;
+  if (lua_isinteger(L, arg))
+    len = lua_fmtinteger(buff, MAX_ITEM, lua_tointeger(L, arg));
+  else {
+    len = lua_fmtnumber(buff, MAX_ITEM, 0, 0, lua_tonumber(L, arg));
+    if (buff[strspn(buff, "-0123456789")] == '\0') {  /* looks like an int? */
+      buff[len++] = lua_getlocaledecpoint();
+      buff[len++] = '0';  /* adds '.0' to result */
+    }
+  }
+  sb->n += len;
+}
+
+
+/*
+** Format a vector or matrix directly into the buffer, growing it when the
+** space left is not enough for its representation.
+*/
+static void builderaddglm (lua_State *L, StrBuilder *sb, int arg) {
+  char *buff = builderprep(L, sb, MAX_ITEM);
+  int len = glm_tostringbuff(L, arg, buff, sb->size - sb->n);
+  if (len >= 0 && (size_t)len >= sb->size - sb->n) {  /* truncated? */
+    buff = builderprep(L, sb, (size_t)len + 1);
+    len = glm_tostringbuff(L, arg, buff, (size_t)len + 1);
+  }
+  if (len > 0)
+    sb->n += len;
+}
+
+
+static void builderadd (lua_State *L, StrBuilder *sb, int arg) {
+  switch (lua_type(L, arg)) {
+    case LUA_TSTRING: {  /* strings and blobs */
+      size_t l;
+      const char *s = lua_tolstring(L, arg, &l);
+      builderaddlstring(L, sb, s, l);
+      break;
+    }
+    case LUA_TNUMBER:
+      builderaddnumber(L, sb, arg);
+      break;
+    case LUA_TVECTOR: case LUA_TMATRIX:
+      builderaddglm(L, sb, arg);
+      break;
+    default: {
+      StrBuilder *other = (StrBuilder *)luaL_testudata(L, arg,
+                                                       LUA_BUILDERHANDLE);
+      if (other == NULL)
+        luaL_typeerror(L, arg, "string");
+      else if (other->n > 0) {  /* 'other' may be 'sb' itself */
+        size_t l = other->n;
+        char *b = builderprep(L, sb, l);
+        memcpy(b, other->b, l * sizeof(char));
+        sb->n += l;
+      }
+      break;
+    }
+  }
+}
+
+
+static void builderfree (lua_State *L, StrBuilder *sb) {
+  if (sb->b != NULL)
+    lua_resizebuffer(L, sb->b, sb->size, 0);
+  sb->b = NULL;
+  sb->n = sb->size = 0;
+}
+
+
+static int str_builder (lua_State *L) {
+  lua_Integer size = luaL_optinteger(L, 1, 0);
+  StrBuilder *sb;
+  luaL_argcheck(L, 0 <= size && (size_t)size <= MAXSIZE, 1,
+                   "invalid capacity");
+  sb = (StrBuilder *)lua_newuserdatauv(L, sizeof(StrBuilder), 0);
+  sb->b = NULL;
+  sb->n = sb->size = 0;
+  luaL_setmetatable(L, LUA_BUILDERHANDLE);
+  if (size > 0)
+    builderprep(L, sb, (size_t)size);
+  return 1;
+}
+
+
+/* builder:append(v1, v2, ...): append the values, returning the builder */
+static int builder_append (lua_State *L) {
+  StrBuilder *sb = checkbuilder(L, 1);
+  int i, top = lua_gettop(L);
+  for (i = 2; i <= top; i++)
+    builderadd(L, sb, i);
+  lua_settop(L, 1);
+  return 1;
+}
+
+
+/* builder:clear(): discard the contents, keeping the buffer */
+static int builder_clear (lua_State *L) {
+  StrBuilder *sb = checkbuilder(L, 1);
+  sb->n = 0;
+  lua_settop(L, 1);
+  return 1;
+}
+
+
+/* builder:tostring(): a copy of the contents */
+static int builder_tostring (lua_State *L) {
+  StrBuilder *sb = checkbuilder(L, 1);
+  lua_pushlstring(L, sb->b, sb->n);
+  return 1;
+}
+
+
+/*
+** builder:finish(): the contents as a string, leaving the builder empty.
+** The buffer is transferred into the string instead of copied.
+*/
+static int builder_finish (lua_State *L) {
+  StrBuilder *sb = checkbuilder(L, 1);
+  if (sb->b == NULL)
+    lua_pushliteral(L, "");
+  else {
+    lua_pushbuffer(L, sb->b, sb->size, sb->n);
+    sb->b = NULL;  /* buffer now belongs to the string */
+    sb->n = sb->size = 0;
+  }
+  return 1;
+}
+
+
+static int builder_len (lua_State *L) {
+  StrBuilder *sb = checkbuilder(L, 1);
+  lua_pushinteger(L, (lua_Integer)sb->n);
+  return 1;
+}
+
+
+static int builder_gc (lua_State *L) {
+  builderfree(L, checkbuilder(L, 1));
+  return 0;
+}
+
+
+static const luaL_Reg buildermeth[] = {
+  {"append", builder_append},
+  {"clear", builder_clear},
+  {"finish", builder_finish},
+  {"tostring", builder_tostring},
+  {NULL, NULL}
+};
+
+
+static const luaL_Reg buildermetameth[] = {
+  {"__index", NULL},  /* place holder */
+  {"__len", builder_len},
+  {"__tostring", builder_tostring},
+  {"__gc", builder_gc},
+  {"__close", builder_gc},
+  {NULL, NULL}
+};
+
+
+static void createbuildermeta (lua_State *L) {
+  luaL_newmetatable(L, LUA_BUILDERHANDLE);  /* metatable for builders */
+  luaL_setfuncs(L, buildermetameth, 0);  /* add metamethods */
+  luaL_newlibtable(L, buildermeth);  /* create method table */
+  luaL_setfuncs(L, buildermeth, 0);  /* add builder methods */
+  lua_setfield(L, -2, "__index");  /* metatable.__index = method table */
+  lua_pop(L, 1);  /* pop metatable */
+}
+
+/* }====================================================== */
+#endif
+
+
 static const luaL_Reg strlib[] = {
   {"byte", str_byte},
   {"char", str_char},
@@ -2069,6 +2673,9 @@ static const luaL_Reg strlib[] = {
   {"isblob", str_isblob},
   {"blob_pack", str_blobpack},
   {"blob_unpack", str_blobunpack},
+#endif
+#if defined(LUAGLM_EXT_BUILDER)
+  {"builder", str_builder},
 #endif
   {NULL, NULL}
 };
@@ -2092,8 +2699,13 @@ static void createmetatable (lua_State *L) {
 ** Open string library
 */
 LUAMOD_API int luaopen_string (lua_State *L) {
-  luaL_newlib(L, strlib);
+  luaL_newlibtable(L, strlib);
+  newpatterncache(L);  /* shared by all library functions */
+  luaL_setfuncs(L, strlib, 1);
   createmetatable(L);
+#if defined(LUAGLM_EXT_BUILDER)
+  createbuildermeta(L);
+#endif
   return 1;
 }
 
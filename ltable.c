@@ -21,10 +21,13 @@
 ** in its main position (i.e. the 'original' position that its hash gives
 ** to it), then the colliding element is in its own main position.
 ** Hence even when the load factor reaches 100%, performance remains good.
+** With LUA_SWISS_TABLES, the hash part is an open-addressing table
+** instead (see 'Swiss hash part' below).
 */
 
 #include <math.h>
 #include <limits.h>
+#include <string.h>
 
 #include "lua.h"
 
@@ -34,6 +37,7 @@
 #include "lmem.h"
 #include "lobject.h"
 #include "lglm_core.h"
+#include "lsimd.h"
 #include "lstate.h"
 #include "lstring.h"
 #include "ltable.h"
@@ -47,12 +51,21 @@
 #define MAXABITS	cast_int(sizeof(int) * CHAR_BIT - 1)
 
 
+/*
+** Size in bytes of an array part with 'n' entries: each entry has a
+** value and a one-byte tag.
+*/
+#define concretesize(n)		(cast_sizet(n) * (sizeof(Value) + 1))
+
+
 /*
 ** MAXASIZE is the maximum size of the array part. It is the minimum
 ** between 2^MAXABITS and the maximum size that, measured in bytes,
 ** fits in a 'size_t'.
 */
-#define MAXASIZE	luaM_limitN(1u << MAXABITS, TValue)
+#define MAXASIZEB	(MAX_SIZET / (sizeof(Value) + 1))
+#define MAXASIZE  \
+	(((1u << MAXABITS) < MAXASIZEB) ? (1u << MAXABITS) : cast_uint(MAXASIZEB))
 
 /*
 ** MAXHBITS is the largest integer such that 2^MAXHBITS fits in a
@@ -66,7 +79,14 @@
 ** between 2^MAXHBITS and the maximum size such that, measured in bytes,
 ** it fits in a 'size_t'.
 */
+#if defined(LUA_SWISS_TABLES)
+/* each node of a Swiss hash part also has a control byte */
+#define MAXHSIZEB	(MAX_SIZET / (sizeof(Node) + 1) - GROUPSIZE)
+#define MAXHSIZE  \
+	(((1u << MAXHBITS) < MAXHSIZEB) ? (1u << MAXHBITS) : cast_uint(MAXHSIZEB))
+#else
 #define MAXHSIZE	luaM_limitN(1u << MAXHBITS, Node)
+#endif
 
 
 /*
@@ -100,6 +120,8 @@ static const Node dummynode_ = {
 static const TValue absentkey = {ABSTKEYCONSTANT};
 
 
+#if !defined(LUA_SWISS_TABLES)
+
 /*
 ** Hash for integers. To allow a good hash, use the remainder operator
 ** ('%'). If integer fits as a non-negative int, compute an int
@@ -114,6 +136,8 @@ static Node *hashint (const Table *t, lua_Integer i) {
     return hashmod(t, ui);
 }
 
+#endif
+
 
 /*
 ** Hash for floating-point numbers.
@@ -145,6 +169,8 @@ static int l_hashfloat (lua_Number n) {
 #endif
 
 
+#if !defined(LUA_SWISS_TABLES)
+
 /*
 ** returns the 'main' position of an element in a table (that is,
 ** the index of its hash value).
@@ -169,6 +195,9 @@ static Node *mainpositionTV (const Table *t, const TValue *key) {
       TString *ts = tsvalue(key);
       return hashstr(t, ts);
     }
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR:  /* slices hash as the long strings they represent */
+#endif
     case LUA_VLNGSTR: {
       TString *ts = tsvalue(key);
       return hashpow2(t, luaS_hashlongstr(ts));
@@ -202,6 +231,192 @@ l_sinline Node *mainpositionfromnode (const Table *t, Node *nd) {
   return mainpositionTV(t, &key);
 }
 
+#else
+
+/*
+** {======================================================
+** Swiss hash part
+** =======================================================
+** The hash part is an open-addressing table. Besides its node, each
+** position has a control byte: CTRL_EMPTY if the position was never
+** used, or 7 bits of the hash of the key in it otherwise. Positions
+** are grouped in groups of GROUPSIZE; a search compares the bits of
+** the key's hash against all the control bytes of a group at once and
+** only looks at the nodes that match, visiting the groups in the
+** key's probe sequence until it finds a group with an empty position.
+** A node keeps its key when its value is erased, working as a
+** tombstone; this keeps the probe sequences that pass over it intact
+** and lets 'next' find the key. Tombstones are cleaned by the next
+** rehash, which happens when the insertions used all the positions
+** allowed by the maximum load factor (7/8; 1 for hash parts with a
+** single group).
+** Tables smaller than a group still get GROUPSIZE control bytes, the
+** ones past their size permanently empty.
+*/
+
+#define CTRL_EMPTY	0x80
+#define GROUPSIZE	16
+
+
+/* number of control bytes of a hash part with 'n' positions */
+#define ctrlsize(n)	((n) < GROUPSIZE ? GROUPSIZE : (n))
+
+/* size in bytes of a hash part with 'n' positions */
+#define hashblocksize(n)  \
+	(cast_sizet(n) * sizeof(Node) + cast_sizet(ctrlsize(n)))
+
+/* maximum number of keys in a hash part with 'n' positions */
+#define maxhashuse(n)	((n) <= GROUPSIZE ? (n) : (n) - (n) / 8)
+
+
+/* number of groups of 't' minus 1 */
+#define groupmask(t)	((sizenode(t) - 1) / GROUPSIZE)
+
+/* the first group in the probe sequence of hash 'h' */
+#define hashgroup(t,h)	(((h) >> 7) & groupmask(t))
+
+/* the bits of hash 'h' kept in a control byte */
+#define hashtag(h)	cast_byte((h) & 0x7F)
+
+
+/*
+** Masks of the positions in the group starting at 'ctrl' whose control
+** byte is 'tag' and of the empty ones.
+*/
+#if defined(LUA_SIMD)
+
+static unsigned int matchtag (const lu_byte *ctrl, lu_byte tag) {
+  const __m128i g = _mm_loadu_si128((const __m128i *)ctrl);
+  return cast_uint(_mm_movemask_epi8(
+                     _mm_cmpeq_epi8(g, _mm_set1_epi8(cast_char(tag)))));
+}
+
+static unsigned int matchempty (const lu_byte *ctrl) {
+  /* only CTRL_EMPTY has its high bit set */
+  return cast_uint(_mm_movemask_epi8(
+                     _mm_loadu_si128((const __m128i *)ctrl)));
+}
+
+#else
+
+static unsigned int matchtag (const lu_byte *ctrl, lu_byte tag) {
+  unsigned int mask = 0;
+  int i;
+  for (i = 0; i < GROUPSIZE; i++)
+    mask |= cast_uint(ctrl[i] == tag) << i;
+  return mask;
+}
+
+static unsigned int matchempty (const lu_byte *ctrl) {
+  return matchtag(ctrl, CTRL_EMPTY);
+}
+
+#endif
+
+
+/*
+** Mixes the bits of 'h', so that all bits of the result depend on all
+** bits of 'h' (the raw hashes of integers and pointers vary only in
+** a few of them). (This is the finalizer of MurmurHash3.)
+*/
+static unsigned int mixhash (unsigned int h) {
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+
+/* 'size_t' or 'lua_Unsigned' value folded into an 'unsigned int' */
+#define foldhash(x)	cast_uint((x) ^ ((x) >> 31 >> 1))
+
+
+static unsigned int hashinteger (lua_Integer i) {
+  lua_Unsigned ui = l_castS2U(i);
+  return mixhash(foldhash(ui));
+}
+
+
+/*
+** Hash of a key. Strings already have well-distributed hashes.
+*/
+static unsigned int hashkey (const TValue *key) {
+  unsigned int h;
+  switch (ttypetag(key)) {
+    case LUA_VSHRSTR:
+      return tsvalue(key)->hash;
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR:  /* slices hash as the long strings they represent */
+#endif
+    case LUA_VLNGSTR:
+      return luaS_hashlongstr(tsvalue(key));
+    case LUA_VNUMINT:
+      return hashinteger(ivalue(key));
+    case LUA_VNUMFLT:
+      h = cast_uint(l_hashfloat(fltvalue(key)));
+      break;
+    case LUA_VVECTOR2:
+    case LUA_VVECTOR3:
+    case LUA_VVECTOR4:
+    case LUA_VQUAT: {
+      size_t vh = glmVec_hash(key);
+      h = foldhash(vh);
+      break;
+    }
+    case LUA_VFALSE:
+      h = 0;
+      break;
+    case LUA_VTRUE:
+      h = 1;
+      break;
+    case LUA_VLIGHTUSERDATA:
+      h = point2uint(pvalue(key));
+      break;
+    case LUA_VLCF:
+      h = point2uint(fvalue(key));
+      break;
+#if defined(LUAGLM_EXT_BLOB)
+    case LUA_VBLOBSTR:  /* blobs stored by pointer */
+#endif
+    default:
+      h = point2uint(gcvalue(key));
+      break;
+  }
+  return mixhash(h);
+}
+
+
+/*
+** Takes a position for a new key with hash 'h': the first empty
+** position in its probe sequence, whose control byte gets the key's
+** tag. (A probe sequence visits the groups in triangular steps, which
+** go through all of them, as their number is a power of 2.) There must
+** be one, as 't->growthleft' is not zero.
+*/
+static Node *findfree (Table *t, unsigned int h) {
+  unsigned int gmask = groupmask(t);
+  unsigned int g = hashgroup(t, h);
+  unsigned int step = 0;
+  for (;;) {
+    unsigned int m = matchempty(t->ctrl + g * GROUPSIZE);
+    if (m != 0) {
+      unsigned int i = g * GROUPSIZE + cast_uint(l_ctz(m));
+      lua_assert(cast_int(i) < sizenode(t));
+      t->ctrl[i] = hashtag(h);
+      return gnode(t, i);
+    }
+    lua_assert(step < gmask);
+    g = (g + ++step) & gmask;
+  }
+}
+
+
+/* }====================================================== */
+
+#endif
+
 
 /*
 ** Check whether key 'k1' is equal to the key in node 'n2'. This
@@ -225,8 +440,14 @@ l_sinline Node *mainpositionfromnode (const Table *t, Node *nd) {
 */
 static int equalkey (const TValue *k1, const Node *n2, int deadok) {
   if ((rawtt(k1) != keytt(n2)) &&  /* not the same variants? */
-       !(deadok && keyisdead(n2) && iscollectable(k1)))
+       !(deadok && keyisdead(n2) && iscollectable(k1))) {
+#if defined(LUAGLM_EXT_SLICE)
+    /* slices are never keys, but they may index long string keys */
+    if (ttisslicestring(k1) && keytt(n2) == ctb(LUA_VLNGSTR))
+      return luaS_eqlngstr(tsvalue(k1), keystrval(n2));
+#endif
    return 0;  /* cannot be same key */
+  }
   switch (keytt(n2)) {
     case LUA_VNIL: case LUA_VFALSE: case LUA_VTRUE:
       return 1;
@@ -312,6 +533,39 @@ static unsigned int setlimittosize (Table *t) {
 ** which may be in array part, nor for floats with integral values.)
 ** See explanation about 'deadok' in function 'equalkey'.
 */
+#if defined(LUA_SWISS_TABLES)
+
+/*
+** A key erased and inserted again takes a new position, while the
+** collector may turn its old node into a dead key. So, a search that
+** accepts dead keys only settles for one if the key is not found alive.
+*/
+static const TValue *getgeneric (Table *t, const TValue *key, int deadok) {
+  const TValue *dead = &absentkey;
+  unsigned int h, g, gmask, step = 0;
+  if (isdummy(t))
+    return &absentkey;
+  h = hashkey(key);
+  g = hashgroup(t, h);
+  gmask = groupmask(t);
+  for (;;) {  /* check the groups in the probe sequence of 'key' */
+    const lu_byte *ctrl = t->ctrl + g * GROUPSIZE;
+    unsigned int m;
+    for (m = matchtag(ctrl, hashtag(h)); m != 0; m &= m - 1) {
+      Node *n = gnode(t, g * GROUPSIZE + cast_uint(l_ctz(m)));
+      if (equalkey(key, n, 0))
+        return gval(n);  /* that's it */
+      else if (deadok && isabstkey(dead) && equalkey(key, n, 1))
+        dead = gval(n);  /* keep looking for it alive */
+    }
+    if (matchempty(ctrl) != 0 || step == gmask)
+      return dead;  /* not found alive */
+    g = (g + ++step) & gmask;
+  }
+}
+
+#else
+
 static const TValue *getgeneric (Table *t, const TValue *key, int deadok) {
   Node *n = mainpositionTV(t, key);
   for (;;) {  /* check whether 'key' is somewhere in the chain */
@@ -326,6 +580,8 @@ static const TValue *getgeneric (Table *t, const TValue *key, int deadok) {
   }
 }
 
+#endif
+
 
 /*
 ** returns the index for 'k' if 'k' is an appropriate key to live in
@@ -362,14 +618,19 @@ static unsigned int findindex (lua_State *L, Table *t, TValue *key,
 }
 
 
-int luaH_next (lua_State *L, Table *t, StkId key) {
-  unsigned int asize = luaH_realasize(t);
-  unsigned int i = findindex(L, t, s2v(key), asize);  /* find original key */
+/*
+** Put into 'key' and 'key + 1' the first non-empty entry from index 'i'
+** (as returned by 'findindex') on. Returns the index of the entry after
+** it, or 0 when there are no more elements.
+*/
+static unsigned int nextfrom (lua_State *L, Table *t, StkId key,
+                              unsigned int i, unsigned int asize) {
   for (; i < asize; i++) {  /* try first array part */
-    if (!isempty(&t->array[i])) {  /* a non-empty entry? */
+    lu_byte tag = *getArrTag(t, i);
+    if (!tagisempty(tag)) {  /* a non-empty entry? */
       setivalue(s2v(key), i + 1);
-      setobj2s(L, key + 1, &t->array[i]);
-      return 1;
+      farr2val(t, i, tag, s2v(key + 1));
+      return i + 1;
     }
   }
   for (i -= asize; cast_int(i) < sizenode(t); i++) {  /* hash part */
@@ -377,16 +638,66 @@ int luaH_next (lua_State *L, Table *t, StkId key) {
       Node *n = gnode(t, i);
       getnodekey(L, s2v(key), n);
       setobj2s(L, key + 1, gval(n));
-      return 1;
+      return (i + 1) + asize;
     }
   }
   return 0;  /* no more elements */
 }
 
 
+int luaH_next (lua_State *L, Table *t, StkId key) {
+  unsigned int asize = luaH_realasize(t);
+  unsigned int i = findindex(L, t, s2v(key), asize);  /* find original key */
+  return (nextfrom(L, t, key, i, asize) != 0);
+}
+
+
+/*
+** Check whether 'i' is the index of 'key' (as in 'findindex').
+*/
+static int iscursor (Table *t, const TValue *key, unsigned int i,
+                                                  unsigned int asize) {
+  if (i == 0)
+    return ttisnil(key);
+  else if (i <= asize)
+    return (ttisinteger(key) && l_castS2U(ivalue(key)) == i);
+  else
+    return (i - asize <= cast_uint(sizenode(t)) &&
+            equalkey(key, gnode(t, i - asize - 1), 1));
+}
+
+
+/*
+** Variant of 'luaH_next' for traversals that keep in '*cursor' the index
+** returned by the previous call, which saves the search for 'key' while
+** its entry is still in the same place.
+*/
+int luaH_nextcursor (lua_State *L, Table *t, StkId key,
+                                   unsigned int *cursor) {
+  unsigned int asize = luaH_realasize(t);
+  unsigned int i = *cursor;
+  if (!iscursor(t, s2v(key), i, asize))
+    i = findindex(L, t, s2v(key), asize);  /* find original key */
+  *cursor = nextfrom(L, t, key, i, asize);
+  return (*cursor != 0);
+}
+
+
 static void freehash (lua_State *L, Table *t) {
-  if (!isdummy(t))
+  if (!isdummy(t)) {
+#if defined(LUA_SWISS_TABLES)
+    luaM_freemem(L, t->node, hashblocksize(sizenode(t)));
+#else
     luaM_freearray(L, t->node, cast_sizet(sizenode(t)));
+#endif
+  }
+}
+
+
+static void freearray (lua_State *L, Table *t) {
+  unsigned int asize = luaH_realasize(t);
+  if (asize > 0)
+    luaM_freemem(L, t->array - asize, concretesize(asize));
 }
 
 
@@ -459,7 +770,7 @@ static unsigned int numusearray (const Table *t, unsigned int *nums) {
     }
     /* count elements in range (2^(lg - 1), 2^lg] */
     for (; i <= lim; i++) {
-      if (!isempty(&t->array[i-1]))
+      if (!tagisempty(*getArrTag(t, i - 1)))
         lc++;
     }
     nums[lg] += lc;
@@ -493,6 +804,41 @@ static int numusehash (const Table *t, unsigned int *nums, unsigned int *pna) {
 ** comparison ensures that the shift in the second one does not
 ** overflow.
 */
+#if defined(LUA_SWISS_TABLES)
+
+/*
+** A Swiss hash part for 'size' keys must be large enough to keep its
+** load factor under the maximum. Its nodes and control bytes are
+** allocated as a single block.
+*/
+static void setnodevector (lua_State *L, Table *t, unsigned int size) {
+  if (size == 0) {  /* no elements to hash part? */
+    t->node = cast(Node *, dummynode);  /* use common 'dummynode' */
+    t->lsizenode = 0;
+    t->ctrl = NULL;  /* signal that it is using dummy node */
+    t->growthleft = 0;
+  }
+  else {
+    int i;
+    int lsize = luaO_ceillog2(size <= GROUPSIZE ? size : size + size / 7);
+    if (lsize > MAXHBITS || (1u << lsize) > MAXHSIZE)
+      luaG_runerror(L, "table overflow");
+    size = twoto(lsize);
+    t->node = cast(Node *, luaM_newvector(L, hashblocksize(size), char));
+    for (i = 0; i < (int)size; i++) {
+      Node *n = gnode(t, i);
+      setnilkey(n);
+      setempty(gval(n));
+    }
+    t->ctrl = cast(lu_byte *, t->node + size);
+    memset(t->ctrl, CTRL_EMPTY, ctrlsize(size));
+    t->lsizenode = cast_byte(lsize);
+    t->growthleft = maxhashuse(size);
+  }
+}
+
+#else
+
 static void setnodevector (lua_State *L, Table *t, unsigned int size) {
   if (size == 0) {  /* no elements to hash part? */
     t->node = cast(Node *, dummynode);  /* use common 'dummynode' */
@@ -517,6 +863,8 @@ static void setnodevector (lua_State *L, Table *t, unsigned int size) {
   }
 }
 
+#endif
+
 
 /*
 ** (Re)insert all elements from the hash part of 'ot' into table 't'.
@@ -543,13 +891,53 @@ static void reinsert (lua_State *L, Table *ot, Table *t) {
 static void exchangehashpart (Table *t1, Table *t2) {
   lu_byte lsizenode = t1->lsizenode;
   Node *node = t1->node;
+#if defined(LUA_SWISS_TABLES)
+  lu_byte *ctrl = t1->ctrl;
+  unsigned int growthleft = t1->growthleft;
+  t1->ctrl = t2->ctrl;
+  t1->growthleft = t2->growthleft;
+  t2->ctrl = ctrl;
+  t2->growthleft = growthleft;
+#else
   Node *lastfree = t1->lastfree;
+  t1->lastfree = t2->lastfree;
+  t2->lastfree = lastfree;
+#endif
   t1->lsizenode = t2->lsizenode;
   t1->node = t2->node;
-  t1->lastfree = t2->lastfree;
   t2->lsizenode = lsizenode;
   t2->node = node;
-  t2->lastfree = lastfree;
+}
+
+
+/*
+** Reallocate the array part of 't' from 'oldasize' to 'newasize'
+** entries, keeping the entries common to both sizes. As the values of
+** those entries end at 't->array' and their tags start there, they
+** move as a single block. Returns NULL when 'newasize' is zero or the
+** allocation fails; the old array part is kept in the latter case.
+*/
+static Value *resizearray (lua_State *L, Table *t, unsigned int oldasize,
+                                                   unsigned int newasize) {
+  if (oldasize == newasize)
+    return t->array;
+  else if (newasize == 0) {  /* erasing array? */
+    luaM_freemem(L, t->array - oldasize, concretesize(oldasize));
+    return NULL;
+  }
+  else {
+    Value *np = cast(Value *,
+        luaM_reallocvector(L, NULL, 0, concretesize(newasize), char));
+    if (np == NULL)  /* allocation failed? */
+      return NULL;
+    np += newasize;  /* values are before the pointer, tags after it */
+    if (oldasize > 0) {
+      unsigned int tomove = (oldasize < newasize) ? oldasize : newasize;
+      memcpy(np - tomove, t->array - tomove, concretesize(tomove));
+      luaM_freemem(L, t->array - oldasize, concretesize(oldasize));
+    }
+    return np;
+  }
 }
 
 
@@ -571,7 +959,7 @@ void luaH_resize (lua_State *L, Table *t, unsigned int newasize,
   unsigned int i;
   Table newt;  /* to keep the new hash part */
   unsigned int oldasize = setlimittosize(t);
-  TValue *newarray;
+  Value *newarray;
   /* create new hash part with appropriate size into 'newt' */
   setnodevector(L, &newt, nhsize);
   if (newasize < oldasize) {  /* will array shrink? */
@@ -579,14 +967,18 @@ void luaH_resize (lua_State *L, Table *t, unsigned int newasize,
     exchangehashpart(t, &newt);  /* and new hash */
     /* re-insert into the new hash the elements from vanishing slice */
     for (i = newasize; i < oldasize; i++) {
-      if (!isempty(&t->array[i]))
-        luaH_setint(L, t, i + 1, &t->array[i]);
+      lu_byte tag = *getArrTag(t, i);
+      if (!tagisempty(tag)) {
+        TValue aux;
+        farr2val(t, i, tag, &aux);
+        luaH_setint(L, t, i + 1, &aux);
+      }
     }
     t->alimit = oldasize;  /* restore current size... */
     exchangehashpart(t, &newt);  /* and hash (in case of errors) */
   }
   /* allocate new array */
-  newarray = luaM_reallocvector(L, t->array, oldasize, newasize, TValue);
+  newarray = resizearray(L, t, oldasize, newasize);
   if (l_unlikely(newarray == NULL && newasize > 0)) {  /* allocation failed? */
     freehash(L, &newt);  /* release new hash part */
     luaM_error(L);  /* raise error (with array unchanged) */
@@ -596,7 +988,7 @@ void luaH_resize (lua_State *L, Table *t, unsigned int newasize,
   t->array = newarray;  /* set new array part */
   t->alimit = newasize;
   for (i = oldasize; i < newasize; i++)  /* clear new slice of the array */
-     setempty(&t->array[i]);
+    *getArrTag(t, i) = LUA_VEMPTY;
   /* re-insert elements from old hash part into new parts */
   reinsert(L, &newt, t);  /* 'newt' now has the old hash */
   freehash(L, &newt);  /* free old hash part */
@@ -605,6 +997,9 @@ void luaH_resize (lua_State *L, Table *t, unsigned int newasize,
 
 void luaH_resizearray (lua_State *L, Table *t, unsigned int nasize) {
   int nsize = allocsizenode(t);
+#if defined(LUA_SWISS_TABLES)
+  nsize = maxhashuse(nsize);  /* number of keys that keeps the same size */
+#endif
   luaH_resize(L, t, nasize, nsize);
 }
 
@@ -655,12 +1050,16 @@ Table *luaH_new (lua_State *L) {
 
 
 void luaH_free (lua_State *L, Table *t) {
+  if (t->flags & BITCHAIN)  /* part of a cached '__index' chain? */
+    luaT_invalidatechains(L);  /* its address may be reused */
   freehash(L, t);
-  luaM_freearray(L, t->array, luaH_realasize(t));
+  freearray(L, t);
   luaM_free(L, t);
 }
 
 
+#if !defined(LUA_SWISS_TABLES)
+
 static Node *getfreepos (Table *t) {
   if (!isdummy(t)) {
     while (t->lastfree > t->node) {
@@ -672,6 +1071,8 @@ static Node *getfreepos (Table *t) {
   return NULL;  /* could not find a free place */
 }
 
+#endif
+
 
 
 /*
@@ -680,6 +1081,9 @@ static Node *getfreepos (Table *t) {
 ** position or not: if it is not, move colliding node to an empty place and
 ** put new key in its main position; otherwise (colliding node is in its main
 ** position), new key goes to an empty position.
+** (A Swiss hash part puts the new key in the first empty position of
+** its probe sequence, growing the table first if insertions already
+** took all positions allowed by the maximum load factor.)
 */
 void luaH_newkey (lua_State *L, Table *t, const TValue *key, TValue *value) {
   Node *mp;
@@ -703,6 +1107,16 @@ void luaH_newkey (lua_State *L, Table *t, const TValue *key, TValue *value) {
   }
   if (ttisnil(value))
     return;  /* do not insert nil values */
+#if defined(LUA_SWISS_TABLES)
+  if (t->growthleft == 0) {  /* no free position? (or dummy node) */
+    rehash(L, t, key);  /* grow table */
+    /* whatever called 'newkey' takes care of TM cache */
+    luaH_set(L, t, key, value);  /* insert key into grown table */
+    return;
+  }
+  t->growthleft--;
+  mp = findfree(t, hashkey(key));
+#else
   mp = mainpositionTV(t, key);
   if (!isempty(gval(mp)) || isdummy(t)) {  /* main position is taken? */
     Node *othern;
@@ -736,6 +1150,13 @@ void luaH_newkey (lua_State *L, Table *t, const TValue *key, TValue *value) {
       mp = f;
     }
   }
+#endif
+#if defined(LUAGLM_EXT_SLICE)
+  if (ttisslicestring(key)) {  /* do not let keys keep slice parents alive */
+    setsvalue(L, &aux, luaS_fromslice(L, tsvalue(key)));
+    key = &aux;  /* insert it as a long string (with the same hash) */
+  }
+#endif
   setnodekey(L, mp, key);
   luaC_barrierback(L, obj2gco(t), key);
   lua_assert(isempty(gval(mp)));
@@ -744,42 +1165,134 @@ void luaH_newkey (lua_State *L, Table *t, const TValue *key, TValue *value) {
 
 
 /*
-** Search function for integers. If integer is inside 'alimit', get it
-** directly from the array part. Otherwise, if 'alimit' is not equal to
+** Check whether integer 'key' is in the array part of 't'. If it is
+** inside 'alimit', that is it. Otherwise, if 'alimit' is not equal to
 ** the real size of the array, key still can be in the array part. In
 ** this case, try to avoid a call to 'luaH_realasize' when key is just
 ** one more than the limit (so that it can be incremented without
-** changing the real size of the array).
+** changing the real size of the array). Returns 'key' if it is in the
+** array part, 0 otherwise.
 */
-const TValue *luaH_getint (Table *t, lua_Integer key) {
+static unsigned int ikeyinarray (Table *t, lua_Integer key) {
   if (l_castS2U(key) - 1u < t->alimit)  /* 'key' in [1, t->alimit]? */
-    return &t->array[key - 1];
+    return cast_uint(key);
   else if (!limitequalsasize(t) &&  /* key still may be in the array part? */
            (l_castS2U(key) == t->alimit + 1 ||
             l_castS2U(key) - 1u < luaH_realasize(t))) {
     t->alimit = cast_uint(key);  /* probably '#t' is here now */
-    return &t->array[key - 1];
+    return cast_uint(key);
   }
-  else {
-    Node *n = hashint(t, key);
-    for (;;) {  /* check whether 'key' is somewhere in the chain */
+  else
+    return 0;
+}
+
+
+/*
+** Search function for integers in the hash part.
+*/
+#if defined(LUA_SWISS_TABLES)
+
+static const TValue *getintfromhash (Table *t, lua_Integer key) {
+  unsigned int h, g, gmask, step = 0;
+  if (isdummy(t))
+    return &absentkey;
+  h = hashinteger(key);
+  g = hashgroup(t, h);
+  gmask = groupmask(t);
+  for (;;) {  /* check the groups in the probe sequence of 'key' */
+    const lu_byte *ctrl = t->ctrl + g * GROUPSIZE;
+    unsigned int m;
+    for (m = matchtag(ctrl, hashtag(h)); m != 0; m &= m - 1) {
+      Node *n = gnode(t, g * GROUPSIZE + cast_uint(l_ctz(m)));
       if (keyisinteger(n) && keyival(n) == key)
         return gval(n);  /* that's it */
-      else {
-        int nx = gnext(n);
-        if (nx == 0) break;
-        n += nx;
-      }
     }
-    return &absentkey;
+    if (matchempty(ctrl) != 0 || step == gmask)
+      return &absentkey;  /* not found */
+    g = (g + ++step) & gmask;
+  }
+}
+
+#else
+
+static const TValue *getintfromhash (Table *t, lua_Integer key) {
+  Node *n = hashint(t, key);
+  for (;;) {  /* check whether 'key' is somewhere in the chain */
+    if (keyisinteger(n) && keyival(n) == key)
+      return gval(n);  /* that's it */
+    else {
+      int nx = gnext(n);
+      if (nx == 0) break;
+      n += nx;
+    }
+  }
+  return &absentkey;
+}
+
+#endif
+
+
+/*
+** Finish a get on the hash part: copy the value found (if any) into
+** 'res' and return its tag.
+*/
+static lu_byte finishnodeget (const TValue *val, TValue *res) {
+  if (!ttisnil(val)) {
+    setobj(cast(lua_State *, NULL), res, val);
   }
+  return ttypetag(val);
 }
 
 
 /*
-** search function for short strings
+** The get functions put the value of 't[key]' into 'res' and return
+** its tag; an empty tag means that the key is absent, and then 'res'
+** is left unchanged.
 */
-const TValue *luaH_getshortstr (Table *t, TString *key) {
+lu_byte luaH_getint (Table *t, lua_Integer key, TValue *res) {
+  unsigned int k = ikeyinarray(t, key);
+  if (k > 0) {
+    lu_byte tag = *getArrTag(t, k - 1);
+    if (!tagisempty(tag))
+      farr2val(t, k - 1, tag, res);
+    return tag;
+  }
+  else
+    return finishnodeget(getintfromhash(t, key), res);
+}
+
+
+/*
+** search function for short strings. (This function and 'luaH_Hgetstr'
+** return the slot itself, for callers that need the node or keep a
+** pointer to the value, such as the metamethod cache.)
+*/
+#if defined(LUA_SWISS_TABLES)
+
+const TValue *luaH_Hgetshortstr (Table *t, TString *key) {
+  unsigned int g, gmask, step = 0;
+  lua_assert(key->tt == LUA_VSHRSTR);
+  if (isdummy(t))
+    return &absentkey;
+  g = hashgroup(t, key->hash);
+  gmask = groupmask(t);
+  for (;;) {  /* check the groups in the probe sequence of 'key' */
+    const lu_byte *ctrl = t->ctrl + g * GROUPSIZE;
+    unsigned int m;
+    for (m = matchtag(ctrl, hashtag(key->hash)); m != 0; m &= m - 1) {
+      Node *n = gnode(t, g * GROUPSIZE + cast_uint(l_ctz(m)));
+      if (keyisshrstr(n) && eqshrstr(keystrval(n), key))
+        return gval(n);  /* that's it */
+    }
+    if (matchempty(ctrl) != 0 || step == gmask)
+      return &absentkey;  /* not found */
+    g = (g + ++step) & gmask;
+  }
+}
+
+#else
+
+const TValue *luaH_Hgetshortstr (Table *t, TString *key) {
   Node *n = hashstr(t, key);
   lua_assert(key->tt == LUA_VSHRSTR);
   for (;;) {  /* check whether 'key' is somewhere in the chain */
@@ -794,10 +1307,36 @@ const TValue *luaH_getshortstr (Table *t, TString *key) {
   }
 }
 
+#endif
+
+
+lu_byte luaH_getshortstr (Table *t, TString *key, TValue *res) {
+  return finishnodeget(luaH_Hgetshortstr(t, key), res);
+}
+
+
+/*
+** Search for a short-string key and, when it is present, set 'hint'
+** to its node. (Slow path of the inline caches; see 'luaH_hintok'.)
+*/
+static const TValue *Hgetshortstrhint (Table *t, TString *key,
+                                                 unsigned int *hint) {
+  const TValue *slot = luaH_Hgetshortstr(t, key);
+  if (!isabstkey(slot))
+    *hint = cast_uint(nodefromval(slot) - gnode(t, 0));
+  return slot;
+}
+
+
+lu_byte luaH_getshortstrhint (Table *t, TString *key, TValue *res,
+                                         unsigned int *hint) {
+  return finishnodeget(Hgetshortstrhint(t, key, hint), res);
+}
 
-const TValue *luaH_getstr (Table *t, TString *key) {
+
+const TValue *luaH_Hgetstr (Table *t, TString *key) {
   if (key->tt == LUA_VSHRSTR)
-    return luaH_getshortstr(t, key);
+    return luaH_Hgetshortstr(t, key);
   else {  /* for long strings, use generic case */
     TValue ko;
     setsvalue(cast(lua_State *, NULL), &ko, key);
@@ -806,38 +1345,114 @@ const TValue *luaH_getstr (Table *t, TString *key) {
 }
 
 
+lu_byte luaH_getstr (Table *t, TString *key, TValue *res) {
+  return finishnodeget(luaH_Hgetstr(t, key), res);
+}
+
+
 /*
 ** main search function
 */
-const TValue *luaH_get (Table *t, const TValue *key) {
+lu_byte luaH_get (Table *t, const TValue *key, TValue *res) {
+  switch (ttypetag(key)) {
+    case LUA_VSHRSTR: return luaH_getshortstr(t, tsvalue(key), res);
+    case LUA_VNUMINT: return luaH_getint(t, ivalue(key), res);
+    case LUA_VNIL: return LUA_VABSTKEY;
+    case LUA_VNUMFLT: {
+      lua_Integer k;
+      if (luaV_flttointeger(fltvalue(key), &k, F2Ieq)) /* integral index? */
+        return luaH_getint(t, k, res);  /* use specialized version */
+      /* else... */
+    }  /* FALLTHROUGH */
+    default:
+      return finishnodeget(getgeneric(t, key, 0), res);
+  }
+}
+
+
+/*
+** The "pre-set" functions store 'val' into 't[key]' when the key is
+** present with a non-empty value, returning HOK. Otherwise, they
+** return where the value should go, to be used by 'luaH_finishset'
+** after the caller checks for metamethods. (See HOK in 'ltable.h'.)
+*/
+static int finishnodeset (Table *t, const TValue *slot, TValue *val) {
+  if (!ttisnil(slot)) {
+    setobj(cast(lua_State *, NULL), cast(TValue *, slot), val);
+    return HOK;  /* success */
+  }
+  else if (isabstkey(slot))
+    return HNOTFOUND;  /* no slot with that key */
+  else  /* return node encoded */
+    return cast_int(nodefromval(slot) - gnode(t, 0)) + HFIRSTNODE;
+}
+
+
+int luaH_psetint (Table *t, lua_Integer key, TValue *val) {
+  unsigned int k = ikeyinarray(t, key);
+  if (k > 0) {
+    lu_byte *tag = getArrTag(t, k - 1);
+    if (!tagisempty(*tag)) {
+      fval2arr(t, k - 1, tag, val);
+      return HOK;
+    }
+    else
+      return ~cast_int(k - 1);  /* empty array entry */
+  }
+  else
+    return finishnodeset(t, getintfromhash(t, key), val);
+}
+
+
+int luaH_psetshortstr (Table *t, TString *key, TValue *val) {
+  return finishnodeset(t, luaH_Hgetshortstr(t, key), val);
+}
+
+
+int luaH_psetshortstrhint (Table *t, TString *key, TValue *val,
+                                     unsigned int *hint) {
+  return finishnodeset(t, Hgetshortstrhint(t, key, hint), val);
+}
+
+
+int luaH_psetstr (Table *t, TString *key, TValue *val) {
+  return finishnodeset(t, luaH_Hgetstr(t, key), val);
+}
+
+
+int luaH_pset (Table *t, const TValue *key, TValue *val) {
   switch (ttypetag(key)) {
-    case LUA_VSHRSTR: return luaH_getshortstr(t, tsvalue(key));
-    case LUA_VNUMINT: return luaH_getint(t, ivalue(key));
-    case LUA_VNIL: return &absentkey;
+    case LUA_VSHRSTR: return luaH_psetshortstr(t, tsvalue(key), val);
+    case LUA_VNUMINT: return luaH_psetint(t, ivalue(key), val);
+    case LUA_VNIL: return HNOTFOUND;
     case LUA_VNUMFLT: {
       lua_Integer k;
       if (luaV_flttointeger(fltvalue(key), &k, F2Ieq)) /* integral index? */
-        return luaH_getint(t, k);  /* use specialized version */
+        return luaH_psetint(t, k, val);  /* use specialized version */
       /* else... */
     }  /* FALLTHROUGH */
     default:
-      return getgeneric(t, key, 0);
+      return finishnodeset(t, getgeneric(t, key, 0), val);
   }
 }
 
 
 /*
-** Finish a raw "set table" operation, where 'slot' is where the value
-** should have been (the result of a previous "get table").
+** Finish a raw "set table" operation, where 'hres' is the result of a
+** previous "pre-set" that did not store the value.
 ** Beware: when using this function you probably need to check a GC
 ** barrier and invalidate the TM cache.
 */
 void luaH_finishset (lua_State *L, Table *t, const TValue *key,
-                                   const TValue *slot, TValue *value) {
-  if (isabstkey(slot))
+                                   TValue *value, int hres) {
+  lua_assert(hres != HOK);
+  if (hres == HNOTFOUND)
     luaH_newkey(L, t, key, value);
-  else
-    setobj2t(L, cast(TValue *, slot), value);
+  else if (hres > 0) {  /* regular node? */
+    setobj2t(L, gval(gnode(t, hres - HFIRSTNODE)), value);
+  }
+  else  /* array entry */
+    obj2arr(t, cast_uint(~hres), value);
 }
 
 
@@ -846,20 +1461,19 @@ void luaH_finishset (lua_State *L, Table *t, const TValue *key,
 ** barrier and invalidate the TM cache.
 */
 void luaH_set (lua_State *L, Table *t, const TValue *key, TValue *value) {
-  const TValue *slot = luaH_get(t, key);
-  luaH_finishset(L, t, key, slot, value);
+  int hres = luaH_pset(t, key, value);
+  if (hres != HOK)
+    luaH_finishset(L, t, key, value, hres);
 }
 
 
 void luaH_setint (lua_State *L, Table *t, lua_Integer key, TValue *value) {
-  const TValue *p = luaH_getint(t, key);
-  if (isabstkey(p)) {
+  int hres = luaH_psetint(t, key, value);
+  if (hres != HOK) {
     TValue k;
     setivalue(&k, key);
-    luaH_newkey(L, t, &k, value);
+    luaH_finishset(L, t, &k, value, hres);
   }
-  else
-    setobj2t(L, cast(TValue *, p), value);
 }
 
 
@@ -876,6 +1490,12 @@ void luaH_setint (lua_State *L, Table *t, lua_Integer key, TValue *value) {
 ** boundary. ('j + 1' cannot be a present integer key because it is
 ** not a valid integer in Lua.)
 */
+static int hashkeyisempty (Table *t, lua_Unsigned key) {
+  const TValue *v = getintfromhash(t, l_castU2S(key));
+  return isempty(v);
+}
+
+
 static lua_Unsigned hash_search (Table *t, lua_Unsigned j) {
   lua_Unsigned i;
   if (j == 0) j++;  /* the caller ensures 'j + 1' is present */
@@ -885,27 +1505,30 @@ static lua_Unsigned hash_search (Table *t, lua_Unsigned j) {
       j *= 2;
     else {
       j = LUA_MAXINTEGER;
-      if (isempty(luaH_getint(t, j)))  /* t[j] not present? */
+      if (hashkeyisempty(t, j))  /* t[j] not present? */
         break;  /* 'j' now is an absent index */
       else  /* weird case */
         return j;  /* well, max integer is a boundary... */
     }
-  } while (!isempty(luaH_getint(t, j)));  /* repeat until an absent t[j] */
+  } while (!hashkeyisempty(t, j));  /* repeat until an absent t[j] */
   /* i < j  &&  t[i] present  &&  t[j] absent */
   while (j - i > 1u) {  /* do a binary search between them */
     lua_Unsigned m = (i + j) / 2;
-    if (isempty(luaH_getint(t, m))) j = m;
+    if (hashkeyisempty(t, m)) j = m;
     else i = m;
   }
   return i;
 }
 
 
-static unsigned int binsearch (const TValue *array, unsigned int i,
-                                                    unsigned int j) {
+/* true if entry 'k' (1-based) of the array part is empty */
+#define arraykeyisempty(t,k)	tagisempty(*getArrTag(t, (k) - 1))
+
+
+static unsigned int binsearch (Table *t, unsigned int i, unsigned int j) {
   while (j - i > 1u) {  /* binary search */
     unsigned int m = (i + j) / 2;
-    if (isempty(&array[m - 1])) j = m;
+    if (arraykeyisempty(t, m)) j = m;
     else i = m;
   }
   return i;
@@ -946,9 +1569,9 @@ static unsigned int binsearch (const TValue *array, unsigned int i,
 */
 lua_Unsigned luaH_getn (Table *t) {
   unsigned int limit = t->alimit;
-  if (limit > 0 && isempty(&t->array[limit - 1])) {  /* (1)? */
+  if (limit > 0 && arraykeyisempty(t, limit)) {  /* (1)? */
     /* there must be a boundary before 'limit' */
-    if (limit >= 2 && !isempty(&t->array[limit - 2])) {
+    if (limit >= 2 && !arraykeyisempty(t, limit - 1)) {
       /* 'limit - 1' is a boundary; can it be a new limit? */
       if (ispow2realasize(t) && !ispow2(limit - 1)) {
         t->alimit = limit - 1;
@@ -957,7 +1580,7 @@ lua_Unsigned luaH_getn (Table *t) {
       return limit - 1;
     }
     else {  /* must search for a boundary in [0, limit] */
-      unsigned int boundary = binsearch(t->array, 0, limit);
+      unsigned int boundary = binsearch(t, 0, limit);
       /* can this boundary represent the real size of the array? */
       if (ispow2realasize(t) && boundary > luaH_realasize(t) / 2) {
         t->alimit = boundary;  /* use it as the new limit */
@@ -969,14 +1592,14 @@ lua_Unsigned luaH_getn (Table *t) {
   /* 'limit' is zero or present in table */
   if (!limitequalsasize(t)) {  /* (2)? */
     /* 'limit' > 0 and array has more elements after 'limit' */
-    if (isempty(&t->array[limit]))  /* 'limit + 1' is empty? */
+    if (arraykeyisempty(t, limit + 1))  /* 'limit + 1' is empty? */
       return limit;  /* this is the boundary */
     /* else, try last element in the array */
     limit = luaH_realasize(t);
-    if (isempty(&t->array[limit - 1])) {  /* empty? */
+    if (arraykeyisempty(t, limit)) {  /* empty? */
       /* there must be a boundary in the array after old limit,
          and it must be a valid new limit */
-      unsigned int boundary = binsearch(t->array, t->alimit, limit);
+      unsigned int boundary = binsearch(t, t->alimit, limit);
       t->alimit = boundary;
       return boundary;
     }
@@ -984,8 +1607,8 @@ lua_Unsigned luaH_getn (Table *t) {
   }
   /* (3) 'limit' is the last element and either is zero or present in table */
   lua_assert(limit == luaH_realasize(t) &&
-             (limit == 0 || !isempty(&t->array[limit - 1])));
-  if (isdummy(t) || isempty(luaH_getint(t, cast(lua_Integer, limit + 1))))
+             (limit == 0 || !arraykeyisempty(t, limit)));
+  if (isdummy(t) || hashkeyisempty(t, cast(lua_Unsigned, limit) + 1))
     return limit;  /* 'limit + 1' is absent */
   else  /* 'limit + 1' is also present */
     return hash_search(t, limit);
@@ -1000,8 +1623,6 @@ void luaH_setreadonly (Table *t, int readonly) {
 
 
 #if defined(LUAGLM_EXT_API)
-#include <string.h>
-
 int luaH_type (const Table *t) {
   if (luaH_realasize(t) == 0)
     return t->node == dummynode ? LUA_TTEMPTY : LUA_TTHASH;
@@ -1012,7 +1633,7 @@ void luaH_wipetable (lua_State *L, Table *t) {
   unsigned int asize = luaH_realasize(t);
   unsigned int i = 0;
   for (; i < asize; i++)  /* array part */
-    setnilvalue(&t->array[i]);
+    *getArrTag(t, i) = LUA_VNIL;
 
   if (!isdummy(t)) {  /* traverse hash part */
     Node *n, *limit = gnode(t, cast_sizet(sizenode(t)));
@@ -1029,8 +1650,8 @@ void luaH_compact(lua_State *L, Table *t) {
   unsigned int oldasize = setlimittosize(t);
   unsigned int newasize = cast_uint(luaH_getn(t)); /* t->alimit; */
   if (oldasize != newasize) {
-    TValue *array = luaM_reallocvector(L, t->array, oldasize, newasize, TValue);
-    if (l_likely(array != NULL)) {
+    Value *array = resizearray(L, t, oldasize, newasize);
+    if (l_likely(array != NULL || newasize == 0)) {
       t->array = array;
       t->alimit = newasize;
       setrealasize(t);
@@ -1040,10 +1661,11 @@ void luaH_compact(lua_State *L, Table *t) {
     }
   }
 }
+#endif
+
 
 void luaH_clonetable (lua_State *L, const Table *from, Table *to) {
   const unsigned int from_realasize = luaH_realasize(from);
-  const unsigned int to_realasize = luaH_realasize(to);
 
   Table newt;  /* to keep the new hash part */
   newt.alimit = 0;
@@ -1054,6 +1676,15 @@ void luaH_clonetable (lua_State *L, const Table *from, Table *to) {
     const size_t size_from = cast_sizet(sizenode(from));
 
     newt.lsizenode = from->lsizenode;
+#if defined(LUA_SWISS_TABLES)
+    newt.node = cast(Node *, luaM_newvector(L, hashblocksize(size_from), char));
+    if (l_unlikely(newt.node == NULL))  /* allocation failed? */
+      luaM_error(L);  /* raise error */
+
+    memcpy(newt.node, from->node, hashblocksize(size_from));
+    newt.ctrl = cast(lu_byte *, newt.node + size_from);
+    newt.growthleft = from->growthleft;
+#else
     newt.node = luaM_newvector(L, size_from, Node);
     if (l_unlikely(newt.node == NULL))  /* allocation failed? */
       luaM_error(L);  /* raise error */
@@ -1061,51 +1692,100 @@ void luaH_clonetable (lua_State *L, const Table *from, Table *to) {
     memcpy(newt.node, from->node, size_from * sizeof(Node));
     if (from->lastfree)
       newt.lastfree = newt.node + (from->lastfree - from->node);
+#endif
   }
 
-  if (from_realasize > 0) {  /* create/reallocate new array part */
-    TValue *array = (to_realasize == 0) ? newt.array : to->array;
-
-    newt.alimit = from->alimit;
-    newt.array = luaM_reallocvector(L, array, to_realasize, from_realasize, TValue);
-    if (l_unlikely(newt.array == NULL)) {  /* allocation failed? */
+  if (from_realasize > 0) {  /* create new array part */
+    size_t size = concretesize(from_realasize);
+    Value *array = cast(Value *, luaM_reallocvector(L, NULL, 0, size, char));
+    if (l_unlikely(array == NULL)) {  /* allocation failed? */
       freehash(L, &newt);  /* release new hash part */
       luaM_error(L);  /* raise error */
     }
 
-    memcpy(newt.array, from->array, from_realasize * sizeof(TValue));
-  }
-  else {  /* delete current array */
-    if (to->array != NULL) {
-      luaM_freearray(L, to->array, to_realasize);
-      to->array = NULL;
-    }
+    memcpy(array, from->array - from_realasize, size);
+    newt.array = array + from_realasize;
+    newt.alimit = from->alimit;
   }
 
+  freearray(L, to);  /* delete previous array part */
   freehash(L, to);  /* delete previous hash part */
   to->array = newt.array;
   to->alimit = newt.alimit;
   to->node = newt.node;
+#if defined(LUA_SWISS_TABLES)
+  to->ctrl = newt.ctrl;
+  to->growthleft = newt.growthleft;
+#else
   to->lastfree = newt.lastfree;
+#endif
   to->lsizenode = newt.lsizenode;
   to->flags = ((to->flags & ~BITRAS) | (from->flags & BITRAS));
+  invalidatecaches(L, to);  /* 'to' may now have metamethod fields */
 #if defined(LUAGLM_EXT_READONLY)
   to->readonly = 0;
 #endif
   if (isblack(obj2gco(to)))
     luaC_barrierback_(L, obj2gco(to));
 }
-#endif
+
+
+/*
+** Replace the table in 'slot' of 't' by a new copy of it, a template.
+*/
+static void copysubtemplate (lua_State *L, Table *t, Value *slot) {
+  const Table *tpl = gco2t(slot->gc);
+  Table *sub = luaH_new(L);
+  slot->gc = obj2gco(sub);  /* anchor new table in its parent */
+  luaC_objbarrier(L, t, sub);
+  luaH_copytemplate(L, tpl, sub);
+}
+
+
+/*
+** Make the new table 't' a copy of the template 'tpl', built by the
+** parser for a constructor with only constant fields. Tables inside a
+** template are templates for nested constructors, so they are copied
+** too.
+*/
+void luaH_copytemplate (lua_State *L, const Table *tpl, Table *t) {
+  unsigned int i;
+  unsigned int asize;
+  luaH_clonetable(L, tpl, t);
+  asize = luaH_realasize(t);
+  for (i = 0; i < asize; i++) {
+    if (*getArrTag(t, i) == ctb(LUA_VTABLE))
+      copysubtemplate(L, t, getArrVal(t, i));
+  }
+  if (!isdummy(t)) {
+    Node *n, *limit = gnode(t, cast_sizet(sizenode(t)));
+    for (n = gnode(t, 0); n < limit; n++) {
+      if (ttistable(gval(n)))
+        copysubtemplate(L, t, &gval(n)->value_);
+    }
+  }
+}
 
 
 #if defined(LUA_DEBUG)
 
 /* export these functions for the test library */
 
+#if defined(LUA_SWISS_TABLES)
+
+/* a Swiss hash part has no main positions: use the first of the group */
+Node *luaH_mainposition (const Table *t, const TValue *key) {
+  return gnode(t, hashgroup(t, hashkey(key)) * GROUPSIZE);
+}
+
+#else
+
 Node *luaH_mainposition (const Table *t, const TValue *key) {
   return mainpositionTV(t, key);
 }
 
+#endif
+
 int luaH_isdummy (const Table *t) { return isdummy(t); }
 
 #endif
@@ -8,6 +8,7 @@
 #define ltable_h
 
 #include "lobject.h"
+#include "ltm.h"
 
 
 #define gnode(t,i)	(&(t)->node[i])
@@ -23,8 +24,22 @@
 #define invalidateTMcache(t)	((t)->flags &= ~maskflags)
 
 
+/*
+** Invalidate the caches that depend on the keys of 't' after it may
+** have gained new keys: its TM cache and, when 't' is part of a cached
+** '__index' chain (BITCHAIN), all cached chains.
+*/
+#define invalidatecaches(L,t) \
+  { if (l_unlikely((t)->flags & BITCHAIN)) luaT_invalidatechains(L); \
+    invalidateTMcache(t); }
+
+
 /* true when 't' is using 'dummynode' as its hash part */
+#if defined(LUA_SWISS_TABLES)
+#define isdummy(t)		((t)->ctrl == NULL)
+#else
 #define isdummy(t)		((t)->lastfree == NULL)
+#endif
 
 
 /* allocated size for hash nodes */
@@ -35,24 +50,130 @@
 #define nodefromval(v)	cast(Node *, (v))
 
 
-LUAI_FUNC const TValue *luaH_getint (Table *t, lua_Integer key);
+/*
+** Results of the "pre-set" functions ('luaH_pset*'). HOK means the
+** value was stored; HNOTFOUND means the key is absent; HNOTATABLE and
+** HREADONLY are used by the VM for values that are not tables and for
+** readonly tables (which are not written by the fast track). Larger
+** values encode the node where the key is present with an empty value
+** ('HFIRSTNODE' plus its index), and negative values encode an empty
+** entry 'i' of the array part as '~i'. Those cases need
+** 'luaH_finishset'.
+*/
+#define HOK		0
+#define HNOTFOUND	1
+#define HNOTATABLE	2
+#define HREADONLY	3
+#define HFIRSTNODE	4
+
+
+/*
+** Tag and value of entry 'i' (0-based) of the array part. (See the
+** layout of the array part in 'Table'.)
+*/
+#define getArrTag(t,i)	(cast(lu_byte*, (t)->array) + (i))
+#define getArrVal(t,i)	((t)->array - 1 - (i))
+
+/* move values between the array part and a 'TValue' */
+#define arr2obj(h,i,o)  \
+  ((o)->tt_ = *getArrTag(h,(i)), (o)->value_ = *getArrVal(h,(i)))
+
+#define obj2arr(h,i,o)  \
+  (*getArrTag(h,(i)) = (o)->tt_, *getArrVal(h,(i)) = (o)->value_)
+
+/* same, when the tag (or its address) is already known */
+#define farr2val(h,i,tag,res)  \
+  ((res)->tt_ = (tag), (res)->value_ = *getArrVal(h,(i)))
+
+#define fval2arr(h,i,ptag,o)  \
+  (*(ptag) = (o)->tt_, *getArrVal(h,(i)) = (o)->value_)
+
+
+/*
+** Fast track for 'luaH_getint': put 't[k]' into 'res' and its tag into
+** 'tag'. ('res' is not changed when 'tag' is empty.)
+*/
+#define luaH_fastgeti(t,k,res,tag) \
+  { Table *h_ = (t); lua_Unsigned u_ = l_castS2U(k) - 1u; \
+    if (u_ < h_->alimit) { \
+      tag = *getArrTag(h_, u_); \
+      if (!tagisempty(tag)) { farr2val(h_, u_, tag, res); }} \
+    else { tag = luaH_getint(h_, (k), res); }}
+
+
+/*
+** Fast track for 'luaH_psetint'. An empty entry in the array part can
+** be filled directly when the table has no '__newindex' metamethod.
+*/
+#define luaH_fastseti(t,k,val,hres) \
+  { Table *h_ = (t); lua_Unsigned u_ = l_castS2U(k) - 1u; \
+    if (u_ < h_->alimit) { \
+      lu_byte *tag_ = getArrTag(h_, u_); \
+      if (!tagisempty(*tag_) || checknoTM(h_->metatable, TM_NEWINDEX)) \
+        { fval2arr(h_, u_, tag_, val); hres = HOK; } \
+      else hres = ~cast_int(u_); } \
+    else { hres = luaH_psetint(h_, k, val); }}
+
+
+/*
+** Inline caches (see 'luaF_initcache'): 'hint' is valid for short
+** string 'k' when node 'hint' of 't' holds that key.
+*/
+#define luaH_hintok(t,k,hint)  \
+  ((hint) < cast_uint(sizenode(t)) && keyisshrstr(gnode(t, hint)) && \
+   keystrval(gnode(t, hint)) == (k))
+
+
+/*
+** Fast tracks for 'luaH_getshortstr' and 'luaH_psetshortstr' with an
+** inline cache 'hint', which is updated when the key is not where the
+** hint says.
+*/
+#define luaH_fastgetshortstr(t,k,res,hint,tag) \
+  { Table *h_ = (t); unsigned int s_ = (hint); \
+    if (luaH_hintok(h_, k, s_) && !isempty(gval(gnode(h_, s_)))) { \
+      const TValue *v_ = gval(gnode(h_, s_)); \
+      tag = ttypetag(v_); setobj(cast(lua_State *, NULL), res, v_); } \
+    else { tag = luaH_getshortstrhint(h_, k, res, &(hint)); }}
+
+#define luaH_fastsetshortstr(t,k,val,hint,hres) \
+  { Table *h_ = (t); unsigned int s_ = (hint); \
+    if (luaH_hintok(h_, k, s_) && !isempty(gval(gnode(h_, s_)))) \
+      { setobj(cast(lua_State *, NULL), gval(gnode(h_, s_)), val); \
+        hres = HOK; } \
+    else { hres = luaH_psetshortstrhint(h_, k, val, &(hint)); }}
+
+
+LUAI_FUNC lu_byte luaH_getint (Table *t, lua_Integer key, TValue *res);
+LUAI_FUNC lu_byte luaH_getshortstr (Table *t, TString *key, TValue *res);
+LUAI_FUNC lu_byte luaH_getstr (Table *t, TString *key, TValue *res);
+LUAI_FUNC lu_byte luaH_get (Table *t, const TValue *key, TValue *res);
+LUAI_FUNC lu_byte luaH_getshortstrhint (Table *t, TString *key, TValue *res,
+                                                  unsigned int *hint);
+LUAI_FUNC const TValue *luaH_Hgetshortstr (Table *t, TString *key);
+LUAI_FUNC const TValue *luaH_Hgetstr (Table *t, TString *key);
+LUAI_FUNC int luaH_psetint (Table *t, lua_Integer key, TValue *val);
+LUAI_FUNC int luaH_psetshortstr (Table *t, TString *key, TValue *val);
+LUAI_FUNC int luaH_psetshortstrhint (Table *t, TString *key, TValue *val,
+                                                unsigned int *hint);
+LUAI_FUNC int luaH_psetstr (Table *t, TString *key, TValue *val);
+LUAI_FUNC int luaH_pset (Table *t, const TValue *key, TValue *val);
 LUAI_FUNC void luaH_setint (lua_State *L, Table *t, lua_Integer key,
                                                     TValue *value);
-LUAI_FUNC const TValue *luaH_getshortstr (Table *t, TString *key);
-LUAI_FUNC const TValue *luaH_getstr (Table *t, TString *key);
-LUAI_FUNC const TValue *luaH_get (Table *t, const TValue *key);
 LUAI_FUNC void luaH_newkey (lua_State *L, Table *t, const TValue *key,
                                                     TValue *value);
 LUAI_FUNC void luaH_set (lua_State *L, Table *t, const TValue *key,
                                                  TValue *value);
 LUAI_FUNC void luaH_finishset (lua_State *L, Table *t, const TValue *key,
-                                       const TValue *slot, TValue *value);
+                                              TValue *value, int hres);
 LUAI_FUNC Table *luaH_new (lua_State *L);
 LUAI_FUNC void luaH_resize (lua_State *L, Table *t, unsigned int nasize,
                                                     unsigned int nhsize);
 LUAI_FUNC void luaH_resizearray (lua_State *L, Table *t, unsigned int nasize);
 LUAI_FUNC void luaH_free (lua_State *L, Table *t);
 LUAI_FUNC int luaH_next (lua_State *L, Table *t, StkId key);
+LUAI_FUNC int luaH_nextcursor (lua_State *L, Table *t, StkId key,
+                                             unsigned int *cursor);
 LUAI_FUNC lua_Unsigned luaH_getn (Table *t);
 LUAI_FUNC unsigned int luaH_realasize (const Table *t);
 #if defined(LUAGLM_EXT_READONLY)
@@ -62,8 +183,9 @@ LUAI_FUNC void luaH_setreadonly (Table *t, int readonly);
 LUAI_FUNC int luaH_type (const Table *t);
 LUAI_FUNC void luaH_wipetable (lua_State *L, Table *t);
 LUAI_FUNC void luaH_compact (lua_State *L, Table *t);
-LUAI_FUNC void luaH_clonetable (lua_State *L, const Table *t, Table *t2);
 #endif
+LUAI_FUNC void luaH_clonetable (lua_State *L, const Table *t, Table *t2);
+LUAI_FUNC void luaH_copytemplate (lua_State *L, const Table *tpl, Table *t);
 
 
 #if defined(LUA_DEBUG)
@@ -0,0 +1,136 @@
+/*
+** $Id: ltailcall.h $
+** Tail-call threaded code for the Lua interpreter
+** See Copyright Notice in lua.h
+*/
+
+/*
+** With LUA_USE_TAILCALL, each 'vmcase' of 'luaV_execute' becomes a
+** function of its own, and each instruction ends with a tail call to
+** the function of the next one. The state of the interpreter ('L',
+** 'ci', 'pc', 'base', 'k', and 'trap') goes in the arguments of these
+** functions, so that it lives in registers across instructions; 'i',
+** 'ra', and 'cl' are recomputed by each function.
+**
+** Each 'vmcase' closes the function of the previous case. (The first
+** one closes the block after 'vmdispatch' and the function that runs
+** the first instruction, like 'ljumptab.h' leaves that block dead.)
+*/
+
+#undef vmfetch
+#undef vmdispatch
+#undef vmcase
+#undef vmbreak
+#undef vmgoto
+#undef vmlabel
+#undef vmfused
+#undef vmexec
+
+
+/*
+** Without 'musttail', the C stack grows with each instruction unless
+** the compiler optimizes sibling calls (e.g., gcc -O2).
+*/
+#if defined(__has_attribute)
+#if __has_attribute(musttail)
+#define l_musttail	__attribute__((musttail))
+#endif
+#endif
+
+#if !defined(l_musttail)
+#if defined(__GNUC__) && !defined(__OPTIMIZE__)
+#error "LUA_USE_TAILCALL needs 'musttail' or an optimized build (-O2)"
+#endif
+#define l_musttail	/* empty */
+#endif
+
+/* keep rare paths out of the functions of the opcodes */
+#if defined(__GNUC__)
+#define l_noinline	__attribute__((noinline))
+#else
+#define l_noinline	/* empty */
+#endif
+
+
+#define vmargs	lua_State *L, CallInfo *ci, const Instruction *pc, \
+		StkId base, TValue *k, int trap
+
+#define vmtail(f)	l_musttail return (f)(L, ci, pc, base, k, trap)
+
+#define vmprologue  \
+	Instruction i = pc[-1];  /* instruction being executed */  \
+	StkId ra = RA(i);  /* instruction's A register */  \
+	LClosure *cl = clLvalue(s2v(ci->func));  \
+	cast_void(ra); cast_void(cl);  \
+	lua_assert(base == ci->func + 1);  \
+	lua_assert(base <= L->top && L->top < L->stack_last);  \
+	lua_assert(isIT(i) || (cast_void(L->top = base), 1));
+
+/* hooks go to 'vm_hook', so that most opcodes call no functions */
+#define vmfetch()	{ \
+  if (l_unlikely(trap))  /* stack reallocation or hooks? */ \
+    vmtail(vm_hook); \
+  luai_execop(pc); \
+  i = *(pc++); \
+  ra = RA(i); /* WARNING: any stack reallocation invalidates 'ra' */ \
+}
+
+#define vmdispatch(x)	vmtail(disptab[x]);
+
+#define vmcase(l)	} } static void vm_##l (vmargs) { vmprologue {
+
+#define vmbreak		vmfetch(); vmdispatch(GET_OPCODE(i));
+
+#define vmgoto(l)	vmtail(vm_##l)
+
+#define vmlabel(l)	/* empty */
+
+#define vmfused(l)	/* empty */
+
+#define vmexec(l)	vmtail(vm_##l)
+
+
+typedef void (*VMHandler) (vmargs);
+
+
+#if defined(LUAGLM_EXT_DEFER)
+#define vmdefer(X)	X(OP_DEFER)
+#else
+#define vmdefer(X)	/* empty */
+#endif
+
+/* all opcodes, in the order of 'lopcodes.h' */
+#define vmopcodes(X)  \
+  X(OP_MOVE) X(OP_LOADI) X(OP_LOADF) X(OP_LOADK) X(OP_LOADKX)  \
+  X(OP_LOADFALSE) X(OP_LFALSESKIP) X(OP_LOADTRUE) X(OP_LOADNIL)  \
+  X(OP_GETUPVAL) X(OP_SETUPVAL) X(OP_GETTABUP) X(OP_GETTABLE) X(OP_GETI)  \
+  X(OP_GETFIELD) X(OP_SETTABUP) X(OP_SETTABLE) X(OP_SETI) X(OP_SETFIELD)  \
+  X(OP_NEWTABLE) X(OP_SELF) X(OP_ADDI) X(OP_ADDK) X(OP_SUBK) X(OP_MULK)  \
+  X(OP_MODK) X(OP_POWK) X(OP_DIVK) X(OP_IDIVK) X(OP_BANDK) X(OP_BORK)  \
+  X(OP_BXORK) X(OP_SHRI) X(OP_SHLI) X(OP_ADD) X(OP_SUB) X(OP_MUL)  \
+  X(OP_MOD) X(OP_POW) X(OP_DIV) X(OP_IDIV) X(OP_BAND) X(OP_BOR)  \
+  X(OP_BXOR) X(OP_SHL) X(OP_SHR) X(OP_MMBIN) X(OP_MMBINI) X(OP_MMBINK)  \
+  X(OP_UNM) X(OP_BNOT) X(OP_NOT) X(OP_LEN) X(OP_CONCAT) X(OP_CLOSE)  \
+  X(OP_TBC) X(OP_JMP) X(OP_EQ) X(OP_LT) X(OP_LE) X(OP_EQK) X(OP_EQI)  \
+  X(OP_LTI) X(OP_LEI) X(OP_GTI) X(OP_GEI) X(OP_TEST) X(OP_TESTSET)  \
+  X(OP_CALL) X(OP_TAILCALL) X(OP_RETURN) X(OP_RETURN0) X(OP_RETURN1)  \
+  X(OP_FORLOOP) X(OP_FORPREP) X(OP_TFORPREP) X(OP_TFORCALL)  \
+  X(OP_TFORLOOP) X(OP_SETLIST) X(OP_CLOSURE) vmdefer(X) X(OP_VARARG)  \
+  X(OP_VARARGPREP) X(OP_EXTRAARG) X(OP_MOVE_CALL) X(OP_LOADI_CALL)  \
+  X(OP_GETTABLE_CALL) X(OP_SELF_CALL) X(OP_GETUPVAL_GETTABLE)  \
+  X(OP_MOVE_GETTABLE) X(OP_GETTABUP_GETFIELD) X(OP_GETFIELD_GETFIELD)  \
+  X(OP_MUL_ADD) X(OP_MODK_EQI)
+
+#define vmproto(l)	static void vm_##l (vmargs);
+#define vmentry(l)	vm_##l,
+
+static void vm_startfunc (vmargs);
+static void vm_returning (vmargs);
+static void vm_ret (vmargs);
+static l_noinline void vm_hook (vmargs);
+vmopcodes(vmproto)
+
+static const VMHandler disptab[NUM_OPCODES] = {
+  vmopcodes(vmentry)
+};
+
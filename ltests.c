@@ -316,6 +316,11 @@ static void printobj (global_State *g, GCObject *o) {
            ttypename(novariant(o->tt)), (void *)o,
            isdead(g,o) ? 'd' : isblack(o) ? 'b' : iswhite(o) ? 'w' : 'g',
            "ns01oTt"[getage(o)], o->marked);
+#if defined(LUAGLM_EXT_SLICE)
+  if (o->tt == LUA_VSLCSTR)  /* not zero-terminated */
+    printf(" '%.*s'", (int)gco2ts(o)->u.lnglen, getstr(gco2ts(o)));
+  else
+#endif
 #if defined(LUAGLM_EXT_BLOB)
   if (novariant((o)->tt) == LUA_TSTRING)
 #else
@@ -367,8 +372,11 @@ static void checktable (global_State *g, Table *h) {
   Node *n, *limit = gnode(h, sizenode(h));
   GCObject *hgc = obj2gco(h);
   checkobjrefN(g, hgc, h->metatable);
-  for (i = 0; i < asize; i++)
-    checkvalref(g, hgc, &h->array[i]);
+  for (i = 0; i < asize; i++) {
+    TValue aux;
+    arr2obj(h, i, &aux);
+    checkvalref(g, hgc, &aux);
+  }
   for (n = gnode(h, 0); n < limit; n++) {
     if (!isempty(gval(n))) {
       TValue k;
@@ -393,6 +401,7 @@ static void checkudata (global_State *g, Udata *u) {
 static void checkproto (global_State *g, Proto *f) {
   int i;
   GCObject *fgc = obj2gco(f);
+  checkobjrefN(g, fgc, f->cache);
   checkobjrefN(g, fgc, f->source);
   for (i=0; i<f->sizek; i++) {
     if (iscollectable(f->k + i))
@@ -502,6 +511,13 @@ static void checkrefs (global_State *g, GCObject *o) {
       assert(!isgray(o));  /* strings are never gray */
       break;
     }
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR: {
+      assert(!isgray(o));  /* strings are never gray */
+      checkobjref(g, o, obj2gco(getslice(gco2ts(o))->parent));
+      break;
+    }
+#endif
     default: assert(0);
   }
 }
@@ -770,6 +786,63 @@ static int printcode (lua_State *L) {
 }
 
 
+/*
+** Opcode pairs: 'l_countop' is called by the VM before each instruction
+** it executes, and counts it with the previous one when both are
+** consecutive in the same function (or only an OP_MMBIN* that was
+** skipped lies between them). Pairs across calls, returns, and jumps
+** cannot be fused, so they do not count. Superinstructions count as
+** the opcodes that they replace.
+*/
+static struct {
+  const Instruction *lastpc;
+  unsigned long count[NUM_OPCODES][NUM_OPCODES];
+} oppairs;
+
+
+void l_countop (const void *pc) {
+  const Instruction *i = cast(const Instruction *, pc);
+  const Instruction *last = oppairs.lastpc;
+  if (last != NULL && (i == last + 1 ||
+      (i == last + 2 && testMMMode(GET_OPCODE(last[1]))))) {
+    OpCode o1 = getBaseOp(GET_OPCODE(*last));
+    OpCode o2 = getBaseOp(GET_OPCODE(*i));
+    oppairs.count[o1][o2]++;
+  }
+  oppairs.lastpc = i;
+}
+
+
+/*
+** Return a table with the counts of the pairs executed since the last
+** call, keyed by "OPCODE1 OPCODE2", and reset the counts. Also return
+** a set with the pairs that have superinstructions.
+*/
+static int listoppairs (lua_State *L) {
+  int o1, o2, s;
+  lua_newtable(L);
+  for (o1 = 0; o1 < NUM_OPCODES; o1++) {
+    for (o2 = 0; o2 < NUM_OPCODES; o2++) {
+      if (oppairs.count[o1][o2] > 0) {
+        lua_pushfstring(L, "%s %s", opnames[o1], opnames[o2]);
+        lua_pushinteger(L, cast(lua_Integer, oppairs.count[o1][o2]));
+        lua_rawset(L, -3);
+        oppairs.count[o1][o2] = 0;
+      }
+    }
+  }
+  oppairs.lastpc = NULL;
+  lua_newtable(L);
+  for (s = 0; s < NUM_OPCODES - NUM_BASEOPS; s++) {
+    lua_pushfstring(L, "%s %s", opnames[luaP_superops[s][0]],
+                                opnames[luaP_superops[s][1]]);
+    lua_pushboolean(L, 1);
+    lua_rawset(L, -3);
+  }
+  return 2;
+}
+
+
 static int listk (lua_State *L) {
   Proto *p;
   int i;
@@ -1008,13 +1081,19 @@ static int table_query (lua_State *L) {
   if (i == -1) {
     lua_pushinteger(L, asize);
     lua_pushinteger(L, allocsizenode(t));
+#if defined(LUA_SWISS_TABLES)
+    lua_pushinteger(L, t->growthleft);
+#else
     lua_pushinteger(L, isdummy(t) ? 0 : t->lastfree - t->node);
+#endif
     lua_pushinteger(L, t->alimit);
     return 4;
   }
   else if ((unsigned int)i < asize) {
+    TValue aux;
+    arr2obj(t, i, &aux);
     lua_pushinteger(L, i);
-    pushobject(L, &t->array[i]);
+    pushobject(L, &aux);
     lua_pushnil(L);
   }
   else if ((i -= asize) < sizenode(t)) {
@@ -1028,10 +1107,14 @@ static int table_query (lua_State *L) {
     else
       lua_pushliteral(L, "<undef>");
     pushobject(L, gval(gnode(t, i)));
+#if defined(LUA_SWISS_TABLES)
+    lua_pushnil(L);  /* no chains in a Swiss hash part */
+#else
     if (gnext(&t->node[i]) != 0)
       lua_pushinteger(L, gnext(&t->node[i]));
     else
       lua_pushnil(L);
+#endif
   }
   return 3;
 }
@@ -2039,6 +2122,7 @@ static const struct luaL_Reg tests_funcs[] = {
   {"listk", listk},
   {"listabslineinfo", listabslineinfo},
   {"listlocals", listlocals},
+  {"oppairs", listoppairs},
   {"loadlib", loadlib},
   {"checkpanic", checkpanic},
   {"newstate", newstate},
@@ -2083,6 +2167,10 @@ int luaB_opentests (lua_State *L) {
   lua_assert(f == debug_realloc && ud == cast_voidp(&l_memcontrol));
   lua_setallocf(L, f, ud);  /* exercise this function */
   luaL_newlib(L, tests_funcs);
+#if defined(LUA_SWISS_TABLES)
+  lua_pushboolean(L, 1);
+  lua_setfield(L, -2, "swisstables");  /* hash parts have other sizes */
+#endif
   return 1;
 }
 
@@ -64,6 +64,14 @@ LUA_API Memcontrol l_memcontrol;
 extern void *l_Trick;
 
 
+/*
+** Count pairs of consecutive instructions executed by the VM
+** (see 'T.oppairs')
+*/
+#define luai_execop(pc)		l_countop(pc)
+LUAI_FUNC void l_countop (const void *pc);
+
+
 
 /*
 ** Function to traverse and check all memory used by Lua
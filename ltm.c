@@ -19,6 +19,7 @@
 #include "lgc.h"
 #include "lobject.h"
 #include "lglm_core.h"
+#include "lmem.h"
 #include "lstate.h"
 #include "lstring.h"
 #include "ltable.h"
@@ -59,7 +60,7 @@ void luaT_init (lua_State *L) {
 ** tag methods
 */
 const TValue *luaT_gettm (Table *events, TMS event, TString *ename) {
-  const TValue *tm = luaH_getshortstr(events, ename);
+  const TValue *tm = luaH_Hgetshortstr(events, ename);
   lua_assert(event <= TM_EQ);
   if (notm(tm)) {  /* no tag method? */
     events->flags |= cast_byte(1u<<event);  /* cache this fact */
@@ -82,10 +83,183 @@ const TValue *luaT_gettmbyobj (lua_State *L, const TValue *o, TMS event) {
       mt = G(L)->mt[ttype(o)];
       break;
   }
-  return (mt ? luaH_getshortstr(mt, G(L)->tmname[event]) : &G(L)->nilvalue);
+  return (mt ? luaH_Hgetshortstr(mt, G(L)->tmname[event]) : &G(L)->nilvalue);
 }
 
 
+/*
+** {==================================================================
+** Cache of '__index' chains
+** ===================================================================
+*/
+
+/* size of the cache (must be a power of 2) */
+#define CHAINCACHESIZE	128
+
+/* maximum number of metatables in a cached chain */
+#define MAXCHAIN	4
+
+/* 'node' of a chain where the key was not found */
+#define CHAINABSENT	(~0u)
+
+
+/*
+** A cached search for a short string 'key' along the '__index' chain of
+** tables with metatable 'mt[0]': 't[i]' is the '__index' field of
+** 'mt[i]', stored in node 'tmnode[i]' of that metatable, and 'mt[i+1]'
+** is the metatable of 't[i]'. The search ends in node 'node' of
+** 't[depth - 1]' or, when 'node' is CHAINABSENT, with no '__index' in
+** 'mt[depth]'.
+**
+** An entry is used only while 'epoch' is the current 'chainepoch', that
+** is, while no table in the chain gained new keys (which could shadow
+** 'key') or was freed (whose address could be reused), and while no
+** garbage collection ended (nothing marks 'key', so another string could
+** reuse its address). Overwriting an existing field keeps the epoch, so
+** each use also checks the '__index' fields and metatables of the chain
+** through their nodes, without hashing.
+*/
+typedef struct IndexChain {
+  Table *mt[MAXCHAIN + 1];
+  Table *t[MAXCHAIN];
+  unsigned int tmnode[MAXCHAIN];
+  TString *key;
+  unsigned int node;
+  unsigned int epoch;
+  int depth;
+} IndexChain;
+
+
+#define chainslot(g,mt,key)  \
+  (&(g)->chaincache[((point2uint(mt) >> 4) ^ (key)->hash) & \
+                    (CHAINCACHESIZE - 1)])
+
+
+/*
+** Check whether chain 'c' is still valid for 'key', returning the slot
+** with the value of 'key' (or NULL when the chain changed).
+*/
+static const TValue *checkchain (global_State *g, const IndexChain *c,
+                                  TString *key) {
+  TString *ename = g->tmname[TM_INDEX];
+  int i;
+  for (i = 0; i < c->depth; i++) {
+    Table *mt = c->mt[i];
+    unsigned int n = c->tmnode[i];
+    const TValue *tm;
+    if (!luaH_hintok(mt, ename, n))
+      return NULL;  /* '__index' moved or removed */
+    tm = gval(gnode(mt, n));
+    if (!ttistable(tm) || hvalue(tm) != c->t[i] ||
+        c->t[i]->metatable != c->mt[i + 1])
+      return NULL;  /* chain changed */
+  }
+  if (c->node == CHAINABSENT)
+    return &g->nilvalue;
+  else {
+    Table *h = c->t[c->depth - 1];
+    if (!luaH_hintok(h, key, c->node) || isempty(gval(gnode(h, c->node))))
+      return NULL;  /* key moved or removed */
+    return gval(gnode(h, c->node));
+  }
+}
+
+
+/*
+** Search 'key' along the '__index' chain of 'h', as long as that chain
+** goes through tables, and fill entry 'c' with that search. Return the
+** slot with the value of 'key', or NULL when the search cannot be
+** cached ('__index' functions and long chains).
+*/
+static const TValue *fillchain (lua_State *L, IndexChain *c, Table *h,
+                                TString *key) {
+  const TValue *slot;
+  Table *mt = h->metatable;
+  int d = 0;
+  for (;;) {
+    const TValue *tm = fasttm(L, mt, TM_INDEX);
+    c->mt[d] = mt;
+    if (tm == NULL) {  /* end of the chain? */
+      if (d == 0)
+        return NULL;  /* no chain */
+      c->node = CHAINABSENT;
+      slot = &G(L)->nilvalue;
+      break;
+    }
+    else if (d == MAXCHAIN || !ttistable(tm))
+      return NULL;  /* cannot cache this chain */
+    c->tmnode[d] = cast_uint(nodefromval(tm) - gnode(mt, 0));
+    c->t[d] = hvalue(tm);
+    slot = luaH_Hgetshortstr(c->t[d], key);
+    mt = c->t[d]->metatable;
+    if (!isempty(slot)) {  /* found 'key'? */
+      c->node = cast_uint(nodefromval(slot) - gnode(c->t[d], 0));
+      c->mt[++d] = mt;
+      break;
+    }
+    d++;
+  }
+  c->key = key;
+  c->depth = d;
+  c->epoch = G(L)->chainepoch;
+  while (d-- > 0) {  /* mark the tables in the chain */
+    c->mt[d]->flags |= BITCHAIN;
+    c->t[d]->flags |= BITCHAIN;
+  }
+  if (c->node == CHAINABSENT && c->mt[c->depth] != NULL)
+    c->mt[c->depth]->flags |= BITCHAIN;  /* it must not gain an '__index' */
+  return slot;
+}
+
+
+/*
+** Get the value of short string 'key', which is absent from table 'h',
+** through the '__index' chain of 'h' into 'res'. Return 0 when that
+** chain goes through functions (or is too long), so that the caller
+** must do the search itself.
+*/
+int luaT_indexchain (lua_State *L, Table *h, TString *key, TValue *res) {
+  global_State *g = G(L);
+  IndexChain *c;
+  const TValue *slot;
+  if (l_unlikely(g->chaincache == NULL)) {  /* first use? */
+    g->chaincache = luaM_newvector(L, CHAINCACHESIZE, IndexChain);
+    luaT_clearchaincache(L);
+  }
+  c = chainslot(g, h->metatable, key);
+  if (c->key == key && c->mt[0] == h->metatable && c->epoch == g->chainepoch &&
+      (slot = checkchain(g, c, key)) != NULL) {
+    setobj(L, res, slot);  /* cache hit */
+    return 1;
+  }
+  c->key = NULL;  /* entry will be refilled */
+  slot = fillchain(L, c, h, key);
+  if (slot == NULL)
+    return 0;
+  setobj(L, res, slot);
+  return 1;
+}
+
+
+void luaT_clearchaincache (lua_State *L) {
+  global_State *g = G(L);
+  if (g->chaincache != NULL) {
+    int i;
+    for (i = 0; i < CHAINCACHESIZE; i++)
+      g->chaincache[i].key = NULL;
+  }
+}
+
+
+void luaT_freechaincache (lua_State *L) {
+  global_State *g = G(L);
+  if (g->chaincache != NULL)
+    luaM_freearray(L, g->chaincache, CHAINCACHESIZE);
+}
+
+/* }================================================================== */
+
+
 /*
 ** Return the name of the type of an object. For tables and userdata
 ** with metatable, use their '__name' metafield, if present.
@@ -94,8 +268,12 @@ const char *luaT_objtypename (lua_State *L, const TValue *o) {
   Table *mt;
   if ((ttistable(o) && (mt = hvalue(o)->metatable) != NULL) ||
       (ttisfulluserdata(o) && (mt = uvalue(o)->metatable) != NULL)) {
-    const TValue *name = luaH_getshortstr(mt, luaS_new(L, "__name"));
+    const TValue *name = luaH_Hgetshortstr(mt, luaS_new(L, "__name"));
+#if defined(LUAGLM_EXT_SLICE)
+    if (ttisstring(name) && !ttisslicestring(name))  /* zero-terminated? */
+#else
     if (ttisstring(name))  /* is '__name' a string? */
+#endif
       return getstr(tsvalue(name));  /* use it as type name */
   }
   return ttypename(ttype(o));  /* else use standard type name */
@@ -147,8 +325,13 @@ static int callbinTM (lua_State *L, const TValue *p1, const TValue *p2,
 }
 
 
+/*
+** 'temp' tells that the result is an intermediate value that only the
+** next arithmetic operator consumes (see 'marktemp' in lcode.c), so
+** that a matrix created for it can be reused by that operator.
+*/
 void luaT_trybinTM (lua_State *L, const TValue *p1, const TValue *p2,
-                    StkId res, TMS event) {
+                    StkId res, TMS event, int temp) {
   /*
   ** For performance reasons, inlined unary/binary vector/quaternion/matrix
   ** operators take precedence over metamethods. This approach leaves the base
@@ -161,9 +344,11 @@ void luaT_trybinTM (lua_State *L, const TValue *p1, const TValue *p2,
   ** @TODO: Document above.
   */
   if (ttisvector(p1) || ttismatrix(p1) || ttisvector(p2) || ttismatrix(p2)) {
-    if (l_likely(glm_trybinTM(L, p1, p2, res, event))) {
+    if (l_likely(glm_trybinTM(L, p1, p2, res, event, temp))) {
       return;
     }
+    glm_escapemat(p1);  /* operands go to a metamethod */
+    glm_escapemat(p2);
   }
 
   if (l_unlikely(!callbinTM(L, p1, p2, res, event))) {
@@ -198,19 +383,20 @@ void luaT_tryconcatTM (lua_State *L) {
 
 
 void luaT_trybinassocTM (lua_State *L, const TValue *p1, const TValue *p2,
-                                       int flip, StkId res, TMS event) {
+                                       int flip, StkId res, TMS event,
+                                       int temp) {
   if (flip)
-    luaT_trybinTM(L, p2, p1, res, event);
+    luaT_trybinTM(L, p2, p1, res, event, temp);
   else
-    luaT_trybinTM(L, p1, p2, res, event);
+    luaT_trybinTM(L, p1, p2, res, event, temp);
 }
 
 
 void luaT_trybiniTM (lua_State *L, const TValue *p1, lua_Integer i2,
-                                   int flip, StkId res, TMS event) {
+                                   int flip, StkId res, TMS event, int temp) {
   TValue aux;
   setivalue(&aux, i2);
-  luaT_trybinassocTM(L, p1, &aux, flip, res, event);
+  luaT_trybinassocTM(L, p1, &aux, flip, res, event, temp);
 }
 
 
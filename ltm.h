@@ -50,12 +50,20 @@ typedef enum {
 /*
 ** Mask with 1 in all fast-access methods. A 1 in any of these bits
 ** in the flag of a (meta)table means the metatable does not have the
-** corresponding metamethod field. (Bit 7 of the flag is used for
-** 'isrealasize'.)
+** corresponding metamethod field. (Bit 6 of the flag is used for
+** BITCHAIN and bit 7 for 'isrealasize'.)
 */
 #define maskflags	(~(~0u << (TM_EQ + 1)))
 
 
+/*
+** Bit of 'flags' set in tables that are part of a cached '__index'
+** chain (see 'luaT_indexchain'). Adding keys to such a table, or
+** freeing it, drops all cached chains.
+*/
+#define BITCHAIN	(1 << 6)
+
+
 /*
 ** Test whether there is no tagmethod.
 ** (Because tagmethods use raw accesses, the result may be an "empty" nil.)
@@ -63,19 +71,38 @@ typedef enum {
 #define notm(tm)	ttisnil(tm)
 
 
-#define gfasttm(g,et,e) ((et) == NULL ? NULL : \
-  ((et)->flags & (1u<<(e))) ? NULL : luaT_gettm(et, e, (g)->tmname[e]))
+/*
+** Test whether there is no tagmethod. (A false result only means that
+** the absence of the tagmethod is not cached.)
+*/
+#define checknoTM(mt,e)	((mt) == NULL || (mt)->flags & (1u<<(e)))
+
+#define gfasttm(g,et,e)  \
+  (checknoTM(et, e) ? NULL : luaT_gettm(et, e, (g)->tmname[e]))
 
 #define fasttm(l,et,e)	gfasttm(G(l), et, e)
 
 #define ttypename(x)	luaT_typenames_[(x) + 1]
 
+
+/*
+** Invalidate all cached '__index' chains (see 'luaT_indexchain'). When
+** the epoch wraps around, old entries could match it again, so they are
+** cleared.
+*/
+#define luaT_invalidatechains(L) \
+  { if (l_unlikely(++G(L)->chainepoch == 0)) luaT_clearchaincache(L); }
+
 LUAI_DDEC(const char *const luaT_typenames_[LUA_TOTALTYPES];)
 
 
 LUAI_FUNC const char *luaT_objtypename (lua_State *L, const TValue *o);
 
 LUAI_FUNC const TValue *luaT_gettm (Table *events, TMS event, TString *ename);
+LUAI_FUNC int luaT_indexchain (lua_State *L, Table *h, TString *key,
+                                             TValue *res);
+LUAI_FUNC void luaT_freechaincache (lua_State *L);
+LUAI_FUNC void luaT_clearchaincache (lua_State *L);
 LUAI_FUNC const TValue *luaT_gettmbyobj (lua_State *L, const TValue *o,
                                                        TMS event);
 LUAI_FUNC void luaT_init (lua_State *L);
@@ -85,12 +112,12 @@ LUAI_FUNC void luaT_callTM (lua_State *L, const TValue *f, const TValue *p1,
 LUAI_FUNC void luaT_callTMres (lua_State *L, const TValue *f,
                             const TValue *p1, const TValue *p2, StkId p3);
 LUAI_FUNC void luaT_trybinTM (lua_State *L, const TValue *p1, const TValue *p2,
-                              StkId res, TMS event);
+                              StkId res, TMS event, int temp);
 LUAI_FUNC void luaT_tryconcatTM (lua_State *L);
 LUAI_FUNC void luaT_trybinassocTM (lua_State *L, const TValue *p1,
-       const TValue *p2, int inv, StkId res, TMS event);
+       const TValue *p2, int inv, StkId res, TMS event, int temp);
 LUAI_FUNC void luaT_trybiniTM (lua_State *L, const TValue *p1, lua_Integer i2,
-                               int inv, StkId res, TMS event);
+                               int inv, StkId res, TMS event, int temp);
 LUAI_FUNC int luaT_callorderTM (lua_State *L, const TValue *p1,
                                 const TValue *p2, TMS event);
 LUAI_FUNC int luaT_callorderiTM (lua_State *L, const TValue *p1, int v2,
@@ -32,6 +32,9 @@
 /* mark for precompiled code ('<esc>Lua') */
 #define LUA_SIGNATURE	"\x1bLua"
 
+/* option in the 'mode' of 'lua_load' to compile with optimizations */
+#define LUA_LOADOPTIMIZE	'O'
+
 /* option for multiple returns in 'lua_pcall' and 'lua_call' */
 #define LUA_MULTRET	(-1)
 
@@ -313,6 +316,36 @@ LUA_API char *(lua_tostringblob) (lua_State *L, int idx, size_t *len);
 LUA_API char *(lua_pushblob) (lua_State *L, size_t len);
 #endif
 
+/*
+** string slice API
+*/
+#if defined(LUAGLM_EXT_SLICE)
+/*
+** Pushes the 'len' characters of the string at the given index starting at
+** offset 'i'. Long results reference the original string instead of copying
+** it; they are converted to regular strings by lua_tolstring.
+*/
+LUA_API void (lua_pushslice) (lua_State *L, int idx, size_t i, size_t len);
+#endif
+
+/*
+** string buffer API
+*/
+#if defined(LUAGLM_EXT_BUILDER)
+/*
+** Resizes the string buffer 'buff' of 'osz' bytes to 'nsz' bytes, returning
+** its new address. A NULL buffer creates a new one; a zero 'nsz' frees it.
+*/
+LUA_API char *(lua_resizebuffer) (lua_State *L, char *buff, size_t osz, size_t nsz);
+
+/*
+** Pushes the first 'len' bytes of the string buffer 'buff' (of 'sz' bytes)
+** as a string. The buffer is consumed: long strings take ownership of its
+** memory instead of copying it.
+*/
+LUA_API const char *(lua_pushbuffer) (lua_State *L, char *buff, size_t sz, size_t len);
+#endif
+
 /*
 ** 'load' and 'call' functions (load and run Lua code)
 */
@@ -377,11 +410,28 @@ LUA_API int   (lua_error) (lua_State *L);
 
 LUA_API int   (lua_next) (lua_State *L, int idx);
 
+/*
+** Registers the iteration functions of 'pairs' ('next') and 'ipairs'.
+** Generic 'for' loops that use them over tables, vectors, and matrices
+** are run by the VM without calling them.
+*/
+LUA_API void  (lua_setiterators) (lua_State *L, lua_CFunction next,
+                                                lua_CFunction inext);
+
 LUA_API void  (lua_concat) (lua_State *L, int n);
 LUA_API void  (lua_len)    (lua_State *L, int idx);
 
 LUA_API size_t   (lua_stringtonumber) (lua_State *L, const char *s);
 
+/*
+** Write a number into 'buff' (of 'sz' bytes) with the semantics of 'snprintf'
+** and the formats LUA_INTEGER_FMT and "%.<prec><conv>" respectively. A zero
+** 'conv' uses the format of 'tostring'.
+*/
+LUA_API int      (lua_fmtinteger) (char *buff, size_t sz, lua_Integer n);
+LUA_API int      (lua_fmtnumber) (char *buff, size_t sz, int conv, int prec,
+                                  lua_Number n);
+
 LUA_API lua_Alloc (lua_getallocf) (lua_State *L, void **ud);
 LUA_API void      (lua_setallocf) (lua_State *L, lua_Alloc f, void *ud);
 
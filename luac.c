@@ -29,11 +29,13 @@ static void PrintFunction(const Proto* f, int full);
 #define luaU_print	PrintFunction
 
 #define PROGNAME	"luac"		/* default program name */
+#define OPTMODE	"btO"		/* load mode with LUA_LOADOPTIMIZE */
 #define OUTPUT		PROGNAME ".out"	/* default output file */
 
 static int listing=0;			/* list bytecodes? */
 static int dumping=1;			/* dump bytecodes? */
 static int stripping=0;			/* strip debug information? */
+static const char* mode=NULL;		/* load mode (optimize?) */
 static char Output[]={ OUTPUT };	/* default output file name */
 static const char* output=Output;	/* actual output file name */
 static const char* progname=PROGNAME;	/* actual program name */
@@ -62,6 +64,7 @@ static l_noret usage(const char* message)
   "Available options are:\n"
   "  -l       list (use -l -l for full listing)\n"
   "  -o name  output to file 'name' (default is \"%s\")\n"
+  "  -O       optimize (inline expansion and bytecode optimizations)\n"
   "  -p       parse only\n"
   "  -s       strip debug information\n"
   "  -v       show version information\n"
@@ -99,6 +102,8 @@ static int doargs(int argc, char* argv[])
     usage("'-o' needs argument");
    if (IS("-")) output=NULL;
   }
+  else if (IS("-O"))			/* optimize */
+   mode=OPTMODE;
   else if (IS("-p"))			/* parse only */
    dumping=0;
   else if (IS("-s"))			/* strip debug information */
@@ -177,7 +182,7 @@ static int pmain(lua_State* L)
  for (i=0; i<argc; i++)
  {
   const char* filename=IS("-") ? NULL : argv[i];
-  if (luaL_loadfile(L,filename)!=LUA_OK) fatal(lua_tostring(L,-1));
+  if (luaL_loadfilex(L,filename,mode)!=LUA_OK) fatal(lua_tostring(L,-1));
  }
  f=combine(L,argc);
  if (listing) luaU_print(f,listing>1);
@@ -285,6 +290,9 @@ static void PrintType(const Proto* f, int i)
   case LUA_VLNGSTR:
 	printf("S");
 	break;
+  case LUA_VTABLE:
+	printf("T");
+	break;
   default:				/* cannot happen */
 	printf("?%d",ttypetag(o));
 	break;
@@ -321,6 +329,9 @@ static void PrintConstant(const Proto* f, int i)
   case LUA_VLNGSTR:
 	PrintString(tsvalue(o));
 	break;
+  case LUA_VTABLE:
+	printf("{...}");
+	break;
   default:				/* cannot happen */
 	printf("?%d",ttypetag(o));
 	break;
@@ -353,7 +364,7 @@ static void PrintCode(const Proto* f)
   printf("\t%d\t",pc+1);
   if (line>0) printf("[%d]\t",line); else printf("[-]\t");
   printf("%-9s\t",opnames[o]);
-  switch (o)
+  switch (getBaseOp(o))
   {
    case OP_MOVE:
 	printf("%d %d",a,b);
@@ -429,96 +440,97 @@ static void PrintCode(const Proto* f)
 	break;
    case OP_NEWTABLE:
 	printf("%d %d %d",a,b,c);
-	printf(COMMENT "%d",c+EXTRAARGC);
+	if (b==TEMPLATEB) { printf(COMMENT); PrintConstant(f,EXTRAARG); }
+	else printf(COMMENT "%d",c+EXTRAARGC);
 	break;
    case OP_SELF:
 	printf("%d %d %d%s",a,b,c,ISK);
 	if (isk) { printf(COMMENT); PrintConstant(f,c); }
 	break;
    case OP_ADDI:
-	printf("%d %d %d",a,b,sc);
+	printf("%d %d %d%s",a,b,sc,ISK);
 	break;
    case OP_ADDK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_SUBK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_MULK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_MODK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_POWK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_DIVK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_IDIVK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_BANDK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_BORK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_BXORK:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	printf(COMMENT); PrintConstant(f,c);
 	break;
    case OP_SHRI:
-	printf("%d %d %d",a,b,sc);
+	printf("%d %d %d%s",a,b,sc,ISK);
 	break;
    case OP_SHLI:
-	printf("%d %d %d",a,b,sc);
+	printf("%d %d %d%s",a,b,sc,ISK);
 	break;
    case OP_ADD:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_SUB:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_MUL:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_MOD:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_POW:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_DIV:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_IDIV:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_BAND:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_BOR:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_BXOR:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_SHL:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_SHR:
-	printf("%d %d %d",a,b,c);
+	printf("%d %d %d%s",a,b,c,ISK);
 	break;
    case OP_MMBIN:
 	printf("%d %d %d",a,b,c);
@@ -535,7 +547,7 @@ static void PrintCode(const Proto* f)
 	if (isk) printf(" flip");
 	break;
    case OP_UNM:
-	printf("%d %d",a,b);
+	printf("%d %d%s",a,b,ISK);
 	break;
    case OP_BNOT:
 	printf("%d %d",a,b);
@@ -663,6 +675,9 @@ static void PrintCode(const Proto* f)
 	printf("%d %d %d",a,b,c);
 	printf(COMMENT "not handled");
 	break;
+#else
+   default:		/* superinstructions: 'getBaseOp' never gives them */
+	break;
 #endif
   }
   printf("\n");
@@ -401,6 +401,10 @@
 ** by prefixing it with one of FLT/DBL/LDBL.
 @@ LUA_NUMBER_FRMLEN is the length modifier for writing floats.
 @@ LUA_NUMBER_FMT is the format for writing floats.
+@@ LUA_NUMBER_PREC is the precision of LUA_NUMBER_FMT, when Lua can
+** produce that format without the C library (see 'luaO_fmtnum').
+@@ LUA_NUMBER_SHORTEST makes Lua write floats with the shortest string
+** that reads back as the same value, instead of using LUA_NUMBER_FMT.
 @@ lua_number2str converts a float to a string.
 @@ l_mathop allows the addition of an 'l' or 'f' to all math operations.
 @@ l_floor takes the floor of a float.
@@ -476,6 +480,7 @@
 
 #define LUA_NUMBER_FRMLEN	""
 #define LUA_NUMBER_FMT		"%.14g"
+#define LUA_NUMBER_PREC		14
 
 #define l_mathop(op)		op
 
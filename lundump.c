@@ -21,6 +21,7 @@
 #include "lmem.h"
 #include "lobject.h"
 #include "lstring.h"
+#include "ltable.h"
 #include "lundump.h"
 #include "lzio.h"
 
@@ -186,6 +187,92 @@ static void loadCode (LoadState *S, Proto *f) {
 static void loadFunction(LoadState *S, Proto *f, TString *psource);
 
 
+static void loadTemplate (LoadState *S, Proto *f, Table *t);
+
+/*
+** Load a value into 'o', which must keep it alive ('f->k' or the
+** stack).
+*/
+static void loadValue (LoadState *S, Proto *f, TValue *o) {
+  int t = loadByte(S);
+  switch (t) {
+    case LUA_VNIL:
+      setnilvalue(o);
+      break;
+    case LUA_VFALSE:
+      setbfvalue(o);
+      break;
+    case LUA_VTRUE:
+      setbtvalue(o);
+      break;
+    case LUA_VNUMFLT:
+      setfltvalue(o, loadNumber(S));
+      break;
+    case LUA_VNUMINT:
+      setivalue(o, loadInteger(S));
+      break;
+    case LUA_VVECTOR2:
+    case LUA_VVECTOR3:
+    case LUA_VVECTOR4:
+    case LUA_VQUAT:
+      setvvalue(o, loadVectorType(S, t), cast_byte(t));
+      break;
+    case LUA_VSHRSTR:
+#if defined(LUAGLM_EXT_BLOB)
+    case LUA_VBLOBSTR:
+#endif
+    case LUA_VLNGSTR:
+      setsvalue2n(S->L, o, loadString(S, f));
+      break;
+    case LUA_VTABLE: {  /* template of a constructor */
+      Table *h = luaH_new(S->L);
+      sethvalue(S->L, o, h);
+      luaC_objbarrier(S->L, f, h);
+      loadTemplate(S, f, h);
+      break;
+    }
+    default: error(S, "bad format for constant");
+  }
+}
+
+
+/*
+** Load the contents of a table template (see 'dumpTemplate'). Keys and
+** values are anchored in the stack while they are loaded.
+*/
+static void loadTemplate (LoadState *S, Proto *f, Table *t) {
+  lua_State *L = S->L;
+  int asize = loadInt(S);
+  int nh = loadInt(S);
+  int i;
+  luaH_resize(L, t, cast_uint(asize), cast_uint(nh));
+  for (i = 0; i < asize + nh; i++) {
+    TValue *k, *v;
+    luaD_checkstack(L, 3);  /* key, value, and a long string being loaded */
+    k = s2v(L->top);
+    v = s2v(L->top + 1);
+    setnilvalue(k);
+    setnilvalue(v);
+    L->top += 2;
+    if (i < asize) {  /* array part? */
+      setivalue(k, i + 1);
+    }
+    else
+      loadValue(S, f, k);
+    loadValue(S, f, v);
+    k = s2v(L->top - 2);  /* nested templates may reallocate the stack */
+    v = s2v(L->top - 1);
+    if (!ttisnil(v)) {
+      if (ttisnil(k))
+        error(S, "bad format for constant");
+      luaH_set(L, t, k, v);
+      luaC_barrierback(L, obj2gco(t), v);
+    }
+    L->top -= 2;
+  }
+}
+
+
 static void loadConstants (LoadState *S, Proto *f) {
   int i;
   int n = loadInt(S);
@@ -193,41 +280,8 @@ static void loadConstants (LoadState *S, Proto *f) {
   f->sizek = n;
   for (i = 0; i < n; i++)
     setnilvalue(&f->k[i]);
-  for (i = 0; i < n; i++) {
-    TValue *o = &f->k[i];
-    int t = loadByte(S);
-    switch (t) {
-      case LUA_VNIL:
-        setnilvalue(o);
-        break;
-      case LUA_VFALSE:
-        setbfvalue(o);
-        break;
-      case LUA_VTRUE:
-        setbtvalue(o);
-        break;
-      case LUA_VNUMFLT:
-        setfltvalue(o, loadNumber(S));
-        break;
-      case LUA_VNUMINT:
-        setivalue(o, loadInteger(S));
-        break;
-      case LUA_VVECTOR2:
-      case LUA_VVECTOR3:
-      case LUA_VVECTOR4:
-      case LUA_VQUAT:
-        setvvalue(o, loadVectorType(S, t), cast_byte(t));
-        break;
-      case LUA_VSHRSTR:
-#if defined(LUAGLM_EXT_BLOB)
-      case LUA_VBLOBSTR:
-#endif
-      case LUA_VLNGSTR:
-        setsvalue2n(S->L, o, loadString(S, f));
-        break;
-      default: lua_assert(0);
-    }
-  }
+  for (i = 0; i < n; i++)
+    loadValue(S, f, &f->k[i]);
 }
 
 
@@ -306,6 +360,7 @@ static void loadFunction (LoadState *S, Proto *f, TString *psource) {
   f->is_vararg = loadByte(S);
   f->maxstacksize = loadByte(S);
   loadCode(S, f);
+  luaF_initcache(S->L, f);
   loadConstants(S, f);
   loadUpvalues(S, f);
   loadProtos(S, f);
@@ -22,8 +22,10 @@
 #include "ldo.h"
 #include "lfunc.h"
 #include "lgc.h"
+#include "lmem.h"
 #include "lobject.h"
 #include "lglm_core.h"
+#include "ljit.h"
 #include "lopcodes.h"
 #include "lstate.h"
 #include "lstring.h"
@@ -45,6 +47,15 @@
 #endif
 
 
+/*
+** Optionally, run each opcode in a function of its own, chained by
+** tail calls (see 'ltailcall.h'). That replaces the jump table.
+*/
+#if !defined(LUA_USE_TAILCALL)
+#define LUA_USE_TAILCALL	0
+#endif
+
+
 /*
 ** Prevent GCC -- or attempt to -- from optimizing the indirect jumps by sharing
 ** them between opcodes when using threaded code.
@@ -92,6 +103,17 @@
 #endif
 
 
+#if defined(LUAGLM_EXT_SLICE)
+/*
+** Maximum length of a string slice that can be converted to a number.
+** (Slices are not zero-terminated, so they are converted from a copy.)
+*/
+#if !defined(LUAI_MAXSLICENUM)
+#define LUAI_MAXSLICENUM	200
+#endif
+#endif
+
+
 /*
 ** Try to convert a value from string to a number value.
 ** If the value is not a string or is a string not representing
@@ -104,6 +126,17 @@ static int l_strton (const TValue *obj, TValue *result) {
   setivalue(result, 0);
   if (!cvt2num(obj))  /* is object not a string? */
     return 0;
+#if defined(LUAGLM_EXT_SLICE)
+  else if (ttisslicestring(obj)) {  /* not zero-terminated: use a copy */
+    char buff[LUAI_MAXSLICENUM + 1];
+    size_t l = vslen(obj);
+    if (l > LUAI_MAXSLICENUM)
+      return 0;  /* too long to be converted */
+    memcpy(buff, svalue(obj), l * sizeof(char));
+    buff[l] = '\0';
+    return (luaO_str2num(buff, result) == l + 1);
+  }
+#endif
   else
     return (luaO_str2num(svalue(obj), result) == vslen(obj) + 1);
 }
@@ -294,15 +327,15 @@ static int floatforloop (StkId ra) {
 
 /*
 ** Finish the table access 'val = t[key]'.
-** if 'slot' is NULL, 't' is not a table; otherwise, 'slot' points to
-** t[k] entry (which must be empty).
+** if 'tag' is LUA_VNOTABLE, 't' is not a table; otherwise, 'tag' is
+** the (empty) tag of the t[k] entry.
 */
 void luaV_finishget (lua_State *L, const TValue *t, TValue *key, StkId val,
-                      const TValue *slot) {
+                      lu_byte tag) {
   int loop;  /* counter to avoid infinite loops */
   const TValue *tm;  /* metamethod */
   for (loop = 0; loop < MAXTAGLOOP; loop++) {
-    if (slot == NULL) {  /* 't' is not a table? */
+    if (tag == LUA_VNOTABLE) {  /* 't' is not a table? */
       lua_assert(!ttistable(t));
       tm = luaT_gettmbyobj(L, t, TM_INDEX);
       if (l_unlikely(notm(tm)))
@@ -310,12 +343,15 @@ void luaV_finishget (lua_State *L, const TValue *t, TValue *key, StkId val,
       /* else will try the metamethod */
     }
     else {  /* 't' is a table */
-      lua_assert(isempty(slot));
+      lua_assert(tagisempty(tag));
       tm = fasttm(L, hvalue(t)->metatable, TM_INDEX);  /* table's metamethod */
       if (tm == NULL) {  /* no metamethod? */
         setnilvalue(s2v(val));  /* result is nil */
         return;
       }
+      else if (loop == 0 && ttistable(tm) && ttisshrstring(key) &&
+               luaT_indexchain(L, hvalue(t), tsvalue(key), s2v(val)))
+        return;  /* found through a (cached) chain of tables */
       /* else will try the metamethod */
     }
     if (ttisfunction(tm)) {  /* is metamethod a function? */
@@ -323,10 +359,9 @@ void luaV_finishget (lua_State *L, const TValue *t, TValue *key, StkId val,
       return;
     }
     t = tm;  /* else try to access 'tm[key]' */
-    if (luaV_fastget(L, t, key, slot, luaH_get)) {  /* fast track? */
-      setobj2s(L, val, slot);  /* done */
-      return;
-    }
+    luaV_fastget(t, key, s2v(val), luaH_get, tag);
+    if (!tagisempty(tag))  /* fast track? */
+      return;  /* done */
     /* else repeat (tail call 'luaV_finishget') */
   }
   luaG_runerror(L, "'__index' chain too long; possible loop");
@@ -336,31 +371,43 @@ void luaV_finishget (lua_State *L, const TValue *t, TValue *key, StkId val,
 #if defined(LUAGLM_EXT_READONLY)
   #define luaV_readonly_check(L, T) \
     if ((T)->readonly) luaG_runerror((L), "table configured as readonly")
+
+
+/*
+** An assignment to a readonly table can only go to its '__newindex'
+** metamethod 'tm', and only for absent keys.
+*/
+static void readonlyset (lua_State *L, Table *h, const TValue *key,
+                                       const TValue *tm) {
+  TValue aux;
+  if (tm == NULL || !tagisempty(luaH_get(h, key, &aux)))
+    luaG_runerror(L, "table configured as readonly");
+}
 #endif
 
 
 /*
 ** Finish a table assignment 't[key] = val'.
-** If 'slot' is NULL, 't' is not a table.  Otherwise, 'slot' points
-** to the entry 't[key]', or to a value with an absent key if there
-** is no such entry.  (The value at 'slot' must be empty, otherwise
-** 'luaV_fastget' would have done the job.)
+** If 'hres' is HNOTATABLE, 't' is not a table.  Otherwise, 'hres' is
+** the result of a pre-set that did not store the value (see HOK in
+** 'ltable.h'), which tells where the entry 't[key]' should go.
 */
 void luaV_finishset (lua_State *L, const TValue *t, TValue *key,
-                     TValue *val, const TValue *slot) {
+                     TValue *val, int hres) {
   int loop;  /* counter to avoid infinite loops */
   for (loop = 0; loop < MAXTAGLOOP; loop++) {
     const TValue *tm;  /* '__newindex' metamethod */
-    if (slot != NULL) {  /* is 't' a table? */
+    if (hres != HNOTATABLE) {  /* is 't' a table? */
       Table *h = hvalue(t);  /* save 't' table */
-      lua_assert(isempty(slot));  /* slot must be empty */
+      lua_assert(hres != HOK);
       tm = fasttm(L, h->metatable, TM_NEWINDEX);  /* get metamethod */
-      if (tm == NULL) {  /* no metamethod? */
 #if defined(LUAGLM_EXT_READONLY)
-        luaV_readonly_check(L, h);
+      if (l_unlikely(hres == HREADONLY))
+        readonlyset(L, h, key, tm);  /* only 'tm' can handle it */
 #endif
-        luaH_finishset(L, h, key, slot, val);  /* set new value */
-        invalidateTMcache(h);
+      if (tm == NULL) {  /* no metamethod? */
+        luaH_finishset(L, h, key, val, hres);  /* set new value */
+        invalidatecaches(L, h);
         luaC_barrierback(L, obj2gco(h), val);
         return;
       }
@@ -377,14 +424,12 @@ void luaV_finishset (lua_State *L, const TValue *t, TValue *key,
       return;
     }
     t = tm;  /* else repeat assignment over 'tm' */
-    if (luaV_fastget(L, t, key, slot, luaH_get)) {
-#if defined(LUAGLM_EXT_READONLY)
-      luaV_readonly_check(L, hvalue(t));
-#endif
-      luaV_finishfastset(L, t, slot, val);
+    luaV_fastset(t, key, val, hres, luaH_pset);
+    if (hres == HOK) {
+      luaV_finishfastset(L, t, val);
       return;  /* done */
     }
-    /* else 'return luaV_finishset(L, t, key, val, slot)' (loop) */
+    /* else 'return luaV_finishset(L, t, key, val, hres)' (loop) */
   }
   luaG_runerror(L, "'__newindex' chain too long; possible loop");
 }
@@ -397,11 +442,7 @@ void luaV_finishset (lua_State *L, const TValue *t, TValue *key,
 ** and it uses 'strcoll' (to respect locales) for each segments
 ** of the strings.
 */
-static int l_strcmp (const TString *ls, const TString *rs) {
-  const char *l = getstr(ls);
-  size_t ll = tsslen(ls);
-  const char *r = getstr(rs);
-  size_t lr = tsslen(rs);
+static int l_strcoll (const char *l, size_t ll, const char *r, size_t lr) {
   for (;;) {  /* for each segment */
     int temp = strcoll(l, r);
     if (temp != 0)  /* not equal? */
@@ -420,6 +461,29 @@ static int l_strcmp (const TString *ls, const TString *rs) {
 }
 
 
+static int l_strcmp (lua_State *L, const TString *ls, const TString *rs) {
+  size_t ll = tsslen(ls);
+  size_t lr = tsslen(rs);
+#if defined(LUAGLM_EXT_SLICE)
+  if (ls->tt == LUA_VSLCSTR || rs->tt == LUA_VSLCSTR) {
+    /* 'strcoll' needs zero-terminated strings: compare copies */
+    char *buff = luaM_newvector(L, ll + lr + 2, char);
+    int res;
+    memcpy(buff, getstr(ls), ll * sizeof(char));
+    buff[ll] = '\0';
+    memcpy(buff + ll + 1, getstr(rs), lr * sizeof(char));
+    buff[ll + lr + 1] = '\0';
+    res = l_strcoll(buff, ll, buff + ll + 1, lr);
+    luaM_freearray(L, buff, ll + lr + 2);
+    return res;
+  }
+#else
+  UNUSED(L);
+#endif
+  return l_strcoll(getstr(ls), ll, getstr(rs), lr);
+}
+
+
 /*
 ** Check whether integer 'i' is less than float 'f'. If 'i' has an
 ** exact representation as a float ('l_intfitsf'), compare numbers as
@@ -545,7 +609,7 @@ l_sinline int LEnum (const TValue *l, const TValue *r) {
 static int lessthanothers (lua_State *L, const TValue *l, const TValue *r) {
   lua_assert(!ttisnumber(l) || !ttisnumber(r));
   if (ttisstring(l) && ttisstring(r))  /* both are strings? */
-    return l_strcmp(tsvalue(l), tsvalue(r)) < 0;
+    return l_strcmp(L, tsvalue(l), tsvalue(r)) < 0;
   else
     return luaT_callorderTM(L, l, r, TM_LT);
 }
@@ -567,7 +631,7 @@ int luaV_lessthan (lua_State *L, const TValue *l, const TValue *r) {
 static int lessequalothers (lua_State *L, const TValue *l, const TValue *r) {
   lua_assert(!ttisnumber(l) || !ttisnumber(r));
   if (ttisstring(l) && ttisstring(r))  /* both are strings? */
-    return l_strcmp(tsvalue(l), tsvalue(r)) <= 0;
+    return l_strcmp(L, tsvalue(l), tsvalue(r)) <= 0;
   else
     return luaT_callorderTM(L, l, r, TM_LE);
 }
@@ -590,6 +654,12 @@ int luaV_lessequal (lua_State *L, const TValue *l, const TValue *r) {
 int luaV_equalobj (lua_State *L, const TValue *t1, const TValue *t2) {
   const TValue *tm;
   if (ttypetag(t1) != ttypetag(t2)) {  /* not the same variant? */
+#if defined(LUAGLM_EXT_SLICE)
+    /* slices are equal to long strings with the same contents */
+    if ((ttisslicestring(t1) && ttislngstring(t2)) ||
+        (ttislngstring(t1) && ttisslicestring(t2)))
+      return luaS_eqlngstr(tsvalue(t1), tsvalue(t2));
+#endif
     if (ttype(t1) != ttype(t2) || ttype(t1) != LUA_TNUMBER)
       return 0;  /* only numbers can be equal with different variants */
     else {  /* two numbers with different variants */
@@ -612,6 +682,9 @@ int luaV_equalobj (lua_State *L, const TValue *t1, const TValue *t2) {
     case LUA_VSHRSTR: return eqshrstr(tsvalue(t1), tsvalue(t2));
 #if defined(LUAGLM_EXT_BLOB)
     case LUA_VBLOBSTR: return luaS_eqlngstr(tsvalue(t1), tsvalue(t2));
+#endif
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR: return luaS_eqlngstr(tsvalue(t1), tsvalue(t2));
 #endif
     case LUA_VLNGSTR: return luaS_eqlngstr(tsvalue(t1), tsvalue(t2));
     case LUA_VVECTOR2: return glmVec_equalObj(L, t1, t2, LUA_VVECTOR2);
@@ -738,6 +811,9 @@ void luaV_objlen (lua_State *L, StkId ra, const TValue *rb) {
     }
 #if defined(LUAGLM_EXT_BLOB)
     case LUA_VBLOBSTR:
+#endif
+#if defined(LUAGLM_EXT_SLICE)
+    case LUA_VSLCSTR:
 #endif
     case LUA_VLNGSTR: {
       setivalue(s2v(ra), tsvalue(rb)->u.lnglen);
@@ -826,9 +902,89 @@ lua_Integer luaV_shiftl (lua_Integer x, lua_Integer y) {
 }
 
 
+/*
+** Generic 'for' loops over the iteration functions registered with
+** 'lua_setiterators': do the traversal of tables, vectors, and matrices
+** without calling them. With 'next' over a table, 'ra + 3' keeps the
+** index of the last key (see 'luaH_nextcursor'); that slot is free when
+** the to-be-closed variable is nil or false, as an integer cannot be
+** closed. Returns 0 when the loop needs the regular call.
+*/
+static int fortraverse (lua_State *L, StkId ra, int nvars) {
+  global_State *g = G(L);
+  lua_CFunction f = fvalue(s2v(ra));
+  TValue *state = s2v(ra + 1);
+  if (f == g->iternext) {
+    int more;
+    setobjs2s(L, ra + 4, ra + 2);  /* key to be replaced by the next one */
+    if (ttistable(state)) {
+      TValue *cursor = s2v(ra + 3);
+      unsigned int i;
+      if (ttisinteger(cursor))
+        i = cast_uint(ivalue(cursor));
+      else if (l_isfalse(cursor))
+        i = 0;  /* first step */
+      else
+        return 0;  /* to-be-closed variable in use */
+      more = luaH_nextcursor(L, hvalue(state), ra + 4, &i);
+      setivalue(cursor, cast(lua_Integer, i));
+    }
+    else if (ttisvector(state))
+      more = glmVec_next(state, ra + 4);
+    else if (ttismatrix(state))
+      more = glmMat_next(state, ra + 4);
+    else
+      return 0;  /* let 'next' raise the error */
+    if (!more) {
+      setnilvalue(s2v(ra + 4));  /* end of the loop */
+      return 1;
+    }
+  }
+  else if (f == g->iterinext && ttistable(state) &&
+           ttisinteger(s2v(ra + 2)) &&
+           fasttm(L, hvalue(state)->metatable, TM_INDEX) == NULL) {
+    lua_Integer n = intop(+, ivalue(s2v(ra + 2)), 1);
+    lu_byte tag;
+    luaH_fastgeti(hvalue(state), n, s2v(ra + 5), tag);
+    if (tagisempty(tag)) {
+      setnilvalue(s2v(ra + 4));  /* end of the loop */
+      return 1;
+    }
+    setivalue(s2v(ra + 4), n);
+  }
+  else
+    return 0;
+  for (; nvars > 2; nvars--)  /* other variables are nil */
+    setnilvalue(s2v(ra + 3 + nvars));
+  return 1;
+}
+
+
+/*
+** check whether cached closure in prototype 'p' may be reused, that is,
+** whether there is a cached closure with the same upvalues needed by
+** new closure to be created.
+*/
+static LClosure *getcached (Proto *p, UpVal **encup, StkId base) {
+  LClosure *c = p->cache;
+  if (c != NULL) {  /* is there a cached closure? */
+    int nup = p->sizeupvalues;
+    Upvaldesc *uv = p->upvalues;
+    int i;
+    for (i = 0; i < nup; i++) {  /* check whether it has right upvalues */
+      TValue *v = uv[i].instack ? s2v(base + uv[i].idx) : encup[uv[i].idx]->v;
+      if (c->upvals[i]->v != v)
+        return NULL;  /* wrong upvalue; cannot reuse closure */
+    }
+  }
+  return c;  /* return cached closure (or NULL if no cached closure) */
+}
+
+
 /*
 ** create a new Lua closure, push it in the stack, and initialize
-** its upvalues.
+** its upvalues. The new closure becomes the cached closure of its
+** prototype (a weak reference: see 'traverseproto').
 */
 static void pushclosure (lua_State *L, Proto *p, UpVal **encup, StkId base,
                          StkId ra) {
@@ -845,6 +1001,8 @@ static void pushclosure (lua_State *L, Proto *p, UpVal **encup, StkId base,
       ncl->upvals[i] = encup[uv[i].idx];
     luaC_objbarrier(L, ncl, ncl->upvals[i]);
   }
+  p->cache = ncl;  /* save it on cache for reuse */
+  luaC_objbarrier(L, p, ncl);
 }
 
 
@@ -855,7 +1013,7 @@ void luaV_finishOp (lua_State *L) {
   CallInfo *ci = L->ci;
   StkId base = ci->func + 1;
   Instruction inst = *(ci->u.l.savedpc - 1);  /* interrupted instruction */
-  OpCode op = GET_OPCODE(inst);
+  OpCode op = getBaseOp(GET_OPCODE(inst));
   switch (op) {  /* finish its execution */
     case OP_MMBIN: case OP_MMBINI: case OP_MMBINK: {
       setobjs2s(L, base + GETARG_A(*(ci->u.l.savedpc - 2)), --L->top);
@@ -1102,6 +1260,9 @@ void luaV_finishOp (lua_State *L) {
 #define KC(i)	(k+GETARG_C(i))
 #define RKC(i)	((TESTARG_k(i)) ? k + GETARG_C(i) : s2v(base + GETARG_C(i)))
 
+/* inline cache of the current instruction (see 'luaF_initcache') */
+#define fieldhint()	(cl->p->icache[pc - 1 - cl->p->code])
+
 
 
 #define updatetrap(ci)  (trap = ci->u.l.trap)
@@ -1120,6 +1281,23 @@ void luaV_finishOp (lua_State *L) {
 #define dojump(ci,i,e)	{ pc += GETARG_sJ(i) + e; updatetrap(ci); }
 
 
+/*
+** Run the native code of the function from 'pc', if the JIT compiler
+** is on for it and no hooks are active (see 'ljit.c'). Native code
+** changes only registers and returns where the interpreter goes on;
+** it may stop because of 'trap', so 'trap' must be read again (but
+** only if something ran, as 'trap' can be off for OP_VARARGPREP).
+*/
+#if defined(LUA_USE_JIT)
+#define jitrun(ci)  \
+	{ if (l_unlikely(luaJ_active(L, cl->p)) && !trap) {  \
+	    const Instruction *npc = luaJ_run(L, ci, pc);  \
+	    if (npc != pc) { pc = npc; updatetrap(ci); } } }
+#else
+#define jitrun(ci)	((void)0)
+#endif
+
+
 /* for test instructions, execute the jump instruction that follows it */
 #define donextjump(ci)	{ Instruction ni = *pc; dojump(ci, ni, 1); }
 
@@ -1166,12 +1344,110 @@ void luaV_finishOp (lua_State *L) {
            luai_threadyield(L); }
 
 
+/* called before each instruction that the VM executes */
+#if !defined(luai_execop)
+#define luai_execop(pc)		((void)0)
+#endif
+
+
+/*
+** Table reads, shared by their opcodes and the superinstructions that
+** run them first.
+*/
+
+/* R[A] := UpValue[B][K[C]:string] */
+#define op_gettabup(L) {  \
+  TValue *upval = cl->upvals[GETARG_B(i)]->v;  \
+  TValue *rc = KC(i);  \
+  TString *key = tsvalue(rc);  /* key must be a string */  \
+  if (ttisvector(upval)) {  \
+    if (l_unlikely(!glmVec_fastgets(upval, key, ra))) {  \
+      Protect(glmVec_get(L, upval, rc, ra));  \
+    }  \
+  }  \
+  else {  \
+    lu_byte tag;  \
+    luaV_fastgetshortstr(upval, key, s2v(ra), fieldhint(), tag);  \
+    if (tagisempty(tag))  \
+      Protect(luaV_finishget(L, upval, rc, ra, tag));  \
+  } }
+
+
+/* R[A] := R[B][R[C]] */
+#define op_gettable(L) {  \
+  TValue *rb = vRB(i);  \
+  TValue *rc = vRC(i);  \
+  if (ttisvector(rb)) {  /* fast track for integers / character indexing? */  \
+    if (!(ttisinteger(rc) && glmVec_fastgeti(rb, ivalue(rc), ra))  \
+        && !(ttisstring(rc) && glmVec_fastgets(rb, tsvalue(rc), ra))) {  \
+      Protect(glmVec_get(L, rb, rc, ra));  \
+    }  \
+  }  \
+  else if (ttismatrix(rb)) {  /* fast track for integers? */  \
+    if (!(ttisinteger(rc) && glmMat_fastgeti(rb, ivalue(rc), ra))) {  \
+      Protect(glmMat_get(L, rb, rc, ra));  \
+    }  \
+  }  \
+  else {  \
+    lu_byte tag;  \
+    if (ttisinteger(rc)) {  /* fast track for integers? */  \
+      luaV_fastgeti(rb, ivalue(rc), s2v(ra), tag);  \
+    }  \
+    else  \
+      luaV_fastget(rb, rc, s2v(ra), luaH_get, tag);  \
+    if (tagisempty(tag))  \
+      Protect(luaV_finishget(L, rb, rc, ra, tag));  \
+  } }
+
+
+/* R[A] := R[B][K[C]:string] */
+#define op_getfield(L) {  \
+  TValue *rb = vRB(i);  \
+  TValue *rc = KC(i);  \
+  TString *key = tsvalue(rc);  /* key must be a string */  \
+  if (ttisvector(rb)) {  \
+    if (l_unlikely(!glmVec_fastgets(rb, key, ra))) {  \
+      Protect(glmVec_get(L, rb, rc, ra));  \
+    }  \
+  }  \
+  else {  \
+    lu_byte tag;  \
+    luaV_fastgetshortstr(rb, key, s2v(ra), fieldhint(), tag);  \
+    if (tagisempty(tag))  \
+      Protect(luaV_finishget(L, rb, rc, ra, tag));  \
+  } }
+
+
+/* R[A+1] := R[B]; R[A] := R[B][RK(C):string] */
+#define op_self(L) {  \
+  TValue *rb = vRB(i);  \
+  TValue *rc = RKC(i);  \
+  TString *key = tsvalue(rc);  /* key must be a string */  \
+  setobj2s(L, ra + 1, rb);  \
+  if (ttisvector(rb)) {  /* key must be a string */  \
+    if (l_unlikely(!glmVec_fastgets(rb, key, ra))) {  \
+      Protect(glmVec_get(L, rb, rc, ra));  \
+    }  \
+  }  \
+  else {  \
+    lu_byte tag;  \
+    if (key->tt == LUA_VSHRSTR) {  \
+      luaV_fastgetshortstr(rb, key, s2v(ra), fieldhint(), tag);  \
+    }  \
+    else  \
+      luaV_fastget(rb, key, s2v(ra), luaH_getstr, tag);  \
+    if (tagisempty(tag))  \
+      Protect(luaV_finishget(L, rb, rc, ra, tag));  \
+  } }
+
+
 /* fetch an instruction and prepare its execution */
 #define vmfetch()	{ \
   if (l_unlikely(trap)) {  /* stack reallocation or hooks? */ \
     trap = luaG_traceexec(L, pc);  /* handle hooks */ \
     updatebase(ci);  /* correct stack */ \
   } \
+  luai_execop(pc); \
   i = *(pc++); \
   ra = RA(i); /* WARNING: any stack reallocation invalidates 'ra' */ \
 }
@@ -1180,6 +1456,36 @@ void luaV_finishOp (lua_State *L) {
 #define vmcase(l)	case l:
 #define vmbreak		break
 
+/* go to label 'l' ('startfunc', 'returning', or 'ret') */
+#define vmgoto(l)	goto l
+#define vmlabel(l)	l:
+
+
+/*
+** 'vmexec' executes instruction 'i' with the code of opcode 'l', which
+** starts with the label 'vmfused'. (Jump tables have labels for all
+** opcodes, but a switch does not.)
+**
+** Superinstructions: 'vmfuse' fetches the instruction that follows
+** the first part of a superinstruction and goes directly to the code
+** of its opcode 'l'. That instruction may be itself a superinstruction
+** starting with 'l'. 'vmfusemm' does the same after an arithmetic
+** opcode; when that opcode did not skip its OP_MMBIN* 'mm' (operands
+** were not numbers), it runs 'mm' first, which then falls through to
+** 'l' as usual.
+*/
+#define vmfused(l)	F_##l:
+#define vmexec(l)	goto F_##l
+
+#define vmfuse(l)  \
+	{ vmfetch(); lua_assert(getBaseOp(GET_OPCODE(i)) == l); vmexec(l); }
+
+#define vmfusemm(l,mm)  \
+	{ vmfetch(); if (l_unlikely(GET_OPCODE(i) == mm)) vmexec(mm);  \
+	  lua_assert(getBaseOp(GET_OPCODE(i)) == l); vmexec(l); }
+
+
+#if !LUA_USE_TAILCALL
 
 LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
   LClosure *cl;
@@ -1194,6 +1500,51 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
   trap = L->hookmask;
  returning:  /* trap already set */
   cl = clLvalue(s2v(ci->func));
+
+#else
+
+#include "ltailcall.h"
+
+void luaV_execute (lua_State *L, CallInfo *ci) {
+  vm_startfunc(L, ci, NULL, NULL, NULL, 0);
+}
+
+
+static void vm_startfunc (vmargs) {
+  trap = L->hookmask;
+  vmgoto(returning);
+}
+
+
+/* return from a Lua function (see the end of OP_RETURN1) */
+static void vm_ret (vmargs) {
+  if (ci->callstatus & CIST_FRESH)
+    return;  /* end this frame */
+  else {
+    ci = ci->previous;
+    vmgoto(returning);  /* continue running caller in this frame */
+  }
+}
+
+
+/* handle hooks before the next instruction (see 'vmfetch') */
+static void vm_hook (vmargs) {
+  Instruction i;
+  trap = luaG_traceexec(L, pc);  /* handle hooks */
+  updatebase(ci);  /* correct stack */
+  luai_execop(pc);
+  i = *(pc++);
+  vmdispatch(GET_OPCODE(i));
+}
+
+
+static void vm_returning (vmargs) {  /* trap already set */
+  LClosure *cl = clLvalue(s2v(ci->func));
+  Instruction i;  /* first instruction */
+  StkId ra;
+  cast_void(ra);  /* 'vmfetch' sets it for the first instruction */
+
+#endif
   k = cl->p->k;
   pc = ci->u.l.savedpc;
   if (l_unlikely(trap)) {
@@ -1206,10 +1557,13 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
     ci->u.l.trap = 1;  /* assume trap is on, for now */
   }
   base = ci->func + 1;
+  jitrun(ci);
+#if !LUA_USE_TAILCALL
   /* main loop of interpreter */
   for (;;) {
     Instruction i;  /* instruction being executed */
     StkId ra;  /* instruction's A register */
+#endif
     vmfetch();
     #if 0
       /* low-level line tracing for debugging Lua */
@@ -1277,51 +1631,11 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         vmbreak;
       }
       vmcase(OP_GETTABUP) {
-        TValue *upval = cl->upvals[GETARG_B(i)]->v;
-        TValue *rc = KC(i);
-        TString *key = tsvalue(rc);  /* key must be a string */
-        if (ttisvector(upval)) {
-          if (l_unlikely(!glmVec_fastgets(upval, key, ra))) {
-            Protect(glmVec_get(L, upval, rc, ra));
-          }
-        }
-        else {
-          const TValue *slot;
-          if (luaV_fastget(L, upval, key, slot, luaH_getshortstr)) {
-            setobj2s(L, ra, slot);
-          }
-          else {
-            Protect(luaV_finishget(L, upval, rc, ra, slot));
-          }
-        }
+        op_gettabup(L);
         vmbreak;
       }
-      vmcase(OP_GETTABLE) {
-        TValue *rb = vRB(i);
-        TValue *rc = vRC(i);
-        if (ttisvector(rb)) {  /* fast track for integers / character indexing? */
-          if (!(ttisinteger(rc) && glmVec_fastgeti(rb, ivalue(rc), ra))
-              && !(ttisstring(rc) && glmVec_fastgets(rb, tsvalue(rc), ra))) {
-            Protect(glmVec_get(L, rb, rc, ra));
-          }
-        }
-        else if (ttismatrix(rb)) {  /* fast track for integers? */
-          if (!(ttisinteger(rc) && glmMat_fastgeti(rb, ivalue(rc), ra))) {
-            Protect(glmMat_get(L, rb, rc, ra));
-          }
-        }
-        else {
-          const TValue *slot;
-          lua_Unsigned n;
-          if (ttisinteger(rc)  /* fast track for integers? */
-              ? (cast_void(n = ivalue(rc)), luaV_fastgeti(L, rb, n, slot))
-              : luaV_fastget(L, rb, rc, slot, luaH_get)) {
-            setobj2s(L, ra, slot);
-          }
-          else {
-            Protect(luaV_finishget(L, rb, rc, ra, slot));
-          }
-        }
+      vmcase(OP_GETTABLE) vmfused(OP_GETTABLE) {
+        op_gettable(L);
         vmbreak;
       }
       vmcase(OP_GETI) {
@@ -1338,36 +1652,18 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           }
         }
         else {
-          const TValue *slot;
-          if (luaV_fastgeti(L, rb, c, slot)) {
-            setobj2s(L, ra, slot);
-          }
-          else {
+          lu_byte tag;
+          luaV_fastgeti(rb, c, s2v(ra), tag);
+          if (tagisempty(tag)) {
             TValue key;
             setivalue(&key, c);
-            Protect(luaV_finishget(L, rb, &key, ra, slot));
+            Protect(luaV_finishget(L, rb, &key, ra, tag));
           }
         }
         vmbreak;
       }
-      vmcase(OP_GETFIELD) {
-        TValue *rb = vRB(i);
-        TValue *rc = KC(i);
-        TString *key = tsvalue(rc);  /* key must be a string */
-        if (ttisvector(rb)) {
-          if (l_unlikely(!glmVec_fastgets(rb, key, ra))) {
-            Protect(glmVec_get(L, rb, rc, ra));
-          }
-        }
-        else {
-          const TValue *slot;
-          if (luaV_fastget(L, rb, key, slot, luaH_getshortstr)) {
-            setobj2s(L, ra, slot);
-          }
-          else {
-            Protect(luaV_finishget(L, rb, rc, ra, slot));
-          }
-        }
+      vmcase(OP_GETFIELD) vmfused(OP_GETFIELD) {
+        op_getfield(L);
         vmbreak;
       }
       vmcase(OP_SETTABUP) {
@@ -1377,16 +1673,13 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         if (ttismatrix(upval))
           Protect(glmMat_set(L, upval, rb, rc));
         else {
-          const TValue *slot;
+          int hres;
           TString *key = tsvalue(rb);  /* key must be a string */
-          if (luaV_fastget(L, upval, key, slot, luaH_getshortstr)) {
-#if defined(LUAGLM_EXT_READONLY)
-            luaV_readonly_check(L, hvalue(upval));
-#endif
-            luaV_finishfastset(L, upval, slot, rc);
-          }
+          luaV_fastsetshortstr(upval, key, rc, fieldhint(), hres);
+          if (hres == HOK)
+            luaV_finishfastset(L, upval, rc);
           else
-            Protect(luaV_finishset(L, upval, rb, rc, slot));
+            Protect(luaV_finishset(L, upval, rb, rc, hres));
         }
         vmbreak;
       }
@@ -1396,19 +1689,16 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         if (ttismatrix(s2v(ra)))
           Protect(glmMat_set(L, s2v(ra), rb, rc));
         else {
-          const TValue *slot;
-          lua_Unsigned n;
-          if (ttisinteger(rb)  /* fast track for integers? */
-              ? (cast_void(n = ivalue(rb)), luaV_fastgeti(L, s2v(ra), n, slot))
-              : luaV_fastget(L, s2v(ra), rb, slot, luaH_get)) {
-#if defined(LUAGLM_EXT_READONLY)
-            luaV_readonly_check(L, hvalue(s2v(ra)));
-#endif
-            luaV_finishfastset(L, s2v(ra), slot, rc);
-          }
-          else {
-            Protect(luaV_finishset(L, s2v(ra), rb, rc, slot));
+          int hres;
+          if (ttisinteger(rb)) {  /* fast track for integers? */
+            luaV_fastseti(s2v(ra), ivalue(rb), rc, hres);
           }
+          else
+            luaV_fastset(s2v(ra), rb, rc, hres, luaH_pset);
+          if (hres == HOK)
+            luaV_finishfastset(L, s2v(ra), rc);
+          else
+            Protect(luaV_finishset(L, s2v(ra), rb, rc, hres));
         }
         vmbreak;
       }
@@ -1418,41 +1708,44 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         if (ttismatrix(s2v(ra)))
           Protect(glmMat_seti(L, s2v(ra), c, rc));
         else {
-          const TValue *slot;
-          if (luaV_fastgeti(L, s2v(ra), c, slot)) {
-#if defined(LUAGLM_EXT_READONLY)
-            luaV_readonly_check(L, hvalue(s2v(ra)));
-#endif
-            luaV_finishfastset(L, s2v(ra), slot, rc);
-          }
+          int hres;
+          luaV_fastseti(s2v(ra), c, rc, hres);
+          if (hres == HOK)
+            luaV_finishfastset(L, s2v(ra), rc);
           else {
             TValue key;
             setivalue(&key, c);
-            Protect(luaV_finishset(L, s2v(ra), &key, rc, slot));
+            Protect(luaV_finishset(L, s2v(ra), &key, rc, hres));
           }
         }
         vmbreak;
       }
       vmcase(OP_SETFIELD) {
-        const TValue *slot;
+        int hres;
         TValue *rb = KB(i);
         TValue *rc = RKC(i);
         TString *key = tsvalue(rb);  /* key must be a string */
-        if (luaV_fastget(L, s2v(ra), key, slot, luaH_getshortstr)) {
-#if defined(LUAGLM_EXT_READONLY)
-          luaV_readonly_check(L, hvalue(s2v(ra)));
-#endif
-          luaV_finishfastset(L, s2v(ra), slot, rc);
-        }
-        else {
-          Protect(luaV_finishset(L, s2v(ra), rb, rc, slot));
-        }
+        luaV_fastsetshortstr(s2v(ra), key, rc, fieldhint(), hres);
+        if (hres == HOK)
+          luaV_finishfastset(L, s2v(ra), rc);
+        else
+          Protect(luaV_finishset(L, s2v(ra), rb, rc, hres));
         vmbreak;
       }
       vmcase(OP_NEWTABLE) {
         int b = GETARG_B(i);  /* log2(hash size) + 1 */
         int c = GETARG_C(i);  /* array size */
         Table *t;
+        if (b == TEMPLATEB) {  /* copy of a template? */
+          const TValue *tpl = k + GETARG_Ax(*pc);
+          pc++;  /* skip extra argument */
+          L->top = ra + 1;  /* correct top in case of emergency GC */
+          t = luaH_new(L);  /* memory allocation */
+          sethvalue2s(L, ra, t);
+          luaH_copytemplate(L, hvalue(tpl), t);  /* idem */
+          checkGC(L, ra + 1);
+          vmbreak;
+        }
         if (b > 0)
           b = 1 << (b - 1);  /* size is 2^(b - 1) */
         lua_assert((!TESTARG_k(i)) == (GETARG_Ax(*pc) == 0));
@@ -1468,24 +1761,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         vmbreak;
       }
       vmcase(OP_SELF) {
-        TValue *rb = vRB(i);
-        TValue *rc = RKC(i);
-        TString *key = tsvalue(rc);  /* key must be a string */
-        setobj2s(L, ra + 1, rb);
-        if (ttisvector(rb)) {  /* key must be a string */
-          if (l_unlikely(!glmVec_fastgets(rb, key, ra))) {
-            Protect(glmVec_get(L, rb, rc, ra));
-          }
-        }
-        else {
-          const TValue *slot;
-          if (luaV_fastget(L, rb, key, slot, luaH_getstr)) {
-            setobj2s(L, ra, slot);
-          }
-          else {
-            Protect(luaV_finishget(L, rb, rc, ra, slot));
-          }
-        }
+        op_self(L);
         vmbreak;
       }
       vmcase(OP_ADDI) {
@@ -1550,7 +1826,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         }
         vmbreak;
       }
-      vmcase(OP_ADD) {
+      vmcase(OP_ADD) vmfused(OP_ADD) {
         op_arith(L, l_addi, luai_numadd);
         vmbreak;
       }
@@ -1598,13 +1874,14 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         op_bitwise(L, luaV_shiftr);
         vmbreak;
       }
-      vmcase(OP_MMBIN) {
+      vmcase(OP_MMBIN) vmfused(OP_MMBIN) {
         Instruction pi = *(pc - 2);  /* original arith. expression */
         TValue *rb = vRB(i);
         TMS tm = (TMS)GETARG_C(i);
         StkId result = RA(pi);
-        lua_assert(OP_ADD <= GET_OPCODE(pi) && GET_OPCODE(pi) <= OP_SHR);
-        Protect(luaT_trybinTM(L, s2v(ra), rb, result, tm));
+        lua_assert(OP_ADD <= getBaseOp(GET_OPCODE(pi)) &&
+                   getBaseOp(GET_OPCODE(pi)) <= OP_SHR);
+        Protect(luaT_trybinTM(L, s2v(ra), rb, result, tm, GETARG_k(pi)));
         vmbreak;
       }
       vmcase(OP_MMBINI) {
@@ -1613,16 +1890,18 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         TMS tm = (TMS)GETARG_C(i);
         int flip = GETARG_k(i);
         StkId result = RA(pi);
-        Protect(luaT_trybiniTM(L, s2v(ra), imm, flip, result, tm));
+        Protect(luaT_trybiniTM(L, s2v(ra), imm, flip, result, tm,
+                               GETARG_k(pi)));
         vmbreak;
       }
-      vmcase(OP_MMBINK) {
+      vmcase(OP_MMBINK) vmfused(OP_MMBINK) {
         Instruction pi = *(pc - 2);  /* original arith. expression */
         TValue *imm = KB(i);
         TMS tm = (TMS)GETARG_C(i);
         int flip = GETARG_k(i);
         StkId result = RA(pi);
-        Protect(luaT_trybinassocTM(L, s2v(ra), imm, flip, result, tm));
+        Protect(luaT_trybinassocTM(L, s2v(ra), imm, flip, result, tm,
+                                   GETARG_k(pi)));
         vmbreak;
       }
       vmcase(OP_UNM) {
@@ -1636,7 +1915,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           setfltvalue(s2v(ra), luai_numunm(L, nb));
         }
         else
-          Protect(luaT_trybinTM(L, rb, rb, ra, TM_UNM));
+          Protect(luaT_trybinTM(L, rb, rb, ra, TM_UNM, GETARG_k(i)));
         vmbreak;
       }
       vmcase(OP_BNOT) {
@@ -1646,7 +1925,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           setivalue(s2v(ra), intop(^, ~l_castS2U(0), ib));
         }
         else
-          Protect(luaT_trybinTM(L, rb, rb, ra, TM_BNOT));
+          Protect(luaT_trybinTM(L, rb, rb, ra, TM_BNOT, 0));
         vmbreak;
       }
       vmcase(OP_NOT) {
@@ -1683,6 +1962,8 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
       }
       vmcase(OP_JMP) {
         dojump(ci, i, 0);
+        if (GETARG_sJ(i) < 0)  /* loop? */
+          jitrun(ci);
         vmbreak;
       }
       vmcase(OP_EQ) {
@@ -1707,7 +1988,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         docondjump();
         vmbreak;
       }
-      vmcase(OP_EQI) {
+      vmcase(OP_EQI) vmfused(OP_EQI) {
         int cond;
         int im = GETARG_sB(i);
         if (ttisinteger(s2v(ra)))
@@ -1750,7 +2031,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         }
         vmbreak;
       }
-      vmcase(OP_CALL) {
+      vmcase(OP_CALL) vmfused(OP_CALL) {
         CallInfo *newci;
         int b = GETARG_B(i);
         int nresults = GETARG_C(i) - 1;
@@ -1762,7 +2043,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           updatetrap(ci);  /* C call; nothing else to be done */
         else {  /* Lua call: run function in this same C frame */
           ci = newci;
-          goto startfunc;
+          vmgoto(startfunc);
         }
         vmbreak;
       }
@@ -1783,12 +2064,12 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           lua_assert(base == ci->func + 1);
         }
         if ((n = luaD_pretailcall(L, ci, ra, b, delta)) < 0)  /* Lua function? */
-          goto startfunc;  /* execute the callee */
+          vmgoto(startfunc);  /* execute the callee */
         else {  /* C function? */
           ci->func -= delta;  /* restore 'func' (if vararg) */
           luaD_poscall(L, ci, n);  /* finish caller */
           updatetrap(ci);  /* 'luaD_poscall' can change hooks */
-          goto ret;  /* caller returns after the tail call */
+          vmgoto(ret);  /* caller returns after the tail call */
         }
       }
       vmcase(OP_RETURN) {
@@ -1810,7 +2091,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         L->top = ra + n;  /* set call for 'luaD_poscall' */
         luaD_poscall(L, ci, n);
         updatetrap(ci);  /* 'luaD_poscall' can change hooks */
-        goto ret;
+        vmgoto(ret);
       }
       vmcase(OP_RETURN0) {
         if (l_unlikely(L->hookmask)) {
@@ -1826,7 +2107,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           for (nres = ci->nresults; l_unlikely(nres > 0); nres--)
             setnilvalue(s2v(L->top++));  /* all results are nil */
         }
-        goto ret;
+        vmgoto(ret);
       }
       vmcase(OP_RETURN1) {
         if (l_unlikely(L->hookmask)) {
@@ -1847,12 +2128,12 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
               setnilvalue(s2v(L->top++));  /* complete missing results */
           }
         }
-       ret:  /* return from a Lua function */
+       vmlabel(ret)  /* return from a Lua function */
         if (ci->callstatus & CIST_FRESH)
           return;  /* end this frame */
         else {
           ci = ci->previous;
-          goto returning;  /* continue running caller in this frame */
+          vmgoto(returning);  /* continue running caller in this frame */
         }
       }
       vmcase(OP_FORLOOP) {
@@ -1871,6 +2152,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         else if (floatforloop(ra))  /* float loop */
           pc -= GETARG_Bx(i);  /* jump back */
         updatetrap(ci);  /* allows a signal to break the loop */
+        jitrun(ci);
         vmbreak;
       }
       vmcase(OP_FORPREP) {
@@ -1889,26 +2171,28 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         pc += GETARG_Bx(i);
         i = *(pc++);  /* go to next instruction */
         lua_assert(GET_OPCODE(i) == OP_TFORCALL && ra == RA(i));
-        goto l_tforcall;
+        vmexec(OP_TFORCALL);
       }
-      vmcase(OP_TFORCALL) {
-       l_tforcall:
+      vmcase(OP_TFORCALL) vmfused(OP_TFORCALL) {
         /* 'ra' has the iterator function, 'ra + 1' has the state,
            'ra + 2' has the control variable, and 'ra + 3' has the
            to-be-closed variable. The call will use the stack after
            these values (starting at 'ra + 4')
         */
-        /* push function, state, and control variable */
-        memcpy(ra + 4, ra, 3 * sizeof(*ra));
-        L->top = ra + 4 + 3;
-        ProtectNT(luaD_call(L, ra + 4, GETARG_C(i)));  /* do the call */
-        updatestack(ci);  /* stack may have changed */
+        /* stock iterators run in the VM (unless hooks must see them) */
+        if (!(ttislcf(s2v(ra)) && !L->hookmask &&
+              halfProtect(fortraverse(L, ra, GETARG_C(i))))) {
+          /* push function, state, and control variable */
+          memcpy(ra + 4, ra, 3 * sizeof(*ra));
+          L->top = ra + 4 + 3;
+          ProtectNT(luaD_call(L, ra + 4, GETARG_C(i)));  /* do the call */
+          updatestack(ci);  /* stack may have changed */
+        }
         i = *(pc++);  /* go to next instruction */
         lua_assert(GET_OPCODE(i) == OP_TFORLOOP && ra == RA(i));
-        goto l_tforloop;
+        vmexec(OP_TFORLOOP);
       }
-      vmcase(OP_TFORLOOP) {
-        l_tforloop:
+      vmcase(OP_TFORLOOP) vmfused(OP_TFORLOOP) {
         if (!ttisnil(s2v(ra + 4))) {  /* continue loop? */
           setobjs2s(L, ra + 2, ra + 4);  /* save control variable */
           pc -= GETARG_Bx(i);  /* jump back */
@@ -1939,7 +2223,7 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
           luaH_resizearray(L, h, last);  /* preallocate it at once */
         for (; n > 0; n--) {
           TValue *val = s2v(ra + n);
-          setobj2t(L, &h->array[last - 1], val);
+          obj2arr(h, last - 1, val);
           last--;
           luaC_barrierback(L, obj2gco(h), val);
         }
@@ -1947,8 +2231,14 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
       }
       vmcase(OP_CLOSURE) {
         Proto *p = cl->p->p[GETARG_Bx(i)];
-        halfProtect(pushclosure(L, p, cl->upvals, base, ra));
-        checkGC(L, ra + 1);
+        LClosure *ncl = getcached(p, cl->upvals, base);  /* cached closure */
+        if (ncl != NULL) {  /* found one? */
+          setclLvalue2s(L, ra, ncl);  /* reuse it */
+        }
+        else {
+          halfProtect(pushclosure(L, p, cl->upvals, base, ra));
+          checkGC(L, ra + 1);
+        }
         vmbreak;
       }
 #if defined(LUAGLM_EXT_DEFER)
@@ -1975,8 +2265,52 @@ LUA_JUMPTABLE_ATTRIBUTE void luaV_execute (lua_State *L, CallInfo *ci) {
         lua_assert(0);
         vmbreak;
       }
+      vmcase(OP_MOVE_CALL) {
+        setobjs2s(L, ra, RB(i));
+        vmfuse(OP_CALL);
+      }
+      vmcase(OP_LOADI_CALL) {
+        lua_Integer b = GETARG_sBx(i);
+        setivalue(s2v(ra), b);
+        vmfuse(OP_CALL);
+      }
+      vmcase(OP_GETTABLE_CALL) {
+        op_gettable(L);
+        vmfuse(OP_CALL);
+      }
+      vmcase(OP_SELF_CALL) {
+        op_self(L);
+        vmfuse(OP_CALL);
+      }
+      vmcase(OP_GETUPVAL_GETTABLE) {
+        int b = GETARG_B(i);
+        setobj2s(L, ra, cl->upvals[b]->v);
+        vmfuse(OP_GETTABLE);
+      }
+      vmcase(OP_MOVE_GETTABLE) {
+        setobjs2s(L, ra, RB(i));
+        vmfuse(OP_GETTABLE);
+      }
+      vmcase(OP_GETTABUP_GETFIELD) {
+        op_gettabup(L);
+        vmfuse(OP_GETFIELD);
+      }
+      vmcase(OP_GETFIELD_GETFIELD) {
+        op_getfield(L);
+        vmfuse(OP_GETFIELD);
+      }
+      vmcase(OP_MUL_ADD) {
+        op_arith(L, l_muli, luai_nummul);
+        vmfusemm(OP_ADD, OP_MMBIN);
+      }
+      vmcase(OP_MODK_EQI) {
+        op_arithK(L, luaV_mod, luaV_modf);
+        vmfusemm(OP_EQI, OP_MMBINK);
+      }
     }
+#if !LUA_USE_TAILCALL
   }
+#endif
 }
 
 /* }================================================================== */
@@ -10,6 +10,7 @@
 
 #include "ldo.h"
 #include "lobject.h"
+#include "ltable.h"
 #include "ltm.h"
 
 
@@ -80,38 +81,71 @@ typedef enum {
 
 
 /*
-** fast track for 'gettable': if 't' is a table and 't[k]' is present,
-** return 1 with 'slot' pointing to 't[k]' (position of final result).
-** Otherwise, return 0 (meaning it will have to check metamethod)
-** with 'slot' pointing to an empty 't[k]' (if 't' is a table) or NULL
-** (otherwise). 'f' is the raw get function to use.
+** fast track for 'gettable': if 't' is a table, put the raw value of
+** 't[k]' into 'res' and its tag into 'tag'; otherwise, set 'tag' to
+** LUA_VNOTABLE. An empty tag means it will have to check metamethods
+** (and 'res' was left unchanged). 'f' is the raw get function to use.
 */
-#define luaV_fastget(L,t,k,slot,f) \
-  (!ttistable(t)  \
-   ? (slot = NULL, 0)  /* not a table; 'slot' is NULL and result is 0 */  \
-   : (slot = f(hvalue(t), k),  /* else, do raw access */  \
-      !isempty(slot)))  /* result not empty? */
+#define luaV_fastget(t,k,res,f,tag) \
+  (tag = (!ttistable(t) ? LUA_VNOTABLE : f(hvalue(t), k, res)))
 
 
 /*
 ** Special case of 'luaV_fastget' for integers, inlining the fast case
 ** of 'luaH_getint'.
 */
-#define luaV_fastgeti(L,t,k,slot) \
-  (!ttistable(t)  \
-   ? (slot = NULL, 0)  /* not a table; 'slot' is NULL and result is 0 */  \
-   : (slot = (l_castS2U(k) - 1u < hvalue(t)->alimit) \
-              ? &hvalue(t)->array[k - 1] : luaH_getint(hvalue(t), k), \
-      !isempty(slot)))  /* result not empty? */
+#define luaV_fastgeti(t,k,res,tag) \
+  { if (!ttistable(t)) tag = LUA_VNOTABLE; \
+    else { luaH_fastgeti(hvalue(t), k, res, tag); }}
 
 
 /*
-** Finish a fast set operation (when fast get succeeds). In that case,
-** 'slot' points to the place to put the value.
+** Special case of 'luaV_fastget' for short strings with an inline
+** cache 'hint' (see 'luaF_initcache').
 */
-#define luaV_finishfastset(L,t,slot,v) \
-    { setobj2t(L, cast(TValue *,slot), v); \
-      luaC_barrierback(L, gcvalue(t), v); }
+#define luaV_fastgetshortstr(t,k,res,hint,tag) \
+  { if (!ttistable(t)) tag = LUA_VNOTABLE; \
+    else { luaH_fastgetshortstr(hvalue(t), k, res, hint, tag); }}
+
+
+/*
+** fast track for 'settable': if 't' is a table and 't[k]' is present,
+** store 'val' there and set 'hres' to HOK. Otherwise, 'hres' tells
+** 'luaV_finishset' where the value should go (HNOTATABLE if 't' is not
+** a table). 'f' is the raw pre-set function to use.
+*/
+#if defined(LUAGLM_EXT_READONLY)
+#define luaV_fastset(t,k,val,hres,f) \
+  (hres = (!ttistable(t) ? HNOTATABLE : \
+           l_unlikely(hvalue(t)->readonly) ? HREADONLY : f(hvalue(t), k, val)))
+
+#define luaV_fastseti(t,k,val,hres) \
+  { if (!ttistable(t)) hres = HNOTATABLE; \
+    else if (l_unlikely(hvalue(t)->readonly)) hres = HREADONLY; \
+    else { luaH_fastseti(hvalue(t), k, val, hres); }}
+
+#define luaV_fastsetshortstr(t,k,val,hint,hres) \
+  { if (!ttistable(t)) hres = HNOTATABLE; \
+    else if (l_unlikely(hvalue(t)->readonly)) hres = HREADONLY; \
+    else { luaH_fastsetshortstr(hvalue(t), k, val, hint, hres); }}
+#else
+#define luaV_fastset(t,k,val,hres,f) \
+  (hres = (!ttistable(t) ? HNOTATABLE : f(hvalue(t), k, val)))
+
+#define luaV_fastseti(t,k,val,hres) \
+  { if (!ttistable(t)) hres = HNOTATABLE; \
+    else { luaH_fastseti(hvalue(t), k, val, hres); }}
+
+#define luaV_fastsetshortstr(t,k,val,hint,hres) \
+  { if (!ttistable(t)) hres = HNOTATABLE; \
+    else { luaH_fastsetshortstr(hvalue(t), k, val, hint, hres); }}
+#endif
+
+
+/*
+** Finish a fast set operation (when fast set succeeds).
+*/
+#define luaV_finishfastset(L,t,v)	luaC_barrierback(L, gcvalue(t), v)
 
 
 
@@ -125,9 +159,9 @@ LUAI_FUNC int luaV_tointegerns (const TValue *obj, lua_Integer *p,
                                 F2Imod mode);
 LUAI_FUNC int luaV_flttointeger (lua_Number n, lua_Integer *p, F2Imod mode);
 LUAI_FUNC void luaV_finishget (lua_State *L, const TValue *t, TValue *key,
-                               StkId val, const TValue *slot);
+                               StkId val, lu_byte tag);
 LUAI_FUNC void luaV_finishset (lua_State *L, const TValue *t, TValue *key,
-                               TValue *val, const TValue *slot);
+                               TValue *val, int hres);
 LUAI_FUNC void luaV_finishOp (lua_State *L);
 LUAI_FUNC void luaV_execute (lua_State *L, CallInfo *ci);
 LUAI_FUNC void luaV_concat (lua_State *L, int total);
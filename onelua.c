@@ -91,6 +91,7 @@
 #include "ltable.c"
 #include "ldo.c"
 #include "lvm.c"
+#include "ljit.c"
 #include "lapi.c"
 #include "lglm.cpp"
 
@@ -102,6 +103,7 @@
 #include "lbaselib.c"
 #include "lcorolib.c"
 #include "ldblib.c"
+#include "ljitlib.c"
 #include "liolib.c"
 #include "lmathlib.c"
 #include "loadlib.c"
@@ -477,5 +477,47 @@ do
   end
 end
 
+
+do   print("testing calls expanded inline")
+  -- same results with and without optimizations
+  local src = [[
+    local log = {}
+    local function arg (x) log[#log + 1] = x; return x end
+    local function multi () return 1, 2, 3 end
+    local add <const> = function (a, b) return a + (b or 0) end
+    local sq <const> = function (x) return x * x end
+    local both <const> = function (x) return sq(x) + add(x, x) end
+    local idx <const> = function (t, k) return t[k] end
+    local r = {}
+    r[1] = add(arg(1), arg(2))
+    r[2] = add(arg(3), arg(4), arg(5))   -- extra argument is evaluated
+    r[3] = add(arg(6))
+    r[4] = add(multi())
+    r[5] = select('#', add(1, 2), add(3, 4))
+    r[6] = both(both(2))
+    r[7] = 1 + sq(sq(2)) * add(sq(1), 2) - both(3)
+    r[8] = idx(setmetatable({}, {__index = function (_, k) return k * 2 end}), 21)
+    r[9] = add(1, 2) == 3 and sq(2) or "x"
+    local add = sq   -- not inlinable anymore
+    r[10] = add(5)
+    r[11] = table.concat(log, " ")
+    r[12] = debug.traceback("", 1):match("^\n[^\n]*\n%s*([^\n]*)")
+    return r
+  ]]
+  local r1 = load(src, "=inline")()
+  local r2 = load(src, "=inline", "tO")()
+  for i = 1, 11 do assert(r1[i] == r2[i]) end
+  assert(r2[6] == 80 and r2[11] == "1 2 3 4 5 6")
+
+  -- errors are raised at the line of the call
+  local st, msg = pcall(load([[
+    local add <const> = function (a, b)
+      return a + b
+    end
+    return add(1,
+               {})]], "=inline", "tO"))
+  assert(not st and string.find(msg, "^inline:4: attempt to perform"))
+end
+
 print('OK')
 return deep
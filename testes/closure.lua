@@ -56,6 +56,21 @@ do
   assert(f() == f())
 end
 
+do   -- closures with the same upvalues reuse a cached closure
+  local function f () return function (x) return x end end
+  assert(f() == f())    -- no upvalues
+  local up = {}
+  local function g () return function () return up end end
+  assert(g() == g() and g()() == up)    -- same upvalue
+  local function h (x) return function () return x end end
+  assert(h(1) ~= h(1) and h(1)() == 1)   -- a new upvalue on each call
+  local c = {}
+  for i = 1, 3 do c[i] = function () return up end end
+  assert(c[1] == c[2] and c[2] == c[3])
+  collectgarbage()
+  assert(g() == g() and g()() == up)
+end
+
 
 -- testing closures with 'for' control variable
 a = {}
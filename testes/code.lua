@@ -83,6 +83,20 @@ end
 checkKlist(foo, {1, 1.0, 2, 2.0, 0, 0.0})
 
 
+-- constant constructors keep only their outermost template
+foo = function (t)
+  t.x = {{{1, "a"}}, "b", {y = "c"}}
+  return "a"
+end
+
+do
+  local k = T.listk(foo)
+  assert(#k == 3 and k[1] == "x" and type(k[2]) == "table" and k[3] == "a")
+  local t = {}
+  assert(foo(t) == "a" and t.x[1][1][2] == "a" and t.x[3].y == "c")
+end
+
+
 -- testing opcodes
 
 -- check that 'f' opcodes match '...'
@@ -451,5 +465,161 @@ do   -- string constants
   assert(T.listk(f2)[1] == nil)
 end
 
+
+do   -- inline expansion of calls (load mode 'O')
+  local function ncalls (f)
+    local n = 0
+    for _, i in ipairs(T.listcode(f)) do
+      if string.find(i, "%- %u*CALL%s") then n = n + 1 end
+    end
+    return n
+  end
+
+  local function compile (body, mode)
+    return load("local k = 10\n" ..
+      "local add <const> = function (a, b) return a + b end\n" ..
+      "local addk <const> = function (x) return add(x, k) end\n" ..
+      "local two <const> = function (a) return a, a end\n" ..
+      "local rec <const> = function (x) return rec(x) end\n" ..
+      "local fn <const> = function () return function () end end\n" ..
+      "return function (x, y) " .. body .. " end", "=inline", mode)()
+  end
+
+  local f = compile("return add(x, y) * addk(x)", "tO")
+  assert(f(1, 2) == 33 and ncalls(f) == 0)
+  f = compile("return add(x, y) * addk(x)", "t")   -- no optimizations
+  assert(f(1, 2) == 33 and ncalls(f) == 2)
+  f = compile("local k = 1; return addk(x)", "tO")   -- 'k' is shadowed
+  assert(f(1) == 11 and ncalls(f) == 1)
+  f = compile("local add = nil; return addk(x)", "tO")   -- 'add' too
+  assert(f(1) == 11 and ncalls(f) == 1)
+  f = compile("return add(x)", "tO")   -- missing argument
+  assert(not pcall(f, 1) and ncalls(f) == 0)
+  f = compile("add(x, y)", "tO")   -- as a statement
+  assert(not pcall(f, 1) and ncalls(f) == 0)
+  f = compile("return two(x), rec, fn", "tO")   -- not inlinable
+  assert(f(1) == 1 and ncalls(f) == 1)
+
+  local function long (ntok)   -- inlinable function with 'ntok' tokens
+    local neg = (ntok % 2 == 0) and "-" or ""
+    local body = neg .. "a" .. string.rep(" + a", (ntok - 7 - #neg) // 2)
+    return load("local f <const> = function (a) return " .. body .. " end\n" ..
+                "return function (x) return f(x) end", "=long", "tO")()
+  end
+  assert(long(47)(1) == 21 and ncalls(long(47)) == 0)
+  assert(long(48)(1) == 19 and ncalls(long(48)) == 0)   -- MAXINLINE tokens
+  assert(long(49)(1) == 22 and ncalls(long(49)) == 1)   -- too long
+end
+
+
+do   -- bytecode optimizations (load mode 'O')
+  local function count (s, mode, op)
+    local f = assert(load(s, "=opt", mode))
+    local n = 0
+    for _, i in ipairs(T.listcode(f)) do
+      if string.find(i, "%- " .. op .. "%s") then n = n + 1 end
+    end
+    return n, f
+  end
+
+  local function check (s, op, nplain, nopt, ...)
+    local n, f = count(s, "t", op)
+    local nO, fO = count(s, "tO", op)
+    assert(n == nplain and nO == nopt)
+    assert(select("#", f(...)) == select("#", fO(...)))
+    for i = 1, select("#", f(...)) do
+      assert(select(i, f(...)) == select(i, fO(...)))
+    end
+  end
+
+  -- jump to a return becomes the return; final return is unreachable
+  local s = "local a, b = ...; if a then b = 1 else b = 2 end return b"
+  check(s, "JMP", 2, 1, true)
+  check(s, "RETURN", 2, 2, false)
+  check("local a, b = ...; if a then return b end return a", "RETURN",
+        3, 2, 1, 2)
+  -- dead store in the same line
+  check("local x; x = 1; return x", "LOADNIL", 1, 0)
+  -- values returned directly from the locals
+  check("local a, b, c = ...; local x = 1; return a, b, c", "MOVE", 3, 0,
+        1, 2, 3)
+  check("local a, b = ...; return b, a", "MOVE", 2, 2, 1, 2)
+end
+
+
+do   -- superinstructions (load mode 'O')
+  local s = [[
+    local t, f, x = ...
+    local y = t.a.b * x + x
+    t.n = t.n + x
+    if x % 2 == 1 then collectgarbage() end
+    return f(y), f(t[f(x)]), t:get()
+  ]]
+  local function ops (mode)
+    local l = {}
+    for _, i in ipairs(T.listcode(load(s, "=super", mode))) do
+      l[#l + 1] = string.match(i, "%- (%S+)")
+    end
+    return table.concat(l, " ")
+  end
+  local function get (self) return self.n end
+  local function new () return {a = {b = 2}, n = 0, get = get} end
+  local id = function (x) return x end
+  assert(not string.find(ops("t"), "_"))
+  local l = ops("tO")
+  assert(string.find(l, "GETFIELD_GETFIELD GETFIELD MUL_ADD MMBIN ADD MMBIN"))
+  assert(string.find(l, "MODK_EQI MMBINK EQI JMP GETTABUP CALL"))
+  assert(string.find(l, "MOVE_CALL CALL MOVE MOVE MOVE_CALL CALL GETTABLE_CALL",
+                     1, true))
+  assert(string.find(l, "SELF_CALL CALL"))
+  local f, fO = load(s, "=super", "t"), load(s, "=super", "tO")
+  local a, b, c = f(new(), id, 5)
+  local aO, bO, cO = fO(new(), id, 5)
+  assert(a == 15 and b == nil and c == 5 and aO == a and bO == b and cO == c)
+
+  -- metamethods of the first part (its OP_MMBIN* is not skipped)
+  local mx = setmetatable({}, {__mul = function () return 2 end,
+                               __add = function () return 3 end,
+                               __mod = function () return 1 end})
+  a, b, c = fO(new(), id, mx)
+  assert(a == 3 and b == nil and c == 3)
+
+  -- errors and names in the first part of a superinstruction
+  local _, msg = pcall(fO, {}, id, 5)
+  assert(string.find(msg, "field 'a'"))
+  _, msg = pcall(fO, new(), nil, 5)
+  assert(string.find(msg, "local 'f'"))
+
+  -- yields inside metamethods of the first part
+  local mt = {__index = function (_, k) return coroutine.yield(k) end}
+  local co = coroutine.wrap(fO)
+  assert(co(setmetatable({n = 0}, mt), id, 5) == "a")
+  assert(co({b = 2}) == 5)   -- 't[f(x)]'
+  assert(co(nil) == "get")
+  a, b, c = co(get)
+  assert(a == 15 and b == nil and c == 5)
+end
+
+
+do   -- intermediate results of arithmetic chains (load mode 'O')
+  local s = "local a, b, c, t = ...; return -a * b * c + 1, a * b, t[a * b]"
+  local function temps (mode)
+    local l = {}
+    for _, i in ipairs(T.listcode(load(s, "=temp", mode))) do
+      local op = string.match(i, "%- (%u+)")
+      if op ~= "MMBIN" and op ~= "MMBINI" then
+        l[#l + 1] = op .. (string.find(i, "%(k%)$") and "*" or "")
+      end
+    end
+    return table.concat(l, " ")
+  end
+  assert(not string.find(temps("t"), "*", 1, true))
+  assert(string.find(temps("tO"), "UNM* MUL* MUL* ADDI MUL MUL GETTABLE",
+                     1, true))
+  local f = load(s, "=temp", "tO")
+  local x, y, z = f(2, 3, 4, {[6] = 10})
+  assert(x == -23 and y == 6 and z == 10)
+end
+
 print 'OK'
 
@@ -316,6 +316,58 @@ do   -- test invalidating flags
 end
 
 
+do   -- '__index' chains through tables (cached)
+  local A = {a = 1, f = "A"}
+  local B = setmetatable({b = 2}, {__index = A})
+  local C = setmetatable({c = 3}, {__index = B})
+  local o = setmetatable({}, {__index = C})
+  for _ = 1, 3 do
+    assert(o.a == 1 and o.b == 2 and o.c == 3 and o.f == "A" and o.x == nil)
+  end
+  B.f = "B"; assert(o.f == "B")        -- shadowed by a new key
+  B.f = nil; assert(o.f == "A")        -- removed
+  B.f = "B2"; assert(o.f == "B2")      -- reused node
+  rawset(C, "f", "C"); assert(o.f == "C")
+  C.f = nil; B.f = nil
+  A.a = 10; assert(o.a == 10)
+  A.x = "x"; assert(o.x == "x")        -- absent key now present
+  A.x = nil; assert(o.x == nil)
+  for i = 1, 100 do A["k" .. i] = i end   -- rehash
+  assert(o.a == 10 and o.k50 == 50 and o.f == "A")
+  getmetatable(B).__index = {f = "N"}     -- new '__index'
+  assert(o.f == "N" and o.a == nil)
+  getmetatable(B).__index = A; assert(o.f == "A")
+  setmetatable(B, {__index = {a = "M"}})  -- new metatable
+  assert(o.a == "M" and o.f == nil)
+  getmetatable(B).__index = function (_, k) return k .. "!" end
+  assert(o.a == "a!" and o.b == 2)
+  setmetatable(A, {})
+  getmetatable(B).__index = A
+  assert(o.zz == nil)
+  getmetatable(A).__index = {zz = "zz"}   -- end of chain gets an '__index'
+  assert(o.zz == "zz")
+  local t = {deep = "deep"}      -- long chain
+  for _ = 1, 10 do t = setmetatable({}, {__index = t}) end
+  for _ = 1, 3 do assert(t.deep == "deep" and t.nope == nil) end
+  for i = 1, 20 do   -- tables in chains are collected and reused
+    local m = {__index = {v = i}}
+    local q = setmetatable({}, m)
+    assert(q.v == i and q.w == nil)
+    m.__index = {w = i}
+    assert(q.w == i and q.v == nil)
+    collectgarbage()
+  end
+  for i = 1, 50 do   -- absent keys are collected and their memory reused
+    assert(o["miss" .. i] == nil)
+    collectgarbage()
+    A["hit" .. i] = i
+    assert(o["hit" .. i] == i and o["miss" .. i] == nil)
+    collectgarbage()
+    assert(o["hit" .. (i // 2 + 1)] == i // 2 + 1)
+  end
+end
+
+
 if not T then
   (Message or print)('\n >>> testC not active: skipping tests for \z
 userdata <<<\n')
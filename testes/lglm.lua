@@ -250,3 +250,25 @@ do
   assert(T.testC("rawgeti 2 0; return 1", m) == nil)
   assert(T.testC("rawgeti 2 -1; return 1", m) == nil)
 end
+
+---------------------------------------
+-------- intermediate matrices --------
+---------------------------------------
+
+print("intermediate matrices")
+do
+  local s = [[
+    local a, b, c, ud = ...
+    return a * b * c, -a * b + a, (a * b + ud) * c
+  ]]
+  local saved
+  local ud = setmetatable({}, {__add = function (x) saved = x; return x end})
+  local m = mat(c1, c2, c3)
+  local f, fO = load(s, "=temp", "t"), load(s, "=temp", "tO")
+  local r1, r2, r3 = f(m, m, m, ud)
+  local m2 = m * m
+  local x1, x2, x3 = fO(m, m, m, ud)
+  assert(_eq(x1, r1) and _eq(x2, r2) and _eq(x3, r3))
+  assert(_eq(saved, m2))  -- not overwritten by the last product
+  assert(_eq(m, mat(c1, c2, c3)))  -- operands are never reused
+end
@@ -292,6 +292,33 @@ for s in coroutine.wrap(function () gen("", len) end) do
 end
 
 
+-- testing tokens split across the pieces given by a reader
+prog = [==[
+local name_with_digits_123 = 0x1fp-2 + 12.5e1 + .25  -- a comment
+local s = "abc\"\\\n\z
+           def" .. 'x\065y' .. [=[
+long]]string]=] --[[ long
+comment ]] .. "\u{48}"
+return name_with_digits_123, s, require"debug".getinfo(1).currentline
+]==]
+
+do
+  local r1, r2, r3 = load(prog)()
+  for k = 1, 20 do
+    local i = 1
+    local f = load(function ()
+      local piece = string.sub(prog, i, i + k - 1)
+      i = i + k
+      return piece
+    end)
+    local a1, a2, a3 = f()
+    assert(a1 == r1 and a2 == r2 and a3 == r3)
+  end
+  assert(r1 == 0x1fp-2 + 125.25 and r3 == 6)
+  assert(r2 == "abc\"\\\ndefxAylong]]stringH")
+end
+
+
 -- testing decimal point locale
 if os.setlocale("pt_BR") or os.setlocale("ptb") then
   assert(tonumber("3,4") == 3.4 and tonumber"3.4" == 3.4)
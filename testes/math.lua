@@ -435,6 +435,37 @@ if not _soft then
   assert(tonumber('0x.' .. string.rep('0', 1000) .. '74p4004') == 0x7.4)
 end
 
+do   -- conversions must be correctly rounded (same results as 'strtod')
+  assert(eqT(tonumber("0.1"), 0x1.999999999999ap-4))
+  assert(eqT(tonumber("1e23"), 0x1.52d02c7e14af6p76))
+  assert(eqT(tonumber("9007199254740993.0"), 2.0^53))   -- tie to even
+  assert(eqT(tonumber("9007199254740995.0"), 2.0^53 + 4))
+  assert(eqT(tonumber("2.2250738585072011e-308"), 0x0.fffffffffffffp-1022))
+  assert(eqT(tonumber("2.4703282292062327e-324"), 0.0))
+  assert(eqT(tonumber("2.4703282292062328e-324"), 0x1p-1074))
+  assert(eqT(tonumber("1.7976931348623158e308"), 0x1.fffffffffffffp1023))
+  assert(tonumber("1.7976931348623159e308") == math.huge)
+  -- halfway between 1 and its successor, with more than 19 digits
+  local half = "1.00000000000000011102230246251565404236316680908203125"
+  assert(eqT(tonumber(half), 1.0))
+  assert(eqT(tonumber(half .. "1"), 1.0 + 2^-52))
+  assert(eqT(tonumber(half:sub(1, -2) .. "4" .. string.rep("9", 40)), 1.0))
+  -- hexadecimal numerals with more digits than fit in a double
+  assert(eqT(tonumber("0x1.00000000000008"), 1.0))
+  assert(eqT(tonumber("0x1.0000000000000801"), 0x1.0000000000001p0))
+  assert(eqT(tonumber("0x1.00000000000018"), 0x1.0000000000002p0))
+  assert(eqT(tonumber("0x1p-1075"), 0.0))
+  assert(eqT(tonumber("0x1.8p-1075"), 0x1p-1074))
+  assert(1/tonumber("-0x0p0") < 0 and 1/tonumber("-0.0e10") < 0)
+  -- round trips
+  for i = 1, 200 do
+    local x = math.random() * 2.0^math.random(-1070, 1020)
+    assert(tonumber(string.format("%.17g", x)) == x)   -- may be an integer
+    assert(eqT(tonumber(string.format("%a", x)), x))
+    assert(eqT(tonumber(string.format("%.17e", -x)), -x))
+  end
+end
+
 -- testing 'tonumber' for invalid formats
 
 local function f (...)
@@ -1028,4 +1059,32 @@ assert(not pcall(random, maxint, minint))
 
 
 
+if jit then
+  print("testing JIT compiler")
+  local function loops (n)
+    local s, f, t = 0, 0.0, {}
+    for i = 1, n do s = s + i * 2; t[i] = i end
+    for i = n, 1, -0.5 do f = f + i / 4 end
+    for i = maxint - 2, maxint do s = s + (i & 1) end
+    for i = 1, #t do s = s + t[i] end
+    return s, f
+  end
+  local s, f = loops(100)
+  jit.on(loops)
+  for _ = 1, 3 do
+    local s1, f1 = loops(100)
+    assert(s1 == s and f1 == f and math.type(f1) == "float")
+  end
+  assert(jit.status(loops) == (jit.arch ~= false))
+  -- new types go back to the interpreter
+  local a, b = loops(3.0)
+  assert(a == 20 and b == 2.5)
+  assert(not pcall(loops, "x"))
+  jit.flush(loops)
+  jit.off(loops)
+  assert(not jit.status(loops))
+  assert(loops(100) == s)
+end
+
+
 print('OK')
@@ -417,5 +417,38 @@ do   -- test reuse of original string in gsub
   assert(r == s and string.format("%p", s) ~= string.format("%p", r))
 end
 
+do  print("testing start filters of compiled patterns")
+  -- literal prefixes, first-character sets, and captures before them
+  assert(string.find("xxab-ab", "ab%-") == 3)
+  assert(string.match("  (12) ms", "%((%d+)%)") == "12")
+  assert(string.match("abcabd", "()ab(d)") == 4)
+  assert(string.find("aaab", "a+b") == 1)
+  assert(string.find("xbxb", "xa*b") == 1)
+  assert(string.find("y{x}", "%b{}") == 2)
+  assert(string.gsub("a.b.c", "%.", "/") == "a/b/c")
+  assert(string.gsub("^a^b", "%^", "") == "ab")
+  local t = {}
+  for k in string.gmatch("^a ^b", "^(%a)") do t[#t + 1] = k end
+  assert(#t == 2 and t[1] == "a" and t[2] == "b")   -- '^' is literal
+  -- errors are raised only when 'match' reaches the item
+  assert(string.find("xyz", "a[") == nil)
+  checkerror("missing", string.find, "xaz", "a[")
+  assert(string.gsub("x", "[", "", 0) == "x")
+  -- literal patterns (')' is only literal for plain searches)
+  assert(string.find("a)b", "a)") == 1)
+  checkerror("invalid pattern capture", string.match, "a)b", "a)")
+  assert(string.match("xxabab", "ab") == "ab")
+  assert(select(2, string.gsub(string.rep("ab", 40), "abab", "")) == 20)
+  t = {}
+  for k in string.gmatch("aaaaa", "aa") do t[#t + 1] = k end
+  assert(#t == 2)
+  assert(string.find(string.rep("a", 100) .. "b", string.rep("a", 20) .. "b",
+                     1, true) == 81)
+  -- the cache keeps working after many distinct patterns
+  for i = 1, 100 do
+    assert(string.find("abc" .. i .. "def", i .. "d") == 4)
+  end
+end
+
 print('OK')
 
@@ -338,6 +338,47 @@ do print("testing 'format %a %A'")
 end
 
 
+do print("testing number formatting")
+  -- plain formats do not go through 'snprintf'; a width makes them do so
+  local function check (fmt, n)
+    local wfmt = string.gsub(fmt, "^%%", "%%1")
+    assert(string.format(fmt, n) == string.format(wfmt, n))
+  end
+  for _, n in ipairs{0.0, -0.0, 1.0, -1.5, 0.1, 1/3, -2/3, 2^53, 2^63, 1e15,
+                     1e16, 1e100, -1e-5, 1e-300, 0.5, 2.5, 0.125, 2.675,
+                     1.0005, 0.9995, 123456.78125, 5e-324, 1/0, -1/0} do
+    for _, fmt in ipairs{"%g", "%f", "%.14g", "%.1g", "%.0g", "%.15g",
+                         "%.17g", "%.3f", "%.0f", "%.10f", "%.20f"} do
+      check(fmt, n)
+    end
+  end
+  for i = 1, 2000 do
+    local n = math.random() * 10.0^math.random(-30, 30)
+    check("%.14g", n); check("%g", n); check("%f", n); check("%.2f", n)
+    local d = math.random(math.mininteger, math.maxinteger) >> math.random(0, 63)
+    check("%d", d); check("%d", -d)
+    assert(tostring(d) == string.format("%1d", d))
+    assert(tostring(n) == string.format("%1.14g", n) or
+           tostring(n) == string.format("%1.14g", n) .. ".0" or
+           tonumber(tostring(n)) == n)   -- shortest representation
+  end
+  assert(string.format("%.14g", 0.1) == "0.1")
+  assert(string.format("%.2f", 2.675) == "2.67")   -- 2.67499999...
+  assert(string.format("%.3f", 0.9995) == "1.000")   -- 0.99950000...
+  assert(string.format("%.0f", 0.5) == "0" and string.format("%.0f", 1.5) == "2")
+  assert(string.format("%f", -1e-7) == "-0.000000")
+  assert(string.format("%g", 1e20) == "1e+20")
+  assert(string.format("%g", 0.0001) == "0.0001")
+  assert(string.format("%g", 0.00001) == "1e-05")
+  assert(string.format("%d", 0) == "0" and string.format("%i", -7) == "-7")
+  assert(tostring(-0.0) == "-0.0" and tostring(1e100) == "1e+100")
+  assert(tostring(2^63) == "9.2233720368548e+18" or
+         tostring(2^63) == "9.223372036854776e+18")   -- LUA_NUMBER_SHORTEST
+  -- near a tie between two floats (too close for the fast digits)
+  assert(tostring(1e23) == "1e+23" and tostring(1.7e-35) == "1.7e-35")
+  assert(tostring(4e126) == "4e+126")
+end
+
 -- testing some flags  (all these results are required by ISO C)
 assert(string.format("%#12o", 10) == "         012")
 assert(string.format("%#10x", 100) == "      0x64")
@@ -514,5 +555,65 @@ else
 end
 
 
+do print("testing long substrings (slices)")
+  local base = string.rep("abcdefghij", 10) .. " " .. string.rep("0", 60) .. "42 "
+  local s = base:sub(5, 80)
+  assert(#s == 76 and s == string.rep("abcdefghij", 10):sub(5, 80))
+  assert(s:sub(2, 60) == base:sub(6, 64) and s:sub(1) == s)
+  assert(s < base:sub(6, 90) and base:sub(1, 50) <= base:sub(1, 51))
+  assert(s .. "!" == base:sub(5, 80) .. "!" and string.format("%s", s) == s)
+
+  -- slices as table keys
+  local t = {[s] = 1}
+  assert(t[base:sub(5, 80)] == 1 and t[string.rep("abcdefghij", 10):sub(5, 80)] == 1)
+  assert(next(t) == s and next(t, base:sub(5, 80)) == nil)
+
+  -- coercions
+  local n = base:sub(101)
+  assert(#n == 64 and n + 1 == 43 and tonumber(n) == 42 and math.tointeger(n) == 42)
+
+  -- slices keep their source string alive
+  local slices = {}
+  for i = 1, 100 do
+    slices[i] = (string.rep("xyz", 1000) .. i):sub(10, 2000)
+  end
+  collectgarbage(); collectgarbage()
+  for i = 1, 100 do assert(#slices[i] == 1991 and slices[i]:sub(1, 3) == "xyz") end
+
+  -- captures and string.strsplit
+  local a = string.rep("a", 50)
+  local b = string.rep("b", 60)
+  assert(string.match(a .. "," .. b, "^(%a+),(%a+)$") == a)
+  local x, y = string.strsplit(",", a .. "," .. b)
+  assert(x == a and y == b)
+end
+
+
+if string.builder then print("testing string builders")
+  local sb = string.builder()
+  assert(#sb == 0 and sb:tostring() == "" and sb:finish() == "")
+  assert(sb:append("abc", 1, 2.5, 3.0, -0.0, math.mininteger) == sb)
+  assert(sb:tostring() == "abc12.53.0-0.0" .. math.mininteger)
+  assert(tostring(sb) == sb:tostring() and #sb == #sb:tostring())
+  assert(sb:clear():append("x"):finish() == "x" and #sb == 0)
+
+  local t = {}
+  for i = 1, 1000 do sb:append("item", i, ","); t[i] = "item" .. i .. "," end
+  local s = sb:finish()
+  assert(s == table.concat(t) and #sb == 0 and sb:finish() == "")
+  t = {[s] = true}; assert(t[table.concat({s})])
+
+  sb:append("ab"):append(sb):append(sb)   -- append itself
+  assert(sb:tostring() == "abababab")
+  checkerror("string expected", sb.append, sb, {})
+  checkerror("string expected", sb.append, sb, nil)
+  checkerror("invalid capacity", string.builder, -1)
+
+  local big <close> = string.builder(1000)
+  assert(#big:append(string.rep("y", 5000)) == 5000)
+  assert(big:finish() == string.rep("y", 5000))
+end
+
+
 print('OK')
 